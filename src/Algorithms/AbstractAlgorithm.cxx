@@ -23,8 +23,12 @@
 using namespace std;
 using namespace caret;
 
-AbstractAlgorithm::AbstractAlgorithm(ProgressObject* myProgressObject)
+AbstractAlgorithm::AbstractAlgorithm(ProgressObject* myProgressObject, const AString& traceName)
 {
+    if (CaretTrace::isEnabled() && !traceName.isEmpty())
+    {
+        m_traceScope.grabNew(new CaretTraceScope(traceName, "algorithm"));
+    }
     m_progObj = myProgressObject;
     m_finish = true;
     if (m_progObj == NULL)
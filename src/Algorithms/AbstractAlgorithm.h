@@ -24,6 +24,8 @@
 //make it easy to use these in an algorithm class, don't just forward declare them
 #include "ProgressObject.h"
 #include "CaretAssert.h"
+#include "CaretPointer.h"
+#include "CaretTrace.h"
 #include "OperationParameters.h"
 #include "AbstractOperation.h"
 
@@ -34,13 +36,15 @@ namespace caret {
     {
         ProgressObject* m_progObj;//so that the destructor can make sure the bar finishes
         bool m_finish;
+        CaretPointer<CaretTraceScope> m_traceScope;//only when tracing, times the algorithm until the temporary is destroyed
         AbstractAlgorithm();//prevent default construction
     protected:
         ///override this with the weights of the algorithms this algorithm will call
         static float getSubAlgorithmWeight();//protected so that people don't try to use them to set algorithm weights in progress objects
         ///override this with the amount of work the algorithm does internally, outside of calls to other algorithms
         static float getAlgorithmInternalWeight();
-        AbstractAlgorithm(ProgressObject* myProgressObject);
+        ///traceName should be getCommandSwitch(), so that nested algorithm calls show up by name in traces
+        AbstractAlgorithm(ProgressObject* myProgressObject, const AString& traceName = "");
         virtual ~AbstractAlgorithm();
     public:
         ///use this to set the weight parameter of a ProgressObject
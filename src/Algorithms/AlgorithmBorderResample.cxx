@@ -71,7 +71,7 @@ void AlgorithmBorderResample::useParameters(OperationParameters* myParams, Progr
     AlgorithmBorderResample(myProgObj, borderIn, curSphere, newSphere, borderOut);
 }
 
-AlgorithmBorderResample::AlgorithmBorderResample(ProgressObject* myProgObj, const BorderFile* borderIn, const SurfaceFile* curSphere, const SurfaceFile* newSphere, BorderFile* borderOut) : AbstractAlgorithm(myProgObj)
+AlgorithmBorderResample::AlgorithmBorderResample(ProgressObject* myProgObj, const BorderFile* borderIn, const SurfaceFile* curSphere, const SurfaceFile* newSphere, BorderFile* borderOut) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     SurfaceFile curAdjust, newAdjust;
@@ -23,10 +23,14 @@
 #include "CaretAssert.h"
 #include "CaretLogger.h"
 #include "CaretPointer.h"
+#include "CaretOMP.h"
 #include "CiftiFile.h"
+#include "CiftiGroupReader.h"
 #include "MathFunctions.h"
 
+#include <algorithm>
 #include <cmath>
+#include <utility>
 
 using namespace caret;
 using namespace std;
@@ -57,11 +61,21 @@ OperationParameters* AlgorithmCiftiAverage::getParameters()
     OptionalParameter* weightOpt = ciftiOpt->createOptionalParameter(1, "-weight", "give a weight for this file");
     weightOpt->addDoubleParameter(1, "weight", "the weight to use");
     
+    OptionalParameter* trimOpt = ret->createOptionalParameter(4, "-trimmed-mean", "exclude the most extreme values of each element across files");
+    trimOpt->addDoubleParameter(1, "percent", "percentage of the values to exclude from each end");
+    
+    OptionalParameter* stdevOpt = ret->createOptionalParameter(5, "-stdev-out", "also output the standard deviation of each element across files");
+    stdevOpt->addCiftiOutputParameter(1, "cifti-stdev-out", "output cifti file for the standard deviation");
+    
     ret->setHelpText(
         AString("Averages cifti files together.  ") +
         "Files without -weight specified are given a weight of 1.  " +
         "If -exclude-outliers is specified, at each element, the data across all files is taken as a set, its unweighted mean and sample standard deviation are found, " +
-        "and values outside the specified number of standard deviations are excluded from the (potentially weighted) average at that element."
+        "and values outside the specified number of standard deviations are excluded from the (potentially weighted) average at that element.  " +
+        "If -trimmed-mean is specified, at each element, the numeric values across all files are sorted, and the given percentage of them (rounded down) is removed from each end " +
+        "before taking the (potentially weighted) average.\n\n" +
+        "The -stdev-out option outputs the unweighted sample standard deviation of the numeric values across all files at each element, without any exclusion or trimming.\n\n" +
+        "The input files are read concurrently, a block of rows at a time, so averaging many files on network storage is not limited by the delay of reading one file at a time."
     );
     return ret;
 }
@@ -83,89 +97,290 @@ void AlgorithmCiftiAverage::useParameters(OperationParameters* myParams, Progres
             weights.push_back(1.0f);
         }
     }
+    CiftiFile* stdevOut = NULL;
+    OptionalParameter* stdevOpt = myParams->getOptionalParameter(5);
+    if (stdevOpt->m_present)
+    {
+        stdevOut = stdevOpt->getOutputCifti(1);
+    }
     OptionalParameter* excludeOpt = myParams->getOptionalParameter(2);
+    OptionalParameter* trimOpt = myParams->getOptionalParameter(4);
+    if (excludeOpt->m_present && trimOpt->m_present) throw AlgorithmException("-exclude-outliers and -trimmed-mean may not be used together");
     if (excludeOpt->m_present)
     {
-        AlgorithmCiftiAverage(myProgObj, ciftiList, excludeOpt->getDouble(1), excludeOpt->getDouble(2), ciftiOut, &weights);
+        AlgorithmCiftiAverage(myProgObj, ciftiList, excludeOpt->getDouble(1), excludeOpt->getDouble(2), ciftiOut, &weights, stdevOut);
+    } else if (trimOpt->m_present) {
+        AlgorithmCiftiAverage(myProgObj, ciftiList, (float)trimOpt->getDouble(1), ciftiOut, &weights, stdevOut);
     } else {
-        AlgorithmCiftiAverage(myProgObj, ciftiList, ciftiOut, &weights);
+        AlgorithmCiftiAverage(myProgObj, ciftiList, ciftiOut, &weights, stdevOut);
     }
 }
 
-AlgorithmCiftiAverage::AlgorithmCiftiAverage(ProgressObject* myProgObj, const vector<const CiftiFile*>& ciftiList, CiftiFile* ciftiOut, const vector<float>* weightsPtr) : AbstractAlgorithm(myProgObj)
+namespace
 {
-    LevelProgress myProgress(myProgObj);
-    if (ciftiList.size() == 0)
+    enum AverageMethod
     {
-        throw AlgorithmException("no files specified");
-    }
-    if (weightsPtr != NULL && ciftiList.size() != weightsPtr->size())
+        PLAIN,
+        EXCLUDE_OUTLIERS,
+        TRIMMED
+    };
+    
+    struct AverageSettings
     {
-        throw AlgorithmException("number of weights doesn't match number of input cifti files");
-    }
-    CaretAssert(ciftiList[0] != NULL);
-    CiftiXML baseXML = ciftiList[0]->getCiftiXML();
-    if (baseXML.getNumberOfDimensions() != 2) throw AlgorithmException("cifti average currently only supports 2D files");
-    int numRows = baseXML.getDimensionLength(CiftiXML::ALONG_COLUMN), rowSize = baseXML.getDimensionLength(CiftiXML::ALONG_ROW), numFiles = (int)ciftiList.size();
-    for (int i = 1; i < numFiles; ++i)
+        AverageMethod m_method;
+        float m_sigmaBelow, m_sigmaAbove, m_trimPercent;
+    };
+    
+    bool valueLess(const pair<float, float>& left, const pair<float, float>& right)
     {
-        CaretAssert(ciftiList[i] != NULL);
-        if (!baseXML.approximateMatch(ciftiList[i]->getCiftiXML()))//requires at least length to match, often more restrictive
-        {
-            throw AlgorithmException("cifti file '" + ciftiList[i]->getFileName() + "' does not match earlier inputs");
-        }
+        return left.first < right.first;
     }
-    ciftiOut->setCiftiXML(baseXML);
-    vector<double> accum(rowSize);
-    vector<float> myrow(rowSize);
-    for (int i = 0; i < numRows; ++i)
+    
+    ///the element loops of the three averaging methods, done one row of output at a time, adding files in file order so the result doesn't depend on threads
+    ///returns true if an element with fewer than 2 numeric values was found with outlier exclusion
+    bool averageRow(const CiftiGroupReader& myReader, const int64_t& row, const int64_t& rowSize, const int& numFiles, const AverageSettings& settings,
+                    const vector<float>* weightsPtr, float* outRow, float* stdevRow,
+                    vector<const float*>& rowPointers, vector<double>& accumRow, vector<double>& weightRow, vector<pair<float, float> >& scratch)
     {
-        vector<double> weightaccum(rowSize, 0.0);
-        for (int j = 0; j < rowSize; ++j)
+        bool lowCount = false;
+        rowPointers.resize(numFiles);
+        for (int j = 0; j < numFiles; ++j)
         {
-            accum[j] = 0.0;
+            rowPointers[j] = myReader.getRow(j, row);
         }
-        for (int j = 0; j < numFiles; ++j)
+        switch (settings.m_method)
         {
-            ciftiList[j]->getRow(myrow.data(), i);
-            if (weightsPtr == NULL)
-            {
-                for (int k = 0; k < rowSize; ++k)
+            case PLAIN:
+                accumRow.assign(rowSize, 0.0);
+                weightRow.assign(rowSize, 0.0);
+                for (int j = 0; j < numFiles; ++j)
+                {
+                    const float* myrow = rowPointers[j];
+                    const float weight = (weightsPtr == NULL ? 1.0f : (*weightsPtr)[j]);
+                    for (int64_t k = 0; k < rowSize; ++k)
+                    {
+                        if (MathFunctions::isNumeric(myrow[k]))
+                        {
+                            weightRow[k] += weight;
+                            accumRow[k] += myrow[k] * weight;
+                        }
+                    }
+                }
+                for (int64_t k = 0; k < rowSize; ++k)
+                {
+                    if (weightRow[k] != 0.0)
+                    {
+                        outRow[k] = accumRow[k] / weightRow[k];
+                    } else {
+                        outRow[k] = 0.0f;
+                    }
+                }
+                break;
+            case EXCLUDE_OUTLIERS:
+                for (int64_t k = 0; k < rowSize; ++k)
+                {
+                    double accum = 0.0;
+                    double weightaccum = 0.0;
+                    int nonnumeric = 0;
+                    for (int j = 0; j < numFiles; ++j)
+                    {
+                        const float value = rowPointers[j][k];
+                        if (MathFunctions::isNumeric(value))
+                        {
+                            accum += value;
+                        } else {
+                            ++nonnumeric;
+                        }
+                    }
+                    if (nonnumeric >= numFiles - 1)
+                    {
+                        lowCount = true;
+                        outRow[k] = 0.0f;
+                        continue;
+                    }
+                    float mean = accum / (numFiles - nonnumeric);
+                    accum = 0.0;
+                    for (int j = 0; j < numFiles; ++j)
+                    {
+                        const float value = rowPointers[j][k];
+                        if (MathFunctions::isNumeric(value))
+                        {
+                            float temp = value - mean;
+                            accum += temp * temp;
+                        }
+                    }
+                    float stdev = sqrt(accum / (numFiles - 1 - nonnumeric));
+                    float cutoffLow = mean - settings.m_sigmaBelow * stdev;
+                    float cutoffHigh = mean + settings.m_sigmaAbove * stdev;
+                    accum = 0.0;
+                    for (int j = 0; j < numFiles; ++j)
+                    {
+                        const float value = rowPointers[j][k];
+                        if (value > cutoffLow && value < cutoffHigh)//implicitly excludes NaN and inf
+                        {
+                            if (weightsPtr != NULL)
+                            {
+                                float weight = (*weightsPtr)[j];
+                                accum += value * weight;
+                                weightaccum += weight;
+                            } else {
+                                accum += value;
+                                weightaccum += 1.0;
+                            }
+                        }
+                    }
+                    if (weightaccum != 0.0)
+                    {
+                        outRow[k] = accum / weightaccum;
+                    } else {
+                        outRow[k] = 0.0f;
+                    }
+                }
+                break;
+            case TRIMMED:
+                for (int64_t k = 0; k < rowSize; ++k)
                 {
-                    if (MathFunctions::isNumeric(myrow[k]))
+                    scratch.clear();
+                    for (int j = 0; j < numFiles; ++j)
                     {
-                        weightaccum[k] += 1.0;
-                        accum[k] += myrow[k];
+                        const float value = rowPointers[j][k];
+                        if (MathFunctions::isNumeric(value))
+                        {
+                            scratch.push_back(pair<float, float>(value, (weightsPtr == NULL ? 1.0f : (*weightsPtr)[j])));
+                        }
+                    }
+                    const int numUse = (int)scratch.size();
+                    const int numTrim = (int)floor(numUse * settings.m_trimPercent / 100.0);
+                    stable_sort(scratch.begin(), scratch.end(), valueLess);//stable, so equal values are summed in file order
+                    double accum = 0.0, weightaccum = 0.0;
+                    for (int j = numTrim; j < numUse - numTrim; ++j)
+                    {
+                        accum += scratch[j].first * scratch[j].second;
+                        weightaccum += scratch[j].second;
+                    }
+                    if (weightaccum != 0.0)
+                    {
+                        outRow[k] = accum / weightaccum;
+                    } else {
+                        outRow[k] = 0.0f;
                     }
                 }
-            } else {
-                float weight = (*weightsPtr)[j];
-                for (int k = 0; k < rowSize; ++k)
+                break;
+        }
+        if (stdevRow != NULL)
+        {//unweighted sample standard deviation of all numeric values, by Welford
+            for (int64_t k = 0; k < rowSize; ++k)
+            {
+                double mean = 0.0, residsqr = 0.0;
+                int64_t count = 0;
+                for (int j = 0; j < numFiles; ++j)
                 {
-                    if (MathFunctions::isNumeric(myrow[k]))
+                    const float value = rowPointers[j][k];
+                    if (MathFunctions::isNumeric(value))
                     {
-                        weightaccum[k] += weight;
-                        accum[k] += myrow[k] * weight;
+                        ++count;
+                        double delta = value - mean;
+                        mean += delta / count;
+                        residsqr += delta * (value - mean);
                     }
                 }
+                if (count > 1)
+                {
+                    stdevRow[k] = sqrt(residsqr / (count - 1));
+                } else {
+                    stdevRow[k] = 0.0f;
+                }
             }
         }
-        for (int k = 0; k < rowSize; ++k)
+        return lowCount;
+    }
+    
+    void averageFiles(LevelProgress& myProgress, const vector<const CiftiFile*>& ciftiList, const AverageSettings& settings,
+                      CiftiFile* ciftiOut, const vector<float>* weightsPtr, CiftiFile* stdevOut)
+    {
+        const CiftiXML& baseXML = ciftiList[0]->getCiftiXML();
+        const int64_t numRows = baseXML.getDimensionLength(CiftiXML::ALONG_COLUMN), rowSize = baseXML.getDimensionLength(CiftiXML::ALONG_ROW);
+        const int numFiles = (int)ciftiList.size();
+        ciftiOut->setCiftiXML(baseXML);
+        if (stdevOut != NULL) stdevOut->setCiftiXML(baseXML);
+        CiftiGroupReader myReader(ciftiList);
+        const int64_t rowsPerBlock = myReader.getRowsPerBlock();
+        vector<float> outBlock(rowsPerBlock * rowSize), stdevBlock(stdevOut == NULL ? 0 : rowsPerBlock * rowSize);
+        bool haveWarned = false;
+        for (int64_t firstRow = 0; firstRow < numRows; firstRow += rowsPerBlock)
         {
-            if (weightaccum[k] != 0.0)
+            const int64_t blockRows = min(rowsPerBlock, numRows - firstRow);
+            myReader.readBlock(firstRow, blockRows);
+            bool lowCount = false;
+#pragma omp CARET_PAR
+            {
+                vector<const float*> rowPointers;
+                vector<double> accumRow, weightRow;
+                vector<pair<float, float> > scratch;
+                bool threadLowCount = false;
+#pragma omp CARET_FOR schedule(dynamic)
+                for (int64_t i = 0; i < blockRows; ++i)
+                {
+                    if (averageRow(myReader, firstRow + i, rowSize, numFiles, settings, weightsPtr, outBlock.data() + i * rowSize,
+                                   (stdevOut == NULL ? NULL : stdevBlock.data() + i * rowSize), rowPointers, accumRow, weightRow, scratch))
+                    {
+                        threadLowCount = true;
+                    }
+                }
+                if (threadLowCount)
+                {
+#pragma omp critical
+                    lowCount = true;
+                }
+            }
+            if (lowCount && !haveWarned)
+            {
+                CaretLogWarning("found element where less than 2 files have numeric values");
+                haveWarned = true;
+            }
+            for (int64_t i = 0; i < blockRows; ++i)
             {
-                myrow[k] = accum[k] / weightaccum[k];
-            } else {
-                myrow[k] = 0.0f;
+                ciftiOut->setRow(outBlock.data() + i * rowSize, firstRow + i);
+                if (stdevOut != NULL) stdevOut->setRow(stdevBlock.data() + i * rowSize, firstRow + i);
             }
+            myProgress.reportProgress((firstRow + blockRows) / (float)numRows);
         }
-        ciftiOut->setRow(myrow.data(), i);
+        CaretLogInfo("cifti average " + myReader.getThroughputDescription());
     }
 }
 
+AlgorithmCiftiAverage::AlgorithmCiftiAverage(ProgressObject* myProgObj, const vector<const CiftiFile*>& ciftiList, CiftiFile* ciftiOut, const vector<float>* weightsPtr,
+                                             CiftiFile* stdevOut) : AbstractAlgorithm(myProgObj, getCommandSwitch())
+{
+    LevelProgress myProgress(myProgObj);
+    if (ciftiList.size() == 0)
+    {
+        throw AlgorithmException("no files specified");
+    }
+    if (weightsPtr != NULL && ciftiList.size() != weightsPtr->size())
+    {
+        throw AlgorithmException("number of weights doesn't match number of input cifti files");
+    }
+    CaretAssert(ciftiList[0] != NULL);
+    const CiftiXML& baseXML = ciftiList[0]->getCiftiXML();
+    if (baseXML.getNumberOfDimensions() != 2) throw AlgorithmException("cifti average currently only supports 2D files");
+    int numFiles = (int)ciftiList.size();
+    for (int i = 1; i < numFiles; ++i)
+    {
+        CaretAssert(ciftiList[i] != NULL);
+        if (!baseXML.approximateMatch(ciftiList[i]->getCiftiXML()))//requires at least length to match, often more restrictive
+        {
+            throw AlgorithmException("cifti file '" + ciftiList[i]->getFileName() + "' does not match earlier inputs");
+        }
+    }
+    AverageSettings settings;
+    settings.m_method = PLAIN;
+    averageFiles(myProgress, ciftiList, settings, ciftiOut, weightsPtr, stdevOut);
+}
+
 AlgorithmCiftiAverage::AlgorithmCiftiAverage(ProgressObject* myProgObj, const vector<const CiftiFile*>& ciftiList,
                                              const float& sigmaBelow, const float& sigmaAbove,
-                                             CiftiFile* ciftiOut, const std::vector<float>* weightsPtr): AbstractAlgorithm(myProgObj)
+                                             CiftiFile* ciftiOut, const std::vector<float>* weightsPtr, CiftiFile* stdevOut): AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (ciftiList.size() < 2)
@@ -177,9 +392,9 @@ AlgorithmCiftiAverage::AlgorithmCiftiAverage(ProgressObject* myProgObj, const ve
         throw AlgorithmException("number of weights doesn't match number of input cifti files");
     }
     CaretAssert(ciftiList[0] != NULL);
-    CiftiXML baseXML = ciftiList[0]->getCiftiXML();
+    const CiftiXML& baseXML = ciftiList[0]->getCiftiXML();
     if (baseXML.getNumberOfDimensions() != 2) throw AlgorithmException("cifti average currently only supports 2D files");
-    int numRows = baseXML.getDimensionLength(CiftiXML::ALONG_COLUMN), rowSize = baseXML.getDimensionLength(CiftiXML::ALONG_ROW), numFiles = (int)ciftiList.size();
+    int numFiles = (int)ciftiList.size();
     for (int i = 1; i < numFiles; ++i)
     {
         CaretAssert(ciftiList[i] != NULL);
@@ -188,78 +403,42 @@ AlgorithmCiftiAverage::AlgorithmCiftiAverage(ProgressObject* myProgObj, const ve
             throw AlgorithmException("cifti files do not match");
         }
     }
-    bool haveWarned = false;
-    ciftiOut->setCiftiXML(baseXML);
-    vector<vector<float> > myrows(numFiles, vector<float>(rowSize));
-    for (int i = 0; i < numRows; ++i)
+    AverageSettings settings;
+    settings.m_method = EXCLUDE_OUTLIERS;
+    settings.m_sigmaBelow = sigmaBelow;
+    settings.m_sigmaAbove = sigmaAbove;
+    averageFiles(myProgress, ciftiList, settings, ciftiOut, weightsPtr, stdevOut);
+}
+
+AlgorithmCiftiAverage::AlgorithmCiftiAverage(ProgressObject* myProgObj, const vector<const CiftiFile*>& ciftiList, const float& trimPercent,
+                                             CiftiFile* ciftiOut, const vector<float>* weightsPtr, CiftiFile* stdevOut): AbstractAlgorithm(myProgObj, getCommandSwitch())
+{
+    LevelProgress myProgress(myProgObj);
+    if (ciftiList.size() == 0)
     {
-        for (int j = 0; j < numFiles; ++j)
-        {
-            ciftiList[j]->getRow(myrows[j].data(), i);
-        }
-        vector<float> outrow(rowSize);
-        for (int k = 0; k < rowSize; ++k)
+        throw AlgorithmException("no files specified");
+    }
+    if (!(trimPercent >= 0.0f && trimPercent < 50.0f)) throw AlgorithmException("trimmed mean percent must be at least 0 and less than 50");
+    if (weightsPtr != NULL && ciftiList.size() != weightsPtr->size())
+    {
+        throw AlgorithmException("number of weights doesn't match number of input cifti files");
+    }
+    CaretAssert(ciftiList[0] != NULL);
+    const CiftiXML& baseXML = ciftiList[0]->getCiftiXML();
+    if (baseXML.getNumberOfDimensions() != 2) throw AlgorithmException("cifti average currently only supports 2D files");
+    int numFiles = (int)ciftiList.size();
+    for (int i = 1; i < numFiles; ++i)
+    {
+        CaretAssert(ciftiList[i] != NULL);
+        if (!baseXML.approximateMatch(ciftiList[i]->getCiftiXML()))
         {
-            double accum = 0.0;
-            double weightaccum = 0.0;
-            int nonnumeric = 0;
-            for (int j = 0; j < numFiles; ++j)
-            {
-                if (MathFunctions::isNumeric(myrows[j][k]))
-                {
-                    accum += myrows[j][k];
-                } else {
-                    ++nonnumeric;
-                }
-            }
-            if (nonnumeric >= numFiles - 1)
-            {
-                if (!haveWarned)
-                {
-                    CaretLogWarning("found element where less than 2 files have numeric values");
-                    haveWarned = true;
-                }
-                outrow[k] = 0.0f;
-            } else {
-                float mean = accum / (numFiles - nonnumeric);
-                accum = 0.0;
-                for (int j = 0; j < numFiles; ++j)
-                {
-                    if (MathFunctions::isNumeric(myrows[j][k]))
-                    {
-                        float temp = myrows[j][k] - mean;
-                        accum += temp * temp;
-                    }
-                }
-                float stdev = sqrt(accum / (numFiles - 1 - nonnumeric));
-                float cutoffLow = mean - sigmaBelow * stdev;
-                float cutoffHigh = mean + sigmaAbove * stdev;
-                accum = 0.0;
-                for (int j = 0; j < numFiles; ++j)
-                {
-                    if (myrows[j][k] > cutoffLow && myrows[j][k] < cutoffHigh)//implicitly excludes NaN and inf
-                    {
-                        if (weightsPtr != NULL)
-                        {
-                            float weight = (*weightsPtr)[j];
-                            accum += myrows[j][k] * weight;
-                            weightaccum += weight;
-                        } else {
-                            accum += myrows[j][k];
-                            weightaccum += 1.0;
-                        }
-                    }
-                }
-                if (weightaccum != 0.0)
-                {
-                    outrow[k] = accum / weightaccum;
-                } else {
-                    outrow[k] = 0.0f;
-                }
-            }
+            throw AlgorithmException("cifti file '" + ciftiList[i]->getFileName() + "' does not match earlier inputs");
         }
-        ciftiOut->setRow(outrow.data(), i);
     }
+    AverageSettings settings;
+    settings.m_method = TRIMMED;
+    settings.m_trimPercent = trimPercent;
+    averageFiles(myProgress, ciftiList, settings, ciftiOut, weightsPtr, stdevOut);
 }
 
 float AlgorithmCiftiAverage::getAlgorithmInternalWeight()
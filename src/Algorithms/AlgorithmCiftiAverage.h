@@ -33,8 +33,13 @@ namespace caret {
         static float getSubAlgorithmWeight();
         static float getAlgorithmInternalWeight();
     public:
-        AlgorithmCiftiAverage(ProgressObject* myProgObj, const std::vector<const CiftiFile*>& ciftiList, CiftiFile* ciftiOut, const std::vector<float>* weightsPtr = NULL);
-        AlgorithmCiftiAverage(ProgressObject* myProgObj, const std::vector<const CiftiFile*>& ciftiList, const float& sigmaBelow, const float& sigmaAbove, CiftiFile* ciftiOut, const std::vector<float>* weightsPtr = NULL);
+        AlgorithmCiftiAverage(ProgressObject* myProgObj, const std::vector<const CiftiFile*>& ciftiList, CiftiFile* ciftiOut, const std::vector<float>* weightsPtr = NULL,
+                              CiftiFile* stdevOut = NULL);
+        AlgorithmCiftiAverage(ProgressObject* myProgObj, const std::vector<const CiftiFile*>& ciftiList, const float& sigmaBelow, const float& sigmaAbove, CiftiFile* ciftiOut, const std::vector<float>* weightsPtr = NULL,
+                              CiftiFile* stdevOut = NULL);
+        ///trimPercent is removed from each end of the sorted values at each element
+        AlgorithmCiftiAverage(ProgressObject* myProgObj, const std::vector<const CiftiFile*>& ciftiList, const float& trimPercent, CiftiFile* ciftiOut, const std::vector<float>* weightsPtr = NULL,
+                              CiftiFile* stdevOut = NULL);
         static OperationParameters* getParameters();
         static void useParameters(OperationParameters* myParams, ProgressObject* myProgObj);
         static AString getCommandSwitch();
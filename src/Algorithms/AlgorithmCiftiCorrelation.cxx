@@ -31,6 +31,7 @@
 #include "FileInformation.h"
 #include "CaretPointer.h"
 #include "dot_wrapper.h"
+#include <cmath>
 #include <fstream>
 #include <utility>
 #include <algorithm>
@@ -188,7 +189,7 @@ void AlgorithmCiftiCorrelation::useParameters(OperationParameters* myParams, Pro
 }
 
 AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj, const CiftiFile* myCifti, CiftiFile* myCiftiOut, const vector<float>* weights,
-                                                     const bool& fisherZ, const float& memLimitGB, const bool& noDemean, const bool& covariance) : AbstractAlgorithm(myProgObj)
+                                                     const bool& fisherZ, const float& memLimitGB, const bool& noDemean, const bool& covariance) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (covariance)
@@ -196,10 +197,44 @@ AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj,
         if (fisherZ) throw AlgorithmException("cannot apply fisher z transformation to covariance");
     }
     init(myCifti, weights, noDemean, covariance);
+    correlateAllRows(myCifti, myCiftiOut, fisherZ, memLimitGB, myProgress);
+}
+
+AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj, const CiftiFile* myCifti, const AString& sparseOutName, const int64_t& topK,
+                                                     const float& threshold, const vector<float>* weights, const bool& fisherZ, const float& memLimitGB,
+                                                     const bool& noDemean, const bool& covariance) : AbstractAlgorithm(myProgObj, getCommandSwitch())
+{
+    LevelProgress myProgress(myProgObj);
+    if (covariance)
+    {
+        if (fisherZ) throw AlgorithmException("cannot apply fisher z transformation to covariance");
+    }
+    if (topK < 0 && threshold < 0.0f) throw AlgorithmException("sparse output requires a top-k count or a threshold");
+    init(myCifti, weights, noDemean, covariance);
+    m_sparseTopK = topK;
+    m_sparseThreshold = threshold;
+    CiftiXML newXML = myCifti->getCiftiXML();
+    if (newXML.getNumberOfDimensions() != 2) throw AlgorithmException("sparse correlation output only supports 2D cifti");
+    newXML.setMap(CiftiXML::ALONG_ROW, *(newXML.getMap(CiftiXML::ALONG_COLUMN)));
+    try
+    {
+        m_sparseOut.grabNew(new CaretSparseFileWriter(sparseOutName, newXML, 2, true));
+        correlateAllRows(myCifti, NULL, fisherZ, memLimitGB, myProgress);
+        m_sparseOut->finish();
+    } catch (DataFileException& e) {
+        throw AlgorithmException(e);
+    }
+}
+
+void AlgorithmCiftiCorrelation::correlateAllRows(const CiftiFile* myCifti, CiftiFile* myCiftiOut, const bool& fisherZ, const float& memLimitGB, LevelProgress& myProgress)
+{//writes to the sparse output if myCiftiOut is NULL
     int numRows = myCifti->getNumberOfRows();
-    CiftiXMLOld newXML = myCifti->getCiftiXMLOld();
-    newXML.applyColumnMapToRows();
-    myCiftiOut->setCiftiXML(newXML);
+    if (myCiftiOut != NULL)
+    {
+        CiftiXMLOld newXML = myCifti->getCiftiXMLOld();
+        newXML.applyColumnMapToRows();
+        myCiftiOut->setCiftiXML(newXML);
+    }
     int numCacheRows;
     bool cacheFullInput = true;
     if (memLimitGB >= 0.0f)
@@ -272,8 +307,14 @@ AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj,
         }
         for (int i = startrow; i < endrow; ++i)
         {
-            myCiftiOut->setRow(outRows[i - startrow], i);
+            if (myCiftiOut != NULL)
+            {
+                myCiftiOut->setRow(outRows[i - startrow], i);
+            } else {
+                writeSparseRow(outRows[i - startrow], i);
+            }
         }
+        myProgress.reportProgress(((float)endrow) / numRows);
         if (!cacheFullInput)
         {
             clearCache();//tell the cache we are going to preload a different set of rows now
@@ -285,10 +326,49 @@ AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj,
     }
 }
 
+namespace
+{
+    struct AbsGreater
+    {//for top-k selection of indices into a row, NaNs have been removed already
+        const float* m_row;
+        AbsGreater(const float* row) : m_row(row) { }
+        bool operator()(const int64_t& left, const int64_t& right) const
+        {
+            return abs(m_row[left]) > abs(m_row[right]);
+        }
+    };
+}
+
+void AlgorithmCiftiCorrelation::writeSparseRow(const float* row, const int64_t& index)
+{
+    CaretAssert(m_sparseOut != NULL);
+    const int64_t rowLength = m_inputCifti->getNumberOfRows();
+    m_sparseIndices.clear();
+    for (int64_t j = 0; j < rowLength; ++j)
+    {
+        if (j == index && !m_covariance) continue;//a row's correlation with itself is always 1 (or the clamped artanh of it), and would take a top-k slot in every row
+        if (row[j] != row[j]) continue;//NaN
+        if (m_sparseThreshold >= 0.0f && !(abs(row[j]) >= m_sparseThreshold)) continue;
+        m_sparseIndices.push_back(j);
+    }
+    if (m_sparseTopK >= 0 && (int64_t)m_sparseIndices.size() > m_sparseTopK)
+    {
+        nth_element(m_sparseIndices.begin(), m_sparseIndices.begin() + m_sparseTopK, m_sparseIndices.end(), AbsGreater(row));
+        m_sparseIndices.resize(m_sparseTopK);
+        sort(m_sparseIndices.begin(), m_sparseIndices.end());
+    }
+    m_sparseValues.resize(m_sparseIndices.size());
+    for (size_t j = 0; j < m_sparseIndices.size(); ++j)
+    {
+        m_sparseValues[j] = row[m_sparseIndices[j]];
+    }
+    m_sparseOut->writeFloatRowSparse(index, m_sparseIndices, m_sparseValues);
+}
+
 AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj, const CiftiFile* myCifti, CiftiFile* myCiftiOut,
                                                      const MetricFile* leftRoi, const MetricFile* rightRoi, const MetricFile* cerebRoi,
                                                      const VolumeFile* volRoi, const vector<float>* weights, const bool& fisherZ, const float& memLimitGB,
-                                                     const bool& noDemean, const bool& covariance) : AbstractAlgorithm(myProgObj)
+                                                     const bool& noDemean, const bool& covariance) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (covariance)
@@ -476,7 +556,7 @@ AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj,
 
 AlgorithmCiftiCorrelation::AlgorithmCiftiCorrelation(ProgressObject* myProgObj, const CiftiFile* myCifti, CiftiFile* myCiftiOut, const CiftiFile* ciftiRoi,
                                                      const vector<float>* weights, const bool& fisherZ, const float& memLimitGB,
-                                                     const bool& noDemean, const bool& covariance): AbstractAlgorithm(NULL)//HACK: get around the sentinel by passing a null, because this implementation calls another
+                                                     const bool& noDemean, const bool& covariance): AbstractAlgorithm(NULL, getCommandSwitch())//HACK: get around the sentinel by passing a null, because this implementation calls another
 {
     const CiftiXML& roiXML = ciftiRoi->getCiftiXML();//roi is not optional in this variant
     if (roiXML.getMappingType(CiftiXML::ALONG_COLUMN) != CiftiMappingType::BRAIN_MODELS) throw AlgorithmException("cifti roi does not have brain models mapping along column");
@@ -568,6 +648,8 @@ void AlgorithmCiftiCorrelation::init(const CiftiFile* input, const vector<float>
 {
     m_noDemean = noDemean;
     m_covariance = covariance;
+    m_sparseTopK = -1;
+    m_sparseThreshold = -1.0f;
     m_inputCifti = input;
     m_rowInfo.resize(m_inputCifti->getNumberOfRows());
     m_cacheUsed = 0;
@@ -24,6 +24,7 @@
 #include <vector>
 #include "AbstractAlgorithm.h"
 #include "CaretPointer.h"
+#include "CaretSparseFile.h"
 
 namespace caret {
     
@@ -55,6 +56,13 @@ namespace caret {
         int m_cacheUsed;//reuse cache entries instead of reallocating them
         int m_numCols;
         const CiftiFile* m_inputCifti;//so that accesses work through the cache functions
+        CaretPointer<CaretSparseFileWriter> m_sparseOut;
+        int64_t m_sparseTopK;
+        float m_sparseThreshold;
+        std::vector<int64_t> m_sparseIndices;
+        std::vector<float> m_sparseValues;
+        void correlateAllRows(const CiftiFile* myCifti, CiftiFile* myCiftiOut, const bool& fisherZ, const float& memLimitGB, LevelProgress& myProgress);
+        void writeSparseRow(const float* row, const int64_t& index);
         void cacheRow(const int& ciftiIndex);
         void computeRowStats(const float* row, float& mean, float& rootResidSqr);
         void doSubtract(float* row, const float& mean);
@@ -77,6 +85,11 @@ namespace caret {
         AlgorithmCiftiCorrelation(ProgressObject* myProgObj, const CiftiFile* myCifti, CiftiFile* myCiftiOut, const CiftiFile* ciftiRoi,
                                   const std::vector<float>* weights = NULL, const bool& fisherZ = false, const float& memLimitGB = -1.0f,
                                   const bool& noDemean = false, const bool& covariance = false);
+        ///keeps only the largest absolute values of each output row (topK < 0 for no count limit), and/or those at least as large as threshold (threshold < 0 for none), written as float rows in a version 2 wbsparse file
+        ///the diagonal is left out, except for covariance
+        AlgorithmCiftiCorrelation(ProgressObject* myProgObj, const CiftiFile* myCifti, const AString& sparseOutName, const int64_t& topK, const float& threshold,
+                                  const std::vector<float>* weights = NULL, const bool& fisherZ = false, const float& memLimitGB = -1.0f,
+                                  const bool& noDemean = false, const bool& covariance = false);
         static OperationParameters* getParameters();
         static void useParameters(OperationParameters* myParams, ProgressObject* myProgObj);
         static AString getCommandSwitch();
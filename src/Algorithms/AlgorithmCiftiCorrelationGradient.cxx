@@ -26,17 +26,35 @@
 #include "CaretLogger.h"
 #include "CaretOMP.h"
 #include "CiftiFile.h"
+#include "ElapsedTimer.h"
 #include "GeodesicHelper.h"
 #include "MetricFile.h"
 #include "SurfaceFile.h"
 #include "Vector3D.h"
 #include "VolumeFile.h"
 #include "dot_wrapper.h"
+#include <algorithm>
 #include <cmath>
 
 using namespace caret;
 using namespace std;
 
+namespace
+{
+    const int GRADIENT_BATCH_COLUMNS = 32;//columns per gradient call on surfaces
+    
+    void logStageTimes(const StructureEnum::Enum& myStructure, const double& readSeconds, const double& correlateSeconds, const double& smoothSeconds, const double& gradientSeconds)
+    {
+        AString message = StructureEnum::toName(myStructure) + ": reading " + AString::number(readSeconds, 'f', 2) + "s, correlation " + AString::number(correlateSeconds, 'f', 2) + "s";
+        if (smoothSeconds > 0.0)
+        {
+            message += ", smoothing " + AString::number(smoothSeconds, 'f', 2) + "s";
+        }
+        message += ", gradient " + AString::number(gradientSeconds, 'f', 2) + "s";
+        CaretLogInfo(message);
+    }
+}
+
 AString AlgorithmCiftiCorrelationGradient::getCommandSwitch()
 {
     return "-cifti-correlation-gradient";
@@ -189,7 +207,7 @@ AlgorithmCiftiCorrelationGradient::AlgorithmCiftiCorrelationGradient(ProgressObj
                                                                      const float& surfKern, const float& volKern, const bool& undoFisherInput, const bool& applyFisher,
                                                                      const float& surfaceExclude, const float& volumeExclude,
                                                                      const bool& covariance,
-                                                                     const float& memLimitGB) : AbstractAlgorithm(myProgObj)
+                                                                     const float& memLimitGB) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     init(myCifti, undoFisherInput, applyFisher, covariance);
@@ -311,18 +329,23 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
     MetricFile myRoi;
     myRoi.setNumberOfNodesAndColumns(mySurf->getNumberOfNodes(), 1);
     myRoi.initializeColumn(0);
-    vector<int> rowsToCache;
+    vector<int> rowsToCache, ciftiIndices(mapSize);
     for (int i = 0; i < mapSize; ++i)
     {
+        ciftiIndices[i] = myMap[i].m_ciftiIndex;
         myRoi.setValue(myMap[i].m_surfaceNode, 0, 1.0f);
         if (cacheFullInput)
         {
             rowsToCache.push_back(myMap[i].m_ciftiIndex);
         }
     }
+    ElapsedTimer stageTimer;
+    double readSeconds = 0.0, correlateSeconds = 0.0, smoothSeconds = 0.0, gradientSeconds = 0.0;
     if (cacheFullInput)
     {
+        stageTimer.start();
         cacheRows(rowsToCache);
+        readSeconds += stageTimer.getElapsedTimeSeconds();
     }
     CaretPointer<MetricSmoothingObject> mySmooth;
     if (surfKern > 0.0f)
@@ -340,23 +363,20 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
             {
                 rowsToCache.push_back(myMap[i].m_ciftiIndex);
             }
+            stageTimer.start();
             cacheRows(rowsToCache);
+            readSeconds += stageTimer.getElapsedTimeSeconds();
         }
-        int curRow = 0;//because we can't trust the order threads hit the critical section
+        int uncachedRow = 0;//counts the rows read from the file in this block, see getMovingRow
+        stageTimer.start();
         MetricFile computeMetric;
         computeMetric.setNumberOfNodesAndColumns(mySurf->getNumberOfNodes(), endpos - startpos);
 #pragma omp CARET_PARFOR schedule(dynamic)
         for (int i = 0; i < mapSize; ++i)
         {
             float movingRrs;
-            const float* movingRow;
             int myrow;
-#pragma omp critical
-            {//CiftiFile may explode if we request multiple rows concurrently (needs mutexes), but we should force sequential requests anyway
-                myrow = curRow;//so, manually force it to read sequentially
-                ++curRow;
-                movingRow = getRow(myMap[myrow].m_ciftiIndex, movingRrs);
-            }
+            const float* movingRow = getMovingRow(i, startpos, endpos, cacheFullInput, ciftiIndices, uncachedRow, myrow, movingRrs);
             for (int j = startpos; j < endpos; ++j)
             {
                 if (myrow >= startpos && myrow < endpos)
@@ -377,34 +397,49 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
                 }
             }
         }
+        correlateSeconds += stageTimer.getElapsedTimeSeconds();
         int numMetricCols = endpos - startpos;
-        MetricFile outputMetric, outputMetric2;
-        for (int j = 0; j < numMetricCols; ++j)
-        {
-            const float* myCol;
-            if (surfKern > 0.0f)
+        const float* roiColumn = myRoi.getValuePointerForColumn(0);
+        MetricFile batchMetric, outputMetric;
+        for (int batchStart = 0; batchStart < numMetricCols; batchStart += GRADIENT_BATCH_COLUMNS)
+        {//take the gradient of several columns per call, so that the surface normals and areas aren't recomputed for every column
+            int batchEnd = min(batchStart + GRADIENT_BATCH_COLUMNS, numMetricCols);
+            stageTimer.start();
+            batchMetric.setNumberOfNodesAndColumns(mySurf->getNumberOfNodes(), batchEnd - batchStart);
+            for (int j = batchStart; j < batchEnd; ++j)
             {
-                mySmooth->smoothColumn(&computeMetric, j, &outputMetric);
-                AlgorithmMetricGradient(NULL, mySurf, &outputMetric, &outputMetric2, NULL, -1.0f, &myRoi, false, -1, myAreas);
-                myCol = outputMetric2.getValuePointerForColumn(0);
-            } else {
-                AlgorithmMetricGradient(NULL, mySurf, &computeMetric, &outputMetric, NULL, -1.0f, &myRoi, false, j, myAreas);
-                myCol = outputMetric.getValuePointerForColumn(0);
+                if (surfKern > 0.0f)
+                {
+                    mySmooth->smoothColumn(&computeMetric, j, &batchMetric, j - batchStart);
+                } else {
+                    batchMetric.setValuesForColumn(j - batchStart, computeMetric.getValuePointerForColumn(j));
+                }
             }
-            for (int i = 0; i < mapSize; ++i)
+            if (surfKern > 0.0f)
+            {//without smoothing, the copy into the batch counts as part of the gradient
+                smoothSeconds += stageTimer.getElapsedTimeSeconds();
+                stageTimer.start();
+            }
+            AlgorithmMetricGradient(NULL, mySurf, &batchMetric, &outputMetric, NULL, -1.0f, &myRoi, false, -1, myAreas);
+            for (int j = batchStart; j < batchEnd; ++j)
             {
-                const float* roiColumn = myRoi.getValuePointerForColumn(0);
-                if (roiColumn[myMap[i].m_surfaceNode] > 0.0f)
+                const float* myCol = outputMetric.getValuePointerForColumn(j - batchStart);
+                for (int i = 0; i < mapSize; ++i)
                 {
-                    accum[i] += myCol[myMap[i].m_surfaceNode];
+                    if (roiColumn[myMap[i].m_surfaceNode] > 0.0f)
+                    {
+                        accum[i] += myCol[myMap[i].m_surfaceNode];
+                    }
                 }
             }
+            gradientSeconds += stageTimer.getElapsedTimeSeconds();
         }
     }
     for (int i = 0; i < mapSize; ++i)
     {
         m_outColumn[myMap[i].m_ciftiIndex] = accum[i] / mapSize;
     }
+    logStageTimes(myStructure, readSeconds, correlateSeconds, smoothSeconds, gradientSeconds);
 }
 
 void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::Enum& myStructure, const float& surfKern, const float& surfExclude, const float& memLimitGB, SurfaceFile* mySurf, const MetricFile* myAreas)
@@ -444,18 +479,23 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
     vector<vector<bool> > roiLookup(numCacheRows);//this gets bit compressed
     vector<bool> origRoi(mySurf->getNumberOfNodes());
     vector<vector<int32_t> > excludeNodes(numCacheRows);
-    vector<int> rowsToCache;
+    vector<int> rowsToCache, ciftiIndices(mapSize);
     for (int i = 0; i < mapSize; ++i)
     {
+        ciftiIndices[i] = myMap[i].m_ciftiIndex;
         myRoi.setValue(myMap[i].m_surfaceNode, 0, 1.0f);
         if (cacheFullInput)
         {
             rowsToCache.push_back(myMap[i].m_ciftiIndex);
         }
     }
+    ElapsedTimer stageTimer;
+    double readSeconds = 0.0, correlateSeconds = 0.0, smoothSeconds = 0.0, gradientSeconds = 0.0;
     if (cacheFullInput)
     {
+        stageTimer.start();
         cacheRows(rowsToCache);
+        readSeconds += stageTimer.getElapsedTimeSeconds();
     }
     CaretPointer<MetricSmoothingObject> mySmooth;
     if (surfKern > 0.0f)
@@ -473,7 +513,9 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
             {
                 rowsToCache.push_back(myMap[i].m_ciftiIndex);
             }
+            stageTimer.start();
             cacheRows(rowsToCache);
+            readSeconds += stageTimer.getElapsedTimeSeconds();
         }
         int numSurfNodes = mySurf->getNumberOfNodes();
 #pragma omp CARET_PAR
@@ -498,21 +540,16 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
                 }
             }
         }
-        int curRow = 0;//because we can't trust the order threads hit the critical section
+        int uncachedRow = 0;//counts the rows read from the file in this block, see getMovingRow
+        stageTimer.start();
         MetricFile computeMetric;
         computeMetric.setNumberOfNodesAndColumns(mySurf->getNumberOfNodes(), endpos - startpos);
 #pragma omp CARET_PARFOR schedule(dynamic)
         for (int i = 0; i < mapSize; ++i)
         {
             float movingRrs;
-            const float* movingRow;
             int myrow;
-#pragma omp critical
-            {//CiftiFile may explode if we request multiple rows concurrently (needs mutexes), but we should force sequential requests anyway
-                myrow = curRow;//so, manually force it to read sequentially
-                ++curRow;
-                movingRow = getRow(myMap[myrow].m_ciftiIndex, movingRrs);
-            }
+            const float* movingRow = getMovingRow(i, startpos, endpos, cacheFullInput, ciftiIndices, uncachedRow, myrow, movingRrs);
             for (int j = startpos; j < endpos; ++j)
             {
                 if (roiLookup[j - startpos][myMap[myrow].m_surfaceNode])
@@ -536,39 +573,51 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
                 }
             }
         }
+        correlateSeconds += stageTimer.getElapsedTimeSeconds();
         int numMetricCols = endpos - startpos;
-        MetricFile outputMetric, outputMetric2;
-        MetricFile excludeRoi = myRoi;
-        for (int j = 0; j < numMetricCols; ++j)
-        {
-            int numExclude = (int)excludeNodes[j].size();
-            const float* myCol;
-            for (int k = 0; k < numExclude; ++k)
+        const float* roiColumn = myRoi.getValuePointerForColumn(0);
+        MetricFile batchMetric, batchRoi, outputMetric;
+        for (int batchStart = 0; batchStart < numMetricCols; batchStart += GRADIENT_BATCH_COLUMNS)
+        {//take the gradient of several columns per call, so that the surface normals and areas aren't recomputed for every column
+            int batchEnd = min(batchStart + GRADIENT_BATCH_COLUMNS, numMetricCols);
+            stageTimer.start();
+            batchMetric.setNumberOfNodesAndColumns(mySurf->getNumberOfNodes(), batchEnd - batchStart);
+            batchRoi.setNumberOfNodesAndColumns(mySurf->getNumberOfNodes(), batchEnd - batchStart);
+            for (int j = batchStart; j < batchEnd; ++j)
             {
-                excludeRoi.setValue(excludeNodes[j][k], 0, 0.0f);//exclude the nodes near the seed node
+                batchRoi.setValuesForColumn(j - batchStart, roiColumn);
+                int numExclude = (int)excludeNodes[j].size();
+                for (int k = 0; k < numExclude; ++k)
+                {
+                    batchRoi.setValue(excludeNodes[j][k], j - batchStart, 0.0f);//exclude the nodes near the seed node
+                }
+                if (surfKern > 0.0f)
+                {
+                    mySmooth->smoothColumn(&computeMetric, j, &batchMetric, j - batchStart, &batchRoi, j - batchStart);
+                } else {
+                    batchMetric.setValuesForColumn(j - batchStart, computeMetric.getValuePointerForColumn(j));
+                }
             }
             if (surfKern > 0.0f)
-            {
-                mySmooth->smoothColumn(&computeMetric, j, &outputMetric, &excludeRoi);
-                AlgorithmMetricGradient(NULL, mySurf, &outputMetric, &outputMetric2, NULL, -1.0f, &excludeRoi, false, -1, myAreas);
-                myCol = outputMetric2.getValuePointerForColumn(0);
-            } else {
-                AlgorithmMetricGradient(NULL, mySurf, &computeMetric, &outputMetric, NULL, -1.0f, &excludeRoi, false, j, myAreas);
-                myCol = outputMetric.getValuePointerForColumn(0);
+            {//without smoothing, the copy into the batch counts as part of the gradient
+                smoothSeconds += stageTimer.getElapsedTimeSeconds();
+                stageTimer.start();
             }
-            for (int i = 0; i < mapSize; ++i)
+            AlgorithmMetricGradient(NULL, mySurf, &batchMetric, &outputMetric, NULL, -1.0f, &batchRoi, false, -1, myAreas, true);//each column uses its own exclusion roi
+            for (int j = batchStart; j < batchEnd; ++j)
             {
-                const float* roiColumn = excludeRoi.getValuePointerForColumn(0);
-                if (roiColumn[myMap[i].m_surfaceNode] > 0.0f)
+                const float* myCol = outputMetric.getValuePointerForColumn(j - batchStart);
+                const float* excludeColumn = batchRoi.getValuePointerForColumn(j - batchStart);
+                for (int i = 0; i < mapSize; ++i)
                 {
-                    accum[i] += myCol[myMap[i].m_surfaceNode];
-                    accumCount[i] += 1;//less dubious looking than ++accumCount[i]
+                    if (excludeColumn[myMap[i].m_surfaceNode] > 0.0f)
+                    {
+                        accum[i] += myCol[myMap[i].m_surfaceNode];
+                        accumCount[i] += 1;//less dubious looking than ++accumCount[i]
+                    }
                 }
             }
-            for (int k = 0; k < numExclude; ++k)
-            {
-                excludeRoi.setValue(excludeNodes[j][k], 0, myRoi.getValue(excludeNodes[j][k], 0));//and set them back to original roi afterwards, instead of a full reinitialize
-            }
+            gradientSeconds += stageTimer.getElapsedTimeSeconds();
         }
     }
     for (int i = 0; i < mapSize; ++i)
@@ -580,6 +629,7 @@ void AlgorithmCiftiCorrelationGradient::processSurfaceComponent(StructureEnum::E
             m_outColumn[myMap[i].m_ciftiIndex] = 0.0f;
         }
     }
+    logStageTimes(myStructure, readSeconds, correlateSeconds, smoothSeconds, gradientSeconds);
 }
 
 void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::Enum& myStructure, const float& volKern, const float& memLimitGB)
@@ -640,18 +690,23 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
     myXML.getVolumeDimsAndSForm(ciftiDims, ciftiSform);
     VolumeFile volRoi(newdims, ciftiSform);
     volRoi.setValueAllVoxels(0.0f);
-    vector<int> rowsToCache;
+    vector<int> rowsToCache, ciftiIndices(mapSize);
     for (int i = 0; i < mapSize; ++i)
     {
+        ciftiIndices[i] = myMap[i].m_ciftiIndex;
         volRoi.setValue(1.0f, myMap[i].m_ijk[0] - offset[0], myMap[i].m_ijk[1] - offset[1], myMap[i].m_ijk[2] - offset[2]);
         if (cacheFullInput)
         {
             rowsToCache.push_back(myMap[i].m_ciftiIndex);
         }
     }
+    ElapsedTimer stageTimer;
+    double readSeconds = 0.0, correlateSeconds = 0.0, smoothSeconds = 0.0, gradientSeconds = 0.0;
     if (cacheFullInput)
     {
+        stageTimer.start();
         cacheRows(rowsToCache);
+        readSeconds += stageTimer.getElapsedTimeSeconds();
     }
     for (int startpos = 0; startpos < mapSize; startpos += numCacheRows)
     {
@@ -664,9 +719,12 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
             {
                 rowsToCache.push_back(myMap[i].m_ciftiIndex);
             }
+            stageTimer.start();
             cacheRows(rowsToCache);
+            readSeconds += stageTimer.getElapsedTimeSeconds();
         }
-        int curRow = 0;//because we can't trust the order threads hit the critical section
+        int uncachedRow = 0;//counts the rows read from the file in this block, see getMovingRow
+        stageTimer.start();
         vector<int64_t> computeDims = newdims;
         computeDims.push_back(endpos - startpos);
         VolumeFile computeVol(computeDims, ciftiSform);
@@ -674,14 +732,8 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
         for (int i = 0; i < mapSize; ++i)
         {
             float movingRrs;
-            const float* movingRow;
             int myrow;
-#pragma omp critical
-            {//CiftiFile may explode if we request multiple rows concurrently (needs mutexes), but we should force sequential requests anyway
-                myrow = curRow;//so, manually force it to read sequentially
-                ++curRow;
-                movingRow = getRow(myMap[myrow].m_ciftiIndex, movingRrs);
-            }
+            const float* movingRow = getMovingRow(i, startpos, endpos, cacheFullInput, ciftiIndices, uncachedRow, myrow, movingRrs);
             for (int j = startpos; j < endpos; ++j)
             {
                 if (myrow >= startpos && myrow < endpos)
@@ -702,6 +754,8 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
                 }
             }
         }
+        correlateSeconds += stageTimer.getElapsedTimeSeconds();
+        stageTimer.start();
         VolumeFile outputVol;
         int numSubvols = endpos - startpos;
         for (int j = 0; j < numSubvols; ++j)
@@ -712,11 +766,13 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
                 accum[i] += outputVol.getValue(myMap[i].m_ijk[0] - offset[0], myMap[i].m_ijk[1] - offset[1], myMap[i].m_ijk[2] - offset[2]);
             }
         }
+        gradientSeconds += stageTimer.getElapsedTimeSeconds();
     }
     for (int i = 0; i < mapSize; ++i)
     {
         m_outColumn[myMap[i].m_ciftiIndex] = accum[i] / mapSize;
     }
+    logStageTimes(myStructure, readSeconds, correlateSeconds, smoothSeconds, gradientSeconds);
 }
 
 void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::Enum& myStructure, const float& volKern, const float& volExclude, const float& memLimitGB)
@@ -778,18 +834,23 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
     myXML.getVolumeDimsAndSForm(ciftiDims, ciftiSform);
     VolumeFile volRoi(newdims, ciftiSform);
     volRoi.setValueAllVoxels(0.0f);
-    vector<int> rowsToCache;
+    vector<int> rowsToCache, ciftiIndices(mapSize);
     for (int i = 0; i < mapSize; ++i)
     {
+        ciftiIndices[i] = myMap[i].m_ciftiIndex;
         volRoi.setValue(1.0f, myMap[i].m_ijk[0] - offset[0], myMap[i].m_ijk[1] - offset[1], myMap[i].m_ijk[2] - offset[2]);
         if (cacheFullInput)
         {
             rowsToCache.push_back(myMap[i].m_ciftiIndex);
         }
     }
+    ElapsedTimer stageTimer;
+    double readSeconds = 0.0, correlateSeconds = 0.0, smoothSeconds = 0.0, gradientSeconds = 0.0;
     if (cacheFullInput)
     {
+        stageTimer.start();
         cacheRows(rowsToCache);
+        readSeconds += stageTimer.getElapsedTimeSeconds();
     }
     for (int startpos = 0; startpos < mapSize; startpos += numCacheRows)
     {
@@ -802,9 +863,12 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
             {
                 rowsToCache.push_back(myMap[i].m_ciftiIndex);
             }
+            stageTimer.start();
             cacheRows(rowsToCache);
+            readSeconds += stageTimer.getElapsedTimeSeconds();
         }
-        int curRow = 0;//because we can't trust the order threads hit the critical section
+        int uncachedRow = 0;//counts the rows read from the file in this block, see getMovingRow
+        stageTimer.start();
         vector<int64_t> computeDims = newdims;
         computeDims.push_back(endpos - startpos);
         VolumeFile computeVol(computeDims, ciftiSform);
@@ -812,14 +876,8 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
         for (int i = 0; i < mapSize; ++i)
         {
             float movingRrs;
-            const float* movingRow;
             int myrow;
-#pragma omp critical
-            {//CiftiFile may explode if we request multiple rows concurrently (needs mutexes), but we should force sequential requests anyway
-                myrow = curRow;//so, manually force it to read sequentially
-                ++curRow;
-                movingRow = getRow(myMap[myrow].m_ciftiIndex, movingRrs);
-            }
+            const float* movingRow = getMovingRow(i, startpos, endpos, cacheFullInput, ciftiIndices, uncachedRow, myrow, movingRrs);
             Vector3D movingLoc;
             volRoi.indexToSpace(myMap[myrow].m_ijk, movingLoc);//NOTE: this is outside the cropped volume, but matches the real location in the full volume, because we didn't fix the center
             for (int j = startpos; j < endpos; ++j)
@@ -847,6 +905,8 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
                 }
             }
         }
+        correlateSeconds += stageTimer.getElapsedTimeSeconds();
+        stageTimer.start();
         VolumeFile outputVol, excludeRoi(newdims, ciftiSform);
         excludeRoi.setFrame(volRoi.getFrame());
         int numSubvols = endpos - startpos;
@@ -876,6 +936,7 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
                 }
             }
         }
+        gradientSeconds += stageTimer.getElapsedTimeSeconds();
     }
     for (int i = 0; i < mapSize; ++i)
     {
@@ -886,6 +947,7 @@ void AlgorithmCiftiCorrelationGradient::processVolumeComponent(StructureEnum::En
             m_outColumn[myMap[i].m_ciftiIndex] = 0.0f;
         }
     }
+    logStageTimes(myStructure, readSeconds, correlateSeconds, smoothSeconds, gradientSeconds);
 }
 
 float AlgorithmCiftiCorrelationGradient::correlate(const float* row1, const float& rrs1, const float* row2, const float& rrs2)
@@ -1006,6 +1068,30 @@ const float* AlgorithmCiftiCorrelationGradient::getRow(const int& ciftiIndex, fl
     return ret;
 }
 
+const float* AlgorithmCiftiCorrelationGradient::getMovingRow(const int& loopIndex, const int& startpos, const int& endpos, const bool& cacheFullInput,
+                                                             const vector<int>& ciftiIndices, int& uncachedRow, int& myrowOut, float& rootResidSqr)
+{
+    if (cacheFullInput || (loopIndex >= startpos && loopIndex < endpos))
+    {//cached rows need no ordering or locking, so use the loop index directly
+        myrowOut = loopIndex;
+        return getRow(ciftiIndices[myrowOut], rootResidSqr, true);
+    }
+    float* ret;
+    int ciftiIndex;
+#pragma omp critical
+    {//CiftiFile may explode if we request multiple rows concurrently (needs mutexes), but we should force sequential requests anyway
+        int myTicket = uncachedRow;//so, manually force it to read sequentially, skipping over the cached block
+        ++uncachedRow;
+        myrowOut = (myTicket < startpos ? myTicket : myTicket + endpos - startpos);
+        ciftiIndex = ciftiIndices[myrowOut];
+        ret = getTempRow();
+        m_inputCifti->getRow(ret, ciftiIndex);
+    }//only the read is in the critical section, so the next thread can read while this one adjusts and correlates
+    adjustRow(ret, ciftiIndex);
+    rootResidSqr = m_rowInfo[ciftiIndex].m_rootResidSqr;
+    return ret;
+}
+
 void AlgorithmCiftiCorrelationGradient::adjustRow(float* rowOut, const int& ciftiIndex)
 {
     if (m_undoFisherInput)
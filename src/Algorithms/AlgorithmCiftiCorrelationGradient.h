@@ -57,6 +57,8 @@ namespace caret {
         void cacheRows(const std::vector<int>& ciftiIndices);//grabs the rows and does whatever it needs to, using as much IO bandwidth and CPU resources as available/needed
         void clearCache();
         const float* getRow(const int& ciftiIndex, float& rootResidSqr, const bool& mustBeCached = false);
+        const float* getMovingRow(const int& loopIndex, const int& startpos, const int& endpos, const bool& cacheFullInput,
+                                  const std::vector<int>& ciftiIndices, int& uncachedRow, int& myrowOut, float& rootResidSqr);//rows outside the block are read in file order
         void adjustRow(float* rowOut, const int& ciftiIndex);//does the reverse fisher transform, computes stuff, subtracts mean
         float* getTempRow();
         float correlate(const float* row1, const float& rrs1, const float* row2, const float& rrs2);
@@ -26,12 +26,16 @@
 #include "AlgorithmLabelDilate.h"
 #include "AlgorithmMetricDilate.h"
 #include "AlgorithmVolumeDilate.h"
+#include "CaretPointer.h"
 #include "CiftiFile.h"
+#include "CiftiRowBlock.h"
 #include "LabelFile.h"
 #include "MetricFile.h"
 #include "SurfaceFile.h"
 #include "VolumeFile.h"
 
+#include <algorithm>
+
 using namespace caret;
 using namespace std;
 
@@ -155,7 +159,7 @@ void AlgorithmCiftiDilate::useParameters(OperationParameters* myParams, Progress
 AlgorithmCiftiDilate::AlgorithmCiftiDilate(ProgressObject* myProgObj, const CiftiFile* myCifti, const int& myDir, const float& surfDist, const float& volDist, CiftiFile* myCiftiOut,
                                            const SurfaceFile* myLeftSurf, const SurfaceFile* myRightSurf, const SurfaceFile* myCerebSurf,
                                            const MetricFile* myLeftAreas, const MetricFile* myRightAreas, const MetricFile* myCerebAreas,
-                                           const CiftiFile* myBadRoi, const bool& nearest, const bool& mergedVolume) : AbstractAlgorithm(myProgObj)
+                                           const CiftiFile* myBadRoi, const bool& nearest, const bool& mergedVolume) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CiftiXMLOld myXML = myCifti->getCiftiXMLOld();
@@ -206,6 +210,116 @@ AlgorithmCiftiDilate::AlgorithmCiftiDilate(ProgressObject* myProgObj, const Cift
         }
     }
     myCiftiOut->setCiftiXML(myXML);
+    if (myDir == CiftiXMLOld::ALONG_ROW && myXML.getMappingType(CiftiXMLOld::ALONG_COLUMN) != CIFTI_INDEX_TYPE_LABELS)
+    {//rows are dilated independently, so dilate a block of rows at a time instead of separating each structure from the entire file
+        const int64_t numRows = myCifti->getNumberOfRows(), rowsPerBlock = CiftiRowBlock::getRowsPerBlock(myCifti);
+        if (numRows > rowsPerBlock)
+        {//the rois don't change between blocks, so separate them from a single row and precompute the surface replacements only once
+            CiftiFile rowTemplate;
+            CiftiRowBlock::readBlock(myCifti, 0, 1, &rowTemplate);
+            AlgorithmMetricDilate::Method surfMethod = AlgorithmMetricDilate::WEIGHTED;
+            AlgorithmVolumeDilate::Method volMethod = AlgorithmVolumeDilate::WEIGHTED;
+            if (nearest)
+            {
+                surfMethod = AlgorithmMetricDilate::NEAREST;
+                volMethod = AlgorithmVolumeDilate::NEAREST;
+            }
+            vector<const SurfaceFile*> structSurfs(surfaceList.size(), NULL);
+            vector<const MetricFile*> structAreas(surfaceList.size(), NULL);
+            vector<CaretPointer<MetricFile> > surfBadRois(surfaceList.size()), surfDataRois(surfaceList.size());
+            vector<CaretPointer<AlgorithmMetricDilate::Precomputed> > surfPrecomputed(surfaceList.size());
+            for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
+            {
+                switch (surfaceList[whichStruct])
+                {
+                    case StructureEnum::CORTEX_LEFT:
+                        structSurfs[whichStruct] = myLeftSurf;
+                        structAreas[whichStruct] = myLeftAreas;
+                        break;
+                    case StructureEnum::CORTEX_RIGHT:
+                        structSurfs[whichStruct] = myRightSurf;
+                        structAreas[whichStruct] = myRightAreas;
+                        break;
+                    case StructureEnum::CEREBELLUM:
+                        structSurfs[whichStruct] = myCerebSurf;
+                        structAreas[whichStruct] = myCerebAreas;
+                        break;
+                    default:
+                        break;
+                }
+                MetricFile rowMetric;
+                surfDataRois[whichStruct].grabNew(new MetricFile());
+                AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, surfaceList[whichStruct], &rowMetric, surfDataRois[whichStruct]);
+                if (myBadRoi != NULL)
+                {//without a bad vertex roi, which vertices need dilating depends on the data, so there is nothing to precompute
+                    surfBadRois[whichStruct].grabNew(new MetricFile());
+                    AlgorithmCiftiSeparate(NULL, myBadRoi, CiftiXMLOld::ALONG_COLUMN, surfaceList[whichStruct], surfBadRois[whichStruct]);
+                    surfPrecomputed[whichStruct].grabNew(new AlgorithmMetricDilate::Precomputed());
+                    AlgorithmMetricDilate::precompute(*(surfPrecomputed[whichStruct]), structSurfs[whichStruct], surfDist, surfBadRois[whichStruct],
+                                                      surfDataRois[whichStruct], surfMethod, 2.0f, structAreas[whichStruct]);
+                }
+            }
+            if (mergedVolume)
+            {
+                volumeList.clear();
+                if (myXML.hasVolumeData(myDir)) volumeList.push_back(StructureEnum::INVALID);//INVALID stands in for the merged volume
+            }
+            vector<CaretPointer<VolumeFile> > volBadRois(volumeList.size()), volDataRois(volumeList.size());
+            for (int whichStruct = 0; whichStruct < (int)volumeList.size(); ++whichStruct)
+            {
+                int64_t offset[3];
+                if (myBadRoi != NULL)
+                {
+                    volBadRois[whichStruct].grabNew(new VolumeFile());
+                    if (mergedVolume)
+                    {
+                        AlgorithmCiftiSeparate(NULL, myBadRoi, CiftiXMLOld::ALONG_COLUMN, volBadRois[whichStruct], offset, NULL, true);
+                    } else {
+                        AlgorithmCiftiSeparate(NULL, myBadRoi, CiftiXMLOld::ALONG_COLUMN, volumeList[whichStruct], volBadRois[whichStruct], offset, NULL, true);
+                    }
+                }
+                if (!mergedVolume)
+                {//the merged volume is dilated without a data roi
+                    VolumeFile rowVol;
+                    volDataRois[whichStruct].grabNew(new VolumeFile());
+                    AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, volumeList[whichStruct], &rowVol, offset, volDataRois[whichStruct], true);
+                }
+            }
+            for (int64_t firstRow = 0; firstRow < numRows; firstRow += rowsPerBlock)
+            {
+                CiftiFile blockIn, blockOut;
+                const int64_t blockRows = min(rowsPerBlock, numRows - firstRow);
+                CiftiRowBlock::readBlock(myCifti, firstRow, blockRows, &blockIn);
+                blockOut.setCiftiXML(blockIn.getCiftiXML(), false);
+                for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
+                {
+                    MetricFile myMetric, myMetricOut;
+                    AlgorithmCiftiSeparate(NULL, &blockIn, myDir, surfaceList[whichStruct], &myMetric);
+                    AlgorithmMetricDilate(NULL, &myMetric, structSurfs[whichStruct], surfDist, &myMetricOut, surfBadRois[whichStruct], surfDataRois[whichStruct], -1,
+                                          surfMethod, 2.0f, structAreas[whichStruct], surfPrecomputed[whichStruct]);
+                    AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, surfaceList[whichStruct], &myMetricOut);
+                }
+                for (int whichStruct = 0; whichStruct < (int)volumeList.size(); ++whichStruct)
+                {
+                    VolumeFile myVol, myVolOut;
+                    int64_t offset[3];
+                    if (mergedVolume)
+                    {
+                        AlgorithmCiftiSeparate(NULL, &blockIn, myDir, &myVol, offset, NULL, true);
+                        AlgorithmVolumeDilate(NULL, &myVol, volDist, volMethod, &myVolOut, volBadRois[whichStruct]);
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, &myVolOut, true);
+                    } else {
+                        AlgorithmCiftiSeparate(NULL, &blockIn, myDir, volumeList[whichStruct], &myVol, offset, NULL, true);
+                        AlgorithmVolumeDilate(NULL, &myVol, volDist, volMethod, &myVolOut, volBadRois[whichStruct], volDataRois[whichStruct]);
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, volumeList[whichStruct], &myVolOut, true);
+                    }
+                }
+                CiftiRowBlock::writeBlock(&blockOut, firstRow, myCiftiOut);
+                myProgress.reportProgress((firstRow + blockRows) / (float)numRows);
+            }
+            return;
+        }
+    }
     for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
     {
         const SurfaceFile* mySurf = NULL;
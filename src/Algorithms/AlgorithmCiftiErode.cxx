@@ -26,12 +26,16 @@
 #include "AlgorithmLabelErode.h"
 #include "AlgorithmMetricErode.h"
 #include "AlgorithmVolumeErode.h"
+#include "CaretPointer.h"
 #include "CiftiFile.h"
+#include "CiftiRowBlock.h"
 #include "LabelFile.h"
 #include "MetricFile.h"
 #include "SurfaceFile.h"
 #include "VolumeFile.h"
 
+#include <algorithm>
+
 using namespace caret;
 using namespace std;
 
@@ -139,7 +143,7 @@ void AlgorithmCiftiErode::useParameters(OperationParameters* myParams, ProgressO
 
 AlgorithmCiftiErode::AlgorithmCiftiErode(ProgressObject* myProgObj, const CiftiFile* myCifti, const int& myDir, const float& surfDist, const float& volDist, CiftiFile* myCiftiOut,
                                          const SurfaceFile* myLeftSurf, const SurfaceFile* myRightSurf, const SurfaceFile* myCerebSurf,
-                                         const MetricFile* myLeftAreas, const MetricFile* myRightAreas, const MetricFile* myCerebAreas, const bool& mergedVolume) : AbstractAlgorithm(myProgObj)
+                                         const MetricFile* myLeftAreas, const MetricFile* myRightAreas, const MetricFile* myCerebAreas, const bool& mergedVolume) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     const CiftiXML& myXML = myCifti->getCiftiXML();
@@ -193,6 +197,96 @@ AlgorithmCiftiErode::AlgorithmCiftiErode(ProgressObject* myProgObj, const CiftiF
         }
     }
     myCiftiOut->setCiftiXML(myXML);
+    if (myDir == CiftiXML::ALONG_ROW && myXML.getMappingType(CiftiXML::ALONG_COLUMN) != CiftiMappingType::LABELS)
+    {//rows are eroded independently, so erode a block of rows at a time instead of separating each structure from the entire file
+        const int64_t numRows = myCifti->getNumberOfRows(), rowsPerBlock = CiftiRowBlock::getRowsPerBlock(myCifti);
+        if (numRows > rowsPerBlock)
+        {//the data rois don't change between blocks, so separate them from a single row and build the surface stencils only once
+            CiftiFile rowTemplate;
+            CiftiRowBlock::readBlock(myCifti, 0, 1, &rowTemplate);
+            vector<const SurfaceFile*> structSurfs(surfaceList.size(), NULL);
+            vector<const MetricFile*> structAreas(surfaceList.size(), NULL);
+            vector<CaretPointer<MetricFile> > surfRois(surfaceList.size());
+            vector<vector<vector<int32_t> > > surfStencils(surfaceList.size());
+            for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
+            {
+                switch (surfaceList[whichStruct])
+                {
+                    case StructureEnum::CORTEX_LEFT:
+                        structSurfs[whichStruct] = myLeftSurf;
+                        structAreas[whichStruct] = myLeftAreas;
+                        break;
+                    case StructureEnum::CORTEX_RIGHT:
+                        structSurfs[whichStruct] = myRightSurf;
+                        structAreas[whichStruct] = myRightAreas;
+                        break;
+                    case StructureEnum::CEREBELLUM:
+                        structSurfs[whichStruct] = myCerebSurf;
+                        structAreas[whichStruct] = myCerebAreas;
+                        break;
+                    default:
+                        break;
+                }
+                MetricFile rowMetric;
+                surfRois[whichStruct].grabNew(new MetricFile());
+                AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, surfaceList[whichStruct], &rowMetric, surfRois[whichStruct]);
+                AlgorithmMetricErode::precomputeStencils(surfStencils[whichStruct], structSurfs[whichStruct], surfDist, surfRois[whichStruct], structAreas[whichStruct]);
+            }
+            vector<StructureEnum::Enum> volumeList;
+            if (mergedVolume)
+            {
+                if (myDenseMap.hasVolumeData()) volumeList.push_back(StructureEnum::INVALID);//INVALID stands in for the merged volume
+            } else {
+                volumeList = myDenseMap.getVolumeStructureList();
+            }
+            vector<CaretPointer<VolumeFile> > volRois(volumeList.size());
+            for (int whichStruct = 0; whichStruct < (int)volumeList.size(); ++whichStruct)
+            {
+                VolumeFile rowVol;
+                int64_t offset[3];
+                volRois[whichStruct].grabNew(new VolumeFile());
+                if (mergedVolume)
+                {
+                    AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, &rowVol, offset, volRois[whichStruct], true);
+                } else {
+                    AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, volumeList[whichStruct], &rowVol, offset, volRois[whichStruct], true);
+                }
+            }
+            for (int64_t firstRow = 0; firstRow < numRows; firstRow += rowsPerBlock)
+            {
+                CiftiFile blockIn, blockOut;
+                const int64_t blockRows = min(rowsPerBlock, numRows - firstRow);
+                CiftiRowBlock::readBlock(myCifti, firstRow, blockRows, &blockIn);
+                blockOut.setCiftiXML(blockIn.getCiftiXML(), false);
+                for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
+                {
+                    MetricFile myMetric, myMetricOut;
+                    AlgorithmCiftiSeparate(NULL, &blockIn, myDir, surfaceList[whichStruct], &myMetric);
+                    AlgorithmMetricErode(NULL, &myMetric, structSurfs[whichStruct], surfDist, &myMetricOut, surfRois[whichStruct], -1,
+                                         structAreas[whichStruct], &surfStencils[whichStruct]);
+                    AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, surfaceList[whichStruct], &myMetricOut);
+                }
+                for (int whichStruct = 0; whichStruct < (int)volumeList.size(); ++whichStruct)
+                {
+                    VolumeFile myVol, myVolOut;
+                    int64_t offset[3];
+                    if (mergedVolume)
+                    {
+                        AlgorithmCiftiSeparate(NULL, &blockIn, myDir, &myVol, offset, NULL, true);
+                        AlgorithmVolumeErode(NULL, &myVol, volDist, &myVolOut, volRois[whichStruct]);
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, &myVolOut, true);
+                    } else {
+                        AlgorithmCiftiSeparate(NULL, &blockIn, myDir, volumeList[whichStruct], &myVol, offset, NULL, true);
+                        AlgorithmVolumeErode(NULL, &myVol, volDist, &myVolOut, volRois[whichStruct]);
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, volumeList[whichStruct], &myVolOut, true);
+                    }
+                }
+                CiftiRowBlock::writeBlock(&blockOut, firstRow, myCiftiOut);
+                myProgress.reportProgress((firstRow + blockRows) / (float)numRows);
+            }
+            return;
+        }
+    }
     for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
     {
         const SurfaceFile* mySurf = NULL;
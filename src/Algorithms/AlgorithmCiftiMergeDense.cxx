@@ -80,7 +80,7 @@ void AlgorithmCiftiMergeDense::useParameters(OperationParameters* myParams, Prog
     AlgorithmCiftiMergeDense(myProgObj, myDir, ciftiList, myCiftiOut);
 }
 
-AlgorithmCiftiMergeDense::AlgorithmCiftiMergeDense(ProgressObject* myProgObj, const int& myDir, const vector<const CiftiFile*>& ciftiList, CiftiFile* myCiftiOut) : AbstractAlgorithm(myProgObj)
+AlgorithmCiftiMergeDense::AlgorithmCiftiMergeDense(ProgressObject* myProgObj, const int& myDir, const vector<const CiftiFile*>& ciftiList, CiftiFile* myCiftiOut) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (ciftiList.size() == 0) throw AlgorithmException("no input files specified");
@@ -73,7 +73,7 @@ void AlgorithmCiftiMergeParcels::useParameters(OperationParameters* myParams, Pr
     AlgorithmCiftiMergeParcels(myProgObj, myDir, ciftiList, myCiftiOut);
 }
 
-AlgorithmCiftiMergeParcels::AlgorithmCiftiMergeParcels(ProgressObject* myProgObj, const int& myDir, const vector<const CiftiFile*>& ciftiList, CiftiFile* myCiftiOut) : AbstractAlgorithm(myProgObj)
+AlgorithmCiftiMergeParcels::AlgorithmCiftiMergeParcels(ProgressObject* myProgObj, const int& myDir, const vector<const CiftiFile*>& ciftiList, CiftiFile* myCiftiOut) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CaretAssert(myDir >= 0);
@@ -72,7 +72,7 @@ void AlgorithmCiftiPairwiseCorrelation::useParameters(OperationParameters* myPar
 }
 
 AlgorithmCiftiPairwiseCorrelation::AlgorithmCiftiPairwiseCorrelation(ProgressObject* myProgObj, const CiftiFile* myCiftiA, const CiftiFile* myCiftiB, CiftiFile* myCiftiOut,
-                                                                     const bool& fisherZ, const bool& overrideMappingCheck) : AbstractAlgorithm(myProgObj)
+                                                                     const bool& fisherZ, const bool& overrideMappingCheck) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CiftiXMLOld outXML = myCiftiA->getCiftiXMLOld();
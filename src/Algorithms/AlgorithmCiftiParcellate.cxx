@@ -21,6 +21,7 @@
 #include "AlgorithmCiftiParcellate.h"
 #include "AlgorithmException.h"
 #include "CaretLogger.h"
+#include "CaretOMP.h"
 #include "CiftiFile.h"
 #include "GiftiLabel.h"
 #include "GiftiLabelTable.h"
@@ -205,8 +206,231 @@ void AlgorithmCiftiParcellate::useParameters(OperationParameters* myParams, Prog
     AlgorithmCiftiParcellate(myProgObj, myCiftiIn, myCiftiLabel, direction, myCiftiOut, method, excludeLow, excludeHigh, onlyNumeric);
 }
 
+namespace
+{
+    //MEAN and SUM without outlier exclusion are linear in the data, so they can use a precompiled sparse operator instead of gathering every parcel's values
+    bool isLinearReduction(const ReductionEnum::Enum& method, const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric)
+    {
+        if (excludeLow > 0.0f && excludeHigh > 0.0f) return false;
+        if (onlyNumeric) return false;
+        return method == ReductionEnum::MEAN || method == ReductionEnum::SUM;
+    }
+    
+    //parcellation as a CSR matrix with one row per parcel, built once and applied to every row of the input
+    class ParcelOperator
+    {
+        vector<int64_t> m_rowStart;//numParcels + 1 offsets into m_members
+        vector<int64_t> m_members;//dense indices, ascending within each parcel
+        vector<float> m_weights;//parallel to m_members, empty when unweighted
+        vector<int64_t> m_denseToMember;//position in m_members of each dense index, -1 if not in a parcel
+        vector<int> m_denseToParcel;
+        vector<double> m_divisor;//member count or weight sum for MEAN, 1 for SUM
+    public:
+        ParcelOperator(const vector<int>& indexToParcel, const int& numParcels, const vector<vector<float> >* parcelWeights, const ReductionEnum::Enum& method)
+        {
+            const int64_t numDense = (int64_t)indexToParcel.size();
+            m_rowStart.resize(numParcels + 1, 0);
+            for (int64_t i = 0; i < numDense; ++i)
+            {
+                int parcel = indexToParcel[i];
+                CaretAssert(parcel > -2 && parcel < numParcels);
+                if (parcel != -1) ++m_rowStart[parcel + 1];
+            }
+            for (int p = 0; p < numParcels; ++p)
+            {
+                m_rowStart[p + 1] += m_rowStart[p];
+            }
+            m_members.resize(m_rowStart[numParcels]);
+            if (parcelWeights != NULL) m_weights.resize(m_rowStart[numParcels]);
+            m_denseToMember.resize(numDense, -1);
+            m_denseToParcel = indexToParcel;
+            vector<int64_t> nextPos(m_rowStart.begin(), m_rowStart.end() - 1);
+            for (int64_t i = 0; i < numDense; ++i)
+            {
+                int parcel = indexToParcel[i];
+                if (parcel == -1) continue;
+                int64_t pos = nextPos[parcel]++;
+                m_members[pos] = i;
+                m_denseToMember[i] = pos;
+                if (parcelWeights != NULL)
+                {
+                    CaretAssert((int64_t)(*parcelWeights)[parcel].size() == m_rowStart[parcel + 1] - m_rowStart[parcel]);
+                    m_weights[pos] = (*parcelWeights)[parcel][pos - m_rowStart[parcel]];//parcel weights are in ascending dense index order
+                }
+            }
+            m_divisor.resize(numParcels, 1.0);
+            if (method == ReductionEnum::MEAN)
+            {
+                for (int p = 0; p < numParcels; ++p)
+                {
+                    if (parcelWeights != NULL)
+                    {
+                        double weightsum = 0.0;
+                        for (int64_t k = m_rowStart[p]; k < m_rowStart[p + 1]; ++k)
+                        {
+                            weightsum += m_weights[k];
+                        }
+                        m_divisor[p] = weightsum;
+                    } else {
+                        m_divisor[p] = m_rowStart[p + 1] - m_rowStart[p];
+                    }
+                }
+            }
+        }
+        
+        int getNumParcels() const { return (int)m_divisor.size(); }
+        
+        bool isEmpty(const int& parcel) const { return m_rowStart[parcel] == m_rowStart[parcel + 1]; }
+        
+        double getDivisor(const int& parcel) const { return m_divisor[parcel]; }
+        
+        int getParcel(const int64_t& denseIndex) const { return m_denseToParcel[denseIndex]; }
+        
+        float getWeight(const int64_t& denseIndex) const
+        {
+            CaretAssert(m_denseToMember[denseIndex] != -1);
+            if (m_weights.empty()) return 1.0f;
+            return m_weights[m_denseToMember[denseIndex]];
+        }
+        
+        //accumulation order matches ReductionOperation, so results are the same as the generic path
+        void applyToRow(const float* in, float* out) const
+        {
+            const int numParcels = getNumParcels();
+            for (int p = 0; p < numParcels; ++p)
+            {
+                const int64_t start = m_rowStart[p], end = m_rowStart[p + 1];
+                if (start == end)
+                {
+                    out[p] = 0.0f;
+                    continue;
+                }
+                double accum;
+                if (m_weights.empty())
+                {
+                    double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+                    int64_t k = start;
+                    for (; k + 4 <= end; k += 4)
+                    {
+                        sums[0] += in[m_members[k]];
+                        sums[1] += in[m_members[k + 1]];
+                        sums[2] += in[m_members[k + 2]];
+                        sums[3] += in[m_members[k + 3]];
+                    }
+                    for (; k < end; ++k) sums[0] += in[m_members[k]];
+                    accum = (sums[0] + sums[1]) + (sums[2] + sums[3]);
+                } else {
+                    accum = 0.0;
+                    for (int64_t k = start; k < end; ++k)
+                    {
+                        accum += in[m_members[k]] * m_weights[k];
+                    }
+                }
+                out[p] = accum / m_divisor[p];
+            }
+        }
+    };
+    
+    //reads a block of rows, applies the operator to them in parallel, then writes the block
+    void linearParcellationAlongRow(const CiftiFile* myCiftiIn, CiftiFile* myCiftiOut, const ParcelOperator& myOperator)
+    {
+        const int ROW_BLOCK = 64;
+        vector<int64_t> dims = myCiftiIn->getCiftiXML().getDimensions();
+        const int64_t numCols = dims[0];
+        const int numParcels = myOperator.getNumParcels();
+        vector<float> inBlock(ROW_BLOCK * numCols), outBlock(ROW_BLOCK * numParcels);
+        vector<vector<int64_t> > blockIndices(ROW_BLOCK);
+        MultiDimIterator<int64_t> iter(vector<int64_t>(dims.begin() + 1, dims.end()));
+        while (!iter.atEnd())
+        {
+            int blockRows = 0;
+            for (; blockRows < ROW_BLOCK && !iter.atEnd(); ++blockRows, ++iter)
+            {
+                blockIndices[blockRows] = *iter;
+                myCiftiIn->getRow(inBlock.data() + blockRows * numCols, *iter);
+            }
+#pragma omp CARET_PARFOR schedule(dynamic)
+            for (int i = 0; i < blockRows; ++i)
+            {
+                myOperator.applyToRow(inBlock.data() + i * numCols, outBlock.data() + i * numParcels);
+            }
+            for (int i = 0; i < blockRows; ++i)
+            {
+                myCiftiOut->setRow(outBlock.data() + i * numParcels, blockIndices[i]);
+            }
+        }
+    }
+    
+    //accumulates each input row into its parcel's output row, rather than storing every member row before reducing
+    void linearParcellationAlongColumns(const CiftiFile* myCiftiIn, const int& direction, CiftiFile* myCiftiOut, const ParcelOperator& myOperator)
+    {
+        CaretAssert(direction > 0);
+        vector<int64_t> dims = myCiftiIn->getCiftiXML().getDimensions();
+        const int64_t numCols = dims[0];
+        const int numParcels = myOperator.getNumParcels();
+        vector<int64_t> otherDims = dims;
+        otherDims.erase(otherDims.begin() + direction);
+        otherDims.erase(otherDims.begin());
+        vector<double> accum(numParcels * numCols);
+        vector<float> scratchRow(numCols), scratchOutRow(numCols);
+        for (MultiDimIterator<int64_t> iter(otherDims); !iter.atEnd(); ++iter)
+        {
+            vector<int64_t> indices(dims.size() - 1);//we need to add the parcellated direction index back into the index list to use it in getRow/setRow
+            for (int i = 0; i < (int)otherDims.size(); ++i)
+            {
+                if (i < direction - 1)
+                {
+                    indices[i] = (*iter)[i];
+                } else {
+                    indices[i + 1] = (*iter)[i];
+                }
+            }//indices[direction - 1] is uninitialized, as it is the dimension to be parcellated
+            accum.assign(accum.size(), 0.0);
+            for (int64_t i = 0; i < dims[direction]; ++i)
+            {
+                const int parcel = myOperator.getParcel(i);
+                if (parcel == -1) continue;
+                const float weight = myOperator.getWeight(i);
+                indices[direction - 1] = i;
+                myCiftiIn->getRow(scratchRow.data(), indices);
+                double* parcelAccum = accum.data() + parcel * numCols;
+                for (int64_t j = 0; j < numCols; ++j)
+                {
+                    parcelAccum[j] += scratchRow[j] * weight;
+                }
+            }
+            for (int p = 0; p < numParcels; ++p)
+            {
+                indices[direction - 1] = p;
+                if (myOperator.isEmpty(p))
+                {
+                    scratchOutRow.assign(numCols, 0.0f);
+                } else {
+                    const double* parcelAccum = accum.data() + p * numCols;
+                    const double divisor = myOperator.getDivisor(p);
+                    for (int64_t j = 0; j < numCols; ++j)
+                    {
+                        scratchOutRow[j] = parcelAccum[j] / divisor;
+                    }
+                }
+                myCiftiOut->setRow(scratchOutRow.data(), indices);
+            }
+        }
+    }
+    
+    void doLinearParcellation(const CiftiFile* myCiftiIn, const int& direction, CiftiFile* myCiftiOut, const ParcelOperator& myOperator)
+    {
+        if (direction == CiftiXML::ALONG_ROW)
+        {
+            linearParcellationAlongRow(myCiftiIn, myCiftiOut, myOperator);
+        } else {
+            linearParcellationAlongColumns(myCiftiIn, direction, myCiftiOut, myOperator);
+        }
+    }
+}
+
 AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, const CiftiFile* myCiftiIn, const CiftiFile* myCiftiLabel, const int& direction, CiftiFile* myCiftiOut,
-                                                   const ReductionEnum::Enum& method, const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric) : AbstractAlgorithm(myProgObj)
+                                                   const ReductionEnum::Enum& method, const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CaretAssert(direction >= 0);
@@ -270,9 +494,16 @@ AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, co
     {
         CaretLogWarning(ReductionEnum::toName(method) + " reduction requested while parcellating label data");
     }
+    if (!isLabel && isLinearReduction(method, excludeLow, excludeHigh, onlyNumeric))
+    {
+        ParcelOperator myOperator(indexToParcel, numParcels, NULL, method);
+        doLinearParcellation(myCiftiIn, direction, myCiftiOut, myOperator);
+        return;
+    }
     if (direction == CiftiXML::ALONG_ROW)
     {
         vector<float> scratchOutRow(numParcels);
+        ReductionOperation::Scratch reduceWork;
         vector<vector<float> > parcelData(numParcels);//float so we can use ReductionOperation
         for (int j = 0; j < numParcels; ++j)
         {
@@ -305,13 +536,13 @@ AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, co
                 {
                     if (excludeLow > 0.0f && excludeHigh > 0.0f)
                     {
-                        scratchOutRow[j] = ReductionOperation::reduceExcludeDev(parcelData[j].data(), parcelData[j].size(), method, excludeLow, excludeHigh);
+                        scratchOutRow[j] = ReductionOperation::reduceExcludeDev(parcelData[j].data(), parcelData[j].size(), method, excludeLow, excludeHigh, &reduceWork);
                     } else {
                         if (onlyNumeric)
                         {
-                            scratchOutRow[j] = ReductionOperation::reduceOnlyNumeric(parcelData[j].data(), parcelData[j].size(), method);
+                            scratchOutRow[j] = ReductionOperation::reduceOnlyNumeric(parcelData[j].data(), parcelData[j].size(), method, &reduceWork);
                         } else {
-                            scratchOutRow[j] = ReductionOperation::reduce(parcelData[j].data(), parcelData[j].size(), method);
+                            scratchOutRow[j] = ReductionOperation::reduce(parcelData[j].data(), parcelData[j].size(), method, &reduceWork);
                         }
                     }
                 } else {//labelDir can't be 0 (row) because we are parcellating along row, so row must be dense
@@ -327,6 +558,7 @@ AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, co
         }
     } else {
         vector<float> scratchOutRow(numCols);
+        ReductionOperation::Scratch reduceWork;
         vector<int64_t> otherDims = dims;
         otherDims.erase(otherDims.begin() + direction);//direction being parcellated
         otherDims.erase(otherDims.begin());//row
@@ -388,13 +620,13 @@ AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, co
                         CaretAssert((int64_t)parcelRef[j].size() == count);
                         if (excludeLow > 0.0f && excludeHigh > 0.0f)
                         {
-                            scratchOutRow[j] = ReductionOperation::reduceExcludeDev(parcelRef[j].data(), parcelRef[j].size(), method, excludeLow, excludeHigh);
+                            scratchOutRow[j] = ReductionOperation::reduceExcludeDev(parcelRef[j].data(), parcelRef[j].size(), method, excludeLow, excludeHigh, &reduceWork);
                         } else {
                             if (onlyNumeric)
                             {
-                                scratchOutRow[j] = ReductionOperation::reduceOnlyNumeric(parcelRef[j].data(), parcelRef[j].size(), method);
+                                scratchOutRow[j] = ReductionOperation::reduceOnlyNumeric(parcelRef[j].data(), parcelRef[j].size(), method, &reduceWork);
                             } else {
-                                scratchOutRow[j] = ReductionOperation::reduce(parcelRef[j].data(), parcelRef[j].size(), method);
+                                scratchOutRow[j] = ReductionOperation::reduce(parcelRef[j].data(), parcelRef[j].size(), method, &reduceWork);
                             }
                         }
                     }
@@ -446,11 +678,18 @@ namespace
             CaretLogWarning(ReductionEnum::toName(method) + " reduction requested while parcellating label data");
         }
         int numParcels = myCiftiOut->getCiftiXML().getDimensionLength(direction);
+        if (!isLabel && isLinearReduction(method, excludeLow, excludeHigh, onlyNumeric))
+        {
+            ParcelOperator myOperator(indexToParcel, numParcels, &parcelWeights, method);
+            doLinearParcellation(myCiftiIn, direction, myCiftiOut, myOperator);
+            return;
+        }
         int64_t numCols = myInputXML.getDimensionLength(CiftiXML::ALONG_ROW);
         vector<float> scratchRow(numCols);
         if (direction == CiftiXML::ALONG_ROW)
         {
             vector<float> scratchOutRow(numParcels);
+            ReductionOperation::Scratch reduceWork;
             vector<vector<float> > parcelData(numParcels);//float so we can use ReductionOperation
             for (int j = 0; j < numParcels; ++j)
             {
@@ -483,13 +722,13 @@ namespace
                     {
                         if (excludeLow > 0.0f && excludeHigh > 0.0f)
                         {
-                            scratchOutRow[j] = ReductionOperation::reduceWeightedExcludeDev(parcelData[j].data(), parcelWeights[j].data(), parcelData[j].size(), method, excludeLow, excludeHigh);
+                            scratchOutRow[j] = ReductionOperation::reduceWeightedExcludeDev(parcelData[j].data(), parcelWeights[j].data(), parcelData[j].size(), method, excludeLow, excludeHigh, &reduceWork);
                         } else {
                             if (onlyNumeric)
                             {
-                                scratchOutRow[j] = ReductionOperation::reduceWeightedOnlyNumeric(parcelData[j].data(), parcelWeights[j].data(), parcelData[j].size(), method);
+                                scratchOutRow[j] = ReductionOperation::reduceWeightedOnlyNumeric(parcelData[j].data(), parcelWeights[j].data(), parcelData[j].size(), method, &reduceWork);
                             } else {
-                                scratchOutRow[j] = ReductionOperation::reduceWeighted(parcelData[j].data(), parcelWeights[j].data(), parcelData[j].size(), method);
+                                scratchOutRow[j] = ReductionOperation::reduceWeighted(parcelData[j].data(), parcelWeights[j].data(), parcelData[j].size(), method, &reduceWork);
                             }
                         }
                     } else {//labelDir can't be 0 (row) because we are parcellating along row, so row must be dense
@@ -505,6 +744,7 @@ namespace
             }
         } else {
             vector<float> scratchOutRow(numCols);
+            ReductionOperation::Scratch reduceWork;
             vector<int64_t> otherDims = dims;
             otherDims.erase(otherDims.begin() + direction);//direction being parcellated
             otherDims.erase(otherDims.begin());//row
@@ -566,13 +806,13 @@ namespace
                             CaretAssert((int64_t)parcelRef[j].size() == count);
                             if (excludeLow > 0.0f && excludeHigh > 0.0f)
                             {
-                                scratchOutRow[j] = ReductionOperation::reduceWeightedExcludeDev(parcelRef[j].data(), parcelWeights[i].data(), parcelRef[j].size(), method, excludeLow, excludeHigh);
+                                scratchOutRow[j] = ReductionOperation::reduceWeightedExcludeDev(parcelRef[j].data(), parcelWeights[i].data(), parcelRef[j].size(), method, excludeLow, excludeHigh, &reduceWork);
                             } else {
                                 if (onlyNumeric)
                                 {
-                                    scratchOutRow[j] = ReductionOperation::reduceWeightedOnlyNumeric(parcelRef[j].data(), parcelWeights[i].data(), parcelRef[j].size(), method);
+                                    scratchOutRow[j] = ReductionOperation::reduceWeightedOnlyNumeric(parcelRef[j].data(), parcelWeights[i].data(), parcelRef[j].size(), method, &reduceWork);
                                 } else {
-                                    scratchOutRow[j] = ReductionOperation::reduceWeighted(parcelRef[j].data(), parcelWeights[i].data(), parcelRef[j].size(), method);
+                                    scratchOutRow[j] = ReductionOperation::reduceWeighted(parcelRef[j].data(), parcelWeights[i].data(), parcelRef[j].size(), method, &reduceWork);
                                 }
                             }
                         }
@@ -602,7 +842,7 @@ namespace
 
 AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, const CiftiFile* myCiftiIn, const CiftiFile* myCiftiLabel, const int& direction, CiftiFile* myCiftiOut,
                                                    const MetricFile* leftWeights, const MetricFile* rightWeights, const MetricFile* cerebWeights, const ReductionEnum::Enum& method,
-                                                   const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric): AbstractAlgorithm(myProgObj)
+                                                   const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric): AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CaretAssert(direction >= 0);
@@ -702,7 +942,7 @@ AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, co
 }
 
 AlgorithmCiftiParcellate::AlgorithmCiftiParcellate(ProgressObject* myProgObj, const CiftiFile* myCiftiIn, const CiftiFile* myCiftiLabel, const int& direction, CiftiFile* myCiftiOut,
-                                                   const CiftiFile* ciftiWeights, const ReductionEnum::Enum& method, const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric): AbstractAlgorithm(myProgObj)
+                                                   const CiftiFile* ciftiWeights, const ReductionEnum::Enum& method, const float& excludeLow, const float& excludeHigh, const bool& onlyNumeric): AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CaretAssert(direction >= 0);
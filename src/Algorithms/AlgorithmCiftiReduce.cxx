@@ -93,7 +93,7 @@ void AlgorithmCiftiReduce::useParameters(OperationParameters* myParams, Progress
 }
 
 AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const CiftiFile* ciftiIn, const ReductionEnum::Enum& myReduce, CiftiFile* ciftiOut,
-                                           const bool& onlyNumeric, const int& direction) : AbstractAlgorithm(myProgObj)
+                                           const bool& onlyNumeric, const int& direction) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CaretAssert(direction >= 0);
@@ -109,21 +109,23 @@ AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const Cift
     if (direction == CiftiXML::ALONG_ROW)
     {
         vector<float> scratchInRow(inDims[0]);
+        ReductionOperation::Scratch reduceWork;
         for (MultiDimIterator<int64_t> iter(vector<int64_t>(inDims.begin() + 1, inDims.end())); !iter.atEnd(); ++iter)
         {// + 1 to exclude row dimension, because getRow/setRow
             ciftiIn->getRow(scratchInRow.data(), *iter);
             float result = -1;
             if (onlyNumeric)
             {
-                result = ReductionOperation::reduceOnlyNumeric(scratchInRow.data(), inDims[0], myReduce);
+                result = ReductionOperation::reduceOnlyNumeric(scratchInRow.data(), inDims[0], myReduce, &reduceWork);
             } else {
-                result = ReductionOperation::reduce(scratchInRow.data(), inDims[0], myReduce);
+                result = ReductionOperation::reduce(scratchInRow.data(), inDims[0], myReduce, &reduceWork);
             }
             ciftiOut->setRow(&result, *iter);//if reducing along row, length of output row is 1
         }
     } else {
         vector<vector<float> > scratchInRows(inDims[direction], vector<float>(inDims[0]));
         vector<float> outRow(inDims[0]), reduceScratch(inDims[direction]);//reduction isn't along row, so out rows will be same length as in rows
+        ReductionOperation::Scratch reduceWork;
         vector<int64_t> otherDims = inDims;
         otherDims.erase(otherDims.begin() + direction);//direction isn't 0
         otherDims.erase(otherDims.begin());//remove row direction because getRow/setRow
@@ -144,9 +146,9 @@ AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const Cift
                 }
                 if (onlyNumeric)
                 {
-                    outRow[i] = ReductionOperation::reduceOnlyNumeric(reduceScratch.data(), inDims[direction], myReduce);
+                    outRow[i] = ReductionOperation::reduceOnlyNumeric(reduceScratch.data(), inDims[direction], myReduce, &reduceWork);
                 } else {
-                    outRow[i] = ReductionOperation::reduce(reduceScratch.data(), inDims[direction], myReduce);
+                    outRow[i] = ReductionOperation::reduce(reduceScratch.data(), inDims[direction], myReduce, &reduceWork);
                 }
             }
             indexvec[direction - 1] = 0;//only one element along reduce output direction
@@ -156,7 +158,7 @@ AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const Cift
 }
 
 AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const CiftiFile* ciftiIn, const ReductionEnum::Enum& myReduce, CiftiFile* ciftiOut,
-                                           const float& sigmaBelow, const float& sigmaAbove, const int& direction) : AbstractAlgorithm(myProgObj)
+                                           const float& sigmaBelow, const float& sigmaAbove, const int& direction) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     CaretAssert(direction >= 0);
@@ -172,15 +174,17 @@ AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const Cift
     if (direction == CiftiXML::ALONG_ROW)
     {
         vector<float> scratchInRow(inDims[0]);
+        ReductionOperation::Scratch reduceWork;
         for (MultiDimIterator<int64_t> iter(vector<int64_t>(inDims.begin() + 1, inDims.end())); !iter.atEnd(); ++iter)
         {// + 1 to exclude row dimension, because getRow/setRow
             ciftiIn->getRow(scratchInRow.data(), *iter);
-            float result = ReductionOperation::reduceExcludeDev(scratchInRow.data(), inDims[0], myReduce, sigmaBelow, sigmaAbove);
+            float result = ReductionOperation::reduceExcludeDev(scratchInRow.data(), inDims[0], myReduce, sigmaBelow, sigmaAbove, &reduceWork);
             ciftiOut->setRow(&result, *iter);//if reducing along row, length of output row is 1
         }
     } else {
         vector<vector<float> > scratchInRows(inDims[direction], vector<float>(inDims[0]));
         vector<float> outRow(inDims[0]), reduceScratch(inDims[direction]);//reduction isn't along row, so out rows will be same length as in rows
+        ReductionOperation::Scratch reduceWork;
         vector<int64_t> otherDims = inDims;
         otherDims.erase(otherDims.begin() + direction);//direction isn't 0
         otherDims.erase(otherDims.begin());//remove row direction because getRow/setRow
@@ -199,7 +203,7 @@ AlgorithmCiftiReduce::AlgorithmCiftiReduce(ProgressObject* myProgObj, const Cift
                 {//need reduction input in contiguous array
                     reduceScratch[j] = scratchInRows[j][i];
                 }
-                outRow[i] = ReductionOperation::reduceExcludeDev(reduceScratch.data(), inDims[direction], myReduce, sigmaBelow, sigmaAbove);
+                outRow[i] = ReductionOperation::reduceExcludeDev(reduceScratch.data(), inDims[direction], myReduce, sigmaBelow, sigmaAbove, &reduceWork);
             }
             indexvec[direction - 1] = 0;//only one element along reduce output direction
             ciftiOut->setRow(outRow.data(), indexvec);
@@ -22,13 +22,19 @@
 #include "AlgorithmException.h"
 #include "AlgorithmMetricSmoothing.h"
 #include "AlgorithmVolumeSmoothing.h"
+#include "CaretPointer.h"
 #include "CiftiFile.h"
+#include "CiftiRowBlock.h"
 #include "MetricFile.h"
+#include "MetricSmoothingObject.h"
 #include "VolumeFile.h"
+#include "VolumeSmoothingObject.h"
 #include "SurfaceFile.h"
 #include "AlgorithmCiftiSeparate.h"
 #include "AlgorithmCiftiReplaceStructure.h"
 
+#include <algorithm>
+
 using namespace caret;
 using namespace std;
 
@@ -155,7 +161,7 @@ void AlgorithmCiftiSmoothing::useParameters(OperationParameters* myParams, Progr
 AlgorithmCiftiSmoothing::AlgorithmCiftiSmoothing(ProgressObject* myProgObj, const CiftiFile* myCifti, const float& surfKern, const float& volKern, const int& myDir, CiftiFile* myCiftiOut,
                                                  const SurfaceFile* myLeftSurf, const SurfaceFile* myRightSurf, const SurfaceFile* myCerebSurf,
                                                  const CiftiFile* roiCifti, bool fixZerosVol, bool fixZerosSurf,
-                                                 const MetricFile* myLeftAreas, const MetricFile* myRightAreas, const MetricFile* myCerebAreas, const bool& mergedVolume) : AbstractAlgorithm(myProgObj)
+                                                 const MetricFile* myLeftAreas, const MetricFile* myRightAreas, const MetricFile* myCerebAreas, const bool& mergedVolume) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (!(surfKern > 0.0f) && !(volKern > 0.0f)) throw AlgorithmException("zero smoothing kernels requested for both volume and surface");
@@ -226,6 +232,127 @@ AlgorithmCiftiSmoothing::AlgorithmCiftiSmoothing(ProgressObject* myProgObj, cons
         }
     }
     myCiftiOut->setCiftiXML(myXML);
+    if (myDir == CiftiXMLOld::ALONG_ROW)
+    {//rows are smoothed independently, so smooth a block of rows at a time instead of separating each structure from the entire file
+        const int64_t numRows = myCifti->getNumberOfRows(), rowsPerBlock = CiftiRowBlock::getRowsPerBlock(myCifti);
+        if (numRows > rowsPerBlock)
+        {//the kernels don't depend on the data, so build each structure's kernel once, from the rois of a single row, and apply it to every block
+            CiftiFile rowTemplate;
+            CiftiRowBlock::readBlock(myCifti, 0, 1, &rowTemplate);
+            vector<CaretPointer<MetricFile> > surfRois(surfaceList.size());
+            vector<CaretPointer<MetricSmoothingObject> > surfSmoothers(surfaceList.size());
+            if (surfKern > 0.0f)
+            {
+                for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
+                {
+                    const SurfaceFile* mySurf = NULL;
+                    const MetricFile* myAreas = NULL;
+                    switch (surfaceList[whichStruct])
+                    {
+                        case StructureEnum::CORTEX_LEFT:
+                            mySurf = myLeftSurf;
+                            myAreas = myLeftAreas;
+                            break;
+                        case StructureEnum::CORTEX_RIGHT:
+                            mySurf = myRightSurf;
+                            myAreas = myRightAreas;
+                            break;
+                        case StructureEnum::CEREBELLUM:
+                            mySurf = myCerebSurf;
+                            myAreas = myCerebAreas;
+                            break;
+                        default:
+                            break;
+                    }
+                    MetricFile rowMetric;
+                    surfRois[whichStruct].grabNew(new MetricFile());
+                    AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, surfaceList[whichStruct], &rowMetric, surfRois[whichStruct]);
+                    if (roiCifti != NULL)
+                    {//due to above testing, we know the structure mask is the same, so just overwrite the ROI from the mask
+                        AlgorithmCiftiSeparate(NULL, roiCifti, CiftiXMLOld::ALONG_COLUMN, surfaceList[whichStruct], surfRois[whichStruct]);
+                    }
+                    const float* areaData = NULL;
+                    if (myAreas != NULL) areaData = myAreas->getValuePointerForColumn(0);
+                    surfSmoothers[whichStruct].grabNew(new MetricSmoothingObject(mySurf, surfKern, surfRois[whichStruct], MetricSmoothingObject::GEO_GAUSS_AREA, areaData));
+                }
+            }
+            if (mergedVolume)
+            {
+                volumeList.clear();
+                volumeList.push_back(StructureEnum::INVALID);//INVALID stands in for the merged volume
+            }
+            vector<CaretPointer<VolumeSmoothingObject> > volSmoothers(volumeList.size());
+            if (volKern > 0.0f)
+            {
+                for (int whichStruct = 0; whichStruct < (int)volumeList.size(); ++whichStruct)
+                {
+                    VolumeFile rowVol, rowRoi;
+                    int64_t offset[3];
+                    if (mergedVolume)
+                    {
+                        AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, &rowVol, offset, &rowRoi, true);
+                        if (roiCifti != NULL)
+                        {
+                            AlgorithmCiftiSeparate(NULL, roiCifti, CiftiXMLOld::ALONG_COLUMN, &rowRoi, offset, NULL, true);
+                        }
+                    } else {
+                        AlgorithmCiftiSeparate(NULL, &rowTemplate, myDir, volumeList[whichStruct], &rowVol, offset, &rowRoi, true);
+                        if (roiCifti != NULL)
+                        {
+                            AlgorithmCiftiSeparate(NULL, roiCifti, CiftiXMLOld::ALONG_COLUMN, volumeList[whichStruct], &rowRoi, offset, NULL, true);
+                        }
+                    }
+                    volSmoothers[whichStruct].grabNew(new VolumeSmoothingObject(&rowVol, volKern, &rowRoi, fixZerosVol));
+                }
+            }
+            for (int64_t firstRow = 0; firstRow < numRows; firstRow += rowsPerBlock)
+            {
+                CiftiFile blockIn, blockOut;
+                const int64_t blockRows = min(rowsPerBlock, numRows - firstRow);
+                CiftiRowBlock::readBlock(myCifti, firstRow, blockRows, &blockIn);
+                blockOut.setCiftiXML(blockIn.getCiftiXML(), false);
+                for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
+                {
+                    MetricFile myMetric, myMetricOut;
+                    AlgorithmCiftiSeparate(NULL, &blockIn, myDir, surfaceList[whichStruct], &myMetric);
+                    if (surfKern > 0.0f)
+                    {
+                        surfSmoothers[whichStruct]->smoothMetric(&myMetric, &myMetricOut, surfRois[whichStruct], fixZerosSurf);
+                        myMetricOut.setStructure(surfaceList[whichStruct]);
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, surfaceList[whichStruct], &myMetricOut);
+                    } else {
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, surfaceList[whichStruct], &myMetric);
+                    }
+                }
+                for (int whichStruct = 0; whichStruct < (int)volumeList.size(); ++whichStruct)
+                {
+                    VolumeFile myVol, myVolOut;
+                    VolumeFile* volToWrite = &myVol;
+                    int64_t offset[3];
+                    if (mergedVolume)
+                    {
+                        AlgorithmCiftiSeparate(NULL, &blockIn, myDir, &myVol, offset, NULL, true);
+                    } else {
+                        AlgorithmCiftiSeparate(NULL, &blockIn, myDir, volumeList[whichStruct], &myVol, offset, NULL, true);
+                    }
+                    if (volKern > 0.0f)
+                    {
+                        volSmoothers[whichStruct]->smoothVolume(&myVol, &myVolOut);
+                        volToWrite = &myVolOut;
+                    }
+                    if (mergedVolume)
+                    {
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, volToWrite, true);
+                    } else {
+                        AlgorithmCiftiReplaceStructure(NULL, &blockOut, myDir, volumeList[whichStruct], volToWrite, true);
+                    }
+                }
+                CiftiRowBlock::writeBlock(&blockOut, firstRow, myCiftiOut);
+                myProgress.reportProgress((firstRow + blockRows) / (float)numRows);
+            }
+            return;
+        }
+    }
     for (int whichStruct = 0; whichStruct < (int)surfaceList.size(); ++whichStruct)
     {
         const SurfaceFile* mySurf = NULL;
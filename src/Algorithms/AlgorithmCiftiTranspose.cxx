@@ -20,11 +20,41 @@
 
 #include "AlgorithmCiftiTranspose.h"
 #include "AlgorithmException.h"
+#include "CaretLogger.h"
+#include "CaretOMP.h"
 #include "CiftiFile.h"
+#include "ElapsedTimer.h"
+
+#include <algorithm>
 
 using namespace caret;
 using namespace std;
 
+namespace
+{
+    const int TILE_ROWS = 64;//input rows read at a time, while the previous tile is transposed
+    const int BLOCK_SIZE = 16;//side of the square blocks the transpose works in, so both the tile and the output rows stay in cache
+    
+    ///copy columns [colStart, colEnd) of a tile of input rows into the matching output rows, starting at element outOffset
+    void transposeBlock(const float* tile, const int64_t& tileStride, const int& numTileRows, const int& colStart, const int& colEnd,
+                        float* outRows, const int64_t& outStride, const int& outFirstCol, const int& outOffset)
+    {
+        for (int tileBlock = 0; tileBlock < numTileRows; tileBlock += BLOCK_SIZE)
+        {
+            int tileBlockEnd = min(tileBlock + BLOCK_SIZE, numTileRows);
+            for (int col = colStart; col < colEnd; ++col)
+            {
+                float* outPtr = outRows + (col - outFirstCol) * outStride + outOffset;
+                const float* inPtr = tile + col;
+                for (int t = tileBlock; t < tileBlockEnd; ++t)
+                {
+                    outPtr[t] = inPtr[t * tileStride];
+                }
+            }
+        }
+    }
+}
+
 AString AlgorithmCiftiTranspose::getCommandSwitch()
 {
     return "-cifti-transpose";
@@ -69,7 +99,7 @@ void AlgorithmCiftiTranspose::useParameters(OperationParameters* myParams, Progr
     AlgorithmCiftiTranspose(myProgObj, ciftiIn, ciftiOut, memLimitGB);
 }
 
-AlgorithmCiftiTranspose::AlgorithmCiftiTranspose(ProgressObject* myProgObj, const CiftiFile* ciftiIn, CiftiFile* ciftiOut, const float& memLimitGB) : AbstractAlgorithm(myProgObj)
+AlgorithmCiftiTranspose::AlgorithmCiftiTranspose(ProgressObject* myProgObj, const CiftiFile* ciftiIn, CiftiFile* ciftiOut, const float& memLimitGB) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     const CiftiXML& inXML = ciftiIn->getCiftiXML();
@@ -84,31 +114,71 @@ AlgorithmCiftiTranspose::AlgorithmCiftiTranspose(ProgressObject* myProgObj, cons
     ciftiOut->setCiftiXML(outXML);
     int rowSize = outXML.getDimensionLength(CiftiXML::ALONG_ROW), colSize = outXML.getDimensionLength(CiftiXML::ALONG_COLUMN);
     int64_t outRowBytes = rowSize * sizeof(float);
+    int tileRows = min(TILE_ROWS, rowSize);
+    int64_t tileBytes = 2 * (int64_t)tileRows * colSize * sizeof(float);//double buffered
     int numCacheRows = colSize;
     if (memLimitGB >= 0.0f)
     {
-        numCacheRows = memLimitGB * 1024 * 1024 * 1024 / outRowBytes;
+        numCacheRows = (memLimitGB * 1024 * 1024 * 1024 - tileBytes) / outRowBytes;
         if (numCacheRows < 1) numCacheRows = 1;
         if (numCacheRows > colSize) numCacheRows = colSize;
     }
-    vector<vector<float> > cacheRows(numCacheRows, vector<float>(rowSize));
-    vector<float> scratchInRow(colSize);
+    vector<float> cacheRows((int64_t)numCacheRows * rowSize);
+    vector<float> tiles[2];
+    tiles[0].resize((int64_t)tileRows * colSize);
+    tiles[1].resize((int64_t)tileRows * colSize);
+    int numPasses = (colSize + numCacheRows - 1) / numCacheRows;
+    if (numPasses > 1) CaretLogInfo("transposing " + AString::number(numCacheRows) + " output rows per pass, " + AString::number(numPasses) + " passes through the input");
+    ElapsedTimer myTimer;
+    myTimer.start();
+    double writeSeconds = 0.0;
     for (int i = 0; i < colSize; i += numCacheRows)//loop through cache chunks
     {
         int end = i + numCacheRows;
         if (end > colSize) end = colSize;
-        for (int j = 0; j < rowSize; ++j)//loop through all input rows
+        for (int j = 0; j < tileRows; ++j)
         {
-            ciftiIn->getRow(scratchInRow.data(), j);
-            for (int k = i; k < end; ++k)
+            ciftiIn->getRow(tiles[0].data() + (int64_t)j * colSize, j);
+        }
+        int curTile = 0;
+        for (int tileStart = 0; tileStart < rowSize; tileStart += tileRows)//loop through all input rows, a tile at a time
+        {
+            int tileEnd = min(tileStart + tileRows, rowSize);
+            int nextEnd = min(tileEnd + tileRows, rowSize);
+            const float* tile = tiles[curTile].data();
+            float* nextTile = tiles[1 - curTile].data();
+#pragma omp CARET_PAR
             {
-                cacheRows[k - i][j] = scratchInRow[k];
+#pragma omp CARET_SINGLE nowait
+                {//one thread reads the next tile in file order, then helps with whatever is left of this one
+                    for (int j = tileEnd; j < nextEnd; ++j)
+                    {
+                        ciftiIn->getRow(nextTile + (int64_t)(j - tileEnd) * colSize, j);
+                    }
+                }
+#pragma omp CARET_FOR schedule(dynamic)
+                for (int k = i; k < end; k += BLOCK_SIZE)
+                {
+                    transposeBlock(tile, colSize, tileEnd - tileStart, k, min(k + BLOCK_SIZE, end), cacheRows.data(), rowSize, i, tileStart);
+                }
             }
+            curTile = 1 - curTile;
         }
+        ElapsedTimer writeTimer;
+        writeTimer.start();
         for (int k = i; k < end; ++k)
         {
-            ciftiOut->setRow(cacheRows[k - i].data(), k);
+            ciftiOut->setRow(cacheRows.data() + (int64_t)(k - i) * rowSize, k);
         }
+        writeSeconds += writeTimer.getElapsedTimeSeconds();
+    }
+    double totalSeconds = myTimer.getElapsedTimeSeconds();
+    if (totalSeconds > 0.0)
+    {
+        double matrixMB = (double)rowSize * colSize * sizeof(float) / (1024 * 1024);
+        CaretLogInfo("transposed " + AString::number(matrixMB, 'f', 1) + " MB in " + AString::number(totalSeconds, 'f', 2) + " seconds: read " +
+                     AString::number(matrixMB * numPasses / max(totalSeconds - writeSeconds, 1e-6), 'f', 1) + " MB/s including transposing, wrote " +
+                     AString::number(matrixMB / max(writeSeconds, 1e-6), 'f', 1) + " MB/s");
     }
 }
 
@@ -105,7 +105,7 @@ AlgorithmFociResample::AlgorithmFociResample(ProgressObject* myProgObj, const Fo
                                              const SurfaceFile* leftCurSurf, const SurfaceFile* leftNewSurf,
                                              const SurfaceFile* rightCurSurf, const SurfaceFile* rightNewSurf,
                                              const SurfaceFile* cerebCurSurf, const SurfaceFile* cerebNewSurf,
-                                             const bool& discardNormDist, const bool& restoryXyz) : AbstractAlgorithm(myProgObj)
+                                             const bool& discardNormDist, const bool& restoryXyz) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     checkStructureMatch(leftCurSurf, StructureEnum::CORTEX_LEFT, "current left surface", "-left-surfaces option expects");
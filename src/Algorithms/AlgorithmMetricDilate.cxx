@@ -148,7 +148,8 @@ void AlgorithmMetricDilate::useParameters(OperationParameters* myParams, Progres
 
 AlgorithmMetricDilate::AlgorithmMetricDilate(ProgressObject* myProgObj, const MetricFile* myMetric, const SurfaceFile* mySurf, const float& distance, MetricFile* myMetricOut,
                                              const MetricFile* badNodeRoi, const MetricFile* dataRoi, const int& columnNum,
-                                             const Method& myMethod, const float& exponent, const MetricFile* corrAreas) : AbstractAlgorithm(myProgObj)
+                                             const Method& myMethod, const float& exponent, const MetricFile* corrAreas,
+                                             const Precomputed* precomputed) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numNodes = mySurf->getNumberOfNodes();
@@ -177,8 +178,7 @@ AlgorithmMetricDilate::AlgorithmMetricDilate(ProgressObject* myProgObj, const Me
         throw AlgorithmException("distance cannot be negative");
     }
     myMetricOut->setStructure(mySurf->getStructure());
-    vector<pair<int, StencilElem> > myStencils;//because we need to iterate over it in parallel
-    vector<pair<int, int> > myNearest;
+    Precomputed localPrecomputed;
     vector<float> colScratch(numNodes);
     vector<float> myAreasData;
     const float* myAreas = NULL;
@@ -190,15 +190,18 @@ AlgorithmMetricDilate::AlgorithmMetricDilate(ProgressObject* myProgObj, const Me
         myAreas = corrAreas->getValuePointerForColumn(0);
     }
     bool linear = (myMethod == LINEAR), nearest = (myMethod == NEAREST);
-    if (!linear && badNodeRoi != NULL)//if we know which nodes need to have their values replaced, then we can do the same thing at each vertex for each column
+    if (!linear && badNodeRoi != NULL && precomputed == NULL)//if we know which nodes need to have their values replaced, then we can do the same thing at each vertex for each column
     {
         if (nearest)
         {
-            precomputeNearest(myNearest, mySurf, badNodeRoi, dataRoi, corrAreas, distance);
+            precomputeNearest(localPrecomputed.m_nearest, mySurf, badNodeRoi, dataRoi, corrAreas, distance);
         } else {
-            precomputeStencils(myStencils, mySurf, myAreas, badNodeRoi, dataRoi, corrAreas, distance, exponent);
+            precomputeStencils(localPrecomputed.m_stencils, mySurf, myAreas, badNodeRoi, dataRoi, corrAreas, distance, exponent);
         }
     }
+    if (precomputed == NULL) precomputed = &localPrecomputed;
+    const vector<pair<int, StencilElem> >& myStencils = precomputed->m_stencils;//because we need to iterate over it in parallel
+    const vector<pair<int, int> >& myNearest = precomputed->m_nearest;
     if (columnNum == -1)
     {
         myMetricOut->setNumberOfNodesAndColumns(numNodes, myMetric->getNumberOfColumns());
@@ -252,7 +255,7 @@ AlgorithmMetricDilate::AlgorithmMetricDilate(ProgressObject* myProgObj, const Me
     }
 }
 
-void AlgorithmMetricDilate::processColumn(float* colScratch, const int& numNodes, const float* myInputData, vector<pair<int, int> > myNearest)
+void AlgorithmMetricDilate::processColumn(float* colScratch, const int& numNodes, const float* myInputData, const vector<pair<int, int> >& myNearest)
 {
     for (int i = 0; i < numNodes; ++i)
     {
@@ -273,7 +276,7 @@ void AlgorithmMetricDilate::processColumn(float* colScratch, const int& numNodes
     }
 }
 
-void AlgorithmMetricDilate::processColumn(float* colScratch, const int& numNodes, const float* myInputData, vector<pair<int, StencilElem> > myStencils)
+void AlgorithmMetricDilate::processColumn(float* colScratch, const int& numNodes, const float* myInputData, const vector<pair<int, StencilElem> >& myStencils)
 {
     for (int i = 0; i < numNodes; ++i)
     {
@@ -533,6 +536,40 @@ void AlgorithmMetricDilate::processColumn(float* colScratch, const float* myInpu
     }
 }
 
+void AlgorithmMetricDilate::precompute(Precomputed& precomputedOut, const SurfaceFile* mySurf, const float& distance, const MetricFile* badNodeRoi,
+                                       const MetricFile* dataRoi, const Method& myMethod, const float& exponent, const MetricFile* corrAreas)
+{
+    if (badNodeRoi == NULL) throw AlgorithmException("precomputed dilation requires a bad vertex roi");
+    int numNodes = mySurf->getNumberOfNodes();
+    if (badNodeRoi->getNumberOfNodes() != numNodes) throw AlgorithmException("bad vertex roi number of vertices does not match");
+    if (dataRoi != NULL && dataRoi->getNumberOfNodes() != numNodes) throw AlgorithmException("data roi number of vertices does not match");
+    if (corrAreas != NULL && corrAreas->getNumberOfNodes() != numNodes) throw AlgorithmException("corrected areas metric number of vertices does not match");
+    precomputedOut.m_stencils.clear();
+    precomputedOut.m_nearest.clear();
+    switch (myMethod)
+    {
+        case NEAREST:
+            precomputeNearest(precomputedOut.m_nearest, mySurf, badNodeRoi, dataRoi, corrAreas, distance);
+            break;
+        case WEIGHTED:
+        {
+            vector<float> myAreasData;
+            const float* myAreas = NULL;
+            if (corrAreas == NULL)
+            {
+                mySurf->computeNodeAreas(myAreasData);
+                myAreas = myAreasData.data();
+            } else {
+                myAreas = corrAreas->getValuePointerForColumn(0);
+            }
+            precomputeStencils(precomputedOut.m_stencils, mySurf, myAreas, badNodeRoi, dataRoi, corrAreas, distance, exponent);
+            break;
+        }
+        case LINEAR:
+            break;
+    }
+}
+
 void AlgorithmMetricDilate::precomputeStencils(vector<pair<int, StencilElem> >& myStencils, const SurfaceFile* mySurf, const float* myAreas,
                                                const MetricFile* badNodeRoi, const MetricFile* dataRoi, const MetricFile* corrAreas,
                                                const float& distance, const float& exponent)
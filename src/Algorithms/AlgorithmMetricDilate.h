@@ -33,13 +33,13 @@ namespace caret {
             float m_weightsum;
         };
         AlgorithmMetricDilate();
-        void precomputeStencils(std::vector<std::pair<int, StencilElem> >& myStencils, const SurfaceFile* mySurf, const float* myAreas,
-                                const MetricFile* badNodeRoi, const MetricFile* dataRoi, const MetricFile* corrAreas,
-                                const float& distance, const float& exponent);
-        void precomputeNearest(std::vector<std::pair<int, int> >& myNearest, const SurfaceFile* mySurf,
-                               const MetricFile* badNodeRoi, const MetricFile* dataRoi, const MetricFile* corrAreas, const float& distance);
-        void processColumn(float* colScratch, const int& numNodes, const float* myInputData, std::vector<std::pair<int, int> > myNearest);
-        void processColumn(float* colScratch, const int& numNodes, const float* myInputData, std::vector<std::pair<int, StencilElem> > myStencils);
+        static void precomputeStencils(std::vector<std::pair<int, StencilElem> >& myStencils, const SurfaceFile* mySurf, const float* myAreas,
+                                       const MetricFile* badNodeRoi, const MetricFile* dataRoi, const MetricFile* corrAreas,
+                                       const float& distance, const float& exponent);
+        static void precomputeNearest(std::vector<std::pair<int, int> >& myNearest, const SurfaceFile* mySurf,
+                                      const MetricFile* badNodeRoi, const MetricFile* dataRoi, const MetricFile* corrAreas, const float& distance);
+        void processColumn(float* colScratch, const int& numNodes, const float* myInputData, const std::vector<std::pair<int, int> >& myNearest);
+        void processColumn(float* colScratch, const int& numNodes, const float* myInputData, const std::vector<std::pair<int, StencilElem> >& myStencils);
         void processColumn(float* colScratch, const float* myInputData, const SurfaceFile* mySurf, const float* myAreas,
                            const MetricFile* badNodeRoi, const MetricFile* dataRoi, const MetricFile* corrAreas,
                            const float& distance, const bool& nearest, const bool& linear, const float& exponent);
@@ -53,9 +53,19 @@ namespace caret {
             WEIGHTED,
             LINEAR
         };
+        ///when the bad vertices are known, the replacement for each one is the same for every column, computing these is the slow part, so they can be reused for many metrics
+        struct Precomputed
+        {
+            std::vector<std::pair<int, StencilElem> > m_stencils;
+            std::vector<std::pair<int, int> > m_nearest;
+        };
+        ///only NEAREST and WEIGHTED use precomputed replacements
+        static void precompute(Precomputed& precomputedOut, const SurfaceFile* mySurf, const float& distance, const MetricFile* badNodeRoi,
+                               const MetricFile* dataRoi = NULL, const Method& myMethod = WEIGHTED, const float& exponent = 2.0f, const MetricFile* corrAreas = NULL);
         AlgorithmMetricDilate(ProgressObject* myProgObj, const MetricFile* myMetric, const SurfaceFile* mySurf, const float& distance,
                               MetricFile* myMetricOut, const MetricFile* badNodeRoi = NULL, const MetricFile* dataRoi = NULL, const int& columnNum = -1,
-                              const Method& myMethod = WEIGHTED, const float& exponent = 2.0f, const MetricFile* corrAreas = NULL);
+                              const Method& myMethod = WEIGHTED, const float& exponent = 2.0f, const MetricFile* corrAreas = NULL,
+                              const Precomputed* precomputed = NULL);
         static OperationParameters* getParameters();
         static void useParameters(OperationParameters* myParams, ProgressObject* myProgObj);
         static AString getCommandSwitch();
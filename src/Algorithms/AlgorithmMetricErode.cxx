@@ -103,49 +103,53 @@ void AlgorithmMetricErode::useParameters(OperationParameters* myParams, Progress
     AlgorithmMetricErode(myProgObj, myMetric, mySurf, distance, myMetricOut, myRoi, columnNum, corrAreas);
 }
 
-namespace
+void AlgorithmMetricErode::precomputeStencils(vector<vector<int32_t> >& stencilsOut, const SurfaceFile* mySurf, const float& distance,
+                                              const MetricFile* myRoi, const MetricFile* corrAreas)
 {
-    vector<vector<int32_t> > precomputeStencils(const SurfaceFile* mySurf, const float& distance, const MetricFile* corrAreas, const float* roiCol)
+    int numNodes = mySurf->getNumberOfNodes();
+    const float* roiCol = NULL;
+    if (myRoi != NULL)
+    {
+        roiCol = myRoi->getValuePointerForColumn(0);
+    }
+    stencilsOut.clear();
+    stencilsOut.resize(numNodes);
+    CaretPointer<GeodesicHelperBase> myGeoBase;
+    if (corrAreas != NULL)
     {
-        int numNodes = mySurf->getNumberOfNodes();
-        vector<vector<int32_t> > ret(numNodes);
-        CaretPointer<GeodesicHelperBase> myGeoBase;
-        if (corrAreas != NULL)
+        myGeoBase.grabNew(new GeodesicHelperBase(mySurf, corrAreas->getValuePointerForColumn(0)));
+    }
+    CaretPointer<TopologyHelper> myTopoHelp = mySurf->getTopologyHelper();//we aren't using to depth, so share the topology helper
+#pragma omp CARET_PAR
+    {//use parallel here so each thread gets its own geodesic helper
+        CaretPointer<GeodesicHelper> myGeoHelp;
+        if (corrAreas == NULL)
         {
-            myGeoBase.grabNew(new GeodesicHelperBase(mySurf, corrAreas->getValuePointerForColumn(0)));
+            myGeoHelp = mySurf->getGeodesicHelper();
+        } else {
+            myGeoHelp.grabNew(new GeodesicHelper(myGeoBase));
         }
-        CaretPointer<TopologyHelper> myTopoHelp = mySurf->getTopologyHelper();//we aren't using to depth, so share the topology helper
-#pragma omp CARET_PAR
-        {//use parallel here so each thread gets its own geodesic helper
-            CaretPointer<GeodesicHelper> myGeoHelp;
-            if (corrAreas == NULL)
-            {
-                myGeoHelp = mySurf->getGeodesicHelper();
-            } else {
-                myGeoHelp.grabNew(new GeodesicHelper(myGeoBase));
-            }
 #pragma omp CARET_FOR schedule(dynamic)
-            for (int i = 0; i < numNodes; ++i)
+        for (int i = 0; i < numNodes; ++i)
+        {
+            if (roiCol == NULL || roiCol[i] > 0.0f)
             {
-                if (roiCol == NULL || roiCol[i] > 0.0f)
-                {
-                    vector<int32_t> geoNodes;
-                    vector<float> geoDists;
-                    myGeoHelp->getNodesToGeoDist(i, distance, geoNodes, geoDists);
-                    const vector<int32_t>& topoNodes = myTopoHelp->getNodeNeighbors(i);
-                    set<int32_t> mergeSet(geoNodes.begin(), geoNodes.end());
-                    mergeSet.insert(topoNodes.begin(), topoNodes.end());
-                    mergeSet.erase(i);//center of stencil is already 0 if stencil is used, so don't set it again
-                    ret[i] = vector<int32_t>(mergeSet.begin(), mergeSet.end());
-                }
+                vector<int32_t> geoNodes;
+                vector<float> geoDists;
+                myGeoHelp->getNodesToGeoDist(i, distance, geoNodes, geoDists);
+                const vector<int32_t>& topoNodes = myTopoHelp->getNodeNeighbors(i);
+                set<int32_t> mergeSet(geoNodes.begin(), geoNodes.end());
+                mergeSet.insert(topoNodes.begin(), topoNodes.end());
+                mergeSet.erase(i);//center of stencil is already 0 if stencil is used, so don't set it again
+                stencilsOut[i] = vector<int32_t>(mergeSet.begin(), mergeSet.end());
             }
         }
-        return ret;
     }
 }
 
 AlgorithmMetricErode::AlgorithmMetricErode(ProgressObject* myProgObj, const MetricFile* myMetric, const SurfaceFile* mySurf, const float& distance,
-                                           MetricFile* myMetricOut, const MetricFile* myRoi, const int& columnNum, const MetricFile* corrAreas) : AbstractAlgorithm(myProgObj)
+                                           MetricFile* myMetricOut, const MetricFile* myRoi, const int& columnNum, const MetricFile* corrAreas,
+                                           const vector<vector<int32_t> >* precomputedStencils) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numNodes = mySurf->getNumberOfNodes();
@@ -182,7 +186,15 @@ AlgorithmMetricErode::AlgorithmMetricErode(ProgressObject* myProgObj, const Metr
     {
         roiCol = myRoi->getValuePointerForColumn(0);
     }
-    vector<vector<int32_t> > stencils = precomputeStencils(mySurf, distance, corrAreas, roiCol);
+    vector<vector<int32_t> > localStencils;
+    if (precomputedStencils == NULL)
+    {
+        precomputeStencils(localStencils, mySurf, distance, myRoi, corrAreas);
+        precomputedStencils = &localStencils;
+    } else if ((int)precomputedStencils->size() != numNodes) {
+        throw AlgorithmException("precomputed stencils do not match surface number of vertices");
+    }
+    const vector<vector<int32_t> >& stencils = *precomputedStencils;
     if (columnNum == -1)
     {
         for (int c = 0; c < numInColumns; ++c)
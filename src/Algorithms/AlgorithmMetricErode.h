@@ -32,8 +32,12 @@ namespace caret {
         static float getSubAlgorithmWeight();
         static float getAlgorithmInternalWeight();
     public:
+        ///the stencils depend only on the surface, distance, roi and corrected areas, computing them is the slow part, so they can be reused for many metrics
+        static void precomputeStencils(std::vector<std::vector<int32_t> >& stencilsOut, const SurfaceFile* mySurf, const float& distance,
+                                       const MetricFile* myRoi = NULL, const MetricFile* corrAreas = NULL);
         AlgorithmMetricErode(ProgressObject* myProgObj, const MetricFile* myMetric, const SurfaceFile* mySurf, const float& distance,
-                             MetricFile* myMetricOut, const MetricFile* myRoi = NULL, const int& columnNum = -1, const MetricFile* corrAreas = NULL);
+                             MetricFile* myMetricOut, const MetricFile* myRoi = NULL, const int& columnNum = -1, const MetricFile* corrAreas = NULL,
+                             const std::vector<std::vector<int32_t> >* precomputedStencils = NULL);
         static OperationParameters* getParameters();
         static void useParameters(OperationParameters* myParams, ProgressObject* myProgObj);
         static AString getCommandSwitch();
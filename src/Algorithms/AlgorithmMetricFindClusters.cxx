@@ -21,11 +21,12 @@
 #include "AlgorithmMetricFindClusters.h"
 #include "AlgorithmException.h"
 
+#include "CaretAssert.h"
 #include "CaretLogger.h"
+#include "ClusterGraph.h"
 #include "GeodesicHelper.h"
 #include "MetricFile.h"
 #include "SurfaceFile.h"
-#include "TopologyHelper.h"
 
 #include <vector>
 
@@ -152,65 +153,29 @@ namespace
         double area;
     };
     
-    void processColumn(const float* data, const float* roiData, const float* nodeAreas, TopologyHelper* myTopoHelp, GeodesicHelper* myGeoHelp,
+    void processColumn(const float* data, const float* roiData, const ClusterGraph& myGraph, GeodesicHelper* myGeoHelp,
                        const float& threshVal, const float& minArea, const bool& lessThan, const float& areaRatio, const float& distanceCutoff,
                        float* outData, int& markVal)
     {
-        int numNodes = myTopoHelp->getNumberOfNodes();
-        vector<int> marked(numNodes, 0);
-        if (lessThan)
-        {
-            for (int i = 0; i < numNodes; ++i)
-            {
-                if ((roiData == NULL || roiData[i] > 0.0f) && data[i] < threshVal)
-                {
-                    marked[i] = 1;
-                }
-            }
-        } else {
-            for (int i = 0; i < numNodes; ++i)
-            {
-                if ((roiData == NULL || roiData[i] > 0.0f) && data[i] > threshVal)
-                {
-                    marked[i] = 1;
-                }
-            }
-        }
+        vector<vector<int64_t> > foundClusters;
+        vector<double> foundAreas;
+        myGraph.findClusters(data, threshVal, lessThan, foundClusters, foundAreas, roiData);//ordered by lowest vertex, same as a sequential flood fill
         vector<Cluster> clusters;
         float biggestSize = 0.0f;
         int biggestCluster = -1;
-        for (int i = 0; i < numNodes; ++i)
+        for (int i = 0; i < (int)foundClusters.size(); ++i)
         {
-            if (marked[i])
+            if (foundAreas[i] > minArea)
             {
                 Cluster newCluster;
-                newCluster.members.push_back(i);
-                marked[i] = 0;//unmark it when added to list to prevent multiples
-                for (int index = 0; index < (int)newCluster.members.size(); ++index)//NOTE: vector grows inside loop
+                newCluster.members.assign(foundClusters[i].begin(), foundClusters[i].end());
+                newCluster.area = foundAreas[i];
+                if (newCluster.area > biggestSize)
                 {
-                    int node = newCluster.members[index];//keep list around so we can put it into the output immediately if it is large enough
-                    newCluster.area += nodeAreas[node];
-                    const vector<int32_t>& neighbors = myTopoHelp->getNodeNeighbors(node);
-                    int numNeigh = (int)neighbors.size();
-                    for (int n = 0; n < numNeigh; ++n)
-                    {
-                        const int32_t& neighbor = neighbors[n];
-                        if (marked[neighbor])
-                        {
-                            newCluster.members.push_back(neighbor);
-                            marked[neighbor] = 0;
-                        }
-                    }
-                }
-                if (newCluster.area > minArea)
-                {
-                    if (newCluster.area > biggestSize)
-                    {
-                        biggestSize = newCluster.area;
-                        biggestCluster = (int)clusters.size();
-                    }
-                    clusters.push_back(newCluster);
+                    biggestSize = newCluster.area;
+                    biggestCluster = (int)clusters.size();
                 }
+                clusters.push_back(newCluster);
             }
         }
         vector<int32_t> pathScratch;
@@ -269,7 +234,7 @@ namespace
 
 AlgorithmMetricFindClusters::AlgorithmMetricFindClusters(ProgressObject* myProgObj, const SurfaceFile* mySurf, const MetricFile* myMetric, const float& threshVal, const float& minArea,
                                                          MetricFile* myMetricOut, const bool& lessThan, const MetricFile* myRoi, const MetricFile* myAreas,
-                                                         const int& columnNum, const int& startVal, int* endVal, const float& areaRatio, const float& distanceCutoff) : AbstractAlgorithm(myProgObj)
+                                                         const int& columnNum, const int& startVal, int* endVal, const float& areaRatio, const float& distanceCutoff) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (startVal == 0)
@@ -302,7 +267,7 @@ AlgorithmMetricFindClusters::AlgorithmMetricFindClusters(ProgressObject* myProgO
     } else {
         nodeAreas = myAreas->getValuePointerForColumn(0);
     }
-    CaretPointer<TopologyHelper> myTopoHelp = mySurf->getTopologyHelper();
+    ClusterGraph myGraph(mySurf, nodeAreas);
     CaretPointer<GeodesicHelper> myGeoHelp;
     CaretPointer<GeodesicHelperBase> myGeoBase;
     if (distanceCutoff > 0.0f)//geodesic is only needed for distance cutoff
@@ -326,7 +291,7 @@ AlgorithmMetricFindClusters::AlgorithmMetricFindClusters(ProgressObject* myProgO
             myMetricOut->setColumnName(c, myMetric->getColumnName(c));
             vector<float> outData(numNodes, 0.0f);
             const float* data = myMetric->getValuePointerForColumn(c);
-            processColumn(data, roiData, nodeAreas, myTopoHelp, myGeoHelp, threshVal, minArea, lessThan, areaRatio, distanceCutoff, outData.data(), markVal);
+            processColumn(data, roiData, myGraph, myGeoHelp, threshVal, minArea, lessThan, areaRatio, distanceCutoff, outData.data(), markVal);
             myMetricOut->setValuesForColumn(c, outData.data());
         }
     } else {
@@ -335,7 +300,7 @@ AlgorithmMetricFindClusters::AlgorithmMetricFindClusters(ProgressObject* myProgO
         myMetricOut->setColumnName(0, myMetric->getColumnName(columnNum));
         vector<float> outData(numNodes, 0.0f);
         const float* data = myMetric->getValuePointerForColumn(columnNum);
-        processColumn(data, roiData, nodeAreas, myTopoHelp, myGeoHelp, threshVal, minArea, lessThan, areaRatio, distanceCutoff, outData.data(), markVal);
+        processColumn(data, roiData, myGraph, myGeoHelp, threshVal, minArea, lessThan, areaRatio, distanceCutoff, outData.data(), markVal);
         myMetricOut->setValuesForColumn(0, outData.data());
     }
     if (endVal != NULL) *endVal = markVal;
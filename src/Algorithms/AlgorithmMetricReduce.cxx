@@ -80,7 +80,7 @@ void AlgorithmMetricReduce::useParameters(OperationParameters* myParams, Progres
     }
 }
 
-AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const MetricFile* metricIn, const ReductionEnum::Enum& myReduce, MetricFile* metricOut, const bool& onlyNumeric) : AbstractAlgorithm(myProgObj)
+AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const MetricFile* metricIn, const ReductionEnum::Enum& myReduce, MetricFile* metricOut, const bool& onlyNumeric) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numNodes = metricIn->getNumberOfNodes();
@@ -90,6 +90,7 @@ AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const Me
     metricOut->setStructure(metricIn->getStructure());
     metricOut->setColumnName(0, ReductionEnum::toName(myReduce));
     vector<float> scratch(numCols);
+    ReductionOperation::Scratch reduceWork;//reused across vertices
     for (int node = 0; node < numNodes; ++node)
     {
         for (int col = 0; col < numCols; ++col)
@@ -98,14 +99,14 @@ AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const Me
         }
         if (onlyNumeric)
         {
-            metricOut->setValue(node, 0, ReductionOperation::reduceOnlyNumeric(scratch.data(), numCols, myReduce));
+            metricOut->setValue(node, 0, ReductionOperation::reduceOnlyNumeric(scratch.data(), numCols, myReduce, &reduceWork));
         } else {
-            metricOut->setValue(node, 0, ReductionOperation::reduce(scratch.data(), numCols, myReduce));
+            metricOut->setValue(node, 0, ReductionOperation::reduce(scratch.data(), numCols, myReduce, &reduceWork));
         }
     }
 }
 
-AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const MetricFile* metricIn, const ReductionEnum::Enum& myReduce, MetricFile* metricOut, const float& sigmaBelow, const float& sigmaAbove) : AbstractAlgorithm(myProgObj)
+AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const MetricFile* metricIn, const ReductionEnum::Enum& myReduce, MetricFile* metricOut, const float& sigmaBelow, const float& sigmaAbove) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numNodes = metricIn->getNumberOfNodes();
@@ -115,13 +116,14 @@ AlgorithmMetricReduce::AlgorithmMetricReduce(ProgressObject* myProgObj, const Me
     metricOut->setStructure(metricIn->getStructure());
     metricOut->setColumnName(0, ReductionEnum::toName(myReduce));
     vector<float> scratch(numCols);
+    ReductionOperation::Scratch reduceWork;//reused across vertices
     for (int node = 0; node < numNodes; ++node)
     {
         for (int col = 0; col < numCols; ++col)
         {
             scratch[col] = metricIn->getValue(node, col);
         }
-        metricOut->setValue(node, 0, ReductionOperation::reduceExcludeDev(scratch.data(), numCols, myReduce, sigmaBelow, sigmaAbove));
+        metricOut->setValue(node, 0, ReductionOperation::reduceExcludeDev(scratch.data(), numCols, myReduce, sigmaBelow, sigmaAbove, &reduceWork));
     }
 }
 
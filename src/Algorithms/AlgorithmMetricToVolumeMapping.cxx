@@ -149,7 +149,7 @@ void AlgorithmMetricToVolumeMapping::useParameters(OperationParameters* myParams
 }
 
 AlgorithmMetricToVolumeMapping::AlgorithmMetricToVolumeMapping(ProgressObject* myProgObj, const MetricFile* myMetric, const SurfaceFile* mySurf, const VolumeSpace& myVolSpace,
-                                                                 VolumeFile* myVolOut, const float& nearDist) : AbstractAlgorithm(myProgObj)
+                                                                 VolumeFile* myVolOut, const float& nearDist) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (myMetric->getNumberOfNodes() != mySurf->getNumberOfNodes())
@@ -198,7 +198,7 @@ AlgorithmMetricToVolumeMapping::AlgorithmMetricToVolumeMapping(ProgressObject* m
 
 AlgorithmMetricToVolumeMapping::AlgorithmMetricToVolumeMapping(ProgressObject* myProgObj, const MetricFile* myMetric, const SurfaceFile* mySurf, const VolumeSpace& myVolSpace,
                                                                VolumeFile* myVolOut, const SurfaceFile* innerSurf, const SurfaceFile* outerSurf, const int& subDivs,
-                                                               const bool& greedy, const bool& thickColumn) : AbstractAlgorithm(myProgObj)
+                                                               const bool& greedy, const bool& thickColumn) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     int numNodes = mySurf->getNumberOfNodes();
     if (myMetric->getNumberOfNodes() != numNodes)
@@ -76,7 +76,7 @@ void AlgorithmMetricVectorTowardROI::useParameters(OperationParameters* myParams
 }
 
 AlgorithmMetricVectorTowardROI::AlgorithmMetricVectorTowardROI(ProgressObject* myProgObj, SurfaceFile* mySurf, const MetricFile* targetRoi,
-                                                               MetricFile* myMetricOut, const MetricFile* computeRoi) : AbstractAlgorithm(myProgObj)
+                                                               MetricFile* myMetricOut, const MetricFile* computeRoi) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numNodes = mySurf->getNumberOfNodes();
@@ -67,7 +67,7 @@ void AlgorithmSurfaceCreateSphere::useParameters(OperationParameters* myParams,
     AlgorithmSurfaceCreateSphere(myProgObj, numVertices, mySurfOut);
 }
 
-AlgorithmSurfaceCreateSphere::AlgorithmSurfaceCreateSphere(ProgressObject* myProgObj, const int& numVertices, SurfaceFile* mySurfOut) : AbstractAlgorithm(myProgObj)
+AlgorithmSurfaceCreateSphere::AlgorithmSurfaceCreateSphere(ProgressObject* myProgObj, const int& numVertices, SurfaceFile* mySurfOut) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (numVertices < 1) throw AlgorithmException("desired number of vertices must be positive");
@@ -121,7 +121,7 @@ AlgorithmSurfaceSmoothing::AlgorithmSurfaceSmoothing(ProgressObject* myProgObj,
                                                      SurfaceFile* outputSurfaceFile,
                                                      const float strength,
                                                      const int32_t iterations)
-   : AbstractAlgorithm(myProgObj)
+   : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     if ((strength < 0.0)
         || (strength > 1.0)) {
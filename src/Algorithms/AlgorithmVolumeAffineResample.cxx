@@ -22,9 +22,9 @@
 #include "AffineFile.h"
 #include "AlgorithmException.h"
 #include "CaretLogger.h"
-#include "CaretOMP.h"
 #include "NiftiIO.h"
 #include "Vector3D.h"
+#include "VolumeResampler.h"
 
 using namespace caret;
 using namespace std;
@@ -100,8 +100,35 @@ void AlgorithmVolumeAffineResample::useParameters(OperationParameters* myParams,
     AlgorithmVolumeAffineResample(myProgObj, inVol, affMat, refDims.data(), refSpaceIO.getHeader().getSForm(), myMethod, outVol);
 }
 
+namespace
+{
+    class AffineMapping : public VolumeResampler::SampleMapping
+    {
+        const VolumeFile* m_inVol, * m_outVol;
+        Vector3D m_xvec, m_yvec, m_zvec, m_offset;
+    public:
+        AffineMapping(const VolumeFile* inVol, const VolumeFile* outVol, const Vector3D& xvec, const Vector3D& yvec, const Vector3D& zvec, const Vector3D& offset) :
+            m_inVol(inVol), m_outVol(outVol), m_xvec(xvec), m_yvec(yvec), m_zvec(zvec), m_offset(offset)
+        {
+        }
+        
+        void getRow(const int64_t& j, const int64_t& k, float* indexCoordsOut, bool* validOut) const
+        {
+            const int64_t rowLength = m_outVol->getDimensionsPtr()[0];
+            for (int64_t i = 0; i < rowLength; ++i)
+            {
+                Vector3D outCoord, inCoord;
+                m_outVol->indexToSpace(i, j, k, outCoord);
+                inCoord = m_xvec * outCoord[0] + m_yvec * outCoord[1] + m_zvec * outCoord[2] + m_offset;
+                m_inVol->spaceToIndex(inCoord, indexCoordsOut + i * 3);
+                validOut[i] = true;
+            }
+        }
+    };
+}
+
 AlgorithmVolumeAffineResample::AlgorithmVolumeAffineResample(ProgressObject* myProgObj, const VolumeFile* inVol, const FloatMatrix& myAffine,
-                                                             const int64_t refDims[3], const vector<vector<float> >& refSform, const VolumeFile::InterpType& myMethod, VolumeFile* outVol) : AbstractAlgorithm(myProgObj)
+                                                             const int64_t refDims[3], const vector<vector<float> >& refSform, const VolumeFile::InterpType& myMethod, VolumeFile* outVol) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int64_t affRows, affColumns;
@@ -137,35 +164,8 @@ AlgorithmVolumeAffineResample::AlgorithmVolumeAffineResample(ProgressObject* myP
             *(outVol->getMapLabelTable(i)) = *(inVol->getMapLabelTable(i));
         }
     }
-    for (int64_t c = 0; c < numComponents; ++c)
-    {
-        for (int64_t b = 0; b < numMaps; ++b)
-        {
-            if (myMethod == VolumeFile::CUBIC)
-            {
-                inVol->validateSpline(b, c);//because deconvolve is parallel, but won't execute parallel if we are already in a parallel section
-            }
-#pragma omp CARET_PARFOR schedule(dynamic)
-            for (int64_t k = 0; k < outDims[2]; ++k)
-            {
-                for (int64_t j = 0; j < outDims[1]; ++j)
-                {
-                    for (int64_t i = 0; i < outDims[0]; ++i)
-                    {
-                        Vector3D outCoord, inCoord;
-                        outVol->indexToSpace(i, j, k, outCoord);
-                        inCoord = xvec * outCoord[0] + yvec * outCoord[1] + zvec * outCoord[2] + offset;
-                        float interpVal = inVol->interpolateValue(inCoord, myMethod, NULL, b, c);
-                        outVol->setValue(interpVal, i, j, k, b, c);
-                    }
-                }
-            }
-            if (myMethod == VolumeFile::CUBIC)
-            {
-                inVol->freeSpline(b, c);//release memory we no longer need, if we allocated it
-            }
-        }
-    }
+    AffineMapping myMapping(inVol, outVol, xvec, yvec, zvec, offset);
+    VolumeResampler(inVol, myMethod).resample(myMapping, outVol);
 }
 
 float AlgorithmVolumeAffineResample::getAlgorithmInternalWeight()
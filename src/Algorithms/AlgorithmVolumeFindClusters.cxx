@@ -25,6 +25,7 @@
 #include "CaretLogger.h"
 #include "CaretPointer.h"
 #include "CaretPointLocator.h"
+#include "ClusterGraph.h"
 #include "VolumeFile.h"
 #include "VoxelIJK.h"
 
@@ -135,86 +136,38 @@ void AlgorithmVolumeFindClusters::useParameters(OperationParameters* myParams, P
 
 namespace
 {
-    void processSubvol(const float* inFrame, VolumeFile* volOut, const int64_t& outSubvol, const int64_t& outComponent, const float& threshValue, const float& minVolume,
+    void processSubvol(const float* inFrame, const ClusterGraph& myGraph, VolumeFile* volOut, const int64_t& outSubvol, const int64_t& outComponent, const float& threshValue, const float& minVolume,
                        const bool& lessThan, const float* roiFrame, const float& sizeRatio, const float& distanceCutoff, int& markVal)
     {
         vector<int64_t> dims = volOut->getDimensions();
-        int64_t frameSize = dims[0] * dims[1] * dims[2];
         const VolumeSpace& mySpace = volOut->getVolumeSpace();
         Vector3D ivec, jvec, kvec, origin;
         mySpace.getSpacingVectors(ivec, jvec, kvec, origin);
         float voxelVolume = abs(ivec.dot(jvec.cross(kvec)));
         int64_t minVoxels = (int64_t)ceil(minVolume / voxelVolume);
-        vector<VoxelIJK> neighbors;
-        neighbors.push_back(VoxelIJK(1, 0, 0));
-        neighbors.push_back(VoxelIJK(-1, 0, 0));
-        neighbors.push_back(VoxelIJK(0, 1, 0));
-        neighbors.push_back(VoxelIJK(0, -1, 0));
-        neighbors.push_back(VoxelIJK(0, 0, 1));
-        neighbors.push_back(VoxelIJK(0, 0, -1));
-        vector<char> marked(frameSize, 0);
-        if (lessThan)
-        {
-            for (int64_t i = 0; i < frameSize; ++i)
-            {
-                if ((roiFrame == NULL || roiFrame[i] > 0.0f) && inFrame[i] < threshValue)
-                {
-                    marked[i] = 1;
-                }
-            }
-        } else {
-            for (int64_t i = 0; i < frameSize; ++i)
-            {
-                if ((roiFrame == NULL || roiFrame[i] > 0.0f) && inFrame[i] > threshValue)
-                {
-                    marked[i] = 1;
-                }
-            }
-        }
+        vector<vector<int64_t> > foundClusters;
+        vector<double> foundVolumes;
+        myGraph.findClusters(inFrame, threshValue, lessThan, foundClusters, foundVolumes, roiFrame);//ordered by lowest index, same as scanning k, j, i
         vector<vector<VoxelIJK> > clusters;
         size_t biggestCount = 0;
         int64_t biggestCluster = -1;
-        for (int64_t k = 0; k < dims[2]; ++k)
+        for (size_t whichCluster = 0; whichCluster < foundClusters.size(); ++whichCluster)
         {
-            for (int64_t j = 0; j < dims[1]; ++j)
+            const vector<int64_t>& members = foundClusters[whichCluster];
+            if ((int64_t)members.size() >= minVoxels)
             {
-                for (int64_t i = 0; i < dims[0]; ++i)
+                if (members.size() > biggestCount)
                 {
-                    int64_t myIndex = mySpace.getIndex(i, j, k);
-                    if (marked[myIndex])
-                    {
-                        vector<VoxelIJK> voxelList;
-                        voxelList.push_back(VoxelIJK(i, j, k));
-                        marked[myIndex] = 0;//don't let voxels get duplicated in the list
-                        for (int64_t index = 0; index < (int64_t)voxelList.size(); ++index)//NOTE: vector grows inside loop
-                        {
-                            const VoxelIJK& thisVoxel = voxelList[index];
-                            for (int n = 0; n < (int)neighbors.size(); ++n)
-                            {
-                                VoxelIJK neighVox(thisVoxel.m_ijk[0] + neighbors[n].m_ijk[0],
-                                                    thisVoxel.m_ijk[1] + neighbors[n].m_ijk[1],
-                                                    thisVoxel.m_ijk[2] + neighbors[n].m_ijk[2]);
-                                if (mySpace.indexValid(neighVox.m_ijk))
-                                {
-                                    int64_t neighIndex = mySpace.getIndex(neighVox.m_ijk);
-                                    if (marked[neighIndex])
-                                    {
-                                        voxelList.push_back(neighVox);
-                                        marked[neighIndex] = 0;
-                                    }
-                                }
-                            }
-                        }
-                        if ((int64_t)voxelList.size() >= minVoxels)
-                        {
-                            if (voxelList.size() > biggestCount)
-                            {
-                                biggestCount = voxelList.size();
-                                biggestCluster = (int64_t)clusters.size();
-                            }
-                            clusters.push_back(voxelList);
-                        }
-                    }
+                    biggestCount = members.size();
+                    biggestCluster = (int64_t)clusters.size();
+                }
+                clusters.push_back(vector<VoxelIJK>());
+                vector<VoxelIJK>& voxelList = clusters.back();
+                voxelList.reserve(members.size());
+                for (size_t index = 0; index < members.size(); ++index)
+                {
+                    int64_t myIndex = members[index];
+                    voxelList.push_back(VoxelIJK(myIndex % dims[0], (myIndex / dims[0]) % dims[1], myIndex / (dims[0] * dims[1])));
                 }
             }
         }
@@ -289,7 +242,7 @@ namespace
 
 AlgorithmVolumeFindClusters::AlgorithmVolumeFindClusters(ProgressObject* myProgObj, const VolumeFile* volIn, const float& threshValue, const float& minVolume, VolumeFile* volOut,
                                                          const bool& lessThan, const VolumeFile* myRoi, const int& subvolNum, const int& startVal, int* endVal,
-                                                         const float& sizeRatio, const float& distanceCutoff) : AbstractAlgorithm(myProgObj)
+                                                         const float& sizeRatio, const float& distanceCutoff) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (startVal == 0)
@@ -304,6 +257,7 @@ AlgorithmVolumeFindClusters::AlgorithmVolumeFindClusters(ProgressObject* myProgO
         roiFrame = myRoi->getFrame();
     }
     vector<int64_t> dims = volIn->getDimensions();
+    ClusterGraph myGraph(mySpace, ClusterGraph::FACE);
     int markVal = startVal;
     if (subvolNum == -1)
     {
@@ -314,7 +268,7 @@ AlgorithmVolumeFindClusters::AlgorithmVolumeFindClusters(ProgressObject* myProgO
             for (int64_t s = 0; s < dims[3]; ++s)
             {
                 const float* inFrame = volIn->getFrame(s, c);
-                processSubvol(inFrame, volOut, s, c, threshValue, minVolume, lessThan, roiFrame, sizeRatio, distanceCutoff, markVal);
+                processSubvol(inFrame, myGraph, volOut, s, c, threshValue, minVolume, lessThan, roiFrame, sizeRatio, distanceCutoff, markVal);
             }
         }
     } else {
@@ -325,7 +279,7 @@ AlgorithmVolumeFindClusters::AlgorithmVolumeFindClusters(ProgressObject* myProgO
         for (int64_t c = 0; c < dims[4]; ++c)
         {
             const float* inFrame = volIn->getFrame(subvolNum, c);
-            processSubvol(inFrame, volOut, 0, c, threshValue, minVolume, lessThan, roiFrame, sizeRatio, distanceCutoff, markVal);
+            processSubvol(inFrame, myGraph, volOut, 0, c, threshValue, minVolume, lessThan, roiFrame, sizeRatio, distanceCutoff, markVal);
         }
     }
     if (endVal != NULL) *endVal = markVal;
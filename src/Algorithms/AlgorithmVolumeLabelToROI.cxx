@@ -107,7 +107,7 @@ void AlgorithmVolumeLabelToROI::useParameters(OperationParameters* myParams, Pro
     }
 }
 
-AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj, const VolumeFile* myLabel, const AString& labelName, VolumeFile* myVolumeOut, const int& whichMap) : AbstractAlgorithm(myProgObj)
+AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj, const VolumeFile* myLabel, const AString& labelName, VolumeFile* myVolumeOut, const int& whichMap) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numMaps = myLabel->getNumberOfMaps();
@@ -127,6 +127,7 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
     }
     int64_t frameSize = dims[0] * dims[1] * dims[2];
     vector<float> scratchFrame(frameSize);
+    vector<int32_t> keyFrame(frameSize);//integer label volumes are never converted to float
     if (whichMap == -1)
     {
         myVolumeOut->reinitialize(origDims, myLabel->getSform());
@@ -143,10 +144,10 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
                     scratchFrame[i] = 0.0f;
                 }
             } else {
-                const float* labelFrame = myLabel->getFrame(thisMap);
+                myLabel->getFrameRounded(keyFrame.data(), thisMap);
                 for (int64_t i = 0; i < frameSize; ++i)
                 {
-                    int thisKey = (int)floor(labelFrame[i] + 0.5f);
+                    int thisKey = keyFrame[i];
                     if (thisKey == matchKey)
                     {
                         scratchFrame[i] = 1.0f;
@@ -171,11 +172,11 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
         {
             throw AlgorithmException("label name '" + labelName + "' not found in specified map");
         }
-        const float* labelFrame = myLabel->getFrame(whichMap);
+        myLabel->getFrameRounded(keyFrame.data(), whichMap);
         bool shouldThrow = true;
         for (int64_t i = 0; i < frameSize; ++i)
         {
-            int thisKey = (int)floor(labelFrame[i] + 0.5f);
+            int thisKey = keyFrame[i];
             if (thisKey == matchKey)
             {
                 scratchFrame[i] = 1.0f;
@@ -192,7 +193,7 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
     }
 }
 
-AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj, const VolumeFile* myLabel, const int32_t& labelKey, VolumeFile* myVolumeOut, const int& whichMap) : AbstractAlgorithm(myProgObj)
+AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj, const VolumeFile* myLabel, const int32_t& labelKey, VolumeFile* myVolumeOut, const int& whichMap) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     int numMaps = myLabel->getNumberOfMaps();
@@ -212,6 +213,7 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
     }
     int64_t frameSize = dims[0] * dims[1] * dims[2];
     vector<float> scratchFrame(frameSize);
+    vector<int32_t> keyFrame(frameSize);
     if (whichMap == -1)
     {
         myVolumeOut->reinitialize(origDims, myLabel->getSform());
@@ -223,10 +225,10 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
             {
                 CaretLogWarning("label key " + AString::number(labelKey) + " not found in map #" + AString::number(thisMap + 1));
             }
-            const float* labelFrame = myLabel->getFrame(thisMap);//try anyway, in case label table is incomplete
+            myLabel->getFrameRounded(keyFrame.data(), thisMap);//try anyway, in case label table is incomplete
             for (int64_t i = 0; i < frameSize; ++i)
             {
-                int thisKey = (int)floor(labelFrame[i] + 0.5f);
+                int thisKey = keyFrame[i];
                 if (thisKey == labelKey)
                 {
                     scratchFrame[i] = 1.0f;
@@ -249,11 +251,11 @@ AlgorithmVolumeLabelToROI::AlgorithmVolumeLabelToROI(ProgressObject* myProgObj,
         {
             CaretLogWarning("label key " + AString::number(labelKey) + " not found in specified map");
         }
-        const float* labelFrame = myLabel->getFrame(whichMap);
+        myLabel->getFrameRounded(keyFrame.data(), whichMap);
         bool shouldThrow = true;
         for (int64_t i = 0; i < frameSize; ++i)
         {
-            int thisKey = (int)floor(labelFrame[i] + 0.5f);
+            int thisKey = keyFrame[i];
             if (thisKey == labelKey)
             {
                 scratchFrame[i] = 1.0f;
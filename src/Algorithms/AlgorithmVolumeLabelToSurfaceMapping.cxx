@@ -122,7 +122,7 @@ void AlgorithmVolumeLabelToSurfaceMapping::useParameters(OperationParameters* my
 }
 
 AlgorithmVolumeLabelToSurfaceMapping::AlgorithmVolumeLabelToSurfaceMapping(ProgressObject* myProgObj, const VolumeFile* myVolume, const SurfaceFile* mySurface,
-                                                                           LabelFile* myLabelOut, const int64_t& mySubVol) : AbstractAlgorithm(myProgObj)
+                                                                           LabelFile* myLabelOut, const int64_t& mySubVol) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (myVolume->getType() != SubvolumeAttributes::LABEL)
@@ -199,7 +199,7 @@ AlgorithmVolumeLabelToSurfaceMapping::AlgorithmVolumeLabelToSurfaceMapping(Progr
 AlgorithmVolumeLabelToSurfaceMapping::AlgorithmVolumeLabelToSurfaceMapping(ProgressObject* myProgObj, const VolumeFile* myVolume, const SurfaceFile* mySurface, LabelFile* myLabelOut,
                                                                            const SurfaceFile* innerSurf, const SurfaceFile* outerSurf,
                                                                            const VolumeFile* myRoiVol, const int32_t& subdivisions, const bool& thinColumns,
-                                                                           const int64_t& mySubVol): AbstractAlgorithm(myProgObj)
+                                                                           const int64_t& mySubVol): AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     if (myVolume->getType() != SubvolumeAttributes::LABEL)
@@ -81,7 +81,7 @@ void AlgorithmVolumeReduce::useParameters(OperationParameters* myParams, Progres
     }
 }
 
-AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const VolumeFile* volumeIn, const ReductionEnum::Enum& myReduce, VolumeFile* volumeOut, const bool& onlyNumeric) : AbstractAlgorithm(myProgObj)
+AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const VolumeFile* volumeIn, const ReductionEnum::Enum& myReduce, VolumeFile* volumeOut, const bool& onlyNumeric) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     vector<int64_t> myDims, newDims = volumeIn->getOriginalDimensions();
@@ -95,6 +95,7 @@ AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const Vo
     }
     int64_t frameSize = myDims[0] * myDims[1] * myDims[2];
     vector<float> scratchArray(myDims[3]), outFrame(frameSize);
+    ReductionOperation::Scratch reduceWork;//reused across voxels
     for (int c = 0; c < myDims[4]; ++c)
     {
         for (int64_t i = 0; i < frameSize; ++i)
@@ -106,16 +107,16 @@ AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const Vo
             }
             if (onlyNumeric)
             {
-                outFrame[i] = ReductionOperation::reduceOnlyNumeric(scratchArray.data(), myDims[3], myReduce);
+                outFrame[i] = ReductionOperation::reduceOnlyNumeric(scratchArray.data(), myDims[3], myReduce, &reduceWork);
             } else {
-                outFrame[i] = ReductionOperation::reduce(scratchArray.data(), myDims[3], myReduce);
+                outFrame[i] = ReductionOperation::reduce(scratchArray.data(), myDims[3], myReduce, &reduceWork);
             }
         }
         volumeOut->setFrame(outFrame.data(), 0, c);
     }
 }
 
-AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const VolumeFile* volumeIn, const ReductionEnum::Enum& myReduce, VolumeFile* volumeOut, const float& sigmaBelow, const float& sigmaAbove) : AbstractAlgorithm(myProgObj)
+AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const VolumeFile* volumeIn, const ReductionEnum::Enum& myReduce, VolumeFile* volumeOut, const float& sigmaBelow, const float& sigmaAbove) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     vector<int64_t> myDims, newDims = volumeIn->getOriginalDimensions();
@@ -129,6 +130,7 @@ AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const Vo
     }
     int64_t frameSize = myDims[0] * myDims[1] * myDims[2];
     vector<float> scratchArray(myDims[3]), outFrame(frameSize);
+    ReductionOperation::Scratch reduceWork;//reused across voxels
     for (int c = 0; c < myDims[4]; ++c)
     {
         for (int64_t i = 0; i < frameSize; ++i)
@@ -138,7 +140,7 @@ AlgorithmVolumeReduce::AlgorithmVolumeReduce(ProgressObject* myProgObj, const Vo
                 const float* tempFrame = volumeIn->getFrame(b, c);
                 scratchArray[b] = tempFrame[i];
             }
-            outFrame[i] = ReductionOperation::reduceExcludeDev(scratchArray.data(), myDims[3], myReduce, sigmaBelow, sigmaAbove);
+            outFrame[i] = ReductionOperation::reduceExcludeDev(scratchArray.data(), myDims[3], myReduce, sigmaBelow, sigmaAbove, &reduceWork);
         }
         volumeOut->setFrame(outFrame.data(), 0, c);
     }
@@ -22,9 +22,9 @@
 #include "AlgorithmException.h"
 
 #include "CaretLogger.h"
-#include "CaretOMP.h"
 #include "NiftiIO.h"
 #include "Vector3D.h"
+#include "VolumeResampler.h"
 #include "WarpfieldFile.h"
 
 using namespace caret;
@@ -98,8 +98,44 @@ void AlgorithmVolumeWarpfieldResample::useParameters(OperationParameters* myPara
     AlgorithmVolumeWarpfieldResample(myProgObj, inVol, myWarpfield.getWarpfield(), refDims.data(), refSpaceIO.getHeader().getSForm(), myMethod, outVol);
 }
 
+namespace
+{
+    class WarpfieldMapping : public VolumeResampler::SampleMapping
+    {
+        const VolumeFile* m_inVol, * m_outVol, * m_warpfield;
+    public:
+        WarpfieldMapping(const VolumeFile* inVol, const VolumeFile* outVol, const VolumeFile* warpfield) : m_inVol(inVol), m_outVol(outVol), m_warpfield(warpfield)
+        {
+        }
+        
+        void getRow(const int64_t& j, const int64_t& k, float* indexCoordsOut, bool* validOut) const
+        {//displacement is looked up once per voxel, rather than once per voxel per frame
+            const int64_t rowLength = m_outVol->getDimensionsPtr()[0];
+            for (int64_t i = 0; i < rowLength; ++i)
+            {
+                Vector3D outCoord, inCoord, displacement;
+                m_outVol->indexToSpace(i, j, k, outCoord);
+                bool validDisplacement = false;
+                displacement[0] = m_warpfield->interpolateValue(outCoord, VolumeFile::TRILINEAR, &validDisplacement, 0);
+                validOut[i] = validDisplacement;
+                if (validDisplacement)
+                {
+                    displacement[1] = m_warpfield->interpolateValue(outCoord, VolumeFile::TRILINEAR, NULL, 1);
+                    displacement[2] = m_warpfield->interpolateValue(outCoord, VolumeFile::TRILINEAR, NULL, 2);
+                    inCoord = outCoord + displacement;
+                    m_inVol->spaceToIndex(inCoord, indexCoordsOut + i * 3);
+                } else {
+                    indexCoordsOut[i * 3] = 0.0f;
+                    indexCoordsOut[i * 3 + 1] = 0.0f;
+                    indexCoordsOut[i * 3 + 2] = 0.0f;
+                }
+            }
+        }
+    };
+}
+
 AlgorithmVolumeWarpfieldResample::AlgorithmVolumeWarpfieldResample(ProgressObject* myProgObj, const VolumeFile* inVol, const VolumeFile* warpfield,
-                                                                   const int64_t refDims[3], const vector<vector<float> >& refSform, const VolumeFile::InterpType& myMethod, VolumeFile* outVol) : AbstractAlgorithm(myProgObj)
+                                                                   const int64_t refDims[3], const vector<vector<float> >& refSform, const VolumeFile::InterpType& myMethod, VolumeFile* outVol) : AbstractAlgorithm(myProgObj, getCommandSwitch())
 {
     LevelProgress myProgress(myProgObj);
     vector<int64_t> warpDims;
@@ -123,44 +159,8 @@ AlgorithmVolumeWarpfieldResample::AlgorithmVolumeWarpfieldResample(ProgressObjec
             *(outVol->getMapLabelTable(i)) = *(inVol->getMapLabelTable(i));
         }
     }
-    for (int64_t c = 0; c < numComponents; ++c)
-    {
-        for (int64_t b = 0; b < numMaps; ++b)
-        {
-            if (myMethod == VolumeFile::CUBIC)
-            {
-                inVol->validateSpline(b, c);//because deconvolve is parallel, but won't execute parallel if we are already in a parallel section
-            }
-#pragma omp CARET_PARFOR schedule(dynamic)
-            for (int64_t k = 0; k < outDims[2]; ++k)
-            {
-                for (int64_t j = 0; j < outDims[1]; ++j)
-                {
-                    for (int64_t i = 0; i < outDims[0]; ++i)
-                    {
-                        Vector3D outCoord, inCoord, displacement;
-                        outVol->indexToSpace(i, j, k, outCoord);
-                        bool validDisplacement = false;
-                        displacement[0] = warpfield->interpolateValue(outCoord, VolumeFile::TRILINEAR, &validDisplacement, 0);
-                        if (validDisplacement)
-                        {
-                            displacement[1] = warpfield->interpolateValue(outCoord, VolumeFile::TRILINEAR, NULL, 1);
-                            displacement[2] = warpfield->interpolateValue(outCoord, VolumeFile::TRILINEAR, NULL, 2);
-                            inCoord = outCoord + displacement;
-                            float interpVal = inVol->interpolateValue(inCoord, myMethod, NULL, b, c);
-                            outVol->setValue(interpVal, i, j, k, b, c);
-                        } else {
-                            outVol->setValue(VolumeFile::INVALID_INTERP_VALUE, i, j, k, b, c);
-                        }
-                    }
-                }
-            }
-            if (myMethod == VolumeFile::CUBIC)
-            {
-                inVol->freeSpline(b, c);//release memory we no longer need, if we allocated it
-            }
-        }
-    }
+    WarpfieldMapping myMapping(inVol, outVol, warpfield);
+    VolumeResampler(inVol, myMethod).resample(myMapping, outVol);
 }
 
 float AlgorithmVolumeWarpfieldResample::getAlgorithmInternalWeight()
@@ -45,6 +45,7 @@
 #include "CiftiConnectivityMatrixDenseFile.h"
 #include "CiftiConnectivityMatrixDenseDynamicFile.h"
 #include "CiftiConnectivityMatrixDenseParcelFile.h"
+#include "CiftiConnectivityMatrixDenseSparseFile.h"
 #include "CiftiFiberOrientationFile.h"
 #include "CiftiFiberTrajectoryFile.h"
 #include "CiftiConnectivityMatrixParcelFile.h"
@@ -540,6 +541,14 @@ Brain::resetBrain(const ResetBrainKeepSceneFiles keepSceneFiles,
     }
     m_connectivityDenseScalarFiles.clear();
     
+    for (std::vector<CiftiConnectivityMatrixDenseSparseFile*>::iterator clfi = m_connectivityMatrixDenseSparseFiles.begin();
+         clfi != m_connectivityMatrixDenseSparseFiles.end();
+         clfi++) {
+        CiftiConnectivityMatrixDenseSparseFile* clf = *clfi;
+        delete clf;
+    }
+    m_connectivityMatrixDenseSparseFiles.clear();
+    
     for (std::vector<CiftiParcelSeriesFile*>::iterator clfi = m_connectivityParcelSeriesFiles.begin();
          clfi != m_connectivityParcelSeriesFiles.end();
          clfi++) {
@@ -716,6 +725,8 @@ Brain::resetBrainKeepSceneFiles()
                 break;
             case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
                 break;
+            case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                break;
             case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                 break;
             case DataFileTypeEnum::CONNECTIVITY_FIBER_ORIENTATIONS_TEMPORARY:
@@ -2214,6 +2225,88 @@ Brain::addReadOrReloadConnectivityDenseScalarFile(const FileModeAddReadReload fi
     return clf;
 }
 
+/**
+ * Read a connectivity matrix dense sparse file.
+ *
+ * @param fileMode
+ *    Mode for file adding, reading, or reloading.
+ * @param caretDataFile
+ *    File that is added or reloaded (MUST NOT BE NULL).  If NULL,
+ *    the mode must be READING.
+ * @param filename
+ *    Name of the file.
+ * @return
+ *    File that was read.
+ * @throws DataFileException
+ *    If reading failed.
+ */
+CiftiConnectivityMatrixDenseSparseFile*
+Brain::addReadOrReloadConnectivityMatrixDenseSparseFile(const FileModeAddReadReload fileMode,
+                                                        CaretDataFile* caretDataFile,
+                                                        const AString& filename)
+{
+    CiftiConnectivityMatrixDenseSparseFile* cmdf = NULL;
+    if (caretDataFile != NULL) {
+        cmdf = dynamic_cast<CiftiConnectivityMatrixDenseSparseFile*>(caretDataFile);
+        CaretAssert(cmdf);
+    }
+    else {
+        cmdf = new CiftiConnectivityMatrixDenseSparseFile();
+    }
+    
+    bool addFlag  = false;
+    bool readFlag = false;
+    switch (fileMode) {
+        case FILE_MODE_ADD:
+            addFlag = true;
+            break;
+        case FILE_MODE_READ:
+            addFlag = true;
+            readFlag = true;
+            break;
+        case FILE_MODE_RELOAD:
+            readFlag = true;
+            break;
+    }
+    
+    if (readFlag) {
+        try {
+            try {
+                cmdf->readFile(filename);
+            }
+            catch (const std::bad_alloc&) {
+                /*
+                 * This DataFileException will be caught
+                 * in the outer try/catch and it will
+                 * clean up to avoid memory leaks.
+                 */
+                throw DataFileException(filename,
+                                        CaretDataFileHelper::createBadAllocExceptionMessage(filename));
+            }
+            
+            cmdf->clearModified();
+            validateCiftiMappableDataFile(cmdf);
+        }
+        catch (const DataFileException& dfe) {
+            if (caretDataFile != NULL) {
+                removeAndDeleteDataFile(caretDataFile);
+            }
+            else {
+                delete cmdf;
+            }
+            throw dfe;
+        }
+    }
+    
+    if (addFlag) {
+        updateDataFileNameIfDuplicate(m_connectivityMatrixDenseSparseFiles,
+                                      cmdf);
+        m_connectivityMatrixDenseSparseFiles.push_back(cmdf);
+    }
+    
+    return cmdf;
+}
+
 /**
  * Read a connectivity parcel data series file.
  *
@@ -3264,6 +3357,17 @@ Brain::getConnectivityMatrixDenseFiles(std::vector<CiftiConnectivityMatrixDenseF
     connectivityDenseFilesOut = m_connectivityMatrixDenseFiles;
 }
 
+/**
+ * Get ALL connectivity matrix dense sparse files.
+ * @param connectivityDenseSparseFilesOut
+ *   Contains all connectivity dense sparse files on exit.
+ */
+void
+Brain::getConnectivityMatrixDenseSparseFiles(std::vector<CiftiConnectivityMatrixDenseSparseFile*>& connectivityDenseSparseFilesOut) const
+{
+    connectivityDenseSparseFilesOut = m_connectivityMatrixDenseSparseFiles;
+}
+
 /**
  * Get ALL connectivity matrix dense dynamic files.
  * @param connectivityDenseDynamicFilesOut
@@ -4137,6 +4241,13 @@ Brain::addDataFile(CaretDataFile* caretDataFile)
                     m_connectivityDenseScalarFiles.push_back(file);
                 }
                     break;
+                case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                {
+                    CiftiConnectivityMatrixDenseSparseFile* file = dynamic_cast<CiftiConnectivityMatrixDenseSparseFile*>(caretDataFile);
+                    CaretAssert(file);
+                    m_connectivityMatrixDenseSparseFiles.push_back(file);
+                }
+                    break;
                 case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                 {
                     CiftiBrainordinateDataSeriesFile* file = dynamic_cast<CiftiBrainordinateDataSeriesFile*>(caretDataFile);
@@ -4999,6 +5110,11 @@ Brain::addReadOrReloadDataFile(const FileModeAddReadReload fileMode,
                                                                     caretDataFile,
                                                                         dataFileName);
                 break;
+            case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                caretDataFileRead  = addReadOrReloadConnectivityMatrixDenseSparseFile(fileMode,
+                                                                          caretDataFile,
+                                                                          dataFileName);
+                break;
             case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                 caretDataFileRead  = addReadOrReloadConnectivityDataSeriesFile(fileMode,
                                                                    caretDataFile,
@@ -6154,6 +6270,10 @@ Brain::getAllDataFiles(std::vector<CaretDataFile*>& allDataFilesOut,
                            m_connectivityMatrixDenseFiles.begin(),
                            m_connectivityMatrixDenseFiles.end());
     
+    allDataFilesOut.insert(allDataFilesOut.end(),
+                           m_connectivityMatrixDenseSparseFiles.begin(),
+                           m_connectivityMatrixDenseSparseFiles.end());
+    
 //    allDataFilesOut.insert(allDataFilesOut.end(),
 //                           m_connectivityDataSeriesFiles.begin(),
 //                           m_connectivityDataSeriesFiles.end());
@@ -6402,6 +6522,8 @@ Brain::writeDataFile(CaretDataFile* caretDataFile)
             break;
         case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
             break;
+        case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+            break;
         case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
             break;
         case DataFileTypeEnum::CONNECTIVITY_FIBER_ORIENTATIONS_TEMPORARY:
@@ -6572,6 +6694,14 @@ Brain::removeWithoutDeleteDataFilePrivate(const CaretDataFile* caretDataFile)
         return true;
     }
     
+    std::vector<CiftiConnectivityMatrixDenseSparseFile*>::iterator connDenseSparseIterator = std::find(m_connectivityMatrixDenseSparseFiles.begin(),
+                                                                                                       m_connectivityMatrixDenseSparseFiles.end(),
+                                                                                                       caretDataFile);
+    if (connDenseSparseIterator != m_connectivityMatrixDenseSparseFiles.end()) {
+        m_connectivityMatrixDenseSparseFiles.erase(connDenseSparseIterator);
+        return true;
+    }
+    
     std::vector<CiftiParcelSeriesFile*>::iterator connParcelSeriesIterator = std::find(m_connectivityParcelSeriesFiles.begin(),
                                                                                        m_connectivityParcelSeriesFiles.end(),
                                                                                        caretDataFile);
@@ -56,6 +56,7 @@ namespace caret {
     class CiftiConnectivityMatrixDenseFile;
     class CiftiConnectivityMatrixDenseDynamicFile;
     class CiftiConnectivityMatrixDenseParcelFile;
+    class CiftiConnectivityMatrixDenseSparseFile;
     class CiftiConnectivityMatrixParcelFile;
     class CiftiConnectivityMatrixParcelDenseFile;
     class CiftiFiberOrientationFile;
@@ -211,6 +212,8 @@ namespace caret {
         
         void getConnectivityMatrixDenseDynamicFiles(std::vector<CiftiConnectivityMatrixDenseDynamicFile*>& connectivityDenseDynamicFilesOut) const;
         
+        void getConnectivityMatrixDenseSparseFiles(std::vector<CiftiConnectivityMatrixDenseSparseFile*>& connectivityDenseSparseFilesOut) const;
+        
         int32_t getNumberOfConnectivityDenseLabelFiles() const;
         
         CiftiBrainordinateLabelFile* getConnectivityDenseLabelFile(int32_t indx);
@@ -627,6 +630,10 @@ namespace caret {
                                                                       CaretDataFile* caretDataFile,
                                                                       const AString& filename);
         
+        CiftiConnectivityMatrixDenseSparseFile* addReadOrReloadConnectivityMatrixDenseSparseFile(const FileModeAddReadReload fileMode,
+                                                                                      CaretDataFile* caretDataFile,
+                                                                                      const AString& filename);
+        
         CiftiParcelLabelFile* addReadOrReloadConnectivityParcelLabelFile(const FileModeAddReadReload fileMode,
                                                                 CaretDataFile* caretDataFile,
                                                                 const AString& filename);
@@ -723,6 +730,8 @@ namespace caret {
         
         std::vector<CiftiBrainordinateScalarFile*> m_connectivityDenseScalarFiles;
         
+        std::vector<CiftiConnectivityMatrixDenseSparseFile*> m_connectivityMatrixDenseSparseFiles;
+        
         std::vector<CiftiParcelLabelFile*> m_connectivityParcelLabelFiles;
         
         std::vector<CiftiParcelSeriesFile*> m_connectivityParcelSeriesFiles;
@@ -52,6 +52,7 @@ BrainOpenGL::BrainOpenGL(BrainOpenGLTextRenderInterface* textRenderer)
     m_textRenderer = textRenderer;
     this->borderBeingDrawn = NULL;
     m_drawHighlightedEndPoints = false;
+    m_reuseUnchangedTabImages = false;
 }
 
 /**
@@ -157,6 +158,31 @@ BrainOpenGL::setDrawHighlightedEndPoints(const bool drawHighlightedEndPoints)
     m_drawHighlightedEndPoints = drawHighlightedEndPoints;
 }
 
+/**
+ * @return Should tile tabs whose graphics content key is unchanged
+ * be drawn from the image saved when they were last drawn?
+ */
+bool
+BrainOpenGL::isReuseUnchangedTabImages() const
+{
+    return m_reuseUnchangedTabImages;
+}
+
+/**
+ * Set tile tabs whose graphics content key is unchanged should be
+ * drawn from the image saved when they were last drawn.  This must
+ * only be set when all changes since the last drawing are covered by
+ * BrowserTabContent::getGraphicsContentKey().
+ *
+ * @param reuseUnchangedTabImages
+ *    New status.
+ */
+void
+BrainOpenGL::setReuseUnchangedTabImages(const bool reuseUnchangedTabImages)
+{
+    m_reuseUnchangedTabImages = reuseUnchangedTabImages;
+}
+
 /**
  * Determine if the given version of OpenGL is supported at runtime.
  * OpenGL is continually updated and this method is used to test for 
@@ -169,6 +169,10 @@ namespace caret {
         
         void setDrawHighlightedEndPoints(const bool drawHighlightedEndPoints);
         
+        bool isReuseUnchangedTabImages() const;
+        
+        void setReuseUnchangedTabImages(const bool reuseUnchangedTabImages);
+        
         void getBackgroundColor(uint8_t backgroundColor[3]) const;
         
         static void getMinMaxPointSize(float& minPointSizeOut, float& maxPointSizeOut);
@@ -237,6 +241,9 @@ namespace caret {
         
         bool m_drawHighlightedEndPoints;
         
+        /** Tile tabs whose content is unchanged may be drawn from their previous image */
+        bool m_reuseUnchangedTabImages;
+        
         uint8_t m_foregroundColorByte[4];
         float m_foregroundColorFloat[4];
 
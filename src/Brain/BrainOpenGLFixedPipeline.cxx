@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <limits>
 #include <cmath>
+#include <set>
 
 #include <QStringList>
 #include <QImage>
@@ -94,6 +95,7 @@
 #include "Fiber.h"
 #include "FiberOrientation.h"
 #include "FiberOrientationTrajectory.h"
+#include "FnvHash.h"
 #include "FiberTrajectoryMapProperties.h"
 #include "FociFile.h"
 #include "Focus.h"
@@ -450,6 +452,140 @@ BrainOpenGLFixedPipeline::setTabViewport(const BrainOpenGLViewportContent* vpCon
     }
 }
 
+/**
+ * Get the key for the content of a tile tab.  It combines the graphics
+ * content key of the tab with the tab's viewport, highlighting, and
+ * colors.  Must be called after the tab viewport and colors are set.
+ *
+ * @param vpContent
+ *     Content of the tab's viewport.
+ * @return
+ *     Key for the image of the tab.
+ */
+uint64_t
+BrainOpenGLFixedPipeline::getTabImageContentKey(BrainOpenGLViewportContent* vpContent) const
+{
+    BrowserTabContent* btc = vpContent->getBrowserTabContent();
+    const uint64_t tabKey = ((btc != NULL)
+                             ? btc->getGraphicsContentKey()
+                             : 0);
+    
+    FnvHash hash;
+    hash.add(tabKey);
+    hash.addBytes(m_tabViewport, 4 * sizeof(int));
+    hash.add(vpContent->isTabHighlighted());
+    hash.addBytes(m_backgroundColorByte, 3 * sizeof(m_backgroundColorByte[0]));
+    hash.addBytes(m_foregroundColorByte, 3 * sizeof(m_foregroundColorByte[0]));
+    
+    return hash.getHash();
+}
+
+/**
+ * If the image saved for a tile tab matches the tab's current content
+ * and reuse of images is enabled, draw the image into the tab viewport.
+ *
+ * @param tabIndex
+ *     Index of the tab.
+ * @param contentKey
+ *     Key for the current content of the tab.
+ * @return
+ *     True if the saved image was drawn, else false and the
+ *     tab must be drawn.
+ */
+bool
+BrainOpenGLFixedPipeline::drawSavedTabImage(const int32_t tabIndex,
+                                            const uint64_t contentKey)
+{
+    if ( ! m_reuseUnchangedTabImages) {
+        return false;
+    }
+    std::map<int32_t, TabImage>::const_iterator iter = m_tabImages.find(tabIndex);
+    if (iter == m_tabImages.end()) {
+        return false;
+    }
+    const TabImage& tabImage = iter->second;
+    if ((tabImage.m_contentKey != contentKey)
+        || tabImage.m_rgba.empty()) {
+        return false;
+    }
+    
+    const int width  = tabImage.m_viewport[2];
+    const int height = tabImage.m_viewport[3];
+    glViewport(tabImage.m_viewport[0],
+               tabImage.m_viewport[1],
+               width,
+               height);
+    
+    glPushAttrib(GL_ENABLE_BIT);
+    glDisable(GL_DEPTH_TEST);
+    glDisable(GL_BLEND);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_TEXTURE_2D);
+    
+    glMatrixMode(GL_PROJECTION);
+    glPushMatrix();
+    glLoadIdentity();
+    glOrtho(0.0, width, 0.0, height, -1.0, 1.0);
+    glMatrixMode(GL_MODELVIEW);
+    glPushMatrix();
+    glLoadIdentity();
+    
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glRasterPos2i(0, 0);
+    glDrawPixels(width, height,
+                 GL_RGBA, GL_UNSIGNED_BYTE,
+                 (GLvoid*)&tabImage.m_rgba[0]);
+    glPopClientAttrib();
+    
+    glPopMatrix();
+    glMatrixMode(GL_PROJECTION);
+    glPopMatrix();
+    glMatrixMode(GL_MODELVIEW);
+    
+    glPopAttrib();
+    
+    return true;
+}
+
+/**
+ * Save the pixels of a tile tab that was just drawn so that the
+ * tab may be drawn from the image while its content is unchanged.
+ *
+ * @param tabIndex
+ *     Index of the tab.
+ * @param contentKey
+ *     Key for the content of the tab.
+ */
+void
+BrainOpenGLFixedPipeline::saveTabImage(const int32_t tabIndex,
+                                       const uint64_t contentKey)
+{
+    if ((m_tabViewport[2] <= 0)
+        || (m_tabViewport[3] <= 0)) {
+        m_tabImages.erase(tabIndex);
+        return;
+    }
+    
+    TabImage& tabImage = m_tabImages[tabIndex];
+    tabImage.m_contentKey = contentKey;
+    for (int32_t i = 0; i < 4; i++) {
+        tabImage.m_viewport[i] = m_tabViewport[i];
+    }
+    tabImage.m_rgba.resize(static_cast<int64_t>(m_tabViewport[2]) * m_tabViewport[3] * 4);
+    
+    glPushClientAttrib(GL_CLIENT_PIXEL_STORE_BIT);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(m_tabViewport[0],
+                 m_tabViewport[1],
+                 m_tabViewport[2],
+                 m_tabViewport[3],
+                 GL_RGBA,
+                 GL_UNSIGNED_BYTE,
+                 (GLvoid*)&tabImage.m_rgba[0]);
+    glPopClientAttrib();
+}
+
 /**
  * Get colorbars in window space.
  *
@@ -546,6 +682,15 @@ BrainOpenGLFixedPipeline::drawModels(Brain* brain,
     
     this->checkForOpenGLError(NULL, "At middle of drawModels()");
     
+    /*
+     * Images of tabs are only kept for tile tabs since
+     * there is nothing to reuse with a single tab
+     */
+    if ( ! m_tileTabsActiveFlag) {
+        m_tabImages.clear();
+    }
+    std::set<int32_t> drawnTabIndices;
+    
     for (int32_t i = 0; i < static_cast<int32_t>(viewportContents.size()); i++) {
         /*
          * Viewport of window.
@@ -559,6 +704,20 @@ BrainOpenGLFixedPipeline::drawModels(Brain* brain,
          */
         updateForegroundAndBackgroundColors(vpContent);
         
+        /*
+         * In tile tabs, a tab whose content is unchanged since
+         * it was last drawn is drawn from its saved image
+         */
+        uint64_t tabImageContentKey = 0;
+        if (m_tileTabsActiveFlag) {
+            drawnTabIndices.insert(vpContent->getTabIndex());
+            tabImageContentKey = getTabImageContentKey(vpContent);
+            if (drawSavedTabImage(vpContent->getTabIndex(),
+                                  tabImageContentKey)) {
+                continue;
+            }
+        }
+        
         /*
          * If this is NOT the first viewport content,
          * AND the background color for this viewport content is 
@@ -664,6 +823,24 @@ BrainOpenGLFixedPipeline::drawModels(Brain* brain,
             
             glMatrixMode(GL_MODELVIEW);
         }
+        
+        if (m_tileTabsActiveFlag) {
+            saveTabImage(vpContent->getTabIndex(),
+                         tabImageContentKey);
+        }
+    }
+    
+    /*
+     * Discard images of tabs that are no longer displayed
+     */
+    std::map<int32_t, TabImage>::iterator tabImageIter = m_tabImages.begin();
+    while (tabImageIter != m_tabImages.end()) {
+        if (drawnTabIndices.find(tabImageIter->first) == drawnTabIndices.end()) {
+            m_tabImages.erase(tabImageIter++);
+        }
+        else {
+            ++tabImageIter;
+        }
     }
     
     if ( ! viewportContents.empty()) {
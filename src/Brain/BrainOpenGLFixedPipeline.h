@@ -22,7 +22,9 @@
  */
 /*LICENSE_END*/
 
+#include <map>
 #include <stdint.h>
+#include <vector>
 
 #include "BrainConstants.h"
 #include "BrainOpenGL.h"
@@ -167,6 +169,13 @@ namespace caret {
             StructureEnum::Enum structure;
         };
         
+        /** Pixels of a tile tab saved for drawing it again while its content is unchanged */
+        struct TabImage {
+            uint64_t m_contentKey;
+            int m_viewport[4];
+            std::vector<uint8_t> m_rgba;
+        };
+        
         void setFiberOrientationDisplayInfo(const DisplayPropertiesFiberOrientation* dpfo,
                                             const DisplayGroupEnum::Enum displayGroup,
                                             const int32_t tabIndex,
@@ -505,6 +514,14 @@ namespace caret {
         
         void setTabViewport(const BrainOpenGLViewportContent* vpContent);
         
+        uint64_t getTabImageContentKey(BrainOpenGLViewportContent* vpContent) const;
+        
+        bool drawSavedTabImage(const int32_t tabIndex,
+                               const uint64_t contentKey);
+        
+        void saveTabImage(const int32_t tabIndex,
+                          const uint64_t contentKey);
+        
         void setAnnotationColorBarsForDrawing(std::vector<BrainOpenGLViewportContent*>& viewportContents);
         
         /** Index of window */
@@ -566,6 +583,9 @@ namespace caret {
         /** Tile tabs active */
         bool m_tileTabsActiveFlag;
         
+        /** Images of tile tabs from their last drawing, indexed by tab */
+        std::map<int32_t, TabImage> m_tabImages;
+        
         /** Sphere symbol */
         BrainOpenGLShapeSphere* m_shapeSphere;
         
@@ -40,6 +40,8 @@
 #include "CaretPreferences.h"
 #include "ChartableMatrixInterface.h"
 #include "ChartModelDataSeries.h"
+#include "ChartModelFrequencySeries.h"
+#include "ChartModelTimeSeries.h"
 #include "CiftiBrainordinateDataSeriesFile.h"
 #include "CiftiConnectivityMatrixDenseDynamicFile.h"
 #include "ClippingPlaneGroup.h"
@@ -54,6 +56,7 @@
 #include "EventIdentificationHighlightLocation.h"
 #include "EventModelGetAll.h"
 #include "EventManager.h"
+#include "FnvHash.h"
 #include "FociFile.h"
 #include "IdentificationManager.h"
 #include "LabelFile.h"
@@ -1734,6 +1737,140 @@ BrowserTabContent::getViewingTransformation() const
 }
 
 
+/**
+ * Get a key for the state of this tab that affects the drawing of
+ * its model: the displayed model, the model's overlays, the viewing
+ * transformations, the volume slice settings, and the selected chart
+ * type, lines, or matrix file.  When the key is
+ * unchanged after a change that only affects this kind of state,
+ * graphics previously drawn for the tab may be reused.
+ *
+ * Palettes, annotations, display properties, and data values are NOT
+ * in the key; changes to them must redraw all tabs.
+ *
+ * @return Key for the graphics content of this tab.
+ */
+uint64_t
+BrowserTabContent::getGraphicsContentKey()
+{
+    FnvHash hash;
+    
+    const int32_t modelType = static_cast<int32_t>(m_selectedModelType);
+    hash.add(modelType);
+    const Model* model = getModelForDisplay();
+    hash.add(model);
+    if (model == NULL) {
+        return hash.getHash();
+    }
+    
+    /*
+     * Chart content is the selected chart type, the line chart model
+     * and its lines selected in this tab, or the selected matrix file.
+     * Axis and matrix display settings are display properties, so
+     * changing them redraws all tabs, as for other models.
+     */
+    ModelChart* modelChart = getDisplayedChartModel();
+    if (modelChart != NULL) {
+        const ChartDataTypeEnum::Enum chartDataType = modelChart->getSelectedChartDataType(m_tabNumber);
+        hash.add(chartDataType);
+        const ChartModel* lineChartModel = NULL;
+        const CaretDataFile* matrixFile = NULL;
+        switch (chartDataType) {
+            case ChartDataTypeEnum::CHART_DATA_TYPE_INVALID:
+                break;
+            case ChartDataTypeEnum::CHART_DATA_TYPE_LINE_DATA_SERIES:
+                lineChartModel = modelChart->getSelectedDataSeriesChartModel(m_tabNumber);
+                break;
+            case ChartDataTypeEnum::CHART_DATA_TYPE_LINE_FREQUENCY_SERIES:
+                lineChartModel = modelChart->getSelectedFrequencySeriesChartModel(m_tabNumber);
+                break;
+            case ChartDataTypeEnum::CHART_DATA_TYPE_LINE_TIME_SERIES:
+                lineChartModel = modelChart->getSelectedTimeSeriesChartModel(m_tabNumber);
+                break;
+            case ChartDataTypeEnum::CHART_DATA_TYPE_MATRIX_LAYER:
+                matrixFile = modelChart->getChartableMatrixParcelFileSelectionModel(m_tabNumber)->getSelectedFile();
+                break;
+            case ChartDataTypeEnum::CHART_DATA_TYPE_MATRIX_SERIES:
+                matrixFile = modelChart->getChartableMatrixSeriesFileSelectionModel(m_tabNumber)->getSelectedFile();
+                break;
+        }
+        hash.add(matrixFile);
+        hash.add(lineChartModel);
+        if (lineChartModel != NULL) {
+            const std::vector<const ChartData*> selectedChartDatas = lineChartModel->getAllSelectedChartDatas(m_tabNumber);
+            const int32_t numSelected = static_cast<int32_t>(selectedChartDatas.size());
+            hash.add(numSelected);
+            for (int32_t i = 0; i < numSelected; i++) {
+                hash.add(selectedChartDatas[i]);
+            }
+            hash.add(lineChartModel->isAverageChartDisplaySelected());
+        }
+    }
+    
+    float translation[3];
+    getTranslation(translation);
+    hash.addBytes(translation, sizeof(translation));
+    const float scaling = getScaling();
+    hash.add(scaling);
+    double rotation[4][4];
+    getRotationMatrix().getMatrix(rotation);
+    hash.addBytes(rotation, sizeof(rotation));
+    double obliqueRotation[4][4];
+    m_obliqueVolumeRotationMatrix->getMatrix(obliqueRotation);
+    hash.addBytes(obliqueRotation, sizeof(obliqueRotation));
+    float flatOffsetAndZoom[3];
+    getRightCortexFlatMapOffset(flatOffsetAndZoom[0],
+                                flatOffsetAndZoom[1]);
+    flatOffsetAndZoom[2] = getRightCortexFlatMapZoomFactor();
+    hash.addBytes(flatOffsetAndZoom, sizeof(flatOffsetAndZoom));
+    
+    const int32_t sliceSettings[6] = {
+        static_cast<int32_t>(getSliceViewPlane()),
+        static_cast<int32_t>(getSliceDrawingType()),
+        static_cast<int32_t>(getSliceProjectionType()),
+        getMontageNumberOfColumns(),
+        getMontageNumberOfRows(),
+        getMontageSliceSpacing()
+    };
+    hash.addBytes(sliceSettings, sizeof(sliceSettings));
+    const float sliceCoordinates[3] = {
+        getSliceCoordinateParasagittal(),
+        getSliceCoordinateCoronal(),
+        getSliceCoordinateAxial()
+    };
+    hash.addBytes(sliceCoordinates, sizeof(sliceCoordinates));
+    const bool slicesEnabled[3] = {
+        isSliceParasagittalEnabled(),
+        isSliceCoronalEnabled(),
+        isSliceAxialEnabled()
+    };
+    hash.addBytes(slicesEnabled, sizeof(slicesEnabled));
+    
+    OverlaySet* overlaySet = getOverlaySet();
+    if (overlaySet != NULL) {
+        const int32_t numOverlays = overlaySet->getNumberOfDisplayedOverlays();
+        hash.add(numOverlays);
+        for (int32_t i = 0; i < numOverlays; i++) {
+            Overlay* overlay = overlaySet->getOverlay(i);
+            const bool enabled = overlay->isEnabled();
+            hash.add(enabled);
+            if ( ! enabled) {
+                continue;
+            }
+            const float opacity = overlay->getOpacity();
+            hash.add(opacity);
+            CaretMappableDataFile* mapFile = NULL;
+            int32_t mapIndex = -1;
+            overlay->getSelectionData(mapFile,
+                                      mapIndex);
+            hash.add(mapFile);
+            hash.add(mapIndex);
+        }
+    }
+    
+    return hash.getHash();
+}
+
 /**
  * @return The viewing translation.
  */
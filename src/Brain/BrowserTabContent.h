@@ -268,6 +268,8 @@ namespace caret {
         
         void getTransformationsInModelTransform(ModelTransform& modelTransform) const;
         
+        uint64_t getGraphicsContentKey();
+        
         void setTransformationsFromModelTransform(const ModelTransform& modelTransform);
         
         VolumeSliceViewPlaneEnum::Enum getSliceViewPlane() const;
@@ -126,6 +126,9 @@ CaretMappableDataFileAndMapSelectionModel::performConstruction(Brain* brain,
             case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
                 isMappableFile = true;
                 break;
+            case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                isMappableFile = true;
+                break;
             case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                 isMappableFile = true;
                 break;
@@ -334,6 +334,8 @@ IdentificationTextGenerator::generateVolumeIdentificationText(IdentificationStri
                             case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
                                 limitMapIndicesFlag = true;
                                 break;
+                            case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                                break;
                             case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                                 limitMapIndicesFlag = true;
                                 break;
@@ -512,6 +514,8 @@ IdentificationTextGenerator::generateSurfaceIdentificationText(IdentificationStr
                 case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
                     limitMapIndicesFlag = true;
                     break;
+                case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                    break;
                 case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                     limitMapIndicesFlag = true;
                     break;
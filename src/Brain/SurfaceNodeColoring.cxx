@@ -44,6 +44,7 @@
 #include "DisplayPropertiesLabels.h"
 #include "EventManager.h"
 #include "EventModelSurfaceGet.h"
+#include "FnvHash.h"
 #include "GiftiLabel.h"
 #include "GiftiLabelTable.h"
 #include "GroupAndNameHierarchyGroup.h"
@@ -121,6 +122,7 @@ SurfaceNodeColoring::colorSurfaceNodes(Model* model,
     
     OverlaySet* overlaySet = NULL;
     float* rgba = NULL;
+    uint64_t rgbaKey = 0;
 
     EventBrowserTabGet getBrowserTab(browserTabIndex);
     EventManager::get()->sendEvent(getBrowserTab.getPointer());
@@ -170,23 +172,30 @@ SurfaceNodeColoring::colorSurfaceNodes(Model* model,
      */
     if (surfaceModel != NULL) {
         rgba = surface->getSurfaceNodeColoringRgbaForBrowserTab(browserTabIndex);
+        rgbaKey = surface->getSurfaceNodeColoringKeyForBrowserTab(browserTabIndex);
         overlaySet = surfaceModel->getOverlaySet(browserTabIndex);
     }
     else if (surfaceMontageModel != NULL) {
         rgba = surface->getSurfaceMontageNodeColoringRgbaForBrowserTab(browserTabIndex);
+        rgbaKey = surface->getSurfaceMontageNodeColoringKeyForBrowserTab(browserTabIndex);
         overlaySet = surfaceMontageModel->getOverlaySet(browserTabIndex);
     }
     else if (wholeBrainModel != NULL) {
         rgba = surface->getWholeBrainNodeColoringRgbaForBrowserTab(browserTabIndex);
+        rgbaKey = surface->getWholeBrainNodeColoringKeyForBrowserTab(browserTabIndex);
         overlaySet = wholeBrainModel->getOverlaySet(browserTabIndex);
     }
     
     CaretAssert(overlaySet);
     
     /*
-     * RGBA will be Non-NULL if the surface HAS valid coloring
+     * RGBA will be Non-NULL if the surface HAS valid coloring.
+     * The coloring is reused while the tab's overlay selections
+     * are the same as those used to create the coloring.
      */
-    if (rgba != NULL) {
+    const uint64_t overlayColoringKey = getOverlayColoringKey(overlaySet);
+    if ((rgba != NULL)
+        && (rgbaKey == overlayColoringKey)) {
         return rgba;
     }
     
@@ -213,17 +222,20 @@ SurfaceNodeColoring::colorSurfaceNodes(Model* model,
     
     if (surfaceModel != NULL) {
         surface->setSurfaceNodeColoringRgbaForBrowserTab(browserTabIndex,
-                                                         rgbaColor);
+                                                         rgbaColor,
+                                                         overlayColoringKey);
         rgba = surface->getSurfaceNodeColoringRgbaForBrowserTab(browserTabIndex);
     }
     else if (surfaceMontageModel != NULL) {
         surface->setSurfaceMontageNodeColoringRgbaForBrowserTab(browserTabIndex,
-                                                                rgbaColor);
+                                                                rgbaColor,
+                                                                overlayColoringKey);
         rgba = surface->getSurfaceMontageNodeColoringRgbaForBrowserTab(browserTabIndex);
     }
     else if (wholeBrainModel != NULL) {
         surface->setWholeBrainNodeColoringRgbaForBrowserTab(browserTabIndex, 
-                                                            rgbaColor);
+                                                            rgbaColor,
+                                                            overlayColoringKey);
         rgba = surface->getWholeBrainNodeColoringRgbaForBrowserTab(browserTabIndex);
     }
 
@@ -232,6 +244,40 @@ SurfaceNodeColoring::colorSurfaceNodes(Model* model,
     return rgba;
 }
 
+/**
+ * Get a key for the overlay selections that determine surface coloring
+ * in a tab: which overlays are enabled, their selected file and map,
+ * and their opacity.  Changes to palettes, labels, or data values
+ * invalidate the coloring through EventSurfaceColoringInvalidate.
+ *
+ * @param overlaySet
+ *     Overlays for the surface in the tab.
+ * @return
+ *     Key for the overlay selections.
+ */
+uint64_t
+SurfaceNodeColoring::getOverlayColoringKey(OverlaySet* overlaySet) const
+{
+    FnvHash hash;
+    const int32_t numberOfDisplayedOverlays = overlaySet->getNumberOfDisplayedOverlays();
+    for (int32_t iOver = 0; iOver < numberOfDisplayedOverlays; iOver++) {
+        Overlay* overlay = overlaySet->getOverlay(iOver);
+        if ( ! overlay->isEnabled()) {
+            continue;
+        }
+        CaretMappableDataFile* mapFile = NULL;
+        int32_t mapIndex = -1;
+        overlay->getSelectionData(mapFile,
+                                  mapIndex);
+        hash.add(iOver);
+        hash.add(mapFile);
+        hash.add(mapIndex);
+        hash.add(overlay->getOpacity());
+    }
+    
+    return hash.getHash();
+}
+
 /**
  * Show brainordinate region of interest highlighting on the surface.
  *
@@ -391,6 +437,16 @@ SurfaceNodeColoring::colorSurfaceNodes(const DisplayPropertiesLabels* displayPro
                                                                  numNodes,
                                                                  overlayRGBV);
                     break;
+                case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+                {
+                    CiftiMappableConnectivityMatrixDataFile* cmf = dynamic_cast<CiftiMappableConnectivityMatrixDataFile*>(selectedMapFile);
+                    isColoringValid = assignCiftiMappableConnectivityMatrixColoring(brainStructure,
+                                                                                    cmf,
+                                                                                    selectedMapIndex,
+                                                                                    numNodes,
+                                                                                    overlayRGBV);
+                }
+                    break;
                 case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
                     isColoringValid = this->assignCiftiDataSeriesColoring(brainStructure,
                                                                       dynamic_cast<CiftiBrainordinateDataSeriesFile*>(selectedMapFile),
@@ -494,46 +550,35 @@ SurfaceNodeColoring::colorSurfaceNodes(const DisplayPropertiesLabels* displayPro
             }
             
             if (isColoringValid) {
+                /*
+                 * Opaque overlays replace the coloring.  Otherwise the
+                 * overlay is blended with the underlaying colors except
+                 * for the first overlay that has nothing to blend with.
+                 * Weights are chosen outside of the loop and nodes
+                 * without coloring keep their color through a select,
+                 * so the loop has no branches and vectorizes.
+                 */
                 const float opacity = overlay->getOpacity();
-                const float oneMinusOpacity = 1.0 - opacity;
-                
-                for (int32_t i = 0; i < numNodes; i++) {
-                    const int32_t i4 = i * 4;
-                    const float valid = overlayRGBV[i4 + 3];
-                    if (valid > 0.0 ) {
-                        if (opacity < 1.0) {
-                            if (firstOverlayFlag) {
-                                /*
-                                 * When first overlay, there is nothing to 
-                                 * blend with
-                                 */
-                                rgbaNodeColors[i4]   = (overlayRGBV[i4]   * opacity);
-                                rgbaNodeColors[i4+1] = (overlayRGBV[i4+1] * opacity);
-                                rgbaNodeColors[i4+2] = (overlayRGBV[i4+2] * opacity);
-                            }
-                            else {
-                                /*
-                                 * Blend with underlaying colors
-                                 */
-                                rgbaNodeColors[i4]   = (overlayRGBV[i4]   * opacity)
-                                + (rgbaNodeColors[i4] * oneMinusOpacity);
-                                rgbaNodeColors[i4+1] = (overlayRGBV[i4+1] * opacity)
-                                + (rgbaNodeColors[i4+1] * oneMinusOpacity);
-                                rgbaNodeColors[i4+2] = (overlayRGBV[i4+2] * opacity)
-                                + (rgbaNodeColors[i4+2] * oneMinusOpacity);
-                            }
-                        }
-                        else {
-                            /*
-                             * No opacity so simple replace coloring
-                             */
-                            rgbaNodeColors[i4] = overlayRGBV[i4];
-                            rgbaNodeColors[i4+1] = overlayRGBV[i4+1];
-                            rgbaNodeColors[i4+2] = overlayRGBV[i4+2];
-                        }
+                float overlayWeight   = 1.0;
+                float underlayWeight  = 0.0;
+                if (opacity < 1.0) {
+                    overlayWeight = opacity;
+                    if ( ! firstOverlayFlag) {
+                        underlayWeight = 1.0 - opacity;
                     }
                 }
                 
+                const int64_t numComponents = static_cast<int64_t>(numNodes) * 4;
+                for (int64_t i4 = 0; i4 < numComponents; i4 += 4) {
+                    const bool valid = (overlayRGBV[i4 + 3] > 0.0);
+                    const float red   = (overlayRGBV[i4]   * overlayWeight) + (rgbaNodeColors[i4]   * underlayWeight);
+                    const float green = (overlayRGBV[i4+1] * overlayWeight) + (rgbaNodeColors[i4+1] * underlayWeight);
+                    const float blue  = (overlayRGBV[i4+2] * overlayWeight) + (rgbaNodeColors[i4+2] * underlayWeight);
+                    rgbaNodeColors[i4]   = (valid ? red   : rgbaNodeColors[i4]);
+                    rgbaNodeColors[i4+1] = (valid ? green : rgbaNodeColors[i4+1]);
+                    rgbaNodeColors[i4+2] = (valid ? blue  : rgbaNodeColors[i4+2]);
+                }
+                
                 firstOverlayFlag = false;
             }
         }
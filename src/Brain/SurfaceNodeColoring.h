@@ -85,6 +85,8 @@ namespace caret {
                                OverlaySet* overlaySet,
                                float* rgbaNodeColors);
         
+        uint64_t getOverlayColoringKey(OverlaySet* overlaySet) const;
+        
         bool assignLabelColoring(const DisplayPropertiesLabels* dpl,
                                  const int32_t browserTabIndex,
                                  const BrainStructure* brainStructure,
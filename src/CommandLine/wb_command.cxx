@@ -130,6 +130,11 @@ int main(int argc, char* argv[]) {
          */
         SystemUtilities::setUnexpectedHandler();
         
+        /*
+         * Group commands open every input file before running
+         */
+        SystemUtilities::raiseOpenFileLimit();
+        
         /*
          * Create the session manager.
          */
@@ -142,6 +147,13 @@ int main(int argc, char* argv[]) {
          */
         VolumeFile::setVoxelColoringEnabled(false);
         
+        /*
+         * Most commands use volume data as float frames, which would
+         * keep both the integer and float data of 8 and 16 bit volumes
+         * (label volumes are still kept as integers)
+         */
+        VolumeFile::setNativeStorageEnabled(false);
+        
         QCoreApplication myApp(argc, argv);//so that it doesn't need to link against gui
         
         result = runCommand(argc, argv);
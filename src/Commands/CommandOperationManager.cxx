@@ -148,6 +148,7 @@
 #include "OperationCiftiConvert.h"
 #include "OperationCiftiConvertToScalar.h"
 #include "OperationCiftiCopyMapping.h"
+#include "OperationCiftiCorrelationSparse.h"
 #include "OperationCiftiCreateDenseFromTemplate.h"
 #include "OperationCiftiCreateParcellatedFromTemplate.h"
 #include "OperationCiftiCreateScalarSeries.h"
@@ -204,7 +205,9 @@
 #include "OperationSurfaceCutResample.h"
 #include "OperationSurfaceFlipNormals.h"
 #include "OperationSurfaceGeodesicDistance.h"
+#include "OperationSurfaceGeodesicDistanceAllToAll.h"
 #include "OperationSurfaceGeodesicROIs.h"
+#include "OperationSurfaceHelperCache.h"
 #include "OperationSurfaceInformation.h"
 #include "OperationSurfaceNormals.h"
 #include "OperationSurfaceVertexAreas.h"
@@ -220,6 +223,7 @@
 #include "OperationVolumeSetSpace.h"
 #include "OperationVolumeStats.h"
 #include "OperationVolumeWeightedStats.h"
+#include "OperationWbsparseConvert.h"
 #include "OperationWbsparseMergeDense.h"
 #include "OperationZipSceneFile.h"
 #include "OperationZipSpecFile.h"
@@ -239,9 +243,14 @@
 #include "ProgramParameters.h"
 
 #include "CaretLogger.h"
+#include "CaretOMP.h"
+#include "CaretTrace.h"
 #include "dot_wrapper.h"
+#include "ElapsedTimer.h"
 #include "StructureEnum.h"
 
+#include <algorithm>
+#include <fstream>
 #include <iostream>
 #include <map>
 
@@ -403,6 +412,7 @@ CommandOperationManager::CommandOperationManager()
     this->commandOperations.push_back(new CommandParser(new AutoOperationBorderMerge()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationCiftiChangeMapping()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationCiftiConvert()));
+    this->commandOperations.push_back(new CommandParser(new AutoOperationCiftiCorrelationSparse()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationCiftiCreateDenseFromTemplate()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationCiftiCreateParcellatedFromTemplate()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationCiftiCreateScalarSeries()));
@@ -457,7 +467,9 @@ CommandOperationManager::CommandOperationManager()
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceCutResample()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceFlipNormals()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceGeodesicDistance()));
+    this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceGeodesicDistanceAllToAll()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceGeodesicROIs()));
+    this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceHelperCache()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceInformation()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceNormals()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationSurfaceVertexAreas()));
@@ -473,6 +485,7 @@ CommandOperationManager::CommandOperationManager()
     this->commandOperations.push_back(new CommandParser(new AutoOperationVolumeSetSpace()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationVolumeStats()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationVolumeWeightedStats()));
+    this->commandOperations.push_back(new CommandParser(new AutoOperationWbsparseConvert()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationWbsparseMergeDense()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationZipSceneFile()));
     this->commandOperations.push_back(new CommandParser(new AutoOperationZipSpecFile()));
@@ -587,6 +600,10 @@ CommandOperationManager::runCommand(ProgramParameters& parameters)
         ciftiMax = globalOptionArgs[1].toDouble(&valid);
         if (!valid) throw CommandException("non-numeric option to -cifti-output-range: '" + globalOptionArgs[1] + "'");
     }
+    if (getGlobalOption(parameters, "-trace", 1, globalOptionArgs))
+    {
+        CaretTrace::enable(globalOptionArgs[0]);
+    }
 
     const uint64_t numberOfCommands = this->commandOperations.size();
     const uint64_t numberOfDeprecated = this->deprecatedOperations.size();
@@ -618,6 +635,8 @@ CommandOperationManager::runCommand(ProgramParameters& parameters)
         printDeprecatedCommands();
     } else if (commandSwitch == "-all-commands-help") {
         printAllCommandsHelpInfo("wb_command");
+    } else if (commandSwitch == "-batch") {
+        runBatch(parameters);
     } else {
         
         CommandOperation* operation = NULL;
@@ -660,10 +679,217 @@ CommandOperationManager::runCommand(ProgramParameters& parameters)
                 } else {
                     operation->setCiftiOutputDTypeNoScale(ciftiDType);
                 }
-                operation->execute(parameters, preventProvenance);
+                try
+                {
+                    CaretTraceScope myScope(commandSwitch, "command");
+                    operation->execute(parameters, preventProvenance);
+                } catch (...) {
+                    CaretTrace::writeTrace();//a partial trace is still useful for finding where it died
+                    throw;
+                }
+                CaretTrace::writeTrace();
+            }
+        }
+    }
+}
+
+/**
+ * Split a line of a batch command list into arguments, the way a shell would
+ * for simple quoting: whitespace separates arguments, single quotes take
+ * everything literally, double quotes and backslashes escape whitespace.
+ *
+ * @param line
+ *    The line to split.
+ * @param argumentsOut
+ *    The arguments on the line, empty for a blank or comment line.
+ * @return
+ *    False if the line ends inside of a quote.
+ */
+bool CommandOperationManager::splitBatchLine(const AString& line, vector<AString>& argumentsOut)
+{
+    argumentsOut.clear();
+    AString current;
+    bool inArgument = false;
+    QChar quote;//null when not inside of quotes
+    const int length = line.length();
+    for (int i = 0; i < length; ++i)
+    {
+        const QChar thisChar = line[i];
+        if (quote == '\'')
+        {
+            if (thisChar == '\'') quote = QChar(); else current += thisChar;
+            continue;
+        }
+        if (thisChar == '\\' && i + 1 < length && (quote.isNull() || line[i + 1] == '"' || line[i + 1] == '\\'))
+        {
+            current += line[++i];
+            inArgument = true;
+            continue;
+        }
+        if (quote == '"')
+        {
+            if (thisChar == '"') quote = QChar(); else current += thisChar;
+            continue;
+        }
+        if (thisChar == '\'' || thisChar == '"')
+        {
+            quote = thisChar;
+            inArgument = true;
+        } else if (thisChar.isSpace()) {
+            if (inArgument) argumentsOut.push_back(current);
+            current = "";
+            inArgument = false;
+        } else if (thisChar == '#' && !inArgument) {
+            break;//rest of line is a comment
+        } else {
+            current += thisChar;
+            inArgument = true;
+        }
+    }
+    if (!quote.isNull()) return false;
+    if (inArgument) argumentsOut.push_back(current);
+    return true;
+}
+
+/**
+ * Run the commands in a command list, one command line per line, with up
+ * to the requested number of commands running at once.  Surface inputs are
+ * shared between the commands, see CommandParser::setSurfaceInputCacheEnabled().
+ * The time taken by each command is printed as it finishes.  When more than
+ * one job runs at once, the openmp threads are divided evenly between the
+ * jobs, and global options that change process-wide state (-logging, -simd,
+ * -trace) are rejected on command lines, they must be given before -batch.
+ *
+ * @param parameters
+ *    The batch arguments, the command list file ("-" for standard input)
+ *    and the optional -jobs option.
+ * @throws CommandException
+ *    If the list can't be read or any of the commands failed.
+ */
+void CommandOperationManager::runBatch(ProgramParameters& parameters)
+{
+    const AString listName = parameters.nextString("Command List");
+    int numJobs = 1;
+    while (parameters.hasNext())
+    {
+        const AString option = parameters.nextString("Batch Option");
+        if (option == "-jobs")
+        {
+            numJobs = (int)parameters.nextLong("Number of Jobs");
+            if (numJobs < 1) throw CommandException("number of jobs must be at least 1");
+        } else {
+            throw CommandException("unrecognized option to -batch: '" + option + "'");
+        }
+    }
+    ifstream listFile;
+    istream* listStream = &cin;
+    if (listName != "-")
+    {
+        listFile.open(listName.toLocal8Bit().constData());
+        if (!listFile) throw CommandException("unable to open command list '" + listName + "'");
+        listStream = &listFile;
+    }
+    vector<vector<AString> > commandArguments;
+    vector<AString> commandLines;
+    string lineText;
+    int lineNumber = 0;
+    while (getline(*listStream, lineText))
+    {
+        ++lineNumber;
+        const AString line = AString::fromLocal8Bit(lineText.c_str()).trimmed();
+        vector<AString> arguments;
+        if (!splitBatchLine(line, arguments)) throw CommandException("unterminated quote on line " + AString::number(lineNumber) + " of command list");
+        if (!arguments.empty() && (arguments[0] == "wb_command" || arguments[0].endsWith("/wb_command")))
+        {
+            arguments.erase(arguments.begin());
+        }
+        if (arguments.empty()) continue;
+        if (arguments[0] == "-batch") throw CommandException("-batch can't be used inside of a command list (line " + AString::number(lineNumber) + ")");
+        commandArguments.push_back(arguments);
+        commandLines.push_back(line);
+    }
+    const int numCommands = (int)commandArguments.size();
+    if (numJobs > numCommands) numJobs = max(numCommands, 1);
+    if (numJobs > 1)
+    {//these global options change process-wide state, so commands running at the same time would fight over them
+        const char* processOptions[] = { "-logging", "-simd", "-trace" };
+        for (int i = 0; i < numCommands; ++i)
+        {
+            for (int j = 0; j < (int)commandArguments[i].size(); ++j)
+            {
+                const AString test = commandArguments[i][j].fixUnicodeHyphens(NULL, NULL, true);
+                for (int k = 0; k < 3; ++k)
+                {
+                    if (test == processOptions[k])
+                    {
+                        throw CommandException("global option '" + test + "' can't be used on a command list line when -jobs is more than 1, put it before -batch instead: " +
+                                               commandLines[i]);
+                    }
+                }
+            }
+        }
+    }
+#ifdef CARET_OMP
+    const int oldActiveLevels = omp_get_max_active_levels();
+    const int threadsPerJob = max(omp_get_max_threads() / numJobs, 1);
+    if (numJobs > 1) omp_set_max_active_levels(max(oldActiveLevels, 2));//let the parallel loops inside each command use their share of the threads
+#endif
+    CommandParser::setSurfaceInputCacheEnabled(true);
+    ElapsedTimer batchTimer;
+    batchTimer.start();
+    int numFailed = 0;
+#pragma omp CARET_PAR num_threads(numJobs) if(numJobs > 1)
+    {
+        CommandOperationManager workerManager;//command parsers keep state while running, so each worker needs its own
+#ifdef CARET_OMP
+        if (numJobs > 1) omp_set_num_threads(threadsPerJob);//only affects parallel regions started by this worker
+#endif
+#pragma omp CARET_FOR schedule(dynamic, 1)
+        for (int i = 0; i < numCommands; ++i)
+        {
+            ProgramParameters commandParameters;
+            for (int j = 0; j < (int)commandArguments[i].size(); ++j)
+            {
+                commandParameters.addParameter(commandArguments[i][j]);
+            }
+            AString errorMessage;
+            ElapsedTimer commandTimer;
+            commandTimer.start();
+            try
+            {
+                workerManager.runCommand(commandParameters);
+            } catch (CaretException& e) {
+                errorMessage = e.whatString();
+            } catch (std::bad_alloc&) {
+                errorMessage = "ran out of memory";
+            } catch (std::exception& e) {
+                errorMessage = e.what();
+            } catch (...) {
+                errorMessage = "unknown exception";
+            }
+            const double seconds = commandTimer.getElapsedTimeSeconds();
+#pragma omp critical
+            {
+                if (errorMessage.isEmpty())
+                {
+                    cout << "batch command " << (i + 1) << " of " << numCommands << " finished in " << seconds << " seconds: " << commandLines[i] << endl;
+                } else {
+                    ++numFailed;
+                    cout << "batch command " << (i + 1) << " of " << numCommands << " FAILED after " << seconds << " seconds: " << commandLines[i] << endl;
+                    cout << "   " << errorMessage << endl;
+                }
             }
         }
     }
+    CommandParser::setSurfaceInputCacheEnabled(false);
+#ifdef CARET_OMP
+    omp_set_max_active_levels(oldActiveLevels);
+#endif
+    cout << "batch of " << numCommands << " commands finished in " << batchTimer.getElapsedTimeSeconds() << " seconds" << endl;
+    if (numFailed > 0)
+    {
+        throw CommandException(AString::number(numFailed) + " of " + AString::number(numCommands) + " batch commands failed");
+    }
 }
 
 AString CommandOperationManager::doCompletion(ProgramParameters& parameters, const bool& useExtGlob)
@@ -706,7 +932,12 @@ AString CommandOperationManager::doCompletion(ProgramParameters& parameters, con
     {//can't tab complete a literal number
         return "";
     }
-    ret = "wordlist -disable-provenance\\ -logging\\ -simd\\ -cifti-output-datatype\\ -cifti-output-range";//we could prevent suggesting an already-provided global option, but that would be a bit surprising
+    OptionInfo traceInfo = parseGlobalOption(parameters, "-trace", 1, globalOptionArgs, true);
+    if (traceInfo.specified && !traceInfo.complete)
+    {//output filename, let bash suggest files
+        return "";
+    }
+    ret = "wordlist -disable-provenance\\ -logging\\ -simd\\ -cifti-output-datatype\\ -cifti-output-range\\ -trace";//we could prevent suggesting an already-provided global option, but that would be a bit surprising
     const uint64_t numberOfCommands = this->commandOperations.size();
     const uint64_t numberOfDeprecated = this->deprecatedOperations.size();
     if (!parameters.hasNext())
@@ -967,6 +1198,18 @@ void CommandOperationManager::printHelpInfo()
     cout << "   -all-commands-help          show all processing subcommands and their help" << endl;
     cout << "                                  info - VERY LONG" << endl;
     cout << endl;
+    cout << "Batch processing:" << endl;
+    cout << "   -batch <command-list> [-jobs <n>]" << endl;
+    cout << "                               run the command on each line of <command-list>" << endl;
+    cout << "                                  ('-' for standard input), up to <n> at once," << endl;
+    cout << "                                  reading each surface input only once and" << endl;
+    cout << "                                  printing the time each command took, commands" << endl;
+    cout << "                                  must not use each other's outputs if <n> > 1" << endl;
+    cout << "                                  if <n> > 1, the threads are split evenly" << endl;
+    cout << "                                  between the running commands, and -logging," << endl;
+    cout << "                                  -simd, and -trace must be given before -batch" << endl;
+    cout << "                                  rather than on the command lines" << endl;
+    cout << endl;
     cout << "To get the help information of a processing subcommand, run it without any" << endl;
     cout << "   additional arguments." << endl;
     cout << endl;
@@ -1088,6 +1331,13 @@ void CommandOperationManager::printGlobalOptions()
         cout << "         " << DotSIMDEnum::toName(*iter) << endl;
     }
     cout << endl;
+    //guide for wrap, assuming 80 columns:                                                  |
+    cout << "   -trace <file>                     write a timing trace of the command to" << endl;
+    cout << "                                        <file>, in chrome trace event (JSON)" << endl;
+    cout << "                                        format, with per-phase and" << endl;
+    cout << "                                        per-algorithm time, bytes read and" << endl;
+    cout << "                                        written, and resident memory" << endl;
+    cout << endl;
 }
 
 void CommandOperationManager::printCiftiHelp(const AString& /*programName*/)
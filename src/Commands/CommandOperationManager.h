@@ -44,6 +44,8 @@ namespace caret {
         
         void runCommand(ProgramParameters& parameters);
         
+        void runBatch(ProgramParameters& parameters);
+        
         AString doCompletion(ProgramParameters& parameters, const bool& useExtGlob);
         
         std::vector<CommandOperation*> getCommandOperations();
@@ -89,6 +91,8 @@ namespace caret {
         
         static AString fixUnicode(const AString& input, const bool& quiet);
         
+        static bool splitBatchLine(const AString& line, std::vector<AString>& argumentsOut);
+        
     private:
         std::vector<CommandOperation*> commandOperations, deprecatedOperations;
         
@@ -27,6 +27,7 @@
 #include "CaretCommandLine.h"
 #include "CaretDataFileHelper.h"
 #include "CaretLogger.h"
+#include "CaretTrace.h"
 #include "CiftiFile.h"
 #include "DataFileException.h"
 #include "FileInformation.h"
@@ -38,7 +39,9 @@
 #include "SurfaceFile.h"
 #include "VolumeFile.h"
 
+#include <QDateTime>
 #include <QDir>
+#include <QFileInfo>
 
 #include <iostream>
 
@@ -50,6 +53,16 @@ const AString CommandParser::PARENT_PROVENANCE_NAME = "ParentProvenance";
 const AString CommandParser::PROGRAM_PROVENANCE_NAME = "ProgramProvenance";
 const AString CommandParser::CWD_PROVENANCE_NAME = "WorkingDirectory";
 
+bool CommandParser::s_surfaceCacheEnabled = false;
+int64_t CommandParser::s_surfaceCacheUseCounter = 0;
+map<AString, CommandParser::CachedSurface> CommandParser::s_surfaceCache;
+CaretMutex CommandParser::s_surfaceCacheMutex;
+
+namespace
+{
+    const int SURFACE_CACHE_LIMIT = 64;//enough for the surfaces of several subjects, a 164k surface is about 10MB
+}
+
 CommandParser::CommandParser(AutoOperationInterface* myAutoOper) :
     CommandOperation(myAutoOper->getCommandSwitch(), myAutoOper->getShortDescription()),
     OperationParserInterface(myAutoOper)
@@ -66,6 +79,61 @@ void CommandParser::disableProvenance()
     m_doProvenance = false;
 }
 
+void CommandParser::setSurfaceInputCacheEnabled(const bool& enabled)
+{
+    CaretMutexLocker myLock(&s_surfaceCacheMutex);
+    s_surfaceCacheEnabled = enabled;
+    if (!enabled)
+    {
+        s_surfaceCache.clear();
+    }
+}
+
+CaretPointer<SurfaceFile> CommandParser::readSurface(const AString& fileName)
+{
+    bool useCache = false;
+    {
+        CaretMutexLocker myLock(&s_surfaceCacheMutex);
+        useCache = s_surfaceCacheEnabled;
+    }
+    QFileInfo myInfo(fileName);
+    const AString cacheKey = myInfo.canonicalFilePath();//empty if the file doesn't exist, let readFile report that
+    if (!useCache || cacheKey.isEmpty())
+    {
+        CaretPointer<SurfaceFile> ret(new SurfaceFile());
+        ret->readFile(fileName);
+        return ret;
+    }
+    const int64_t modifiedTime = myInfo.lastModified().toMSecsSinceEpoch(), fileSize = myInfo.size();
+    {
+        CaretMutexLocker myLock(&s_surfaceCacheMutex);
+        map<AString, CachedSurface>::iterator iter = s_surfaceCache.find(cacheKey);
+        if (iter != s_surfaceCache.end() && iter->second.m_modifiedTime == modifiedTime && iter->second.m_fileSize == fileSize)
+        {
+            iter->second.m_lastUsed = ++s_surfaceCacheUseCounter;
+            return iter->second.m_surface;
+        }
+    }
+    CaretPointer<SurfaceFile> ret(new SurfaceFile());
+    ret->readFile(fileName);//don't hold the lock while reading, other commands may be waiting on different surfaces
+    CaretMutexLocker myLock(&s_surfaceCacheMutex);
+    CachedSurface& myEntry = s_surfaceCache[cacheKey];
+    myEntry.m_surface = ret;
+    myEntry.m_modifiedTime = modifiedTime;
+    myEntry.m_fileSize = fileSize;
+    myEntry.m_lastUsed = ++s_surfaceCacheUseCounter;
+    while ((int)s_surfaceCache.size() > SURFACE_CACHE_LIMIT)
+    {//drop the least recently used, commands still using it keep their reference
+        map<AString, CachedSurface>::iterator oldest = s_surfaceCache.begin();
+        for (map<AString, CachedSurface>::iterator iter = s_surfaceCache.begin(); iter != s_surfaceCache.end(); ++iter)
+        {
+            if (iter->second.m_lastUsed < oldest->second.m_lastUsed) oldest = iter;
+        }
+        s_surfaceCache.erase(oldest);
+    }
+    return ret;
+}
+
 void CommandParser::setCiftiOutputDTypeAndScale(const int16_t& dtype, const double& minVal, const double& maxVal)
 {
     m_ciftiDType = dtype;
@@ -92,12 +160,18 @@ void CommandParser::executeOperation(ProgramParameters& parameters)
     m_parentProvenance = "";//in case someone tries to use the same instance more than once
     m_workingDir = QDir::currentPath();//get the current path, in case some stupid command changes the working directory
     //these get set on output files during writeOutput (and for on-disk in provenanceBeforeOperation)
-    parseComponent(myAlgParams.getPointer(), parameters, myOutAssoc);//parsing block
+    {
+        CaretTraceScope myScope("read inputs", "io");//no-op unless -trace was given
+        parseComponent(myAlgParams.getPointer(), parameters, myOutAssoc);//parsing block
+    }
     parameters.verifyAllParametersProcessed();
     makeOnDiskOutputs(myOutAssoc);//check for input on-disk files used as output on-disk files
     //code to show what arguments map to what parameters should go here
     if (m_doProvenance) provenanceBeforeOperation(myOutAssoc);
-    m_autoOper->useParameters(myAlgParams.getPointer(), NULL);//TODO: progress status for caret_command? would probably get messed up by any command info output
+    {
+        CaretTraceScope myScope("compute", "compute");
+        m_autoOper->useParameters(myAlgParams.getPointer(), NULL);//TODO: progress status for caret_command? would probably get messed up by any command info output
+    }
     vector<AString> uncheckedWarnings = myAlgParams->findUncheckedParams("the command");
     for (size_t i = 0; i < uncheckedWarnings.size(); ++i)
     {
@@ -105,6 +179,7 @@ void CommandParser::executeOperation(ProgramParameters& parameters)
     }
     if (m_doProvenance) provenanceAfterOperation(myOutAssoc);
     //TODO: deallocate input files - give abstract parameter a virtual deallocate method? use CaretPointer and rely on reference counting?
+    CaretTraceScope myScope("write outputs", "io");
     writeOutput(myOutAssoc);
 }
 
@@ -324,8 +399,7 @@ void CommandParser::parseComponent(ParameterComponent* myComponent, ProgramParam
                 }
                 case OperationParametersEnum::SURFACE:
                 {
-                    CaretPointer<SurfaceFile> myFile(new SurfaceFile());
-                    myFile->readFile(nextArg);
+                    CaretPointer<SurfaceFile> myFile = readSurface(nextArg);
                     if (m_doProvenance)
                     {
                         const GiftiMetaData* md = myFile->getFileMetaData();
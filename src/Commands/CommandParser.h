@@ -23,11 +23,14 @@
 
 #include "OperationParameters.h"
 #include "AbstractOperation.h"
+#include "CaretMutex.h"
+#include "CaretPointer.h"
 #include "CommandOperation.h"
 #include "ProgramParameters.h"
 #include "CommandException.h"
 #include "ProgramParametersException.h"
 
+#include <map>
 #include <vector>
 #include <set>
 
@@ -71,7 +74,20 @@ namespace caret {
         CompletionInfo completionOption(const AString& mySwitch, ParameterComponent* myComponent, ProgramParameters& parameters, const bool& useExtGlob);
         AString completionOptionHints(ParameterComponent* myComponent, const bool& useExtGlob);
         CompletionInfo completionRemainingOptions(ParameterComponent* myComponent, ProgramParameters& parameters, const bool& useExtGlob);
+        struct CachedSurface
+        {
+            CaretPointer<SurfaceFile> m_surface;
+            int64_t m_modifiedTime, m_fileSize, m_lastUsed;
+        };
+        static bool s_surfaceCacheEnabled;
+        static int64_t s_surfaceCacheUseCounter;
+        static std::map<AString, CachedSurface> s_surfaceCache;//keyed by canonical path
+        static CaretMutex s_surfaceCacheMutex;
+        static CaretPointer<SurfaceFile> readSurface(const AString& fileName);
     public:
+        ///share surface inputs (and the helpers they build) between commands run by the same process, as in -batch
+        ///a cached surface is reused while its file keeps the same modification time and size
+        static void setSurfaceInputCacheEnabled(const bool& enabled);
         CommandParser(AutoOperationInterface* myAutoOper);
         void disableProvenance();
         void setCiftiOutputDTypeAndScale(const int16_t& dtype, const double& minVal, const double& maxVal);
@@ -28,12 +28,16 @@
 #include "CaretAssert.h"
 #include "CaretBinaryFile.h"
 #include "CaretLogger.h"
+#include "CaretOMP.h"
+#include "CaretTrace.h"
 #include "DataFileException.h"
 
 #include <QFile>
 #include "zlib.h"
 
 #include <algorithm>
+#include <cstring>
+#include <vector>
 
 using namespace caret;
 using namespace std;
@@ -59,6 +63,89 @@ namespace caret
     };
     
     const int64_t ZFileImpl::CHUNK_SIZE = 1<<26;//64MiB, large enough for good performance, small enough for zlib, must convert to uint32
+    
+    //reads a gzip stream with our own inflate, recording access points (zran-style) as it goes, so that seeking doesn't require decompressing from the start
+    class ZIndexedReadImpl : public CaretBinaryFile::ImplInterface
+    {
+        struct AccessPoint
+        {
+            int64_t m_outPos;//uncompressed position
+            int64_t m_inPos;//compressed position of the first byte not completely consumed
+            int m_bits;//bits of the preceding byte that are still needed
+            vector<unsigned char> m_window;//preceding uncompressed data, for the inflate dictionary
+        };
+        QFile m_file;
+        z_stream m_strm;
+        bool m_strmInit, m_needHeader, m_atEOF, m_memberContiguous;
+        int64_t m_outPos, m_inPos;//m_inPos is the file position after the data in m_inBuf
+        uint32_t m_memberCrc, m_memberSize;
+        vector<unsigned char> m_inBuf, m_history, m_discard;
+        int64_t m_historyPos;
+        vector<AccessPoint> m_index;
+        const static int64_t SPAN, SKIP_AHEAD, WINDOW_SIZE, IN_BUF_SIZE, CHUNK_SIZE;
+        int getByte();
+        void fillInput();
+        bool readMemberHeader();
+        void readMemberTrailer();
+        void appendHistory(const unsigned char* data, const int64_t& count);
+        void addAccessPoint();
+        void restart();
+        void restoreAccessPoint(const AccessPoint& point);
+        int64_t inflateInto(unsigned char* out, const int64_t& count);
+        void skipForward(const int64_t& count);
+    public:
+        ZIndexedReadImpl();
+        void open(const QString& filename, const CaretBinaryFile::OpenMode& opmode);
+        void close();
+        void seek(const int64_t& position);
+        int64_t pos() { return m_outPos; }
+        int64_t size() { return -1; }
+        void read(void* dataOut, const int64_t& count, int64_t* numRead);
+        void write(const void*, const int64_t&) { throw DataFileException("write called on compressed file '" + m_fileName + "' opened for reading"); }
+        ~ZIndexedReadImpl();
+    };
+    
+    const int64_t ZIndexedReadImpl::SPAN = 1<<20;//1MiB of uncompressed data between access points, each of which stores a 32KiB window
+    const int64_t ZIndexedReadImpl::SKIP_AHEAD = 1<<21;//decompress forward instead of jumping to an access point when the target is this close
+    const int64_t ZIndexedReadImpl::WINDOW_SIZE = 1<<15;
+    const int64_t ZIndexedReadImpl::IN_BUF_SIZE = 1<<18;
+    const int64_t ZIndexedReadImpl::CHUNK_SIZE = 1<<26;//must convert to uint32
+    
+    //writes a single gzip stream, compressing blocks in parallel (pigz-style): each block is a raw deflate stream primed with the previous 32KiB and ended with a sync flush
+    class ZParallelWriteImpl : public CaretBinaryFile::ImplInterface
+    {
+        QFile m_file;
+        bool m_open;
+        vector<unsigned char> m_pending, m_dictionary;
+        uint32_t m_crc;
+        int64_t m_totalSize;//not including m_pending
+        const static int64_t BLOCK_SIZE, BATCH_BLOCKS, WINDOW_SIZE;
+        void compressBatch(const bool& last);
+        void writeToFile(const void* data, const int64_t& count);
+    public:
+        ZParallelWriteImpl() { m_open = false; m_crc = 0; m_totalSize = 0; }
+        void open(const QString& filename, const CaretBinaryFile::OpenMode& opmode);
+        void close();
+        void seek(const int64_t& position);
+        int64_t pos() { return m_totalSize + (int64_t)m_pending.size(); }
+        int64_t size() { return -1; }
+        void read(void*, const int64_t&, int64_t*) { throw DataFileException("read called on compressed file '" + m_fileName + "' opened for writing"); }
+        void write(const void* dataIn, const int64_t& count);
+        ~ZParallelWriteImpl();
+    };
+    
+    const int64_t ZParallelWriteImpl::BLOCK_SIZE = 1<<20;//1MiB per block, the dictionary priming keeps the compression ratio close to single-threaded
+    const int64_t ZParallelWriteImpl::BATCH_BLOCKS = 32;
+    const int64_t ZParallelWriteImpl::WINDOW_SIZE = 1<<15;
+    
+    bool hasGzipMagic(const QString& filename)
+    {
+        QFile test(filename);
+        if (!test.open(QIODevice::ReadOnly)) return false;
+        char magic[2];
+        if (test.read(magic, 2) != 2) return false;
+        return (unsigned char)magic[0] == 0x1f && (unsigned char)magic[1] == 0x8b;
+    }
 #endif //ZLIB_VERSION
 
     class QFileImpl : public CaretBinaryFile::ImplInterface
@@ -118,7 +205,14 @@ void CaretBinaryFile::open(const QString& filename, const OpenMode& opmode)
     if (filename.endsWith(".gz"))
     {
 #ifdef ZLIB_VERSION
-        m_impl.grabNew(new ZFileImpl());
+        if (opmode == READ && hasGzipMagic(filename))
+        {
+            m_impl.grabNew(new ZIndexedReadImpl());
+        } else if (opmode == WRITE_TRUNCATE) {
+            m_impl.grabNew(new ZParallelWriteImpl());
+        } else {//files that aren't really compressed, or unsupported modes, get zlib's own handling and errors
+            m_impl.grabNew(new ZFileImpl());
+        }
 #else //ZLIB_VERSION
         throw DataFileException("can't open .gz file '" + filename + "', compiled without zlib support");
 #endif //ZLIB_VERSION
@@ -134,6 +228,7 @@ void CaretBinaryFile::read(void* dataOut, const int64_t& count, int64_t* numRead
     CaretAssert(count >= 0);//not sure about allowing 0
     if (!getOpenForRead()) throw DataFileException("file is not open for reading");
     m_impl->read(dataOut, count, numRead);
+    if (CaretTrace::isEnabled()) CaretTrace::addBytesRead(numRead != NULL ? *numRead : count);
 }
 
 void CaretBinaryFile::seek(const int64_t& position)
@@ -160,6 +255,7 @@ void CaretBinaryFile::write(const void* dataIn, const int64_t& count)
     CaretAssert(count >= 0);//not sure about allowing 0
     if (!getOpenForWrite()) throw DataFileException("file is not open for writing");
     m_impl->write(dataIn, count);
+    if (CaretTrace::isEnabled()) CaretTrace::addBytesWritten(count);
 }
 
 #ifdef ZLIB_VERSION
@@ -279,6 +375,470 @@ ZFileImpl::~ZFileImpl()
         CaretLogSevere("caught unknown exception type while closing a compressed file");
     }
 }
+
+ZIndexedReadImpl::ZIndexedReadImpl()
+{
+    m_strmInit = false;
+    m_needHeader = true;
+    m_atEOF = false;
+    m_memberContiguous = false;
+    m_outPos = 0;
+    m_inPos = 0;
+    m_memberCrc = 0;
+    m_memberSize = 0;
+    m_historyPos = 0;
+}
+
+void ZIndexedReadImpl::open(const QString& filename, const CaretBinaryFile::OpenMode& opmode)
+{
+    close();
+    m_fileName = filename;
+    if (opmode != CaretBinaryFile::READ) throw DataFileException("indexed compressed reading only supports READ mode");
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::ReadOnly))
+    {
+        throw DataFileException("failed to open compressed file '" + filename + "'");
+    }
+    memset(&m_strm, 0, sizeof(m_strm));
+    if (inflateInit2(&m_strm, -15) != Z_OK)//raw inflate, we parse the gzip headers ourselves so that access points can resume mid-member
+    {
+        m_file.close();
+        throw DataFileException("failed to initialize zlib while opening compressed file '" + filename + "'");
+    }
+    m_strmInit = true;
+    m_inBuf.resize(IN_BUF_SIZE);
+    m_history.resize(WINDOW_SIZE);
+    m_index.clear();
+    restart();
+}
+
+void ZIndexedReadImpl::close()
+{
+    if (m_strmInit)
+    {
+        inflateEnd(&m_strm);
+        m_strmInit = false;
+    }
+    m_file.close();
+    m_index.clear();
+}
+
+void ZIndexedReadImpl::fillInput()
+{
+    CaretAssert(m_strm.avail_in == 0);
+    int64_t readret = m_file.read((char*)m_inBuf.data(), IN_BUF_SIZE);
+    if (readret < 0) throw DataFileException("error while reading compressed file '" + m_fileName + "'");
+    m_inPos += readret;
+    m_strm.next_in = m_inBuf.data();
+    m_strm.avail_in = (uInt)readret;
+}
+
+int ZIndexedReadImpl::getByte()
+{
+    if (m_strm.avail_in == 0)
+    {
+        fillInput();
+        if (m_strm.avail_in == 0) return -1;
+    }
+    --m_strm.avail_in;
+    return *(m_strm.next_in++);
+}
+
+bool ZIndexedReadImpl::readMemberHeader()
+{//returns false at the end of the data, anything after the last member that isn't another gzip member is ignored, like gzread does
+    int id1 = getByte();
+    if (id1 == -1) return false;
+    int id2 = getByte();
+    if (id1 != 0x1f || id2 != 0x8b)
+    {
+        if (m_outPos == 0) throw DataFileException("compressed file '" + m_fileName + "' does not start with a gzip header");
+        return false;
+    }
+    int method = getByte(), flags = getByte();
+    if (method != 8) throw DataFileException("unsupported compression method in compressed file '" + m_fileName + "'");
+    for (int i = 0; i < 6; ++i)
+    {//mtime, extra flags, OS
+        if (getByte() == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+    }
+    if (flags & 4)
+    {
+        int lowByte = getByte(), highByte = getByte();
+        if (highByte == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+        for (int extraLength = lowByte | (highByte << 8); extraLength > 0; --extraLength)
+        {
+            if (getByte() == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+        }
+    }
+    for (int mask = 8; mask <= 16; mask <<= 1)
+    {//file name, comment, zero-terminated
+        if (flags & mask)
+        {
+            int c;
+            do
+            {
+                c = getByte();
+                if (c == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+            } while (c != 0);
+        }
+    }
+    if (flags & 2)
+    {
+        getByte();
+        if (getByte() == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+    }
+    inflateReset(&m_strm);
+    m_memberCrc = crc32(0L, Z_NULL, 0);
+    m_memberSize = 0;
+    m_memberContiguous = true;
+    return true;
+}
+
+void ZIndexedReadImpl::readMemberTrailer()
+{
+    uint32_t trailer[2] = { 0, 0 };
+    for (int i = 0; i < 8; ++i)
+    {
+        int c = getByte();
+        if (c == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+        trailer[i / 4] |= ((uint32_t)c) << (8 * (i % 4));
+    }
+    if (m_memberContiguous && (trailer[0] != m_memberCrc || trailer[1] != m_memberSize))
+    {//we can only check members we decompressed from their start
+        throw DataFileException("checksum mismatch in compressed file '" + m_fileName + "', file is corrupt");
+    }
+}
+
+void ZIndexedReadImpl::appendHistory(const unsigned char* data, const int64_t& count)
+{
+    if (count >= WINDOW_SIZE)
+    {
+        memcpy(m_history.data(), data + count - WINDOW_SIZE, WINDOW_SIZE);
+        m_historyPos = 0;
+        return;
+    }
+    int64_t firstPart = min(count, WINDOW_SIZE - m_historyPos);
+    memcpy(m_history.data() + m_historyPos, data, firstPart);
+    memcpy(m_history.data(), data + firstPart, count - firstPart);
+    m_historyPos = (m_historyPos + count) % WINDOW_SIZE;
+}
+
+void ZIndexedReadImpl::addAccessPoint()
+{
+    m_index.push_back(AccessPoint());
+    AccessPoint& point = m_index.back();
+    point.m_outPos = m_outPos;
+    point.m_inPos = m_inPos - m_strm.avail_in;
+    point.m_bits = m_strm.data_type & 7;
+    int64_t windowSize = min(m_outPos, WINDOW_SIZE);
+    point.m_window.resize(windowSize);
+    for (int64_t i = 0; i < windowSize; ++i)
+    {//oldest first
+        point.m_window[i] = m_history[(m_historyPos - windowSize + i + WINDOW_SIZE) % WINDOW_SIZE];
+    }
+}
+
+void ZIndexedReadImpl::restart()
+{
+    if (!m_file.seek(0)) throw DataFileException("seek failed in compressed file '" + m_fileName + "'");
+    m_inPos = 0;
+    m_strm.avail_in = 0;
+    m_outPos = 0;
+    m_historyPos = 0;
+    m_needHeader = true;
+    m_atEOF = false;
+}
+
+void ZIndexedReadImpl::restoreAccessPoint(const AccessPoint& point)
+{
+    int64_t filePos = point.m_inPos - (point.m_bits ? 1 : 0);
+    if (!m_file.seek(filePos)) throw DataFileException("seek failed in compressed file '" + m_fileName + "'");
+    m_inPos = filePos;
+    m_strm.avail_in = 0;
+    inflateReset(&m_strm);
+    if (point.m_bits)
+    {
+        int c = getByte();
+        if (c == -1) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+        inflatePrime(&m_strm, point.m_bits, c >> (8 - point.m_bits));
+    }
+    if (!point.m_window.empty())
+    {
+        inflateSetDictionary(&m_strm, point.m_window.data(), point.m_window.size());
+        appendHistory(point.m_window.data(), point.m_window.size());
+    }
+    m_outPos = point.m_outPos;
+    m_needHeader = false;
+    m_atEOF = false;
+    m_memberContiguous = false;
+}
+
+int64_t ZIndexedReadImpl::inflateInto(unsigned char* out, const int64_t& count)
+{
+    int64_t produced = 0;
+    while (produced < count && !m_atEOF)
+    {
+        if (m_needHeader)
+        {
+            if (!readMemberHeader())
+            {
+                m_atEOF = true;
+                break;
+            }
+            m_needHeader = false;
+        }
+        if (m_strm.avail_in == 0)
+        {
+            fillInput();
+            if (m_strm.avail_in == 0) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+        }
+        unsigned char* start = out + produced;
+        m_strm.next_out = start;
+        m_strm.avail_out = (uInt)min(count - produced, CHUNK_SIZE);
+        int ret = inflate(&m_strm, Z_BLOCK);//stop at block boundaries so we can record access points
+        if (ret == Z_NEED_DICT || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR || ret == Z_STREAM_ERROR)
+        {
+            throw DataFileException("error while reading compressed file '" + m_fileName + "', file is corrupt");
+        }
+        int64_t numOut = m_strm.next_out - start;
+        if (numOut > 0)
+        {
+            appendHistory(start, numOut);
+            if (m_memberContiguous) m_memberCrc = crc32(m_memberCrc, start, numOut);
+            m_memberSize += (uint32_t)numOut;//gzip stores the size modulo 2^32
+            m_outPos += numOut;
+            produced += numOut;
+        }
+        if (ret == Z_STREAM_END)
+        {
+            readMemberTrailer();
+            m_needHeader = true;
+            continue;
+        }
+        if ((m_strm.data_type & 128) && !(m_strm.data_type & 64))
+        {//at the end of a block header that isn't the last block
+            int64_t lastIndexed = (m_index.empty() ? 0 : m_index.back().m_outPos);
+            if (m_outPos >= lastIndexed + SPAN) addAccessPoint();
+        }
+    }
+    return produced;
+}
+
+void ZIndexedReadImpl::skipForward(const int64_t& count)
+{
+    if (m_discard.empty()) m_discard.resize(IN_BUF_SIZE);
+    int64_t remaining = count;
+    while (remaining > 0)
+    {
+        int64_t got = inflateInto(m_discard.data(), min(remaining, (int64_t)m_discard.size()));
+        if (got == 0) throw DataFileException("seek failed in compressed file '" + m_fileName + "', position is past the end of the file");
+        remaining -= got;
+    }
+}
+
+void ZIndexedReadImpl::seek(const int64_t& position)
+{
+    if (!m_strmInit) throw DataFileException("seek called on unopened ZIndexedReadImpl");//shouldn't happen
+    if (position == m_outPos) return;
+    if (position < m_outPos || position - m_outPos > SKIP_AHEAD)
+    {
+        int low = 0, high = (int)m_index.size();//find the last access point at or before position
+        while (low < high)
+        {
+            int mid = (low + high) / 2;
+            if (m_index[mid].m_outPos <= position)
+            {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low == 0)
+        {
+            if (position < m_outPos) restart();//otherwise, no access point helps, continue from where we are
+        } else {
+            const AccessPoint& point = m_index[low - 1];
+            if (position < m_outPos || point.m_outPos > m_outPos) restoreAccessPoint(point);
+        }
+    }
+    skipForward(position - m_outPos);
+}
+
+void ZIndexedReadImpl::read(void* dataOut, const int64_t& count, int64_t* numRead)
+{
+    if (!m_strmInit) throw DataFileException("read called on unopened ZIndexedReadImpl");//shouldn't happen
+    int64_t totalRead = inflateInto((unsigned char*)dataOut, count);
+    if (numRead == NULL)
+    {
+        if (totalRead != count) throw DataFileException("premature end of file in compressed file '" + m_fileName + "'");
+    } else {
+        *numRead = totalRead;
+    }
+}
+
+ZIndexedReadImpl::~ZIndexedReadImpl()
+{
+    close();
+}
+
+void ZParallelWriteImpl::open(const QString& filename, const CaretBinaryFile::OpenMode& opmode)
+{
+    close();
+    m_fileName = filename;
+    if (opmode != CaretBinaryFile::WRITE_TRUNCATE) throw DataFileException("compressed file only supports READ and WRITE_TRUNCATE modes");
+    m_file.setFileName(filename);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        throw DataFileException("failed to open compressed file '" + filename + "', unable to create file");
+    }
+    m_open = true;
+    m_crc = crc32(0L, Z_NULL, 0);
+    m_totalSize = 0;
+    m_pending.clear();
+    m_pending.reserve(BLOCK_SIZE * BATCH_BLOCKS);
+    m_dictionary.clear();
+    const unsigned char header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 3 };//deflate, no flags, no mtime, unix
+    writeToFile(header, 10);
+}
+
+void ZParallelWriteImpl::writeToFile(const void* data, const int64_t& count)
+{
+    int64_t total = 0;
+    while (total < count)
+    {
+        int64_t writeret = m_file.write(((const char*)data) + total, count - total);
+        if (writeret < 1) throw DataFileException("failed to write to compressed file '" + m_fileName + "'");
+        total += writeret;
+    }
+}
+
+void ZParallelWriteImpl::compressBatch(const bool& last)
+{
+    const int64_t batchSize = (int64_t)m_pending.size();
+    int numBlocks = (int)((batchSize + BLOCK_SIZE - 1) / BLOCK_SIZE);
+    if (numBlocks == 0)
+    {
+        if (!last) return;
+        numBlocks = 1;//the stream still needs a final block
+    }
+    vector<vector<unsigned char> > blockOut(numBlocks);
+    vector<uint32_t> blockCrc(numBlocks);
+    vector<char> blockFailed(numBlocks, 0);
+#pragma omp CARET_PARFOR schedule(dynamic)
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        const int64_t start = i * BLOCK_SIZE, length = min(BLOCK_SIZE, batchSize - start);
+        unsigned char* blockData = m_pending.data() + start;
+        blockCrc[i] = crc32(crc32(0L, Z_NULL, 0), blockData, length);
+        z_stream strm;
+        memset(&strm, 0, sizeof(strm));
+        if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        {
+            blockFailed[i] = 1;
+            continue;
+        }
+        if (i > 0)
+        {
+            const int64_t dictSize = min(start, WINDOW_SIZE);
+            deflateSetDictionary(&strm, blockData - dictSize, dictSize);
+        } else if (!m_dictionary.empty()) {
+            deflateSetDictionary(&strm, m_dictionary.data(), m_dictionary.size());
+        }
+        const bool finish = last && i == numBlocks - 1;
+        vector<unsigned char>& out = blockOut[i];
+        out.resize(deflateBound(&strm, length) + 64);//sync flush adds a few bytes beyond the bound
+        strm.next_in = blockData;
+        strm.avail_in = (uInt)length;
+        int64_t used = 0;
+        for (;;)
+        {
+            strm.next_out = out.data() + used;
+            strm.avail_out = (uInt)(out.size() - used);
+            int ret = deflate(&strm, finish ? Z_FINISH : Z_SYNC_FLUSH);
+            used = out.size() - strm.avail_out;
+            if (ret == Z_STREAM_ERROR)
+            {
+                blockFailed[i] = 1;
+                break;
+            }
+            if (finish ? ret == Z_STREAM_END : (strm.avail_in == 0 && strm.avail_out != 0)) break;
+            out.resize(out.size() * 2);
+        }
+        out.resize(used);
+        deflateEnd(&strm);
+    }
+    for (int i = 0; i < numBlocks; ++i)
+    {
+        if (blockFailed[i]) throw DataFileException("zlib error while compressing data for file '" + m_fileName + "'");
+        const int64_t length = min(BLOCK_SIZE, batchSize - i * BLOCK_SIZE);
+        m_crc = crc32_combine(m_crc, blockCrc[i], length);
+        writeToFile(blockOut[i].data(), blockOut[i].size());
+    }
+    const int64_t dictSize = min(batchSize, WINDOW_SIZE);
+    if (dictSize > 0) m_dictionary.assign(m_pending.end() - dictSize, m_pending.end());
+    m_totalSize += batchSize;
+    m_pending.clear();
+}
+
+void ZParallelWriteImpl::write(const void* dataIn, const int64_t& count)
+{
+    if (!m_open) throw DataFileException("write called on unopened ZParallelWriteImpl");//shouldn't happen
+    const unsigned char* data = (const unsigned char*)dataIn;
+    const int64_t batchBytes = BLOCK_SIZE * BATCH_BLOCKS;
+    int64_t done = 0;
+    while (done < count)
+    {
+        if ((int64_t)m_pending.size() == batchBytes) compressBatch(false);//only compress a full batch once we know more data follows, so the last block gets Z_FINISH
+        int64_t toCopy = min(count - done, batchBytes - (int64_t)m_pending.size());
+        m_pending.insert(m_pending.end(), data + done, data + done + toCopy);
+        done += toCopy;
+    }
+}
+
+void ZParallelWriteImpl::seek(const int64_t& position)
+{
+    if (!m_open) throw DataFileException("seek called on unopened ZParallelWriteImpl");//shouldn't happen
+    int64_t current = pos();
+    if (position == current) return;
+    if (position < current) throw DataFileException("can't seek backwards while writing compressed file '" + m_fileName + "'");
+    vector<unsigned char> zeros(min(position - current, BLOCK_SIZE), 0);//like gzseek, fill forward seeks with zeros
+    while (current < position)
+    {
+        int64_t toWrite = min(position - current, (int64_t)zeros.size());
+        write(zeros.data(), toWrite);
+        current += toWrite;
+    }
+}
+
+void ZParallelWriteImpl::close()
+{
+    if (!m_open) return;
+    m_open = false;//don't try again from the destructor if something throws
+    compressBatch(true);
+    unsigned char trailer[8];
+    uint32_t isize = (uint32_t)m_totalSize;//modulo 2^32, as gzip specifies
+    for (int i = 0; i < 4; ++i)
+    {
+        trailer[i] = (m_crc >> (8 * i)) & 0xff;
+        trailer[i + 4] = (isize >> (8 * i)) & 0xff;
+    }
+    writeToFile(trailer, 8);
+    m_file.close();
+    if (m_file.error() != QFile::NoError) throw DataFileException("error closing compressed file '" + m_fileName + "'");
+}
+
+ZParallelWriteImpl::~ZParallelWriteImpl()
+{
+    try//throwing from a destructor is a bad idea
+    {
+        close();
+    } catch (CaretException& e) {
+        CaretLogSevere(e.whatString());
+    } catch (exception& e) {
+        CaretLogSevere(e.what());
+    } catch (...) {
+        CaretLogSevere("caught unknown exception type while closing a compressed file");
+    }
+}
 #endif //ZLIB_VERSION
 
 void QFileImpl::open(const QString& filename, const CaretBinaryFile::OpenMode& opmode)
@@ -0,0 +1,343 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "CaretTrace.h"
+
+#include "CaretLogger.h"
+#include "CaretMutex.h"
+#include "ElapsedTimer.h"
+
+#include <QFile>
+#include <QTextStream>
+#include <QThread>
+
+#ifdef CARET_OS_MACOSX
+#include <mach/mach.h>
+#endif
+#ifndef CARET_OS_WINDOWS
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+namespace
+{
+    struct TraceEvent
+    {
+        AString m_name;
+        const char* m_category;//NULL for instant events
+        int m_thread;
+        double m_startMicros, m_durationMicros;
+        int64_t m_bytesRead, m_bytesWritten;//counters at start, replaced with the difference at end
+        int64_t m_residentStart, m_residentEnd;
+    };
+    
+    struct MemorySample
+    {
+        double m_micros;
+        int64_t m_resident;
+    };
+    
+    class MemorySampler : public QThread
+    {
+        volatile bool m_stop;
+    public:
+        MemorySampler() { m_stop = false; }
+        void stop() { m_stop = true; wait(); }
+    protected:
+        void run();
+    };
+    
+    bool s_enabled = false;
+    AString s_fileName;
+    CaretMutex s_mutex;
+    ElapsedTimer* s_timer = NULL;//pointer so that it doesn't get constructed during static initialization
+    MemorySampler* s_sampler = NULL;
+    vector<TraceEvent> s_events;
+    vector<MemorySample> s_samples;
+    map<Qt::HANDLE, int> s_threadIndices;
+    int64_t s_bytesRead = 0, s_bytesWritten = 0;
+    const unsigned long SAMPLE_INTERVAL_MS = 10;
+    
+    double nowMicros()
+    {
+        return s_timer->getElapsedTimeMilliseconds() * 1000.0;
+    }
+    
+    int getThreadIndex()
+    {//call with the mutex locked
+        Qt::HANDLE myThread = QThread::currentThreadId();
+        map<Qt::HANDLE, int>::iterator iter = s_threadIndices.find(myThread);
+        if (iter != s_threadIndices.end()) return iter->second;
+        int ret = (int)s_threadIndices.size();
+        s_threadIndices[myThread] = ret;
+        return ret;
+    }
+    
+    void recordMemorySample()
+    {
+        int64_t resident = CaretTrace::getResidentBytes();
+        if (resident < 0) return;
+        CaretMutexLocker myLock(&s_mutex);
+        if (!s_enabled) return;
+        MemorySample mySample;
+        mySample.m_micros = nowMicros();
+        mySample.m_resident = resident;
+        s_samples.push_back(mySample);
+    }
+    
+    void MemorySampler::run()
+    {
+        while (!m_stop)
+        {
+            recordMemorySample();
+            msleep(SAMPLE_INTERVAL_MS);
+        }
+    }
+    
+    AString jsonEscape(const AString& input)
+    {
+        AString ret;
+        for (int i = 0; i < input.size(); ++i)
+        {
+            QChar c = input[i];
+            if (c == '"' || c == '\\')
+            {
+                ret += '\\';
+                ret += c;
+            } else if (c.unicode() < 0x20) {
+                ret += ' ';
+            } else {
+                ret += c;
+            }
+        }
+        return ret;
+    }
+    
+    bool sampleBefore(const MemorySample& left, const MemorySample& right)
+    {
+        return left.m_micros < right.m_micros;
+    }
+    
+    AString megabytes(const int64_t& bytes)
+    {
+        return AString::number(bytes / 1048576.0, 'f', 2);
+    }
+    
+    ///largest sampled resident size during [start, end], including the values recorded at the ends of the event
+    int64_t peakResident(const TraceEvent& myEvent)
+    {
+        int64_t ret = max(myEvent.m_residentStart, myEvent.m_residentEnd);
+        MemorySample searchSample;
+        searchSample.m_micros = myEvent.m_startMicros;
+        const double endMicros = myEvent.m_startMicros + myEvent.m_durationMicros;
+        for (vector<MemorySample>::const_iterator iter = lower_bound(s_samples.begin(), s_samples.end(), searchSample, sampleBefore);
+             iter != s_samples.end() && iter->m_micros <= endMicros; ++iter)
+        {//samples are in time order
+            ret = max(ret, iter->m_resident);
+        }
+        return ret;
+    }
+}
+
+void CaretTrace::enable(const AString& fileName)
+{
+    CaretMutexLocker myLock(&s_mutex);
+    if (s_enabled) return;
+    s_fileName = fileName;
+    s_events.clear();
+    s_samples.clear();
+    s_threadIndices.clear();
+    s_bytesRead = 0;
+    s_bytesWritten = 0;
+    if (s_timer == NULL) s_timer = new ElapsedTimer();
+    s_timer->start();
+    s_enabled = true;
+    if (getResidentBytes() >= 0)
+    {
+        s_sampler = new MemorySampler();
+        s_sampler->start();
+    }
+}
+
+bool CaretTrace::isEnabled()
+{
+    return s_enabled;
+}
+
+void CaretTrace::addBytesRead(const int64_t& bytes)
+{
+    if (!s_enabled) return;
+    CaretMutexLocker myLock(&s_mutex);
+    s_bytesRead += bytes;
+}
+
+void CaretTrace::addBytesWritten(const int64_t& bytes)
+{
+    if (!s_enabled) return;
+    CaretMutexLocker myLock(&s_mutex);
+    s_bytesWritten += bytes;
+}
+
+void CaretTrace::addInstant(const AString& name)
+{
+    if (!s_enabled) return;
+    CaretMutexLocker myLock(&s_mutex);
+    TraceEvent myEvent;
+    myEvent.m_name = name;
+    myEvent.m_category = NULL;
+    myEvent.m_thread = getThreadIndex();
+    myEvent.m_startMicros = nowMicros();
+    myEvent.m_durationMicros = 0.0;
+    myEvent.m_bytesRead = 0;
+    myEvent.m_bytesWritten = 0;
+    myEvent.m_residentStart = -1;
+    myEvent.m_residentEnd = -1;
+    s_events.push_back(myEvent);
+}
+
+int64_t CaretTrace::getResidentBytes()
+{
+#if defined(CARET_OS_MACOSX)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) != KERN_SUCCESS) return -1;
+    return info.resident_size;
+#elif defined(CARET_OS_WINDOWS)
+    return -1;//would need psapi
+#else
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (statm == NULL) return -1;
+    long long totalPages = 0, residentPages = 0;
+    int numRead = fscanf(statm, "%lld %lld", &totalPages, &residentPages);
+    fclose(statm);
+    if (numRead != 2) return -1;
+    return residentPages * (int64_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+int64_t CaretTrace::getPeakResidentBytes()
+{
+#ifdef CARET_OS_WINDOWS
+    return -1;
+#else
+    struct rusage myUsage;
+    if (getrusage(RUSAGE_SELF, &myUsage) != 0) return -1;
+#ifdef CARET_OS_MACOSX
+    return myUsage.ru_maxrss;//bytes on mac
+#else
+    return myUsage.ru_maxrss * (int64_t)1024;//kilobytes on linux
+#endif
+#endif
+}
+
+void CaretTrace::writeTrace()
+{
+    if (!s_enabled) return;
+    if (s_sampler != NULL)
+    {
+        s_sampler->stop();//don't hold the mutex while waiting, the sampler needs it
+        delete s_sampler;
+        s_sampler = NULL;
+    }
+    CaretMutexLocker myLock(&s_mutex);
+    s_enabled = false;
+    QFile myFile(s_fileName);
+    if (!myFile.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        CaretLogWarning("unable to open trace file '" + s_fileName + "' for writing");
+        return;
+    }
+    QTextStream myStream(&myFile);
+    myStream << "{\"displayTimeUnit\": \"ms\",\n\"otherData\": {\"peak_resident_mb\": " << megabytes(getPeakResidentBytes()) << "},\n\"traceEvents\": [\n";
+    bool first = true;
+    for (size_t i = 0; i < s_events.size(); ++i)
+    {
+        const TraceEvent& myEvent = s_events[i];
+        if (!first) myStream << ",\n";
+        first = false;
+        myStream << "{\"name\": \"" << jsonEscape(myEvent.m_name) << "\", \"pid\": 1, \"tid\": " << myEvent.m_thread
+                 << ", \"ts\": " << AString::number(myEvent.m_startMicros, 'f', 0);
+        if (myEvent.m_category == NULL)
+        {
+            myStream << ", \"ph\": \"i\", \"s\": \"t\"}";
+            continue;
+        }
+        myStream << ", \"ph\": \"X\", \"cat\": \"" << myEvent.m_category << "\", \"dur\": " << AString::number(myEvent.m_durationMicros, 'f', 0)
+                 << ", \"args\": {\"bytes_read\": " << myEvent.m_bytesRead << ", \"bytes_written\": " << myEvent.m_bytesWritten;
+        if (myEvent.m_residentStart >= 0)
+        {
+            myStream << ", \"resident_start_mb\": " << megabytes(myEvent.m_residentStart) << ", \"resident_end_mb\": " << megabytes(myEvent.m_residentEnd)
+                     << ", \"resident_peak_mb\": " << megabytes(peakResident(myEvent));
+        }
+        myStream << "}}";
+    }
+    for (size_t i = 0; i < s_samples.size(); ++i)
+    {
+        if (!first) myStream << ",\n";
+        first = false;
+        myStream << "{\"name\": \"resident memory\", \"ph\": \"C\", \"pid\": 1, \"ts\": " << AString::number(s_samples[i].m_micros, 'f', 0)
+                 << ", \"args\": {\"MB\": " << megabytes(s_samples[i].m_resident) << "}}";
+    }
+    myStream << "\n]}\n";
+    s_events.clear();
+    s_samples.clear();
+}
+
+CaretTraceScope::CaretTraceScope(const AString& name, const char* category)
+{
+    m_index = -1;
+    if (!s_enabled) return;
+    int64_t resident = CaretTrace::getResidentBytes();//outside the lock, it reads a file
+    CaretMutexLocker myLock(&s_mutex);
+    if (!s_enabled) return;
+    TraceEvent myEvent;
+    myEvent.m_name = name;
+    myEvent.m_category = category;
+    myEvent.m_thread = getThreadIndex();
+    myEvent.m_startMicros = nowMicros();
+    myEvent.m_durationMicros = 0.0;
+    myEvent.m_bytesRead = s_bytesRead;
+    myEvent.m_bytesWritten = s_bytesWritten;
+    myEvent.m_residentStart = resident;
+    myEvent.m_residentEnd = resident;
+    m_index = (int64_t)s_events.size();
+    s_events.push_back(myEvent);
+}
+
+CaretTraceScope::~CaretTraceScope()
+{
+    if (m_index < 0) return;
+    int64_t resident = CaretTrace::getResidentBytes();
+    CaretMutexLocker myLock(&s_mutex);
+    if (!s_enabled || m_index >= (int64_t)s_events.size()) return;//trace was written while this scope was open
+    TraceEvent& myEvent = s_events[m_index];
+    myEvent.m_durationMicros = nowMicros() - myEvent.m_startMicros;
+    myEvent.m_bytesRead = s_bytesRead - myEvent.m_bytesRead;
+    myEvent.m_bytesWritten = s_bytesWritten - myEvent.m_bytesWritten;
+    myEvent.m_residentEnd = resident;
+}
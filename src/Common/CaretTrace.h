@@ -0,0 +1,68 @@
+#ifndef __CARET_TRACE_H__
+#define __CARET_TRACE_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "AString.h"
+
+#include <stdint.h>
+
+namespace caret {
+    
+    ///records nested timing scopes, I/O byte counts and memory use, and writes them as a Chrome trace (viewable in chrome://tracing or Perfetto)
+    ///does nothing unless enabled, so the hooks can stay in place at little cost
+    class CaretTrace
+    {
+        CaretTrace();//static only
+    public:
+        ///start recording, the trace is written to fileName by writeTrace()
+        static void enable(const AString& fileName);
+        static bool isEnabled();
+        ///write the recorded events and stop recording, does nothing if not enabled
+        static void writeTrace();
+        
+        static void addBytesRead(const int64_t& bytes);
+        static void addBytesWritten(const int64_t& bytes);
+        ///a point event, for things like progress task descriptions
+        static void addInstant(const AString& name);
+        
+        ///current resident set size of the process, -1 if unknown on this platform
+        static int64_t getResidentBytes();
+        ///peak resident set size so far, -1 if unknown on this platform
+        static int64_t getPeakResidentBytes();
+        
+        friend class CaretTraceScope;
+    };
+    
+    ///times the lifetime of the object, scopes nest by time on each thread
+    class CaretTraceScope
+    {
+        int64_t m_index;//-1 when tracing is disabled
+        CaretTraceScope(const CaretTraceScope&);
+        CaretTraceScope& operator=(const CaretTraceScope&);
+    public:
+        CaretTraceScope(const AString& name, const char* category);
+        ~CaretTraceScope();
+    };
+    
+}
+
+#endif //__CARET_TRACE_H__
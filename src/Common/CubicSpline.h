@@ -53,6 +53,15 @@ namespace caret {
             return p0 * m_weights[0] + p1 * m_weights[1] + p2 * m_weights[2];
         }
         
+        ///the weights of the four samples, for when the spline will be applied to many sets of samples
+        inline void getWeights(float weightsOut[4]) const
+        {
+            weightsOut[0] = m_weights[0];
+            weightsOut[1] = m_weights[1];
+            weightsOut[2] = m_weights[2];
+            weightsOut[3] = m_weights[3];
+        }
+        
         ///convenience function for edge evaluating without dummy arguments
         inline float evalBothEdge(const float p1, const float p2)
         {
@@ -169,6 +169,13 @@ DataFileTypeEnum::initialize()
                                         false,
                                         "dscalar.nii"));
     
+    enumData.push_back(DataFileTypeEnum(CONNECTIVITY_DENSE_SPARSE,
+                                        "CONNECTIVITY_DENSE_SPARSE",
+                                        "Connectivity - Dense Sparse",
+                                        "CONNECTIVITY SPARSE",
+                                        false,
+                                        "dconn.wbsparse"));
+    
     enumData.push_back(DataFileTypeEnum(CONNECTIVITY_DENSE_TIME_SERIES,
                                         "CONNECTIVITY_DENSE_TIME_SERIES", 
                                         "Connectivity - Dense Data Series",
@@ -0,0 +1,48 @@
+#ifndef __FNV_HASH_H__
+#define __FNV_HASH_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace caret {
+    
+    ///64-bit FNV-1a hash, for content keys and fingerprints that need to be cheap and stable across runs, not for security
+    class FnvHash
+    {
+        uint64_t m_hash;
+    public:
+        FnvHash() { m_hash = 14695981039346656037ULL; }
+        
+        ///add raw bytes, the result depends on byte order, so don't compare hashes of non-byte data across platforms
+        void addBytes(const void* data, const size_t& numBytes);
+        
+        ///add the bytes of a plain value or pointer
+        template <typename T>
+        void add(const T& value) { addBytes(&value, sizeof(T)); }
+        
+        uint64_t getHash() const { return m_hash; }
+    };
+    
+}
+
+#endif //__FNV_HASH_H__
@@ -20,6 +20,7 @@
 
 #include "ProgressObject.h"
 #include "CaretAssert.h"
+#include "CaretTrace.h"
 #include "EventProgressUpdate.h"
 #include "EventManager.h"
 
@@ -231,6 +232,7 @@ void LevelProgress::reportProgress(const float currentTotal)
 
 void LevelProgress::setTask(const AString& taskDescription)
 {//maybe this should be in a setter in m_progObjRef, here for coherence with progress reporting
+    CaretTrace::addInstant(taskDescription);//command line algorithms have no progress object, but the task is still useful in a trace
     if (m_progObjRef == NULL) return;
     m_progObjRef->m_description = taskDescription;
     EventProgressUpdate myUpdate(m_progObjRef);
@@ -25,64 +25,206 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <limits>
 #include <vector>
 
 using namespace caret;
 using namespace std;
 
-float ReductionOperation::reduce(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type)
+namespace
+{
+    //scratch to use when the caller doesn't provide one
+    ReductionOperation::Scratch& getScratch(ReductionOperation::Scratch* scratch, ReductionOperation::Scratch& localScratch)
+    {
+        if (scratch == NULL) return localScratch;
+        return *scratch;
+    }
+    
+    //single pass mean and sum of squared residuals, using independent Welford accumulators on interleaved elements so the loop isn't one long dependency chain,
+    //merged at the end with the pairwise formula from Chan, Golub and LeVeque
+    void welfordMeanResid(const float* data, const int64_t& numElems, double& meanOut, double& residsqrOut)
+    {
+        const int LANES = 4;
+        double mean[LANES] = { 0.0, 0.0, 0.0, 0.0 }, resid[LANES] = { 0.0, 0.0, 0.0, 0.0 };
+        const int64_t numBlocks = numElems / LANES;
+        for (int64_t b = 0; b < numBlocks; ++b)
+        {
+            const double invCount = 1.0 / (b + 1);//all lanes have the same count inside the blocked loop
+            const float* block = data + b * LANES;
+            for (int l = 0; l < LANES; ++l)
+            {
+                double delta = block[l] - mean[l];
+                mean[l] += delta * invCount;
+                resid[l] += delta * (block[l] - mean[l]);
+            }
+        }
+        double count = numBlocks, totalMean = mean[0], totalResid = resid[0];
+        for (int l = 1; l < LANES; ++l)
+        {
+            if (numBlocks == 0) break;
+            double newCount = count + numBlocks;
+            double delta = mean[l] - totalMean;
+            totalMean += delta * numBlocks / newCount;
+            totalResid += resid[l] + delta * delta * count * numBlocks / newCount;
+            count = newCount;
+        }
+        for (int64_t i = numBlocks * LANES; i < numElems; ++i)//leftovers, one at a time
+        {
+            count += 1.0;
+            double delta = data[i] - totalMean;
+            totalMean += delta / count;
+            totalResid += delta * (data[i] - totalMean);
+        }
+        meanOut = totalMean;
+        residsqrOut = totalResid;
+    }
+    
+    double blockedSum(const float* data, const int64_t& numElems)
+    {
+        double sums[4] = { 0.0, 0.0, 0.0, 0.0 };
+        int64_t i = 0;
+        for (; i + 4 <= numElems; i += 4)
+        {
+            sums[0] += data[i];
+            sums[1] += data[i + 1];
+            sums[2] += data[i + 2];
+            sums[3] += data[i + 3];
+        }
+        for (; i < numElems; ++i) sums[0] += data[i];
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+    
+    //same comparison semantics as the simple loop (NaNs after the first element are never selected), but with independent comparisons
+    float blockedExtreme(const float* data, const int64_t& numElems, const bool& findMax)
+    {
+        float best[4] = { data[0], data[0], data[0], data[0] };
+        int64_t i = 1;
+        if (findMax)
+        {
+            for (; i + 4 <= numElems; i += 4)
+            {
+                if (data[i] > best[0]) best[0] = data[i];
+                if (data[i + 1] > best[1]) best[1] = data[i + 1];
+                if (data[i + 2] > best[2]) best[2] = data[i + 2];
+                if (data[i + 3] > best[3]) best[3] = data[i + 3];
+            }
+            for (; i < numElems; ++i) if (data[i] > best[0]) best[0] = data[i];
+            for (int l = 1; l < 4; ++l) if (best[l] > best[0]) best[0] = best[l];
+        } else {
+            for (; i + 4 <= numElems; i += 4)
+            {
+                if (data[i] < best[0]) best[0] = data[i];
+                if (data[i + 1] < best[1]) best[1] = data[i + 1];
+                if (data[i + 2] < best[2]) best[2] = data[i + 2];
+                if (data[i + 3] < best[3]) best[3] = data[i + 3];
+            }
+            for (; i < numElems; ++i) if (data[i] < best[0]) best[0] = data[i];
+            for (int l = 1; l < 4; ++l) if (best[l] < best[0]) best[0] = best[l];
+        }
+        return best[0];
+    }
+    
+    //open addressing hash table over the bit patterns of the values, sized to at most half full
+    int64_t hashTableSize(const int64_t& numElems)
+    {
+        int64_t ret = 16;
+        while (ret < 2 * numElems) ret *= 2;
+        return ret;
+    }
+    
+    inline uint32_t hashBits(float value)
+    {
+        if (value == 0.0f) value = 0.0f;//-0 and 0 compare equal, so they must land in the same bucket
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    
+    inline int64_t hashFind(const vector<float>& hashValues, const vector<int64_t>& hashCounts, const uint32_t& bits)
+    {
+        const int64_t mask = (int64_t)hashValues.size() - 1;
+        int64_t slot = (int64_t)((bits * 2654435761U) >> 7) & mask;//multiplicative hash, low bits of float patterns are often all zero
+        while (hashCounts[slot] != 0 && hashBits(hashValues[slot]) != bits) slot = (slot + 1) & mask;
+        return slot;
+    }
+    
+    float selectMedian(vector<float>& values)
+    {
+        const int64_t numElems = (int64_t)values.size();
+        const int64_t half = numElems / 2;
+        nth_element(values.begin(), values.begin() + half, values.end());
+        if ((numElems & 1) == 0)//if even, average middle two, the lower middle is the largest element before the upper middle
+        {
+            float lower = *max_element(values.begin(), values.begin() + half);
+            return (lower + values[half]) / 2.0f;
+        } else {
+            return values[half];//otherwise, take the center
+        }
+    }
+    
+    float hashMode(const float* data, const int64_t& numElems, vector<float>& hashValues, vector<int64_t>& hashCounts)
+    {
+        const int64_t tableSize = hashTableSize(numElems);
+        hashValues.resize(tableSize);
+        hashCounts.assign(tableSize, 0);
+        for (int64_t i = 0; i < numElems; ++i)
+        {
+            int64_t slot = hashFind(hashValues, hashCounts, hashBits(data[i]));
+            if (hashCounts[slot] == 0) hashValues[slot] = data[i];
+            ++hashCounts[slot];
+        }
+        int64_t bestCount = 0;
+        float bestval = -1.0f;
+        for (int64_t slot = 0; slot < tableSize; ++slot)
+        {//ties go to the smaller value, as they did when this scanned sorted data
+            if (hashCounts[slot] > bestCount || (hashCounts[slot] == bestCount && hashCounts[slot] != 0 && hashValues[slot] < bestval))
+            {
+                bestCount = hashCounts[slot];
+                bestval = hashValues[slot];
+            }
+        }
+        return bestval;
+    }
+}
+
+float ReductionOperation::reduce(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch)
 {
     CaretAssert(numElems > 0);
     switch (type)
     {
         case ReductionEnum::INVALID:
             throw CaretException("reduction requested with 'INVALID' method");
-        case ReductionEnum::SAMPSTDEV://all of these start by taking the average, for stability
+        case ReductionEnum::SAMPSTDEV:
         case ReductionEnum::TSNR:
         case ReductionEnum::COV:
             if (numElems < 2) throw CaretException("taking the sample standard deviation of 1 element would require dividing by zero");
-        case ReductionEnum::MEAN:
         case ReductionEnum::STDEV:
         case ReductionEnum::VARIANCE:
-        case ReductionEnum::SUM:
         {
-            double sum = 0.0;
-            for (int64_t i = 0; i < numElems; ++i) sum += data[i];
-            switch (type)
+            double mean, residsqr;
+            welfordMeanResid(data, numElems, mean, residsqr);
+            switch(type)
             {
-                case ReductionEnum::SUM:
-                    return sum;
-                case ReductionEnum::MEAN:
-                    return sum / numElems;
+                case ReductionEnum::STDEV:
+                    return sqrt(residsqr / numElems);
+                case ReductionEnum::SAMPSTDEV:
+                    return sqrt(residsqr / (numElems - 1));
+                case ReductionEnum::VARIANCE:
+                    return residsqr / numElems;
+                case ReductionEnum::TSNR:
+                    return mean / sqrt(residsqr / (numElems - 1));
+                case ReductionEnum::COV:
+                    return sqrt(residsqr / (numElems - 1)) / mean;
                 default:
-                {
-                    float mean = sum / numElems;
-                    double residsqr = 0.0;
-                    for (int64_t i = 0; i < numElems; ++i)
-                    {
-                        float tempf = data[i] - mean;
-                        residsqr += tempf * tempf;
-                    }
-                    switch(type)
-                    {
-                        case ReductionEnum::STDEV:
-                            return sqrt(residsqr / numElems);
-                        case ReductionEnum::SAMPSTDEV:
-                            return sqrt(residsqr / (numElems - 1));
-                        case ReductionEnum::VARIANCE:
-                            return residsqr / numElems;
-                        case ReductionEnum::TSNR:
-                            return mean / sqrt(residsqr / (numElems - 1));
-                        case ReductionEnum::COV:
-                            return sqrt(residsqr / (numElems - 1)) / mean;
-                        default:
-                            CaretAssertMessage(0, "unhandled type in sum-based reduction");
-                            return 0.0f;
-                    }
-                }
+                    CaretAssertMessage(0, "unhandled type in variance-based reduction");
+                    return 0.0f;
             }
         }
+        case ReductionEnum::MEAN:
+            return blockedSum(data, numElems) / numElems;
+        case ReductionEnum::SUM:
+            return blockedSum(data, numElems);
         case ReductionEnum::PRODUCT:
         {
             double prod = 1.0;
@@ -90,17 +232,9 @@ float ReductionOperation::reduce(const float* data, const int64_t& numElems, con
             return prod;
         }
         case ReductionEnum::MAX:
-        {
-            float max = data[0];
-            for (int64_t i = 1; i < numElems; ++i) if (data[i] > max) max = data[i];
-            return max;
-        }
+            return blockedExtreme(data, numElems, true);
         case ReductionEnum::MIN:
-        {
-            float min = data[0];
-            for (int64_t i = 1; i < numElems; ++i) if (data[i] < min) min = data[i];
-            return min;
-        }
+            return blockedExtreme(data, numElems, false);
         case ReductionEnum::INDEXMAX:
         {
             float max = data[0];
@@ -131,44 +265,16 @@ float ReductionOperation::reduce(const float* data, const int64_t& numElems, con
         }
         case ReductionEnum::MEDIAN:
         {
-            vector<float> dataCopy(numElems);
-            for (int64_t i = 0; i < numElems; ++i) dataCopy[i] = data[i];
-            sort(dataCopy.begin(), dataCopy.end());
-            if ((numElems & 1) == 0)//if even, average middle two
-            {
-                return (dataCopy[numElems / 2 - 1] + dataCopy[numElems / 2]) / 2.0f;
-            } else {
-                return dataCopy[numElems / 2];//otherwise, take the center
-            }
+            Scratch localScratch;
+            vector<float>& dataCopy = getScratch(scratch, localScratch).m_values;
+            dataCopy.assign(data, data + numElems);
+            return selectMedian(dataCopy);
         }
         case ReductionEnum::MODE:
         {
-            vector<float> dataCopy(numElems);
-            for (int64_t i = 0; i < numElems; ++i) dataCopy[i] = data[i];
-            sort(dataCopy.begin(), dataCopy.end());//sort to put same-value next to each other, a hash based map could be faster for large arrays, but oh well
-            int bestCount = 0, curCount = 1;
-            float bestval = -1.0f, curval = dataCopy[0];
-            for (int64_t i = 1; i < numElems; ++i)//search for largest contiguous region
-            {
-                if (dataCopy[i] == curval)
-                {
-                    ++curCount;
-                } else {
-                    if (curCount > bestCount)
-                    {
-                        bestval = curval;
-                        bestCount = curCount;
-                    }
-                    curval = dataCopy[i];
-                    curCount = 1;
-                }
-            }
-            if (curCount > bestCount)
-            {
-                bestval = curval;
-                bestCount = curCount;
-            }
-            return bestval;
+            Scratch localScratch;
+            Scratch& myScratch = getScratch(scratch, localScratch);
+            return hashMode(data, numElems, myScratch.m_hashValues, myScratch.m_hashCounts);
         }
         case ReductionEnum::COUNT_NONZERO:
         {
@@ -186,7 +292,27 @@ float ReductionOperation::reduce(const float* data, const int64_t& numElems, con
     return 0.0f;
 }
 
-float ReductionOperation::reduceExcludeDev(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove)
+float ReductionOperation::percentile(const float* data, const int64_t& numElems, const float& percent, Scratch* scratch)
+{
+    CaretAssert(numElems > 0);
+    CaretAssert(percent >= 0.0f && percent <= 100.0f);
+    Scratch localScratch;
+    vector<float>& dataCopy = getScratch(scratch, localScratch).m_values;
+    dataCopy.assign(data, data + numElems);
+    const double index = percent / 100.0f * (numElems - 1);
+    if (index <= 0) return *min_element(dataCopy.begin(), dataCopy.end());
+    if (index >= numElems - 1) return *max_element(dataCopy.begin(), dataCopy.end());
+    double ipart, fpart;
+    fpart = modf(index, &ipart);
+    const int64_t lowIndex = (int64_t)ipart;
+    nth_element(dataCopy.begin(), dataCopy.begin() + lowIndex, dataCopy.end());
+    const float lowVal = dataCopy[lowIndex];
+    const float highVal = *min_element(dataCopy.begin() + lowIndex + 1, dataCopy.end());//everything after the nth element is at least as large
+    return (1.0f - fpart) * lowVal + fpart * highVal;
+}
+
+float ReductionOperation::reduceExcludeDev(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove,
+                                           Scratch* scratch)
 {
     CaretAssert(numElems > 0);
     double sum = 0.0;
@@ -249,7 +375,10 @@ float ReductionOperation::reduceExcludeDev(const float* data, const int64_t& num
         default:
             break;
     }
-    vector<float> excluded;
+    Scratch localScratch;
+    Scratch& myScratch = getScratch(scratch, localScratch);
+    vector<float>& excluded = myScratch.m_filtered;
+    excluded.clear();
     excluded.reserve(validNum);
     for (int64_t i = 0; i < numElems; ++i)
     {
@@ -257,10 +386,10 @@ float ReductionOperation::reduceExcludeDev(const float* data, const int64_t& num
     }
     if (excluded.size() == 0) throw CaretException("exclusion parameters to reduceExcludeDev resulted in no usable data");
     if (type == ReductionEnum::SAMPSTDEV && excluded.size() < 2) throw CaretException("SAMPSTDEV requested in reduceExcludeDev when only 1 element passed the exclusion parameters");
-    return reduce(excluded.data(), excluded.size(), type);
+    return reduce(excluded.data(), excluded.size(), type, &myScratch);
 }
 
-float ReductionOperation::reduceOnlyNumeric(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type)
+float ReductionOperation::reduceOnlyNumeric(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch)
 {
     CaretAssert(numElems > 0);
     switch (type)//special case things that use indices
@@ -302,7 +431,10 @@ float ReductionOperation::reduceOnlyNumeric(const float* data, const int64_t& nu
         default:
             break;
     }
-    vector<float> excluded;
+    Scratch localScratch;
+    Scratch& myScratch = getScratch(scratch, localScratch);
+    vector<float>& excluded = myScratch.m_filtered;
+    excluded.clear();
     excluded.reserve(numElems);
     for (int64_t i = 0; i < numElems; ++i)
     {
@@ -310,7 +442,7 @@ float ReductionOperation::reduceOnlyNumeric(const float* data, const int64_t& nu
     }
     if (excluded.size() < 1) throw CaretException("all input values to reduceOnlyNumeric were non-numeric");
     if (type == ReductionEnum::SAMPSTDEV && excluded.size() < 2) throw CaretException("SAMPSTDEV requested in reduceOnlyNumeric when only 1 element is numeric");
-    return reduce(excluded.data(), excluded.size(), type);
+    return reduce(excluded.data(), excluded.size(), type, &myScratch);
 }
 
 namespace
@@ -328,9 +460,137 @@ namespace
             return value < rhs.value;
         }
     };
+    
+    //original sort-based weighted median, still used when there are negative weights, because then the cumulative weight isn't monotonic
+    float sortedWeightedMedian(const float* data, const float* weights, const int64_t& numElems)
+    {
+        vector<ValWeight> toSort;
+        toSort.reserve(numElems);
+        for (int64_t i = 0; i < numElems; ++i)
+        {
+            toSort.push_back(ValWeight(data[i], weights[i]));
+        }
+        stable_sort(toSort.begin(), toSort.end());
+        vector<double> weightaccum(numElems);
+        weightaccum[0] = toSort[0].weight;
+        for (int64_t i = 1; i < numElems; ++i)
+        {
+            weightaccum[i] = weightaccum[i - 1] + toSort[i].weight;
+        }
+        double target = weightaccum.back() / 2;
+        int64_t index = (int64_t)(lower_bound(weightaccum.begin(), weightaccum.end(), target) - weightaccum.begin());
+        if (index == numElems) --index;//deal with edge cases from things like negative weights
+        if (numElems > 1 && index < (numElems - 1) && weightaccum[index] == target)//only average on exact equals, according to https://en.wikipedia.org/wiki/Weighted_median
+        {//could instead always interpolate
+            return (toSort[index].value + toSort[index + 1].value) / 2;
+        } else {
+            return toSort[index].value;
+        }
+    }
+    
+    //weighted quickselect on indices with a three-way partition, gives the same answer as finding the first element whose cumulative weight reaches half the total
+    //in stably sorted order, in expected linear time
+    float selectWeightedMedian(const float* data, const float* weights, const int64_t& numElems, vector<int64_t>& indices)
+    {
+        indices.resize(numElems);
+        double total = 0.0;
+        for (int64_t i = 0; i < numElems; ++i)
+        {
+            indices[i] = i;
+            total += weights[i];
+        }
+        const double target = total / 2;
+        double before = 0.0;//weight of everything left of lo
+        int64_t lo = 0, hi = numElems;
+        while (lo < hi)
+        {
+            const float pivot = data[indices[lo + (hi - lo) / 2]];
+            int64_t lt = lo, i = lo, gt = hi;//[lo, lt) < pivot, [lt, i) == pivot, [gt, hi) > pivot
+            while (i < gt)
+            {
+                const float val = data[indices[i]];
+                if (val < pivot)
+                {
+                    swap(indices[lt], indices[i]);
+                    ++lt;
+                    ++i;
+                } else if (val > pivot) {
+                    --gt;
+                    swap(indices[i], indices[gt]);
+                } else {
+                    ++i;
+                }
+            }
+            double lessWeight = 0.0, equalWeight = 0.0;
+            for (int64_t j = lo; j < lt; ++j) lessWeight += weights[indices[j]];
+            if (lt > lo && before + lessWeight >= target)
+            {
+                hi = lt;
+                continue;
+            }
+            int64_t lastInGroup = indices[lt];//last in original order, which is the last in stably sorted order
+            for (int64_t j = lt; j < gt; ++j)
+            {
+                equalWeight += weights[indices[j]];
+                if (indices[j] > lastInGroup) lastInGroup = indices[j];
+            }
+            if (before + lessWeight + equalWeight >= target)
+            {
+                const double upToGroupLast = before + lessWeight + equalWeight;
+                if (gt < numElems && upToGroupLast == target && (gt == 1 || upToGroupLast - weights[lastInGroup] < target))
+                {//target is first reached, exactly, on the last member of the group, average with the next larger value
+                    float nextVal = data[indices[gt]];
+                    for (int64_t j = gt + 1; j < numElems; ++j)
+                    {
+                        if (data[indices[j]] < nextVal) nextVal = data[indices[j]];
+                    }
+                    return (pivot + nextVal) / 2;
+                }
+                return pivot;
+            }
+            before += lessWeight + equalWeight;
+            lo = gt;
+        }
+        float maxVal = data[0];//only from rounding, cumulative weight never reached half the total, the sorted version returns the last element
+        for (int64_t i = 1; i < numElems; ++i) if (data[i] > maxVal) maxVal = data[i];
+        return maxVal;
+    }
+    
+    float hashWeightedMode(const float* data, const float* weights, const int64_t& numElems, vector<float>& hashValues, vector<float>& hashWeights, vector<int64_t>& hashCounts)
+    {
+        const int64_t tableSize = hashTableSize(numElems);
+        hashValues.resize(tableSize);
+        hashWeights.resize(tableSize);
+        hashCounts.assign(tableSize, 0);
+        float minVal = data[0];
+        for (int64_t i = 0; i < numElems; ++i)
+        {//weights are added in original order, which is the same order the stable sort used
+            int64_t slot = hashFind(hashValues, hashCounts, hashBits(data[i]));
+            if (hashCounts[slot] == 0)
+            {
+                hashValues[slot] = data[i];
+                hashWeights[slot] = weights[i];
+            } else {
+                hashWeights[slot] += weights[i];
+            }
+            ++hashCounts[slot];
+            if (data[i] < minVal) minVal = data[i];
+        }
+        float bestweight = -numeric_limits<float>::infinity(), bestval = minVal;
+        for (int64_t slot = 0; slot < tableSize; ++slot)
+        {//ties go to the smaller value
+            if (hashCounts[slot] == 0) continue;
+            if (hashWeights[slot] > bestweight || (hashWeights[slot] == bestweight && hashValues[slot] < bestval))
+            {
+                bestweight = hashWeights[slot];
+                bestval = hashValues[slot];
+            }
+        }
+        return bestval;
+    }
 }
 
-float ReductionOperation::reduceWeighted(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type)
+float ReductionOperation::reduceWeighted(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch)
 {
     CaretAssert(numElems > 0);
     switch (type)
@@ -354,7 +614,7 @@ float ReductionOperation::reduceWeighted(const float* data, const float* weights
         case ReductionEnum::SUM:
         {
             double accum = 0.0, weightsum = 0.0f;
-            for (int i = 0; i < numElems; ++i)
+            for (int64_t i = 0; i < numElems; ++i)
             {
                 accum += data[i] * weights[i];
                 weightsum += weights[i];
@@ -364,7 +624,7 @@ float ReductionOperation::reduceWeighted(const float* data, const float* weights
             if (type == ReductionEnum::MEAN) return mean;
             accum = 0.0;
             double weightsum2 = 0.0;//for weighted sample stdev
-            for (int i = 0; i < numElems; ++i)
+            for (int64_t i = 0; i < numElems; ++i)
             {
                 float tempf = data[i] - mean;
                 accum += weights[i] * tempf * tempf;
@@ -389,67 +649,24 @@ float ReductionOperation::reduceWeighted(const float* data, const float* weights
         }
         case ReductionEnum::MEDIAN:
         {
-            vector<ValWeight> toSort;
-            toSort.reserve(numElems);
-            for (int i = 0; i < numElems; ++i)
-            {
-                toSort.push_back(ValWeight(data[i], weights[i]));
-            }
-            stable_sort(toSort.begin(), toSort.end());
-            vector<double> weightaccum(numElems);
-            weightaccum[0] = toSort[0].weight;
-            for (int i = 1; i < numElems; ++i)
+            for (int64_t i = 0; i < numElems; ++i)
             {
-                weightaccum[i] = weightaccum[i - 1] + toSort[i].weight;
-            }
-            double target = weightaccum.back() / 2;
-            int64_t index = (int64_t)(lower_bound(weightaccum.begin(), weightaccum.end(), target) - weightaccum.begin());
-            if (index == numElems) --index;//deal with edge cases from things like negative weights
-            if (numElems > 1 && index < (numElems - 1) && weightaccum[index] == target)//only average on exact equals, according to https://en.wikipedia.org/wiki/Weighted_median
-            {//could instead always interpolate
-                return (toSort[index].value + toSort[index + 1].value) / 2;
-            } else {
-                return toSort[index].value;
+                if (weights[i] < 0.0f) return sortedWeightedMedian(data, weights, numElems);
             }
+            Scratch localScratch;
+            return selectWeightedMedian(data, weights, numElems, getScratch(scratch, localScratch).m_indices);
         }
         case ReductionEnum::MODE:
         {
-            vector<ValWeight> toSort;
-            toSort.reserve(numElems);
-            for (int i = 0; i < numElems; ++i)
-            {
-                toSort.push_back(ValWeight(data[i], weights[i]));
-            }
-            stable_sort(toSort.begin(), toSort.end());
-            float bestweight = -numeric_limits<float>::infinity(), curweight = toSort[0].weight;
-            float bestval = toSort[0].value, curval = toSort[0].value;
-            for (int i = 1; i < numElems; ++i)
-            {
-                if (toSort[i].value == curval)
-                {
-                    curweight += toSort[i].weight;
-                } else {
-                    if (curweight > bestweight)
-                    {
-                        bestval = curval;
-                        bestweight = curweight;
-                    }
-                    curval = toSort[i].value;
-                    curweight = toSort[i].weight;
-                }
-            }
-            if (curweight > bestweight)
-            {
-                bestval = curval;
-                bestweight = curweight;
-            }
-            return bestval;
+            Scratch localScratch;
+            Scratch& myScratch = getScratch(scratch, localScratch);
+            return hashWeightedMode(data, weights, numElems, myScratch.m_hashValues, myScratch.m_hashWeights, myScratch.m_hashCounts);
         }
     }
     return 0.0f;
 }
 
-float ReductionOperation::reduceWeightedOnlyNumeric(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type)
+float ReductionOperation::reduceWeightedOnlyNumeric(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch)
 {
     CaretAssert(numElems > 0);
     switch (type)
@@ -466,7 +683,11 @@ float ReductionOperation::reduceWeightedOnlyNumeric(const float* data, const flo
         default:
             break;
     }
-    vector<float> excluded, exweights;
+    Scratch localScratch;
+    Scratch& myScratch = getScratch(scratch, localScratch);
+    vector<float>& excluded = myScratch.m_filtered, & exweights = myScratch.m_filteredWeights;
+    excluded.clear();
+    exweights.clear();
     excluded.reserve(numElems);
     exweights.reserve(numElems);
     for (int64_t i = 0; i < numElems; ++i)
@@ -479,10 +700,11 @@ float ReductionOperation::reduceWeightedOnlyNumeric(const float* data, const flo
     }
     if (excluded.size() < 1) throw CaretException("all input values to reduceWeightedOnlyNumeric were non-numeric");
     if (type == ReductionEnum::SAMPSTDEV && excluded.size() < 2) throw CaretException("SAMPSTDEV requested in reduceWeightedOnlyNumeric when only 1 element is numeric");
-    return reduceWeighted(excluded.data(), exweights.data(), excluded.size(), type);
+    return reduceWeighted(excluded.data(), exweights.data(), excluded.size(), type, &myScratch);
 }
 
-float ReductionOperation::reduceWeightedExcludeDev(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove)
+float ReductionOperation::reduceWeightedExcludeDev(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove,
+                                                   Scratch* scratch)
 {
     CaretAssert(numElems > 0);
     switch (type)
@@ -501,7 +723,7 @@ float ReductionOperation::reduceWeightedExcludeDev(const float* data, const floa
     }
     double accum = 0.0, weightsum = 0.0f;//compute weighted stdev
     int64_t numValid = 0;
-    for (int i = 0; i < numElems; ++i)
+    for (int64_t i = 0; i < numElems; ++i)
     {
         if (MathFunctions::isNumeric(data[i]))
         {
@@ -512,7 +734,7 @@ float ReductionOperation::reduceWeightedExcludeDev(const float* data, const floa
     }
     const float mean = accum / weightsum;
     accum = 0.0;
-    for (int i = 0; i < numElems; ++i)
+    for (int64_t i = 0; i < numElems; ++i)
     {
         if (MathFunctions::isNumeric(data[i]))
         {
@@ -522,7 +744,11 @@ float ReductionOperation::reduceWeightedExcludeDev(const float* data, const floa
     }
     float stdev = sqrt(accum / weightsum);
     float low = mean - stdev * numDevBelow, high = mean + stdev * numDevAbove;
-    vector<float> excluded, exweights;
+    Scratch localScratch;
+    Scratch& myScratch = getScratch(scratch, localScratch);
+    vector<float>& excluded = myScratch.m_filtered, & exweights = myScratch.m_filteredWeights;
+    excluded.clear();
+    exweights.clear();
     excluded.reserve(numValid);
     exweights.reserve(numValid);
     for (int64_t i = 0; i < numElems; ++i)
@@ -535,7 +761,7 @@ float ReductionOperation::reduceWeightedExcludeDev(const float* data, const floa
     }
     if (excluded.size() < 1) throw CaretException("all input values to reduceWeightedExcludeDev were non-numeric");
     if (type == ReductionEnum::SAMPSTDEV && excluded.size() < 2) throw CaretException("SAMPSTDEV requested in reduceWeightedExcludeDev when only 1 element is numeric");
-    return reduceWeighted(excluded.data(), exweights.data(), excluded.size(), type);
+    return reduceWeighted(excluded.data(), exweights.data(), excluded.size(), type, &myScratch);
 }
 
 AString ReductionOperation::getHelpInfo()
@@ -24,19 +24,33 @@
 #include "AString.h"
 #include "ReductionEnum.h"
 
+#include <vector>
+
 namespace caret {
     
     class ReductionOperation
     {
     public:
-        static float reduce(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type);
+        ///reusable working memory for the copying reductions (median, mode, percentile, exclusion), so that callers reducing every row or voxel don't reallocate each time
+        ///NOTE: not thread safe, use one per thread
+        class Scratch
+        {
+            std::vector<float> m_values, m_filtered, m_filteredWeights, m_hashValues, m_hashWeights;
+            std::vector<int64_t> m_indices, m_hashCounts;
+            friend class ReductionOperation;
+        };
+        static float reduce(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch = NULL);
         ///reduce, with exclusion based on number of standard deviations
-        static float reduceExcludeDev(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove);
-        static float reduceOnlyNumeric(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type);
+        static float reduceExcludeDev(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove,
+                                      Scratch* scratch = NULL);
+        static float reduceOnlyNumeric(const float* data, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch = NULL);
         ///weighted versions, do not accept all reduction types
-        static float reduceWeighted(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type);
-        static float reduceWeightedExcludeDev(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove);
-        static float reduceWeightedOnlyNumeric(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type);
+        static float reduceWeighted(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch = NULL);
+        static float reduceWeightedExcludeDev(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, const float& numDevBelow, const float& numDevAbove,
+                                              Scratch* scratch = NULL);
+        static float reduceWeightedOnlyNumeric(const float* data, const float* weights, const int64_t& numElems, const ReductionEnum::Enum& type, Scratch* scratch = NULL);
+        ///value at a percentile (0 to 100), interpolating between the two closest ranks, uses selection rather than sorting
+        static float percentile(const float* data, const int64_t& numElems, const float& percent, Scratch* scratch = NULL);
         static AString getHelpInfo();
     };
     
@@ -0,0 +1,713 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "StreamingReduction.h"
+
+#include "CaretAssert.h"
+#include "CaretException.h"
+#include "CaretOMP.h"
+#include "MathFunctions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace caret;
+using namespace std;
+
+namespace
+{
+    const int64_t BLOCK_FLOATS = 1 << 22;//16MB of rows per read
+    const int64_t COLUMN_CHUNK = 64;//columns per parallel work item
+    const int64_t COLLECT_BUDGET = 1 << 24;//total floats held for exact selection, across all columns
+    const int NUM_BINS = 256;
+    
+    float selectRank(vector<float>& values, const int64_t& rank)
+    {
+        CaretAssert(rank >= 0 && rank < (int64_t)values.size());
+        nth_element(values.begin(), values.begin() + rank, values.end());
+        return values[rank];
+    }
+}
+
+StreamingReduction::RowSource::~RowSource()
+{
+}
+
+StreamingReduction::ColumnPointerSource::ColumnPointerSource(const vector<const float*>& columns, const int64_t& numRows)
+{
+    m_columns = columns;
+    m_numRows = numRows;
+}
+
+void StreamingReduction::ColumnPointerSource::getRows(float* dataOut, const int64_t& firstRow, const int64_t& numRows)
+{
+    CaretAssert(firstRow >= 0 && firstRow + numRows <= m_numRows);
+    const int64_t numCols = (int64_t)m_columns.size();
+    for (int64_t c = 0; c < numCols; ++c)
+    {//read each column contiguously, the block is small enough that the strided writes stay in cache
+        const float* column = m_columns[c] + firstRow;
+        for (int64_t r = 0; r < numRows; ++r)
+        {
+            dataOut[r * numCols + c] = column[r];
+        }
+    }
+}
+
+struct StreamingReduction::Accumulator
+{
+    int64_t m_count, m_extremeIndex, m_nonzero;
+    double m_sum, m_mean, m_resid, m_product, m_weightSum, m_weightSqrSum;
+    float m_extreme;
+    
+    Accumulator()
+    {
+        m_count = 0; m_extremeIndex = 0; m_nonzero = 0;
+        m_sum = 0.0; m_mean = 0.0; m_resid = 0.0; m_product = 1.0; m_weightSum = 0.0; m_weightSqrSum = 0.0;
+        m_extreme = 0.0f;
+    }
+    
+    void add(const float& value, const ReductionEnum::Enum& type)
+    {//same comparison and accumulation semantics as ReductionOperation::reduce, one element at a time
+        switch (type)
+        {
+            case ReductionEnum::SUM:
+            case ReductionEnum::MEAN:
+                m_sum += value;
+                break;
+            case ReductionEnum::STDEV:
+            case ReductionEnum::SAMPSTDEV:
+            case ReductionEnum::VARIANCE:
+            case ReductionEnum::TSNR:
+            case ReductionEnum::COV:
+            {//Welford
+                double delta = value - m_mean;
+                m_mean += delta / (m_count + 1);
+                m_resid += delta * (value - m_mean);
+                break;
+            }
+            case ReductionEnum::PRODUCT:
+                m_product *= value;
+                break;
+            case ReductionEnum::MAX:
+            case ReductionEnum::INDEXMAX:
+                if (m_count == 0 || value > m_extreme)
+                {
+                    m_extreme = value;
+                    m_extremeIndex = m_count;
+                }
+                break;
+            case ReductionEnum::MIN:
+            case ReductionEnum::INDEXMIN:
+                if (m_count == 0 || value < m_extreme)
+                {
+                    m_extreme = value;
+                    m_extremeIndex = m_count;
+                }
+                break;
+            case ReductionEnum::COUNT_NONZERO:
+                if (value != 0.0f) ++m_nonzero;
+                break;
+            default:
+                break;
+        }
+        ++m_count;
+    }
+    
+    void addWeighted(const float& value, const float& weight, const ReductionEnum::Enum& type)
+    {
+        switch (type)
+        {
+            case ReductionEnum::SUM:
+            case ReductionEnum::MEAN:
+                m_sum += value * weight;
+                m_weightSum += weight;
+                break;
+            case ReductionEnum::STDEV:
+            case ReductionEnum::SAMPSTDEV:
+            {//West's weighted incremental variance
+                m_weightSum += weight;
+                m_weightSqrSum += weight * weight;
+                if (m_weightSum != 0.0)
+                {
+                    double delta = value - m_mean;
+                    m_mean += delta * weight / m_weightSum;
+                    m_resid += weight * delta * (value - m_mean);
+                }
+                break;
+            }
+            default:
+                CaretAssert(false);
+                break;
+        }
+        ++m_count;
+    }
+    
+    float getResult(const ReductionEnum::Enum& type, const bool& weighted) const
+    {
+        if (weighted)
+        {
+            switch (type)
+            {
+                case ReductionEnum::SUM:
+                    return m_sum;
+                case ReductionEnum::MEAN:
+                    return m_sum / m_weightSum;
+                case ReductionEnum::STDEV:
+                    return sqrt(m_resid / m_weightSum);
+                case ReductionEnum::SAMPSTDEV:
+                    return sqrt(m_resid / (m_weightSum - m_weightSqrSum / m_weightSum));
+                default:
+                    CaretAssert(false);
+                    return 0.0f;
+            }
+        }
+        switch (type)
+        {
+            case ReductionEnum::SAMPSTDEV:
+            case ReductionEnum::TSNR:
+            case ReductionEnum::COV:
+                if (m_count < 2) throw CaretException("taking the sample standard deviation of 1 element would require dividing by zero");
+                break;
+            default:
+                break;
+        }
+        switch (type)
+        {
+            case ReductionEnum::SUM:
+                return m_sum;
+            case ReductionEnum::MEAN:
+                return m_sum / m_count;
+            case ReductionEnum::STDEV:
+                return sqrt(m_resid / m_count);
+            case ReductionEnum::SAMPSTDEV:
+                return sqrt(m_resid / (m_count - 1));
+            case ReductionEnum::VARIANCE:
+                return m_resid / m_count;
+            case ReductionEnum::TSNR:
+                return m_mean / sqrt(m_resid / (m_count - 1));
+            case ReductionEnum::COV:
+                return sqrt(m_resid / (m_count - 1)) / m_mean;
+            case ReductionEnum::PRODUCT:
+                return m_product;
+            case ReductionEnum::MAX:
+            case ReductionEnum::MIN:
+                return m_extreme;
+            case ReductionEnum::INDEXMAX:
+            case ReductionEnum::INDEXMIN:
+                return m_extremeIndex + 1;//1-based, to match ReductionOperation
+            case ReductionEnum::COUNT_NONZERO:
+                return m_nonzero;
+            default:
+                CaretAssert(false);
+                return 0.0f;
+        }
+    }
+};
+
+///state of exact selection for one column, the wanted ranks are narrowed to a value range [m_low, m_high] a pass at a time
+struct StreamingReduction::Selection
+{
+    enum Mode
+    {
+        COLLECT_ALL,//first pass, keep everything until it is too much
+        HISTOGRAM,
+        COLLECT_RANGE,
+        DONE
+    };
+    Mode m_mode;
+    int64_t m_count, m_nanCount;//numeric values (including infinities), NaNs
+    int64_t m_negInfCount, m_posInfCount;//infinities sort to the ends, so they are counted rather than binned
+    float m_min, m_max;//of the finite values only
+    int m_numRanks;
+    int64_t m_ranks[2];
+    bool m_resolved[2];
+    float m_values[2];
+    double m_fraction;//interpolation between the two ranks, for percentile
+    float m_low, m_high;
+    double m_binScale;
+    int64_t m_below;//number of numeric values less than m_low
+    int64_t m_inRange;
+    vector<float> m_collected, m_binMin, m_binMax;
+    vector<int64_t> m_binCounts;
+    
+    Selection()
+    {
+        m_mode = COLLECT_ALL;
+        m_count = 0; m_nanCount = 0;
+        m_negInfCount = 0; m_posInfCount = 0;
+        m_min = 0.0f; m_max = 0.0f;
+        m_numRanks = 0;
+        m_resolved[0] = false; m_resolved[1] = false;
+        m_fraction = 0.0;
+        m_low = 0.0f; m_high = 0.0f; m_binScale = 0.0;
+        m_below = 0; m_inRange = 0;
+    }
+    
+    void firstPassAdd(const float& value, const int64_t& collectCap)
+    {
+        if (MathFunctions::isNaN(value))
+        {
+            ++m_nanCount;
+            return;
+        }
+        if (MathFunctions::isInf(value))
+        {
+            if (value < 0.0f)
+            {
+                ++m_negInfCount;
+            } else {
+                ++m_posInfCount;
+            }
+        } else if (m_count == m_negInfCount + m_posInfCount) {//first finite value
+            m_min = value;
+            m_max = value;
+        } else {
+            if (value < m_min) m_min = value;
+            if (value > m_max) m_max = value;
+        }
+        ++m_count;
+        if (m_mode == COLLECT_ALL)
+        {
+            if ((int64_t)m_collected.size() < collectCap)
+            {
+                m_collected.push_back(value);
+            } else {
+                vector<float>().swap(m_collected);
+                m_mode = HISTOGRAM;//decided for real after the pass
+            }
+        }
+    }
+    
+    void refineAdd(const float& value)
+    {
+        if (!(value >= m_low && value <= m_high)) return;//also excludes NaN, and infinities since the range is always finite
+        if (m_mode == COLLECT_RANGE)
+        {
+            m_collected.push_back(value);
+            return;
+        }
+        CaretAssert(m_mode == HISTOGRAM);
+        double binPos = ((double)value - m_low) * m_binScale;//in double, the float difference can overflow for ranges near the float limits
+        int bin = 0;
+        if (binPos >= NUM_BINS - 1)
+        {
+            bin = NUM_BINS - 1;
+        } else if (binPos > 0.0) {
+            bin = (int)binPos;
+        }
+        if (m_binCounts[bin] == 0)
+        {
+            m_binMin[bin] = value;
+            m_binMax[bin] = value;
+        } else {
+            if (value < m_binMin[bin]) m_binMin[bin] = value;
+            if (value > m_binMax[bin]) m_binMax[bin] = value;
+        }
+        ++m_binCounts[bin];
+    }
+    
+    bool allResolved() const
+    {
+        for (int i = 0; i < m_numRanks; ++i)
+        {
+            if (!m_resolved[i]) return false;
+        }
+        return true;
+    }
+    
+    void resolve(const int& which, const float& value)
+    {
+        m_values[which] = value;
+        m_resolved[which] = true;
+    }
+    
+    ///narrow to [low, high], and pick how the next pass handles it
+    void setRange(const float low, const float high, const int64_t below, const int64_t inRange, const int64_t& collectCap)
+    {//by value, the arguments may point into the bins this frees
+        CaretAssert(!MathFunctions::isInf(low) && !MathFunctions::isInf(high) && low <= high);//an infinite end would make every value land in one bin, and the passes would never narrow
+        m_low = low;
+        m_high = high;
+        m_below = below;
+        m_inRange = inRange;
+        vector<float>().swap(m_collected);
+        vector<float>().swap(m_binMin);
+        vector<float>().swap(m_binMax);
+        vector<int64_t>().swap(m_binCounts);
+        if (low == high)
+        {//everything left in range is the same value
+            for (int i = 0; i < m_numRanks; ++i)
+            {
+                if (!m_resolved[i]) resolve(i, low);
+            }
+        }
+        if (allResolved())
+        {
+            m_mode = DONE;
+            return;
+        }
+        if (inRange <= collectCap)
+        {
+            m_mode = COLLECT_RANGE;
+            m_collected.reserve(inRange);
+        } else {
+            m_mode = HISTOGRAM;
+            m_binScale = NUM_BINS / ((double)high - low);
+            m_binMin.resize(NUM_BINS);
+            m_binMax.resize(NUM_BINS);
+            m_binCounts.assign(NUM_BINS, 0);
+        }
+    }
+    
+    ///after a first or refining pass, resolve what we can and set up the next pass
+    void finishPass(const int64_t& collectCap)
+    {
+        switch (m_mode)
+        {
+            case COLLECT_ALL:
+            case COLLECT_RANGE:
+                for (int i = 0; i < m_numRanks; ++i)
+                {
+                    if (!m_resolved[i]) resolve(i, selectRank(m_collected, m_ranks[i] - m_below));
+                }
+                vector<float>().swap(m_collected);
+                m_mode = DONE;
+                break;
+            case HISTOGRAM:
+            {
+                int rankBins[2] = { -1, -1 };
+                int64_t belowBin[2] = { 0, 0 };
+                for (int i = 0; i < m_numRanks; ++i)
+                {
+                    if (m_resolved[i]) continue;
+                    int64_t cumulative = m_below;
+                    int bin = 0;
+                    while (cumulative + m_binCounts[bin] <= m_ranks[i])
+                    {
+                        cumulative += m_binCounts[bin];
+                        ++bin;
+                        CaretAssert(bin < NUM_BINS);
+                    }
+                    if (m_binMin[bin] == m_binMax[bin])
+                    {
+                        resolve(i, m_binMin[bin]);
+                    } else {
+                        rankBins[i] = bin;
+                        belowBin[i] = cumulative;
+                    }
+                }
+                int first = -1, last = -1;
+                for (int i = 0; i < m_numRanks; ++i)
+                {
+                    if (rankBins[i] < 0) continue;
+                    if (first < 0) first = i;
+                    last = i;
+                }
+                if (first < 0)
+                {
+                    m_mode = DONE;
+                    break;
+                }
+                int64_t inRange = 0;
+                for (int bin = rankBins[first]; bin <= rankBins[last]; ++bin)
+                {
+                    inRange += m_binCounts[bin];
+                }
+                setRange(m_binMin[rankBins[first]], m_binMax[rankBins[last]], belowBin[first], inRange, collectCap);
+                break;
+            }
+            case DONE:
+                break;
+        }
+    }
+};
+
+StreamingReduction::StreamingReduction(RowSource* data)
+{
+    CaretAssert(data != NULL);
+    m_data = data;
+    m_roi = NULL;
+    m_numGroups = 1;
+    m_numRows = data->getNumberOfRows();
+    m_numCols = data->getNumberOfColumns();
+}
+
+void StreamingReduction::setRoi(RowSource* roi)
+{
+    if (roi != NULL)
+    {
+        if (roi->getNumberOfRows() != m_numRows) throw CaretException("roi has a different number of rows than the data");
+        if (roi->getNumberOfColumns() != 1 && roi->getNumberOfColumns() != m_numCols) throw CaretException("roi must have one column, or as many columns as the data");
+    }
+    m_roi = roi;
+}
+
+void StreamingReduction::setWeights(const vector<float>& weights)
+{
+    if (!weights.empty() && (int64_t)weights.size() != m_numRows) throw CaretException("weights must have one value per row");
+    m_weights = weights;
+}
+
+void StreamingReduction::setGroups(const vector<int>& rowGroups, const int& numGroups)
+{
+    if ((int64_t)rowGroups.size() != m_numRows) throw CaretException("groups must have one value per row");
+    CaretAssert(numGroups > 0);
+    m_rowGroups = rowGroups;
+    m_numGroups = numGroups;
+}
+
+bool StreamingReduction::canReduce(const ReductionEnum::Enum& type, const bool& weighted)
+{
+    switch (type)
+    {
+        case ReductionEnum::SUM:
+        case ReductionEnum::MEAN:
+        case ReductionEnum::STDEV:
+        case ReductionEnum::SAMPSTDEV:
+            return true;
+        case ReductionEnum::VARIANCE:
+        case ReductionEnum::TSNR:
+        case ReductionEnum::COV:
+        case ReductionEnum::PRODUCT:
+        case ReductionEnum::MAX:
+        case ReductionEnum::MIN:
+        case ReductionEnum::INDEXMAX:
+        case ReductionEnum::INDEXMIN:
+        case ReductionEnum::MEDIAN:
+        case ReductionEnum::COUNT_NONZERO:
+            return !weighted;
+        case ReductionEnum::MODE://would need a hash table of every distinct value per column, not worth it over in-memory
+        case ReductionEnum::INVALID:
+            return false;
+    }
+    return false;
+}
+
+int64_t StreamingReduction::getRowsPerBlock() const
+{
+    return max((int64_t)1, BLOCK_FLOATS / max((int64_t)1, m_numCols));
+}
+
+vector<float> StreamingReduction::reduce(const ReductionEnum::Enum& type)
+{
+    const bool weighted = !m_weights.empty();
+    if (!canReduce(type, weighted)) throw CaretException("reduction type '" + ReductionEnum::toName(type) + "' is not supported for streaming" + (weighted ? " with weights" : ""));
+    if (type == ReductionEnum::MEDIAN) return selectRanks(true, 50.0f);
+    const int64_t numResults = m_numGroups * m_numCols;
+    vector<Accumulator> accums(numResults);
+    const int64_t rowsPerBlock = getRowsPerBlock();
+    const int64_t roiCols = (m_roi == NULL ? 0 : m_roi->getNumberOfColumns());
+    const int64_t roiColStep = (roiCols == 1 ? 0 : 1);
+    const int64_t numChunks = (m_numCols + COLUMN_CHUNK - 1) / COLUMN_CHUNK;
+    vector<float> dataBlock(rowsPerBlock * m_numCols), roiBlock(rowsPerBlock * roiCols);
+    for (int64_t firstRow = 0; firstRow < m_numRows; firstRow += rowsPerBlock)
+    {
+        const int64_t blockRows = min(rowsPerBlock, m_numRows - firstRow);
+        m_data->getRows(dataBlock.data(), firstRow, blockRows);
+        if (m_roi != NULL) m_roi->getRows(roiBlock.data(), firstRow, blockRows);
+        //parallel over columns rather than rows, so each column is accumulated in row order regardless of the number of threads
+#pragma omp CARET_PARFOR schedule(dynamic)
+        for (int64_t chunk = 0; chunk < numChunks; ++chunk)
+        {
+            const int64_t startCol = chunk * COLUMN_CHUNK, endCol = min(startCol + COLUMN_CHUNK, m_numCols);
+            for (int64_t r = 0; r < blockRows; ++r)
+            {
+                const int group = (m_rowGroups.empty() ? 0 : m_rowGroups[firstRow + r]);
+                if (group < 0) continue;
+                const float* dataRow = dataBlock.data() + r * m_numCols;
+                const float* roiRow = (m_roi == NULL ? NULL : roiBlock.data() + r * roiCols);
+                Accumulator* groupAccums = accums.data() + group * m_numCols;
+                for (int64_t c = startCol; c < endCol; ++c)
+                {
+                    if (roiRow != NULL && !(roiRow[c * roiColStep] > 0.0f)) continue;
+                    if (weighted)
+                    {
+                        groupAccums[c].addWeighted(dataRow[c], m_weights[firstRow + r], type);
+                    } else {
+                        groupAccums[c].add(dataRow[c], type);
+                    }
+                }
+            }
+        }
+    }
+    vector<float> ret(numResults, 0.0f);
+    m_counts.resize(numResults);
+    for (int64_t i = 0; i < numResults; ++i)
+    {
+        m_counts[i] = accums[i].m_count;
+        if (m_counts[i] > 0) ret[i] = accums[i].getResult(type, weighted);//caller must check counts for empty rois
+    }
+    return ret;
+}
+
+vector<float> StreamingReduction::percentile(const float& percent)
+{
+    CaretAssert(percent >= 0.0f && percent <= 100.0f);
+    if (!m_weights.empty()) throw CaretException("weighted percentile is not supported for streaming");
+    return selectRanks(false, percent);
+}
+
+vector<float> StreamingReduction::selectRanks(const bool& isMedian, const float& percent)
+{
+    const int64_t numResults = m_numGroups * m_numCols;
+    const int64_t collectCap = max((int64_t)256, COLLECT_BUDGET / numResults);
+    vector<Selection> selections(numResults);
+    const int64_t rowsPerBlock = getRowsPerBlock();
+    const int64_t roiCols = (m_roi == NULL ? 0 : m_roi->getNumberOfColumns());
+    const int64_t roiColStep = (roiCols == 1 ? 0 : 1);
+    const int64_t numChunks = (m_numCols + COLUMN_CHUNK - 1) / COLUMN_CHUNK;
+    vector<float> dataBlock(rowsPerBlock * m_numCols), roiBlock(rowsPerBlock * roiCols);
+    bool firstPass = true, needPass = true;
+    while (needPass)
+    {
+        for (int64_t firstRow = 0; firstRow < m_numRows; firstRow += rowsPerBlock)
+        {
+            const int64_t blockRows = min(rowsPerBlock, m_numRows - firstRow);
+            m_data->getRows(dataBlock.data(), firstRow, blockRows);
+            if (m_roi != NULL) m_roi->getRows(roiBlock.data(), firstRow, blockRows);
+#pragma omp CARET_PARFOR schedule(dynamic)
+            for (int64_t chunk = 0; chunk < numChunks; ++chunk)
+            {
+                const int64_t startCol = chunk * COLUMN_CHUNK, endCol = min(startCol + COLUMN_CHUNK, m_numCols);
+                for (int64_t r = 0; r < blockRows; ++r)
+                {
+                    const int group = (m_rowGroups.empty() ? 0 : m_rowGroups[firstRow + r]);
+                    if (group < 0) continue;
+                    const float* dataRow = dataBlock.data() + r * m_numCols;
+                    const float* roiRow = (m_roi == NULL ? NULL : roiBlock.data() + r * roiCols);
+                    Selection* groupSelections = selections.data() + group * m_numCols;
+                    for (int64_t c = startCol; c < endCol; ++c)
+                    {
+                        if (roiRow != NULL && !(roiRow[c * roiColStep] > 0.0f)) continue;
+                        if (firstPass)
+                        {
+                            groupSelections[c].firstPassAdd(dataRow[c], collectCap);
+                        } else if (groupSelections[c].m_mode != Selection::DONE) {
+                            groupSelections[c].refineAdd(dataRow[c]);
+                        }
+                    }
+                }
+            }
+        }
+        if (firstPass)
+        {//now we know the counts, so we can say which ranks we need
+            for (int64_t i = 0; i < numResults; ++i)
+            {
+                Selection& mySel = selections[i];
+                const int64_t numElems = mySel.m_count + mySel.m_nanCount;
+                if (numElems == 0)
+                {
+                    mySel.m_mode = Selection::DONE;
+                    continue;
+                }
+                if (isMedian)
+                {
+                    const int64_t half = numElems / 2;
+                    if ((numElems & 1) == 0)
+                    {
+                        mySel.m_numRanks = 2;
+                        mySel.m_ranks[0] = half - 1;
+                        mySel.m_ranks[1] = half;
+                    } else {
+                        mySel.m_numRanks = 1;
+                        mySel.m_ranks[0] = half;
+                    }
+                } else {
+                    const double index = percent / 100.0f * (numElems - 1);//same arithmetic as ReductionOperation::percentile
+                    if (index <= 0)
+                    {
+                        mySel.m_numRanks = 1;
+                        mySel.m_ranks[0] = 0;
+                    } else if (index >= numElems - 1) {
+                        mySel.m_numRanks = 1;
+                        mySel.m_ranks[0] = numElems - 1;
+                    } else {
+                        double ipart;
+                        mySel.m_fraction = modf(index, &ipart);
+                        mySel.m_numRanks = 2;
+                        mySel.m_ranks[0] = (int64_t)ipart;
+                        mySel.m_ranks[1] = mySel.m_ranks[0] + 1;
+                    }
+                }
+                const int64_t firstFinite = mySel.m_negInfCount, endFinite = mySel.m_count - mySel.m_posInfCount;
+                for (int j = 0; j < mySel.m_numRanks; ++j)
+                {//the ends are known from the first pass, infinities are at the ends, and NaNs sort last
+                    if (mySel.m_ranks[j] >= mySel.m_count)
+                    {
+                        mySel.resolve(j, numeric_limits<float>::quiet_NaN());
+                    } else if (mySel.m_ranks[j] < firstFinite) {
+                        mySel.resolve(j, -numeric_limits<float>::infinity());
+                    } else if (mySel.m_ranks[j] >= endFinite) {
+                        mySel.resolve(j, numeric_limits<float>::infinity());
+                    } else if (mySel.m_ranks[j] == firstFinite) {
+                        mySel.resolve(j, mySel.m_min);
+                    } else if (mySel.m_ranks[j] == endFinite - 1) {
+                        mySel.resolve(j, mySel.m_max);
+                    }
+                }
+                if (mySel.allResolved())
+                {
+                    vector<float>().swap(mySel.m_collected);
+                    mySel.m_mode = Selection::DONE;
+                } else if (mySel.m_mode == Selection::HISTOGRAM) {//collection overflowed, narrow within the finite values
+                    mySel.setRange(mySel.m_min, mySel.m_max, firstFinite, endFinite - firstFinite, collectCap);
+                }
+            }
+        }
+        const bool wasFirstPass = firstPass;
+        firstPass = false;
+#pragma omp CARET_PARFOR schedule(dynamic)
+        for (int64_t i = 0; i < numResults; ++i)
+        {//after the first pass, only the ones that collected everything are ready, the rest just had their first range set up
+            Selection& mySel = selections[i];
+            if (mySel.m_mode != Selection::DONE && (!wasFirstPass || mySel.m_mode == Selection::COLLECT_ALL))
+            {
+                mySel.finishPass(collectCap);
+            }
+        }
+        needPass = false;
+        for (int64_t i = 0; i < numResults; ++i)
+        {
+            if (selections[i].m_mode != Selection::DONE)
+            {
+                needPass = true;
+                break;
+            }
+        }
+    }
+    vector<float> ret(numResults, 0.0f);
+    m_counts.resize(numResults);
+    for (int64_t i = 0; i < numResults; ++i)
+    {
+        const Selection& mySel = selections[i];
+        m_counts[i] = mySel.m_count + mySel.m_nanCount;
+        if (m_counts[i] == 0) continue;
+        CaretAssert(mySel.allResolved());
+        if (mySel.m_numRanks == 1)
+        {
+            ret[i] = mySel.m_values[0];
+        } else if (isMedian) {
+            ret[i] = (mySel.m_values[0] + mySel.m_values[1]) / 2.0f;
+        } else {
+            ret[i] = (1.0f - mySel.m_fraction) * mySel.m_values[0] + mySel.m_fraction * mySel.m_values[1];
+        }
+    }
+    return ret;
+}
@@ -0,0 +1,93 @@
+#ifndef __STREAMING_REDUCTION_H__
+#define __STREAMING_REDUCTION_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "ReductionEnum.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace caret {
+    
+    ///reductions and percentiles of every column of a matrix, computed from sequential passes over blocks of rows
+    ///so that a large on-disk file never needs to be read a column at a time or held in memory
+    ///simple reductions take one pass, MEDIAN and percentiles take a few passes of exact selection (values are narrowed with per-column histograms until the needed ranks can be collected)
+    ///results match ReductionOperation on the same values, up to rounding of the double-precision accumulation order
+    class StreamingReduction
+    {
+    public:
+        ///provides the matrix a block of rows at a time, only called from one thread, with increasing rows within each pass
+        class RowSource
+        {
+        public:
+            virtual ~RowSource();
+            virtual int64_t getNumberOfRows() const = 0;
+            virtual int64_t getNumberOfColumns() const = 0;
+            ///fill dataOut with numRows full rows starting at firstRow, row-major
+            virtual void getRows(float* dataOut, const int64_t& firstRow, const int64_t& numRows) = 0;
+        };
+        
+        ///for data that is already in memory as one array per column (metric maps, volume frames)
+        class ColumnPointerSource : public RowSource
+        {
+            std::vector<const float*> m_columns;
+            int64_t m_numRows;
+        public:
+            ColumnPointerSource(const std::vector<const float*>& columns, const int64_t& numRows);
+            int64_t getNumberOfRows() const { return m_numRows; }
+            int64_t getNumberOfColumns() const { return (int64_t)m_columns.size(); }
+            void getRows(float* dataOut, const int64_t& firstRow, const int64_t& numRows);
+        };
+        
+        StreamingReduction(RowSource* data);
+        ///roi with either one column (used for every column of the data) or one column per data column, elements are used where the roi is greater than zero
+        void setRoi(RowSource* roi);
+        ///one weight per row, only SUM, MEAN, STDEV and SAMPSTDEV can be weighted (see canReduce)
+        void setWeights(const std::vector<float>& weights);
+        ///compute results separately for groups of rows, rows in group -1 are not used
+        void setGroups(const std::vector<int>& rowGroups, const int& numGroups);
+        
+        static bool canReduce(const ReductionEnum::Enum& type, const bool& weighted);
+        ///results are indexed by [group * numColumns + column], throws CaretException in the same cases ReductionOperation does
+        std::vector<float> reduce(const ReductionEnum::Enum& type);
+        ///unweighted only, interpolates between the two closest ranks like ReductionOperation::percentile, NaNs are ordered after all numbers
+        std::vector<float> percentile(const float& percent);
+        ///number of elements that went into each result of the last reduce or percentile call, check for zero when using an roi
+        const std::vector<int64_t>& getCounts() const { return m_counts; }
+    private:
+        struct Accumulator;
+        struct Selection;
+        RowSource* m_data, *m_roi;
+        std::vector<float> m_weights;
+        std::vector<int> m_rowGroups;
+        int m_numGroups;
+        int64_t m_numRows, m_numCols;
+        std::vector<int64_t> m_counts;
+        
+        int64_t getRowsPerBlock() const;
+        void getRoiFlags(std::vector<char>& flagsOut, const std::vector<float>& roiBlock, const int64_t& blockRows) const;
+        std::vector<float> selectRanks(const bool& isMedian, const float& percent);
+    };
+    
+}
+
+#endif //__STREAMING_REDUCTION_H__
@@ -24,6 +24,8 @@
 #ifdef CARET_OS_WINDOWS
 #include <windows.h>
 #else
+#include <limits.h>
+#include <sys/resource.h>
 #include <unistd.h>
 #endif
 
@@ -286,6 +288,30 @@ SystemUtilities::getNumberOfProcessors()
     return 1;
 }
 
+/**
+ * Raise the soft limit on open files to the hard limit, so that commands
+ * taking hundreds of input files (averaging, merging) don't fail partway
+ * through opening them.  Does nothing on windows.
+ */
+void
+SystemUtilities::raiseOpenFileLimit()
+{
+#ifndef CARET_OS_WINDOWS
+    struct rlimit myLimit;
+    if (getrlimit(RLIMIT_NOFILE, &myLimit) != 0) return;
+    rlim_t target = myLimit.rlim_max;
+#ifdef CARET_OS_MACOSX
+    if (target == RLIM_INFINITY || target > OPEN_MAX) target = OPEN_MAX;//mac rejects anything above OPEN_MAX
+#endif
+    if (myLimit.rlim_cur == RLIM_INFINITY || myLimit.rlim_cur >= target) return;
+    myLimit.rlim_cur = target;
+    if (setrlimit(RLIMIT_NOFILE, &myLimit) != 0)
+    {
+        CaretLogFine("unable to raise open file limit");
+    }
+#endif
+}
+
 /**
  * Unit testing of assertions.
  * 
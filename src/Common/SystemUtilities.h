@@ -76,6 +76,8 @@ public:
     static bool isMacOperatingSystem();
 
     static int32_t getNumberOfProcessors();
+    
+    static void raiseOpenFileLimit();
 
     static AString createUniqueID();
     
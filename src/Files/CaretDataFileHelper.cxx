@@ -33,6 +33,7 @@
 #include "CiftiConnectivityMatrixDenseFile.h"
 #include "CiftiConnectivityMatrixDenseDynamicFile.h"
 #include "CiftiConnectivityMatrixDenseParcelFile.h"
+#include "CiftiConnectivityMatrixDenseSparseFile.h"
 #include "CiftiConnectivityMatrixParcelDenseFile.h"
 #include "CiftiConnectivityMatrixParcelFile.h"
 #include "CiftiFile.h"
@@ -325,6 +326,9 @@ CaretDataFileHelper::createCaretDataFileForFileType(const DataFileTypeEnum::Enum
         case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
             caretDataFile = new CiftiBrainordinateScalarFile();
             break;
+        case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+            caretDataFile = new CiftiConnectivityMatrixDenseSparseFile();
+            break;
         case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
             caretDataFile = new CiftiBrainordinateDataSeriesFile();
             break;
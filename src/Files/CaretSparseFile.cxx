@@ -17,7 +17,6 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 /*LICENSE_END*/
-
 #include "CaretSparseFile.h"
 
 #include "ByteOrderEnum.h"
@@ -28,10 +27,62 @@
 
 #include <QByteArray>
 
+#include <algorithm>
+#include <cstring>
+
 using namespace caret;
 using namespace std;
 
 const char magic[] = "\0\0\0\0cst\0";
+const char magicVersion2[] = "\0\0\0\0cst\2";
+
+namespace
+{
+    //version 2 layout: magic, dims[2], rowsPerBlock, nonzero count of each row, coded byte length of each row, (if rowsPerBlock > 0) compressed byte length of each block, row data, XML
+    //each nonempty row is a coding byte, then the index gaps as varints, then the values, coded according to the coding byte
+    //if rowsPerBlock > 0, the rows are concatenated in groups of rowsPerBlock, and each group is compressed separately with qCompress
+    enum RowCoding
+    {
+        CODING_ZIGZAG = 0,//signed varint of each value
+        CODING_FIBERS = 1,//varint of the high 32 bits (totalCount), then the low 32 bits as 4 little endian bytes (fractions and distance don't shrink as varints)
+        CODING_FLOAT = 2//the bits of a 32-bit float, as 4 little endian bytes
+    };
+    
+    const int64_t ROWS_PER_BLOCK = 64;
+    
+    void appendVarint(vector<char>& out, uint64_t value)
+    {
+        while (value >= 128)
+        {
+            out.push_back((char)((value & 127) | 128));
+            value >>= 7;
+        }
+        out.push_back((char)value);
+    }
+    
+    const unsigned char* decodeVarint(const unsigned char* data, const unsigned char* end, uint64_t& valueOut)
+    {
+        valueOut = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (data == end) throw DataFileException("row data ended in the middle of a value");
+            valueOut |= ((uint64_t)(*data & 127)) << shift;
+            if ((*data & 128) == 0) return data + 1;
+            ++data;
+        }
+        throw DataFileException("varint too long in row data");
+    }
+    
+    uint64_t zigzagEncode(const int64_t& value)
+    {//avoid right shift of signed values
+        return (value < 0 ? ~(((uint64_t)value) << 1) : ((uint64_t)value) << 1);
+    }
+    
+    int64_t zigzagDecode(const uint64_t& coded)
+    {
+        return (int64_t)((coded & 1) ? ~(coded >> 1) : (coded >> 1));
+    }
+}
 
 CaretSparseFile::CaretSparseFile(const AString& fileName)
 {
@@ -49,9 +100,13 @@ void CaretSparseFile::readFile(const AString& filename)
     FileInformation fileInfo(filename);//useful later for file size, but create it now to reduce the amount of time between file open and size check
     char buf[8];
     m_file.read(buf, 8);
-    for (int i = 0; i < 8; ++i)
+    if (memcmp(buf, magic, 8) == 0)
     {
-        if (buf[i] != magic[i]) throw DataFileException("file has the wrong magic string");
+        m_version = 1;
+    } else if (memcmp(buf, magicVersion2, 8) == 0) {
+        m_version = 2;
+    } else {
+        throw DataFileException("file has the wrong magic string");
     }
     m_file.read(m_dims, 2 * sizeof(int64_t));
     if (ByteOrderEnum::isSystemBigEndian())
@@ -59,6 +114,18 @@ void CaretSparseFile::readFile(const AString& filename)
         ByteSwapping::swapBytes(m_dims, 2);
     }
     if (m_dims[0] < 1 || m_dims[1] < 1) throw DataFileException("both dimensions must be positive");
+    int64_t headerSize = 8 + 2 * sizeof(int64_t);
+    m_rowsPerBlock = 0;
+    if (m_version == 2)
+    {
+        m_file.read(&m_rowsPerBlock, sizeof(int64_t));
+        if (ByteOrderEnum::isSystemBigEndian())
+        {
+            ByteSwapping::swapBytes(&m_rowsPerBlock, 1);
+        }
+        if (m_rowsPerBlock < 0) throw DataFileException("impossible value found for rows per block");
+        headerSize += sizeof(int64_t);
+    }
     m_indexArray.resize(m_dims[1] + 1);
     vector<int64_t> lengthArray(m_dims[1]);
     m_file.read(lengthArray.data(), m_dims[1] * sizeof(int64_t));
@@ -72,8 +139,55 @@ void CaretSparseFile::readFile(const AString& filename)
         if (lengthArray[i] > m_dims[0] || lengthArray[i] < 0) throw DataFileException("impossible value found in length array");
         m_indexArray[i + 1] = m_indexArray[i] + lengthArray[i];
     }
-    m_valuesOffset = 8 + 2 * sizeof(int64_t) + m_dims[1] * sizeof(int64_t);
-    int64_t xml_offset = m_valuesOffset + m_indexArray[m_dims[1]] * 2 * sizeof(int64_t);
+    m_valuesOffset = headerSize + m_dims[1] * sizeof(int64_t);
+    int64_t xml_offset;
+    if (m_version == 1)
+    {
+        m_byteArray.clear();
+        m_blockArray.clear();
+        xml_offset = m_valuesOffset + m_indexArray[m_dims[1]] * 2 * sizeof(int64_t);
+    } else {
+        vector<int64_t> byteLengthArray(m_dims[1]);
+        m_file.read(byteLengthArray.data(), m_dims[1] * sizeof(int64_t));
+        if (ByteOrderEnum::isSystemBigEndian())
+        {
+            ByteSwapping::swapBytes(byteLengthArray.data(), m_dims[1]);
+        }
+        m_valuesOffset += m_dims[1] * sizeof(int64_t);
+        m_byteArray.resize(m_dims[1] + 1);
+        m_byteArray[0] = 0;
+        for (int64_t i = 0; i < m_dims[1]; ++i)
+        {//every nonzero takes at least 2 bytes, plus the coding byte
+            if (byteLengthArray[i] < 0 || (lengthArray[i] == 0) != (byteLengthArray[i] == 0) ||
+                (lengthArray[i] != 0 && byteLengthArray[i] < 1 + 2 * lengthArray[i])) throw DataFileException("impossible value found in byte length array");
+            m_byteArray[i + 1] = m_byteArray[i] + byteLengthArray[i];
+        }
+        if (m_rowsPerBlock > 0)
+        {
+            int64_t numBlocks = (m_dims[1] + m_rowsPerBlock - 1) / m_rowsPerBlock;
+            vector<int64_t> blockLengthArray(numBlocks);
+            m_file.read(blockLengthArray.data(), numBlocks * sizeof(int64_t));
+            if (ByteOrderEnum::isSystemBigEndian())
+            {
+                ByteSwapping::swapBytes(blockLengthArray.data(), numBlocks);
+            }
+            m_valuesOffset += numBlocks * sizeof(int64_t);
+            m_blockArray.resize(numBlocks + 1);
+            m_blockArray[0] = m_valuesOffset;
+            for (int64_t i = 0; i < numBlocks; ++i)
+            {
+                if (blockLengthArray[i] < 0) throw DataFileException("impossible value found in block length array");
+                m_blockArray[i + 1] = m_blockArray[i] + blockLengthArray[i];
+            }
+            xml_offset = m_blockArray[numBlocks];
+        } else {
+            m_blockArray.clear();
+            xml_offset = m_valuesOffset + m_byteArray[m_dims[1]];
+        }
+    }
+    m_cachedBlock = -1;
+    m_lastRowCoding = -1;
+    m_blockData.clear();
     if (xml_offset >= fileInfo.size()) throw DataFileException("file is truncated");
     int64_t xml_length = fileInfo.size() - xml_offset;
     if (xml_length < 1) throw DataFileException("file is truncated");
@@ -103,6 +217,21 @@ CaretSparseFile::~CaretSparseFile()
 void CaretSparseFile::getRow(const int64_t& index, int64_t* rowOut)
 {
     CaretAssert(index >= 0 && index < m_dims[1]);
+    if (m_version == 2)
+    {
+        readRowVersion2(index, m_scratchArray, m_scratchSparseRow);
+        int64_t numNonzero = (int64_t)m_scratchArray.size();
+        if (numNonzero > 0 && m_lastRowCoding == CODING_FLOAT) throw DataFileException("sparse file row " + AString::number(index) + " contains float values, not integers");
+        for (int64_t i = 0; i < m_dims[0]; ++i)
+        {
+            rowOut[i] = 0;
+        }
+        for (int64_t i = 0; i < numNonzero; ++i)
+        {
+            rowOut[m_scratchArray[i]] = m_scratchSparseRow[i];
+        }
+        return;
+    }
     int64_t start = m_indexArray[index], end = m_indexArray[index + 1];
     int64_t numToRead = (end - start) * 2;
     m_scratchArray.resize(numToRead);
@@ -135,6 +264,12 @@ void CaretSparseFile::getRow(const int64_t& index, int64_t* rowOut)
 void CaretSparseFile::getRowSparse(const int64_t& index, vector<int64_t>& indicesOut, vector<int64_t>& valuesOut)
 {
     CaretAssert(index >= 0 && index < m_dims[1]);
+    if (m_version == 2)
+    {
+        readRowVersion2(index, indicesOut, valuesOut);
+        if (!indicesOut.empty() && m_lastRowCoding == CODING_FLOAT) throw DataFileException("sparse file row " + AString::number(index) + " contains float values, not integers");
+        return;
+    }
     int64_t start = m_indexArray[index], end = m_indexArray[index + 1];
     int64_t numToRead = (end - start) * 2, numNonzero = end - start;
     m_scratchArray.resize(numToRead);
@@ -156,6 +291,86 @@ void CaretSparseFile::getRowSparse(const int64_t& index, vector<int64_t>& indice
     }
 }
 
+void CaretSparseFile::readRowVersion2(const int64_t& index, vector<int64_t>& indicesOut, vector<int64_t>& valuesOut)
+{
+    int64_t numNonzero = m_indexArray[index + 1] - m_indexArray[index];
+    indicesOut.resize(numNonzero);
+    valuesOut.resize(numNonzero);
+    if (numNonzero == 0) return;
+    int64_t numBytes = m_byteArray[index + 1] - m_byteArray[index];
+    const unsigned char* data;
+    if (m_rowsPerBlock == 0)
+    {
+        m_scratchBytes.resize(numBytes);
+        m_file.seek(m_valuesOffset + m_byteArray[index]);
+        m_file.read(m_scratchBytes.data(), numBytes);
+        data = (const unsigned char*)m_scratchBytes.data();
+    } else {
+        int64_t block = index / m_rowsPerBlock, blockStart = block * m_rowsPerBlock, blockEnd = min(blockStart + m_rowsPerBlock, m_dims[1]);
+        if (block != m_cachedBlock)
+        {//rows are usually read in order, so keep the most recent block
+            m_cachedBlock = -1;
+            int64_t compressedSize = m_blockArray[block + 1] - m_blockArray[block];
+            QByteArray compressed(compressedSize, '\0');
+            m_file.seek(m_blockArray[block]);
+            m_file.read(compressed.data(), compressedSize);
+            m_blockData = qUncompress(compressed);
+            if ((uint64_t)m_blockData.size() != m_byteArray[blockEnd] - m_byteArray[blockStart])
+            {
+                throw DataFileException("failed to decompress block " + AString::number(block) + " of sparse file");
+            }
+            m_cachedBlock = block;
+        }
+        data = (const unsigned char*)m_blockData.constData() + (m_byteArray[index] - m_byteArray[blockStart]);
+    }
+    const unsigned char* end = data + numBytes;
+    const unsigned char coding = *data;
+    m_lastRowCoding = coding;
+    ++data;
+    int64_t lastIndex = -1;
+    for (int64_t i = 0; i < numNonzero; ++i)
+    {
+        uint64_t gap;
+        data = decodeVarint(data, end, gap);
+        if (gap >= (uint64_t)(m_dims[0] - 1 - lastIndex)) throw DataFileException("impossible index value found in file");
+        lastIndex += gap + 1;
+        indicesOut[i] = lastIndex;
+    }
+    switch (coding)
+    {
+        case CODING_ZIGZAG:
+            for (int64_t i = 0; i < numNonzero; ++i)
+            {
+                uint64_t coded;
+                data = decodeVarint(data, end, coded);
+                valuesOut[i] = zigzagDecode(coded);
+            }
+            break;
+        case CODING_FIBERS:
+            for (int64_t i = 0; i < numNonzero; ++i)
+            {
+                uint64_t high;
+                data = decodeVarint(data, end, high);
+                if ((high >> 32) != 0 || end - data < 4) throw DataFileException("impossible fiber value found in file");
+                uint64_t low = ((uint64_t)data[0]) | (((uint64_t)data[1]) << 8) | (((uint64_t)data[2]) << 16) | (((uint64_t)data[3]) << 24);
+                data += 4;
+                valuesOut[i] = (int64_t)((high << 32) | low);
+            }
+            break;
+        case CODING_FLOAT:
+            if (end - data < 4 * numNonzero) throw DataFileException("row data has the wrong length");
+            for (int64_t i = 0; i < numNonzero; ++i)
+            {
+                valuesOut[i] = (int64_t)(((uint64_t)data[0]) | (((uint64_t)data[1]) << 8) | (((uint64_t)data[2]) << 16) | (((uint64_t)data[3]) << 24));
+                data += 4;
+            }
+            break;
+        default:
+            throw DataFileException("unknown row coding found in file");
+    }
+    if (data != end) throw DataFileException("row data has the wrong length");
+}
+
 void CaretSparseFile::getFibersRow(const int64_t& index, FiberFractions* rowOut)
 {
     if (m_scratchRow.size() != (size_t)m_dims[0]) m_scratchRow.resize(m_dims[0]);
@@ -182,6 +397,43 @@ void CaretSparseFile::getFibersRowSparse(const int64_t& index, vector<int64_t>&
     }
 }
 
+bool CaretSparseFile::isFloatRow(const int64_t& index)
+{
+    CaretAssert(index >= 0 && index < m_dims[1]);
+    if (m_version < 2) return false;
+    readRowVersion2(index, m_scratchArray, m_scratchSparseRow);
+    return !m_scratchArray.empty() && m_lastRowCoding == CODING_FLOAT;
+}
+
+void CaretSparseFile::getFloatRow(const int64_t& index, float* rowOut)
+{
+    getFloatRowSparse(index, m_scratchArray, m_scratchFloatRow);
+    for (int64_t i = 0; i < m_dims[0]; ++i)
+    {
+        rowOut[i] = 0.0f;
+    }
+    size_t numNonzero = m_scratchArray.size();
+    for (size_t i = 0; i < numNonzero; ++i)
+    {
+        rowOut[m_scratchArray[i]] = m_scratchFloatRow[i];
+    }
+}
+
+void CaretSparseFile::getFloatRowSparse(const int64_t& index, vector<int64_t>& indicesOut, vector<float>& valuesOut)
+{
+    if (m_version < 2) throw DataFileException("sparse file does not contain float rows");
+    CaretAssert(index >= 0 && index < m_dims[1]);
+    readRowVersion2(index, indicesOut, m_scratchSparseRow);
+    size_t numNonzero = m_scratchSparseRow.size();
+    if (numNonzero > 0 && m_lastRowCoding != CODING_FLOAT) throw DataFileException("sparse file row " + AString::number(index) + " does not contain float values");
+    valuesOut.resize(numNonzero);
+    for (size_t i = 0; i < numNonzero; ++i)
+    {
+        uint32_t bits = (uint32_t)m_scratchSparseRow[i];
+        memcpy(&(valuesOut[i]), &bits, sizeof(float));
+    }
+}
+
 void CaretSparseFile::decodeFibers(const uint64_t& coded, FiberFractions& decoded)
 {
     decoded.fiberFractions.resize(3);
@@ -206,12 +458,15 @@ void FiberFractions::zero()
     distance = 0.0f;
 }
 
-CaretSparseFileWriter::CaretSparseFileWriter(const AString& fileName, const CiftiXML& xml)
+CaretSparseFileWriter::CaretSparseFileWriter(const AString& fileName, const CiftiXML& xml, const int32_t& version, const bool& compressBlocks)
 {
-    if (!fileName.endsWith(".trajTEMP.wbsparse"))
-    {//for now (and maybe forever), this format is single-purpose
-        CaretLogWarning("sparse trajectory file '" + fileName + "' should be saved ending in .trajTEMP.wbsparse");
+    if (!fileName.endsWith(".wbsparse"))
+    {
+        CaretLogWarning("sparse file '" + fileName + "' should be saved ending in .wbsparse (.trajTEMP.wbsparse for trajectories)");
     }
+    if (version != 1 && version != 2) throw DataFileException("unsupported wbsparse version: " + AString::number(version));
+    if (compressBlocks && version < 2) throw DataFileException("block compression requires wbsparse version 2");
+    m_version = version;
     m_finished = false;
     int64_t dimensions[2] = { xml.getDimensionLength(CiftiXML::ALONG_ROW), xml.getDimensionLength(CiftiXML::ALONG_COLUMN) };
     if (dimensions[0] < 1 || dimensions[1] < 1) throw DataFileException("both dimensions must be positive");
@@ -223,23 +478,69 @@ CaretSparseFileWriter::CaretSparseFileWriter(const AString& fileName, const Cift
         throw DataFileException("wbsparse files cannot be written compressed");
     }//because after we finish writing the data, we have to come back and write the lengths array
     m_file.open(fileName, CaretBinaryFile::WRITE_TRUNCATE);
-    m_file.write(magic, 8);
+    m_file.write((m_version == 2 ? magicVersion2 : magic), 8);
     int64_t tempdims[2] = { m_dims[0], m_dims[1] };
     if (ByteOrderEnum::isSystemBigEndian())
     {
         ByteSwapping::swapBytes(tempdims, 2);
     }
     m_file.write(tempdims, 2 * sizeof(int64_t));
+    m_valuesOffset = 8 + 2 * sizeof(int64_t);
+    m_rowsPerBlock = 0;
+    if (m_version == 2)
+    {
+        m_rowsPerBlock = (compressBlocks ? ROWS_PER_BLOCK : 0);
+        int64_t temp = m_rowsPerBlock;
+        if (ByteOrderEnum::isSystemBigEndian())
+        {
+            ByteSwapping::swapBytes(&temp, 1);
+        }
+        m_file.write(&temp, sizeof(int64_t));
+        m_valuesOffset += sizeof(int64_t);
+    }
     m_lengthArray.resize(m_dims[1], 0);//initialize the memory so that valgrind won't complain
     m_file.write(m_lengthArray.data(), m_dims[1] * sizeof(uint64_t));//write it to get the file to the correct length
+    m_valuesOffset += m_dims[1] * sizeof(int64_t);
+    if (m_version == 2)
+    {
+        m_byteLengthArray.resize(m_dims[1], 0);
+        m_file.write(m_byteLengthArray.data(), m_dims[1] * sizeof(uint64_t));
+        m_valuesOffset += m_dims[1] * sizeof(int64_t);
+        if (m_rowsPerBlock > 0)
+        {
+            m_blockLengthArray.resize((m_dims[1] + m_rowsPerBlock - 1) / m_rowsPerBlock, 0);
+            m_file.write(m_blockLengthArray.data(), m_blockLengthArray.size() * sizeof(uint64_t));
+            m_valuesOffset += m_blockLengthArray.size() * sizeof(int64_t);
+        }
+    }
     m_nextRowIndex = 0;
-    m_valuesOffset = 8 + 2 * sizeof(int64_t) + m_dims[1] * sizeof(int64_t);
+    m_nextBlockIndex = 0;
 }
 
 void CaretSparseFileWriter::writeRow(const int64_t& index, const int64_t* row)
+{
+    writeRowInternal(index, row, CODING_ZIGZAG);
+}
+
+void CaretSparseFileWriter::writeRowInternal(const int64_t& index, const int64_t* row, const int32_t& coding)
 {
     CaretAssert(index < m_dims[1]);
     CaretAssert(index >= m_nextRowIndex);
+    if (m_version == 2)
+    {
+        m_scratchArray.clear();
+        m_scratchSparseRow.clear();
+        for (int64_t i = 0; i < m_dims[0]; ++i)
+        {
+            if (row[i] != 0)
+            {
+                m_scratchArray.push_back(i);
+                m_scratchSparseRow.push_back(row[i]);
+            }
+        }
+        writeRowSparseInternal(index, m_scratchArray, m_scratchSparseRow, coding);
+        return;
+    }
     while (m_nextRowIndex < index)
     {
         m_lengthArray[m_nextRowIndex] = 0;
@@ -267,6 +568,11 @@ void CaretSparseFileWriter::writeRow(const int64_t& index, const int64_t* row)
 }
 
 void CaretSparseFileWriter::writeRowSparse(const int64_t& index, const vector<int64_t>& indices, const vector<int64_t>& values)
+{
+    writeRowSparseInternal(index, indices, values, CODING_ZIGZAG);
+}
+
+void CaretSparseFileWriter::writeRowSparseInternal(const int64_t& index, const vector<int64_t>& indices, const vector<int64_t>& values, const int32_t& coding)
 {
     CaretAssert(index < m_dims[1]);
     CaretAssert(index >= m_nextRowIndex);
@@ -276,26 +582,92 @@ void CaretSparseFileWriter::writeRowSparse(const int64_t& index, const vector<in
         m_lengthArray[m_nextRowIndex] = 0;
         ++m_nextRowIndex;
     }
-    m_scratchArray.clear();
     size_t numNonzero = indices.size();//assume no zeros
     m_lengthArray[index] = numNonzero;
-    int64_t lastIndex = -1;
-    for (size_t i = 0; i < numNonzero; ++i)
-    {
-        if (indices[i] <= lastIndex || indices[i] >= m_dims[0]) throw DataFileException("indices must be sorted when writing sparse rows");
-        lastIndex = indices[i];
-        m_scratchArray.push_back(indices[i]);
-        m_scratchArray.push_back(values[i]);
-    }
-    if (ByteOrderEnum::isSystemBigEndian())
+    if (m_version == 2)
     {
-        ByteSwapping::swapBytes(m_scratchArray.data(), m_scratchArray.size());
+        writeRowVersion2(index, indices, values, coding);
+    } else {
+        m_scratchArray.clear();
+        int64_t lastIndex = -1;
+        for (size_t i = 0; i < numNonzero; ++i)
+        {
+            if (indices[i] <= lastIndex || indices[i] >= m_dims[0]) throw DataFileException("indices must be sorted when writing sparse rows");
+            lastIndex = indices[i];
+            m_scratchArray.push_back(indices[i]);
+            m_scratchArray.push_back(values[i]);
+        }
+        if (ByteOrderEnum::isSystemBigEndian())
+        {
+            ByteSwapping::swapBytes(m_scratchArray.data(), m_scratchArray.size());
+        }
+        m_file.write(m_scratchArray.data(), m_scratchArray.size() * sizeof(int64_t));
     }
-    m_file.write(m_scratchArray.data(), m_scratchArray.size() * sizeof(int64_t));
     m_nextRowIndex = index + 1;
     if (m_nextRowIndex == m_dims[1]) finish();
 }
 
+void CaretSparseFileWriter::writeRowVersion2(const int64_t& index, const vector<int64_t>& indices, const vector<int64_t>& values, const int32_t& coding)
+{
+    if (m_rowsPerBlock > 0) flushBlocks(index);
+    size_t numNonzero = indices.size(), start = m_blockBuffer.size();
+    if (numNonzero > 0)
+    {
+        m_blockBuffer.push_back((char)coding);
+        int64_t lastIndex = -1;
+        for (size_t i = 0; i < numNonzero; ++i)
+        {
+            if (indices[i] <= lastIndex || indices[i] >= m_dims[0]) throw DataFileException("indices must be sorted when writing sparse rows");
+            appendVarint(m_blockBuffer, indices[i] - lastIndex - 1);
+            lastIndex = indices[i];
+        }
+        if (coding == CODING_FIBERS)
+        {
+            for (size_t i = 0; i < numNonzero; ++i)
+            {
+                uint64_t coded = values[i];
+                appendVarint(m_blockBuffer, coded >> 32);
+                for (int b = 0; b < 4; ++b)
+                {
+                    m_blockBuffer.push_back((char)((coded >> (8 * b)) & 255));
+                }
+            }
+        } else if (coding == CODING_FLOAT) {
+            for (size_t i = 0; i < numNonzero; ++i)
+            {
+                uint64_t coded = values[i];//float bits were put in the low 32 bits by writeFloatRowSparse
+                for (int b = 0; b < 4; ++b)
+                {
+                    m_blockBuffer.push_back((char)((coded >> (8 * b)) & 255));
+                }
+            }
+        } else {
+            for (size_t i = 0; i < numNonzero; ++i)
+            {
+                appendVarint(m_blockBuffer, zigzagEncode(values[i]));
+            }
+        }
+    }
+    m_byteLengthArray[index] = m_blockBuffer.size() - start;
+    if (m_rowsPerBlock == 0)
+    {
+        m_file.write(m_blockBuffer.data(), m_blockBuffer.size());
+        m_blockBuffer.clear();
+    }
+}
+
+void CaretSparseFileWriter::flushBlocks(const int64_t& nextRow)
+{
+    while (m_nextBlockIndex < (int64_t)m_blockLengthArray.size() && (m_nextBlockIndex + 1) * m_rowsPerBlock <= nextRow)
+    {
+        QByteArray compressed = qCompress((const uchar*)m_blockBuffer.data(), m_blockBuffer.size());
+        m_file.write(compressed.constData(), compressed.size());
+        m_blockLengthArray[m_nextBlockIndex] = compressed.size();
+        m_blockBuffer.clear();
+        ++m_nextBlockIndex;
+    }
+}
+
 void CaretSparseFileWriter::writeFibersRow(const int64_t& index, const FiberFractions* row)
 {
     if (m_scratchRow.size() != (size_t)m_dims[0]) m_scratchRow.resize(m_dims[0]);
@@ -308,7 +680,7 @@ void CaretSparseFileWriter::writeFibersRow(const int64_t& index, const FiberFrac
             encodeFibers(row[i], m_scratchRow[i]);
         }
     }
-    writeRow(index, (int64_t*)m_scratchRow.data());
+    writeRowInternal(index, (int64_t*)m_scratchRow.data(), CODING_FIBERS);
 }
 
 void CaretSparseFileWriter::writeFibersRowSparse(const int64_t& index, const vector<int64_t>& indices, const vector<FiberFractions>& values)
@@ -319,7 +691,21 @@ void CaretSparseFileWriter::writeFibersRowSparse(const int64_t& index, const vec
     {
         encodeFibers(values[i], ((uint64_t*)m_scratchSparseRow.data())[i]);
     }
-    writeRowSparse(index, indices, m_scratchSparseRow);
+    writeRowSparseInternal(index, indices, m_scratchSparseRow, CODING_FIBERS);
+}
+
+void CaretSparseFileWriter::writeFloatRowSparse(const int64_t& index, const vector<int64_t>& indices, const vector<float>& values)
+{
+    if (m_version < 2) throw DataFileException("float rows require wbsparse version 2");
+    size_t numNonzero = values.size();
+    m_scratchSparseRow.resize(numNonzero);
+    for (size_t i = 0; i < numNonzero; ++i)
+    {
+        uint32_t bits;
+        memcpy(&bits, &(values[i]), sizeof(uint32_t));
+        m_scratchSparseRow[i] = bits;
+    }
+    writeRowSparseInternal(index, indices, m_scratchSparseRow, CODING_FLOAT);
 }
 
 void CaretSparseFileWriter::finish()
@@ -331,14 +717,25 @@ void CaretSparseFileWriter::finish()
         m_lengthArray[m_nextRowIndex] = 0;
         ++m_nextRowIndex;
     }
+    if (m_rowsPerBlock > 0)
+    {
+        flushBlocks(m_blockLengthArray.size() * m_rowsPerBlock);
+    }
     QByteArray myXMLBytes = m_xml.writeXMLToQByteArray();
     m_file.write(myXMLBytes.constData(), myXMLBytes.size());
-    m_file.seek(8 + 2 * sizeof(int64_t));
+    m_file.seek(8 + 2 * sizeof(int64_t) + (m_version == 2 ? sizeof(int64_t) : 0));
     if (ByteOrderEnum::isSystemBigEndian())
     {
         ByteSwapping::swapBytes(m_lengthArray.data(), m_lengthArray.size());
+        ByteSwapping::swapBytes(m_byteLengthArray.data(), m_byteLengthArray.size());
+        ByteSwapping::swapBytes(m_blockLengthArray.data(), m_blockLengthArray.size());
     }
     m_file.write(m_lengthArray.data(), m_lengthArray.size() * sizeof(uint64_t));
+    if (m_version == 2)
+    {
+        m_file.write(m_byteLengthArray.data(), m_byteLengthArray.size() * sizeof(uint64_t));
+        m_file.write(m_blockLengthArray.data(), m_blockLengthArray.size() * sizeof(uint64_t));
+    }
     m_file.close();
 }
 
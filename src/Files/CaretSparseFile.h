@@ -30,6 +30,8 @@
 #include "DataFile.h"
 #include "DataFileException.h"
 
+#include <QByteArray>
+
 namespace caret {
     
     struct FiberFractions
@@ -44,13 +46,22 @@ namespace caret {
     {
         static void decodeFibers(const uint64_t& coded, FiberFractions& decoded);//takes a uint because right shift on signed is implementation dependent
         CaretBinaryFile m_file;
-        int64_t m_dims[2], m_valuesOffset;
+        int64_t m_dims[2], m_valuesOffset, m_rowsPerBlock, m_cachedBlock;
+        int32_t m_version, m_lastRowCoding;
         std::vector<uint64_t> m_indexArray, m_scratchRow;
+        std::vector<uint64_t> m_byteArray, m_blockArray;//version 2: start of each row in the uncoded data stream, file offset of each compressed block
         std::vector<int64_t> m_scratchArray, m_scratchSparseRow;
+        std::vector<float> m_scratchFloatRow;
+        std::vector<char> m_scratchBytes;
+        QByteArray m_blockData;
+        void readRowVersion2(const int64_t& index, std::vector<int64_t>& indicesOut, std::vector<int64_t>& valuesOut);
         CaretSparseFile(const CaretSparseFile& rhs);
         CiftiXML m_xml;
     public:
         const int64_t* getDimensions() { return m_dims; }
+        
+        ///1 for raw int64 index/value pairs, 2 for delta/varint coded rows with optional block compression
+        int32_t getVersion() const { return m_version; }
 
         CaretSparseFile() {};
         
@@ -63,6 +74,7 @@ namespace caret {
         ///get a reference to the XML data
         const CiftiXML& getCiftiXML() const { return m_xml; }
         
+        ///these and the fibers functions throw if the row was written with writeFloatRowSparse
         void getRow(const int64_t& index, int64_t* rowOut);
         
         void getRowSparse(const int64_t& index, std::vector<int64_t>& indicesOut, std::vector<int64_t>& valuesOut);
@@ -70,6 +82,14 @@ namespace caret {
         void getFibersRow(const int64_t& index, FiberFractions* rowOut);
         
         void getFibersRowSparse(const int64_t& index, std::vector<int64_t>& indicesOut, std::vector<FiberFractions>& valuesOut);
+        
+        ///whether the row was written with writeFloatRowSparse, false for empty rows
+        bool isFloatRow(const int64_t& index);
+        
+        ///only for rows written with writeFloatRowSparse, zeros are filled in for missing elements
+        void getFloatRow(const int64_t& index, float* rowOut);
+        
+        void getFloatRowSparse(const int64_t& index, std::vector<int64_t>& indicesOut, std::vector<float>& valuesOut);
 
         virtual ~CaretSparseFile();
     };
@@ -79,14 +99,22 @@ namespace caret {
         static void encodeFibers(const FiberFractions& orig, uint64_t& coded);
         static uint32_t myclamp(const int& x);
         CaretBinaryFile m_file;
-        int64_t m_dims[2], m_valuesOffset, m_nextRowIndex;
+        int64_t m_dims[2], m_valuesOffset, m_nextRowIndex, m_rowsPerBlock, m_nextBlockIndex;
+        int32_t m_version;
         bool m_finished;
         std::vector<uint64_t> m_lengthArray, m_scratchRow;
+        std::vector<uint64_t> m_byteLengthArray, m_blockLengthArray;//version 2 only
         std::vector<int64_t> m_scratchArray, m_scratchSparseRow;
+        std::vector<char> m_blockBuffer;
+        void writeRowInternal(const int64_t& index, const int64_t* row, const int32_t& coding);
+        void writeRowSparseInternal(const int64_t& index, const std::vector<int64_t>& indices, const std::vector<int64_t>& values, const int32_t& coding);
+        void writeRowVersion2(const int64_t& index, const std::vector<int64_t>& indices, const std::vector<int64_t>& values, const int32_t& coding);
+        void flushBlocks(const int64_t& nextRow);
         CaretSparseFileWriter(const CaretSparseFileWriter& rhs);
         CiftiXML m_xml;
     public:
-        CaretSparseFileWriter(const AString& fileName, const CiftiXML& xml);
+        ///version 1 is readable by older versions of workbench, version 2 is usually several times smaller, and compressBlocks (version 2 only) shrinks it further at some cost to read speed
+        CaretSparseFileWriter(const AString& fileName, const CiftiXML& xml, const int32_t& version = 1, const bool& compressBlocks = false);
         
         ~CaretSparseFileWriter();
         
@@ -102,6 +130,9 @@ namespace caret {
         ///you must write the rows in order, though you can skip empty rows
         void writeFibersRowSparse(const int64_t& index, const std::vector<int64_t>& indices, const std::vector<FiberFractions>& values);
         
+        ///you must write the rows in order, though you can skip empty rows - version 2 only, values are stored exactly
+        void writeFloatRowSparse(const int64_t& index, const std::vector<int64_t>& indices, const std::vector<float>& values);
+        
         ///call this if no rows remain to be written
         void finish();
     };
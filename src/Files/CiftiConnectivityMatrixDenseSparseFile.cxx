@@ -0,0 +1,276 @@
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include <algorithm>
+#include <vector>
+
+#define __CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_DECLARE__
+#include "CiftiConnectivityMatrixDenseSparseFile.h"
+#undef __CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_DECLARE__
+
+#include "CaretAssert.h"
+#include "CaretSparseFile.h"
+#include "CiftiFile.h"
+#include "DataFileException.h"
+
+using namespace caret;
+
+
+
+/**
+ * \class caret::CiftiConnectivityMatrixDenseSparseFile
+ * \brief Connectivity Dense x Dense File stored in the wbsparse format
+ * \ingroup Files
+ *
+ * Contains a connectivity matrix from brainordinates to brainordinates,
+ * such as the distance limited output of -surface-geodesic-distance-all-to-all
+ * with -sparse.  Like the fiber trajectory file, the sparse file is kept
+ * open and rows are read when a brainordinate is selected.  The CIFTI
+ * file in the parent class contains only the XML so that the brainordinate
+ * mapping, palette, and row loading are shared with the dense file.
+ */
+
+/**
+ * Constructor.
+ */
+CiftiConnectivityMatrixDenseSparseFile::CiftiConnectivityMatrixDenseSparseFile()
+: CiftiMappableConnectivityMatrixDataFile(DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE)
+{
+
+}
+
+/**
+ * Destructor.
+ */
+CiftiConnectivityMatrixDenseSparseFile::~CiftiConnectivityMatrixDenseSparseFile()
+{
+
+}
+
+/**
+ * Clear the contents of the file.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::clear()
+{
+    CiftiMappableConnectivityMatrixDataFile::clear();
+
+    m_sparseFile.grabNew(NULL);
+}
+
+/**
+ * Read the file.
+ *
+ * @param filename
+ *    Name of the file.
+ * @throws DataFileException
+ *    If the file was not successfully read.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::readFile(const AString& filename)
+{
+    clear();
+
+    if (DataFile::isFileOnNetwork(filename)) {
+        throw DataFileException(filename,
+                                DataFileTypeEnum::toGuiName(getDataFileType())
+                                + " cannot be read over the network.  The file must be"
+                                " accessed by reading individual rows and this cannot"
+                                " be performed over a network.");
+    }
+
+    checkFileReadability(filename);
+
+    try {
+        m_sparseFile.grabNew(new CaretSparseFile());
+        m_sparseFile->readFile(filename);
+
+        m_ciftiFile.grabNew(new CiftiFile());
+        m_ciftiFile->setCiftiXML(m_sparseFile->getCiftiXML(),
+                                 false);
+
+        initializeAfterReading(filename);
+    }
+    catch (DataFileException& e) {
+        clear();
+        throw e;
+    }
+    catch (CaretException& e) {
+        clear();
+        throw DataFileException(filename,
+                                e.whatString());
+    }
+
+    setFileName(filename);
+    clearModified();
+}
+
+/**
+ * Write the file.
+ *
+ * @param filename
+ *    Name of the file.
+ * @throws DataFileException
+ *    Always, writing is not supported.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::writeFile(const AString& filename)
+{
+    throw DataFileException(filename,
+                            "Writing of sparse dense connectivity files is not supported.");
+}
+
+/**
+ * @return True if this file type supports writing, else false.
+ *
+ * Sparse dense files do NOT support writing.
+ */
+bool
+CiftiConnectivityMatrixDenseSparseFile::supportsWriting() const
+{
+    return false;
+}
+
+/**
+ * Get the minimum and maximum values from ALL maps in this file.
+ * The range is not available since it would require reading every
+ * row in the file.
+ *
+ * @param dataRangeMinimumOut
+ *    Output with the negative maximum float value.
+ * @param dataRangeMaximumOut
+ *    Output with the maximum float value.
+ * @return
+ *    Always false.
+ */
+bool
+CiftiConnectivityMatrixDenseSparseFile::getDataRangeFromAllMaps(float& dataRangeMinimumOut,
+                                                                float& dataRangeMaximumOut) const
+{
+    return CaretMappableDataFile::getDataRangeFromAllMaps(dataRangeMinimumOut,
+                                                          dataRangeMaximumOut);
+}
+
+/**
+ * Load data for the given column.  Every row in the file is read so
+ * this is slow for large files.
+ *
+ * @param dataOut
+ *     Output with data.
+ * @param index
+ *     Index of the column.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::getDataForColumn(float* dataOut,
+                                                         const int64_t& index) const
+{
+    CaretAssert(m_sparseFile);
+
+    const int64_t numberOfRows = m_sparseFile->getDimensions()[1];
+    std::vector<int64_t> indices;
+    std::vector<int64_t> intValues;
+    std::vector<float> floatValues;
+    for (int64_t iRow = 0; iRow < numberOfRows; iRow++) {
+        dataOut[iRow] = 0.0f;
+
+        /*
+         * Indices in a row are sorted
+         */
+        if (m_sparseFile->isFloatRow(iRow)) {
+            m_sparseFile->getFloatRowSparse(iRow, indices, floatValues);
+            std::vector<int64_t>::iterator iter = std::lower_bound(indices.begin(), indices.end(), index);
+            if ((iter != indices.end())
+                && (*iter == index)) {
+                dataOut[iRow] = floatValues[iter - indices.begin()];
+            }
+        }
+        else {
+            m_sparseFile->getRowSparse(iRow, indices, intValues);
+            std::vector<int64_t>::iterator iter = std::lower_bound(indices.begin(), indices.end(), index);
+            if ((iter != indices.end())
+                && (*iter == index)) {
+                dataOut[iRow] = intValues[iter - indices.begin()];
+            }
+        }
+    }
+}
+
+/**
+ * Load data for the given row.
+ *
+ * @param dataOut
+ *     Output with data.
+ * @param index
+ *     Index of the row.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::getDataForRow(float* dataOut,
+                                                      const int64_t& index) const
+{
+    CaretAssert(m_sparseFile);
+
+    if (m_sparseFile->isFloatRow(index)) {
+        m_sparseFile->getFloatRow(index, dataOut);
+    }
+    else {
+        /*
+         * Empty rows and rows containing integers
+         */
+        const int64_t numberOfColumns = m_sparseFile->getDimensions()[0];
+        std::vector<int64_t> rowData(numberOfColumns);
+        m_sparseFile->getRow(index, &rowData[0]);
+        for (int64_t i = 0; i < numberOfColumns; i++) {
+            dataOut[i] = rowData[i];
+        }
+    }
+}
+
+/**
+ * Load PROCESSED data for the given column.
+ *
+ * @param dataOut
+ *     Output with data.
+ * @param index
+ *     Index of the column.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::getProcessedDataForColumn(float* dataOut,
+                                                                  const int64_t& index) const
+{
+    getDataForColumn(dataOut,
+                     index);
+}
+
+/**
+ * Load PROCESSED data for the given row.
+ *
+ * @param dataOut
+ *     Output with data.
+ * @param index
+ *     Index of the row.
+ */
+void
+CiftiConnectivityMatrixDenseSparseFile::getProcessedDataForRow(float* dataOut,
+                                                               const int64_t& index) const
+{
+    getDataForRow(dataOut,
+                  index);
+}
@@ -0,0 +1,76 @@
+#ifndef __CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_H__
+#define __CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "CaretPointer.h"
+#include "CiftiMappableConnectivityMatrixDataFile.h"
+
+namespace caret {
+
+    class CaretSparseFile;
+
+    class CiftiConnectivityMatrixDenseSparseFile : public CiftiMappableConnectivityMatrixDataFile {
+
+    public:
+        CiftiConnectivityMatrixDenseSparseFile();
+
+        virtual ~CiftiConnectivityMatrixDenseSparseFile();
+
+        virtual void clear();
+
+        virtual void readFile(const AString& filename);
+
+        virtual void writeFile(const AString& filename);
+
+        virtual bool supportsWriting() const;
+
+        virtual bool getDataRangeFromAllMaps(float& dataRangeMinimumOut,
+                                             float& dataRangeMaximumOut) const;
+
+    private:
+        CiftiConnectivityMatrixDenseSparseFile(const CiftiConnectivityMatrixDenseSparseFile&);
+
+        CiftiConnectivityMatrixDenseSparseFile& operator=(const CiftiConnectivityMatrixDenseSparseFile&);
+
+    protected:
+        virtual void getDataForColumn(float* dataOut, const int64_t& index) const;
+
+        virtual void getDataForRow(float* dataOut, const int64_t& index) const;
+
+        virtual void getProcessedDataForColumn(float* dataOut, const int64_t& index) const;
+
+        virtual void getProcessedDataForRow(float* dataOut, const int64_t& index) const;
+
+    private:
+        /** Sparse file that stays open so that rows are read as they are needed */
+        CaretPointer<CaretSparseFile> m_sparseFile;
+
+        // ADD_NEW_MEMBERS_HERE
+
+    };
+
+#ifdef __CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_DECLARE__
+    // <PLACE DECLARATIONS OF STATIC MEMBERS HERE>
+#endif // __CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_DECLARE__
+
+} // namespace
+#endif  //__CIFTI_CONNECTIVITY_MATRIX_DENSE_SPARSE_FILE_H__
@@ -0,0 +1,127 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "CiftiGroupReader.h"
+
+#include "CaretAssert.h"
+#include "CaretOMP.h"
+#include "CiftiFile.h"
+#include "DataFileException.h"
+#include "ElapsedTimer.h"
+
+#include <algorithm>
+#include <map>
+
+using namespace caret;
+using namespace std;
+
+CiftiGroupReader::CiftiGroupReader(const vector<const CiftiFile*>& files, const int64_t& memoryLimitBytes)
+{
+    CaretAssert(!files.empty());
+    m_numRows = -1;
+    m_bytesRead = 0;
+    m_readSeconds = 0.0;
+    m_blockFirstRow = 0;
+    m_blockNumRows = 0;
+    map<const CiftiFile*, int> uniqueMap;
+    int64_t totalRowLength = 0;
+    for (int i = 0; i < (int)files.size(); ++i)
+    {
+        CaretAssert(files[i] != NULL);
+        const CiftiXML& myXML = files[i]->getCiftiXML();
+        if (myXML.getNumberOfDimensions() != 2) throw DataFileException("only 2D cifti files can be read in groups");
+        const int64_t numRows = myXML.getDimensionLength(CiftiXML::ALONG_COLUMN);
+        if (m_numRows == -1) m_numRows = numRows;
+        if (numRows != m_numRows) throw DataFileException("cifti file '" + files[i]->getFileName() + "' has a different number of rows than earlier inputs");
+        map<const CiftiFile*, int>::iterator iter = uniqueMap.find(files[i]);
+        if (iter != uniqueMap.end())
+        {
+            m_fileToUnique.push_back(iter->second);
+            continue;
+        }
+        const int newIndex = (int)m_uniqueFiles.size();
+        uniqueMap[files[i]] = newIndex;
+        m_fileToUnique.push_back(newIndex);
+        m_uniqueFiles.push_back(files[i]);
+        m_rowLengths.push_back(myXML.getDimensionLength(CiftiXML::ALONG_ROW));
+        totalRowLength += m_rowLengths.back();
+    }
+    m_rowsPerBlock = max((int64_t)1, min(m_numRows, memoryLimitBytes / (int64_t)(sizeof(float) * max((int64_t)1, totalRowLength))));
+    m_blocks.resize(m_uniqueFiles.size());
+    for (int i = 0; i < (int)m_uniqueFiles.size(); ++i)
+    {
+        m_blocks[i].resize(m_rowsPerBlock * m_rowLengths[i]);
+    }
+}
+
+void CiftiGroupReader::readBlock(const int64_t& firstRow, const int64_t& numRows)
+{
+    CaretAssert(firstRow >= 0 && numRows > 0 && numRows <= m_rowsPerBlock && firstRow + numRows <= m_numRows);
+    ElapsedTimer myTimer;
+    myTimer.start();
+    const int numUnique = (int)m_uniqueFiles.size();
+    bool failed = false;
+    AString failMessage;
+    //each file is read sequentially by one thread, so on shared storage the per-file latencies overlap instead of adding up
+#pragma omp CARET_PARFOR schedule(dynamic)
+    for (int i = 0; i < numUnique; ++i)
+    {
+        try
+        {
+            for (int64_t row = 0; row < numRows; ++row)
+            {
+                m_uniqueFiles[i]->getRow(m_blocks[i].data() + row * m_rowLengths[i], firstRow + row);
+            }
+        } catch (CaretException& e) {//exceptions can't leave the parallel region
+#pragma omp critical
+            {
+                if (!failed)
+                {
+                    failed = true;
+                    failMessage = e.whatString();
+                }
+            }
+        }
+    }
+    if (failed) throw DataFileException(failMessage);
+    m_blockFirstRow = firstRow;
+    m_blockNumRows = numRows;
+    for (int i = 0; i < numUnique; ++i)
+    {
+        m_bytesRead += numRows * m_rowLengths[i] * sizeof(float);
+    }
+    m_readSeconds += myTimer.getElapsedTimeSeconds();
+}
+
+const float* CiftiGroupReader::getRow(const int& file, const int64_t& row) const
+{
+    CaretAssertVectorIndex(m_fileToUnique, file);
+    CaretAssert(row >= m_blockFirstRow && row < m_blockFirstRow + m_blockNumRows);
+    const int unique = m_fileToUnique[file];
+    return m_blocks[unique].data() + (row - m_blockFirstRow) * m_rowLengths[unique];
+}
+
+AString CiftiGroupReader::getThroughputDescription() const
+{
+    const double megabytes = m_bytesRead / (1024.0 * 1024.0);
+    AString ret = "read " + AString::number(megabytes, 'f', 1) + " MB from " + AString::number((int)m_uniqueFiles.size()) + " files in " + AString::number(m_readSeconds, 'f', 2) + " seconds";
+    if (m_readSeconds > 0.0) ret += " (" + AString::number(megabytes / m_readSeconds, 'f', 1) + " MB/s)";
+    return ret;
+}
@@ -0,0 +1,68 @@
+#ifndef __CIFTI_GROUP_READER_H__
+#define __CIFTI_GROUP_READER_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "AString.h"
+
+#include <stdint.h>
+#include <vector>
+
+namespace caret {
+    
+    class CiftiFile;
+    
+    ///reads the same block of rows from many 2D cifti files, with the files read concurrently,
+    ///for commands that combine files element by element (averaging, merging)
+    ///the block size is chosen so that the blocks of all files together stay within a memory limit
+    class CiftiGroupReader
+    {
+        std::vector<const CiftiFile*> m_uniqueFiles;//the same object must not be read from two threads at once
+        std::vector<int> m_fileToUnique;
+        std::vector<int64_t> m_rowLengths;//per unique file
+        std::vector<std::vector<float> > m_blocks;
+        int64_t m_numRows, m_rowsPerBlock, m_blockFirstRow, m_blockNumRows;
+        int64_t m_bytesRead;
+        double m_readSeconds;
+        CiftiGroupReader(const CiftiGroupReader&);
+        CiftiGroupReader& operator=(const CiftiGroupReader&);
+    public:
+        ///files must all have the same number of rows, but rows may differ in length
+        CiftiGroupReader(const std::vector<const CiftiFile*>& files, const int64_t& memoryLimitBytes = 256 * 1024 * 1024);
+        
+        int64_t getNumberOfRows() const { return m_numRows; }
+        int64_t getRowsPerBlock() const { return m_rowsPerBlock; }
+        
+        ///read rows [firstRow, firstRow + numRows) of every file, numRows must not be more than getRowsPerBlock()
+        void readBlock(const int64_t& firstRow, const int64_t& numRows);
+        
+        ///a row from the most recent block, file is the index into the vector given to the constructor
+        const float* getRow(const int& file, const int64_t& row) const;
+        
+        ///for logging throughput, covers all calls to readBlock so far
+        int64_t getBytesRead() const { return m_bytesRead; }
+        double getReadSeconds() const { return m_readSeconds; }
+        AString getThroughputDescription() const;
+    };
+    
+}
+
+#endif //__CIFTI_GROUP_READER_H__
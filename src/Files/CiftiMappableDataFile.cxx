@@ -18,8 +18,11 @@
  */
 /*LICENSE_END*/
 
+#include <algorithm>
 #include <set>
 
+#include <QThread>
+
 #define __CIFTI_MAPPABLE_DATA_FILE_DECLARE__
 #include "CiftiMappableDataFile.h"
 #undef __CIFTI_MAPPABLE_DATA_FILE_DECLARE__
@@ -47,12 +50,268 @@
 #include "GroupAndNameHierarchyModel.h"
 #include "Histogram.h"
 #include "NodeAndVoxelColoring.h"
+#include "Palette.h"
 #include "PaletteColorMapping.h"
 #include "PaletteFile.h"
 #include "SparseVolumeIndexer.h"
 
 using namespace caret;
 
+/**
+ * \class caret::CiftiMappableDataFile::MapPrefetch
+ * \brief Consecutive maps read ahead and colored by a MapPrefetchThread
+ *
+ * The palette color mappings and palettes are copies made when the
+ * prefetch is created so that the thread never uses the palette
+ * settings while the user is changing them.
+ */
+class CiftiMappableDataFile::MapPrefetch {
+public:
+    MapPrefetch(const int32_t firstMapIndex,
+                const int32_t mapCount,
+                const int64_t mapSize)
+    : m_firstMapIndex(firstMapIndex),
+    m_mapCount(mapCount),
+    m_mapSize(mapSize),
+    m_paletteNormalizationMode(PaletteNormalizationModeEnum::NORMALIZATION_SELECTED_MAP_DATA) { }
+    
+    bool containsMap(const int32_t mapIndex) const {
+        return ((mapIndex >= m_firstMapIndex)
+                && (mapIndex < (m_firstMapIndex + m_mapCount)));
+    }
+    
+    /** @return Data for the map or NULL if the data was not kept */
+    const float* getMapData(const int32_t mapIndex) const {
+        if ( ! containsMap(mapIndex)
+            || m_mapData.empty()) {
+            return NULL;
+        }
+        return &m_mapData[(mapIndex - m_firstMapIndex) * m_mapSize];
+    }
+    
+    /** Index of first map */
+    const int32_t m_firstMapIndex;
+    
+    /** Number of maps */
+    const int32_t m_mapCount;
+    
+    /** Number of elements in each map */
+    const int64_t m_mapSize;
+    
+    /** Data for the maps, only kept when the file is read from disk */
+    std::vector<float> m_mapData;
+    
+    /** Non-empty if reading the maps failed */
+    AString m_errorMessage;
+    
+    /** Normalization mode when the prefetch was created */
+    PaletteNormalizationModeEnum::Enum m_paletteNormalizationMode;
+    
+    /** Copy of the file's statistics for NORMALIZATION_ALL_MAP_DATA */
+    CaretPointer<FastStatistics> m_fileFastStatistics;
+    
+    /** Copy of each map's palette color mapping, NULL if the map is not colored */
+    std::vector<CaretPointer<PaletteColorMapping> > m_paletteColorMappings;
+    
+    /** Copy of each map's palette */
+    std::vector<CaretPointer<Palette> > m_palettes;
+    
+    /** Statistics of each map for NORMALIZATION_SELECTED_MAP_DATA */
+    std::vector<CaretPointer<FastStatistics> > m_mapFastStatistics;
+    
+    /** Coloring of each map, empty if the map was not colored */
+    std::vector<std::vector<uint8_t> > m_rgba;
+};
+
+/**
+ * \class caret::CiftiMappableDataFile::MapPrefetchThread
+ * \brief Reads and colors maps in the background while the maps are stepped through in order
+ *
+ * The GUI thread only accesses the prefetch given to startPrefetch() after
+ * finishPrefetch() has waited for the thread, so no other locking is needed.
+ * A file read from disk is opened again by the thread so that reading does
+ * not interfere with the GUI thread's use of its CiftiFile.
+ */
+class CiftiMappableDataFile::MapPrefetchThread : public QThread {
+public:
+    MapPrefetchThread(const CiftiFile* inMemoryCiftiFile,
+                      const AString& fileName)
+    : m_inMemoryCiftiFile(inMemoryCiftiFile),
+    m_fileName(fileName) { }
+    
+    ~MapPrefetchThread() {
+        wait();
+    }
+    
+    /** @return True if a prefetch was started and not yet finished with finishPrefetch() */
+    bool isPrefetchPending() const {
+        return (m_prefetch != NULL);
+    }
+    
+    void startPrefetch(MapPrefetch* prefetch) {
+        CaretAssert( ! isPrefetchPending());
+        m_prefetch.grabNew(prefetch);
+        start(QThread::LowPriority);
+    }
+    
+    /** Wait for the thread and return the maps it prepared */
+    CaretPointer<MapPrefetch> finishPrefetch() {
+        wait();
+        CaretPointer<MapPrefetch> prefetch = m_prefetch;
+        m_prefetch.grabNew(NULL);
+        return prefetch;
+    }
+    
+protected:
+    virtual void run();
+    
+private:
+    void readMapData(MapPrefetch* prefetch);
+    
+    void colorMap(MapPrefetch* prefetch,
+                  const int32_t mapIndex,
+                  const float* data);
+    
+    /** CIFTI file of the data file when it is in memory, otherwise NULL */
+    const CiftiFile* m_inMemoryCiftiFile;
+    
+    /** Name of the data file */
+    const AString m_fileName;
+    
+    /** CIFTI file opened by this thread when the file is read from disk */
+    CaretPointer<CiftiFile> m_onDiskCiftiFile;
+    
+    /** Maps being prepared */
+    CaretPointer<MapPrefetch> m_prefetch;
+};
+
+/**
+ * Read and color the maps of the prefetch.
+ */
+void
+CiftiMappableDataFile::MapPrefetchThread::run()
+{
+    MapPrefetch* prefetch = m_prefetch;
+    CaretAssert(prefetch);
+    
+    try {
+        if (m_inMemoryCiftiFile != NULL) {
+            /*
+             * Data is not kept since getMapData() copies
+             * a column from memory quickly.
+             */
+            std::vector<float> data(prefetch->m_mapSize);
+            for (int32_t iMap = 0; iMap < prefetch->m_mapCount; iMap++) {
+                const int32_t mapIndex = prefetch->m_firstMapIndex + iMap;
+                m_inMemoryCiftiFile->getColumn(&data[0],
+                                               mapIndex);
+                colorMap(prefetch,
+                         mapIndex,
+                         &data[0]);
+            }
+        }
+        else {
+            readMapData(prefetch);
+            for (int32_t iMap = 0; iMap < prefetch->m_mapCount; iMap++) {
+                const int32_t mapIndex = prefetch->m_firstMapIndex + iMap;
+                colorMap(prefetch,
+                         mapIndex,
+                         prefetch->getMapData(mapIndex));
+            }
+        }
+    }
+    catch (const CaretException& e) {
+        prefetch->m_errorMessage = e.whatString();
+        std::vector<float>().swap(prefetch->m_mapData);
+        prefetch->m_rgba.clear();
+    }
+}
+
+/**
+ * Read the data of the prefetch's maps from the file on disk.  Reading
+ * a column from a file on disk reads one element from every row so each
+ * row is read once for all of the maps.
+ *
+ * @param prefetch
+ *    Prefetch whose data is read.
+ */
+void
+CiftiMappableDataFile::MapPrefetchThread::readMapData(MapPrefetch* prefetch)
+{
+    if (m_onDiskCiftiFile == NULL) {
+        m_onDiskCiftiFile.grabNew(new CiftiFile(m_fileName));
+    }
+    
+    const int64_t numberOfRows    = m_onDiskCiftiFile->getNumberOfRows();
+    const int64_t numberOfColumns = m_onDiskCiftiFile->getNumberOfColumns();
+    if ((numberOfRows != prefetch->m_mapSize)
+        || (numberOfColumns < (prefetch->m_firstMapIndex + prefetch->m_mapCount))) {
+        throw DataFileException(m_fileName,
+                                "Dimensions of file on disk do not match the loaded file.");
+    }
+    
+    std::vector<float> mapData(prefetch->m_mapCount * numberOfRows);
+    std::vector<float> rowData(numberOfColumns);
+    for (int64_t iRow = 0; iRow < numberOfRows; iRow++) {
+        m_onDiskCiftiFile->getRow(&rowData[0],
+                                  iRow);
+        for (int32_t iMap = 0; iMap < prefetch->m_mapCount; iMap++) {
+            mapData[iMap * numberOfRows + iRow] = rowData[prefetch->m_firstMapIndex + iMap];
+        }
+    }
+    prefetch->m_mapData.swap(mapData);
+}
+
+/**
+ * Color a map of the prefetch using the palette settings copied
+ * when the prefetch was created.
+ *
+ * @param prefetch
+ *    Prefetch containing the map.
+ * @param mapIndex
+ *    Index of the map.
+ * @param data
+ *    Data of the map.
+ */
+void
+CiftiMappableDataFile::MapPrefetchThread::colorMap(MapPrefetch* prefetch,
+                                                   const int32_t mapIndex,
+                                                   const float* data)
+{
+    const int32_t iMap = mapIndex - prefetch->m_firstMapIndex;
+    if ((iMap >= static_cast<int32_t>(prefetch->m_paletteColorMappings.size()))
+        || (prefetch->m_paletteColorMappings[iMap] == NULL)) {
+        return;
+    }
+    CaretAssertVectorIndex(prefetch->m_palettes, iMap);
+    CaretAssert(prefetch->m_palettes[iMap] != NULL);
+    
+    const FastStatistics* statistics = NULL;
+    switch (prefetch->m_paletteNormalizationMode) {
+        case PaletteNormalizationModeEnum::NORMALIZATION_ALL_MAP_DATA:
+            statistics = prefetch->m_fileFastStatistics;
+            break;
+        case PaletteNormalizationModeEnum::NORMALIZATION_SELECTED_MAP_DATA:
+            prefetch->m_mapFastStatistics[iMap].grabNew(new FastStatistics(data,
+                                                                           prefetch->m_mapSize));
+            statistics = prefetch->m_mapFastStatistics[iMap];
+            break;
+    }
+    if (statistics == NULL) {
+        return;
+    }
+    
+    std::vector<uint8_t>& rgba = prefetch->m_rgba[iMap];
+    rgba.resize(prefetch->m_mapSize * 4, 0);
+    NodeAndVoxelColoring::colorScalarsWithPalette(statistics,
+                                                  prefetch->m_paletteColorMappings[iMap],
+                                                  prefetch->m_palettes[iMap],
+                                                  data,
+                                                  data,
+                                                  prefetch->m_mapSize,
+                                                  &rgba[0]);
+}
+
 
     
 /**
@@ -94,6 +353,10 @@ CiftiMappableDataFile::CiftiMappableDataFile(const DataFileTypeEnum::Enum dataFi
     m_fileHistogram.grabNew(NULL);
     m_fileHistorgramLimitedValues.grabNew(NULL);
     
+    m_mapPrefetch.grabNew(NULL);
+    m_mapPrefetchThread.grabNew(NULL);
+    m_lastColoredMapIndex = -1;
+    
     /*
      * Note: The first palette normalization mode is assumed to
      * be the default mode.
@@ -147,6 +410,18 @@ CiftiMappableDataFile::CiftiMappableDataFile(const DataFileTypeEnum::Enum dataFi
             m_paletteNormalizationModesSupported.push_back(PaletteNormalizationModeEnum::NORMALIZATION_ALL_MAP_DATA);
             m_fileMapDataType              = FILE_MAP_DATA_TYPE_MULTI_MAP;
             break;
+        case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+            /*
+             * Sparse rows have no known range, so only the loaded row is
+             * used for palette normalization.
+             */
+            m_dataReadingAccessMethod      = DATA_ACCESS_FILE_ROWS_OR_XML_ALONG_COLUMN;
+            m_dataMappingAccessMethod      = DATA_ACCESS_FILE_COLUMNS_OR_XML_ALONG_ROW;
+            m_colorMappingMethod           = COLOR_MAPPING_METHOD_PALETTE;
+            m_paletteColorMappingSource    = PALETTE_COLOR_MAPPING_SOURCE_FROM_FILE;
+            m_paletteNormalizationModesSupported.push_back(PaletteNormalizationModeEnum::NORMALIZATION_SELECTED_MAP_DATA);
+            m_fileMapDataType              = FILE_MAP_DATA_TYPE_MATRIX;
+            break;
         case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
             m_dataReadingAccessMethod      = DATA_ACCESS_FILE_COLUMNS_OR_XML_ALONG_ROW;
             m_dataMappingAccessMethod      = DATA_ACCESS_FILE_ROWS_OR_XML_ALONG_COLUMN;
@@ -425,6 +700,11 @@ CiftiMappableDataFile::clearPrivate()
      * m_fileMapDataType
      */
     
+    /*
+     * The prefetch thread may be reading the CIFTI file
+     */
+    stopMapPrefetch();
+    
     m_ciftiFile.grabNew(NULL);
     
     resetDataLoadingMembers();
@@ -451,6 +731,10 @@ CiftiMappableDataFile::resetDataLoadingMembers()
     m_mapContent.clear();
     m_classNameHierarchy->clear();
     m_forceUpdateOfGroupAndNameHierarchy = true;
+    
+    stopMapPrefetch();
+    m_lastColoredMapIndex = -1;
+    m_retainedColoringMapIndices.clear();
 }
 
 /**
@@ -716,6 +1000,10 @@ CiftiMappableDataFile::validateMappingTypes(const AString& filename)
             expectedAlongColumnMapType = CiftiMappingType::BRAIN_MODELS;
             expectedAlongRowMapType = CiftiMappingType::SCALARS;
             break;
+        case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+            expectedAlongColumnMapType = CiftiMappingType::BRAIN_MODELS;
+            expectedAlongRowMapType = CiftiMappingType::BRAIN_MODELS;
+            break;
         case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
             expectedAlongColumnMapType = CiftiMappingType::BRAIN_MODELS;
             expectedAlongRowMapType = CiftiMappingType::SERIES;
@@ -1284,6 +1572,14 @@ CiftiMappableDataFile::getMapData(const int32_t mapIndex,
             break;
         case DATA_ACCESS_FILE_COLUMNS_OR_XML_ALONG_ROW:
             CaretAssert(mapIndex < m_ciftiFile->getNumberOfColumns());
+            if (m_mapPrefetch != NULL) {
+                const float* prefetchedData = m_mapPrefetch->getMapData(mapIndex);
+                if (prefetchedData != NULL) {
+                    dataOut.assign(prefetchedData,
+                                   prefetchedData + m_mapPrefetch->m_mapSize);
+                    break;
+                }
+            }
             dataOut.resize(m_ciftiFile->getNumberOfRows());
             m_ciftiFile->getColumn(&dataOut[0],
                                    mapIndex);
@@ -1315,6 +1611,11 @@ CiftiMappableDataFile::setMapData(const int32_t mapIndex,
     CaretAssert(m_ciftiFile);
     CaretAssert(mapIndex >= 0);
     
+    /*
+     * Maps read ahead may contain the old data
+     */
+    stopMapPrefetch();
+    
     switch (m_dataReadingAccessMethod) {
         case DATA_ACCESS_METHOD_INVALID:
             CaretAssert(0);
@@ -1987,6 +2288,23 @@ CiftiMappableDataFile::updateScalarColoringForMap(const int32_t mapIndex,
     CaretAssertVectorIndex(m_mapContent,
                            mapIndex);
     
+    /*
+     * When maps are stepped through in order (such as playing
+     * a time series as a movie), the next maps are read and
+     * colored by a background thread.
+     */
+    if (mapIndex == (m_lastColoredMapIndex + 1)) {
+        updateMapPrefetch(mapIndex,
+                          paletteFile);
+    }
+    m_lastColoredMapIndex = mapIndex;
+    
+    if (applyPrefetchedColoring(mapIndex,
+                                paletteFile)) {
+        retainMapColoring(mapIndex);
+        return;
+    }
+    
     std::vector<float> data;
     getMapData(mapIndex,
                data);
@@ -2000,7 +2318,12 @@ CiftiMappableDataFile::updateScalarColoringForMap(const int32_t mapIndex,
                 statistics = const_cast<FastStatistics*>(getFileFastStatistics());
                 break;
             case PaletteNormalizationModeEnum::NORMALIZATION_SELECTED_MAP_DATA:
-                statistics = const_cast<FastStatistics*>(getMapFastStatistics(mapIndex));
+                /*
+                 * Use the data already read instead of getMapFastStatistics()
+                 * which reads the map's data again.
+                 */
+                m_mapContent[mapIndex]->updateFastStatistics(data);
+                statistics = m_mapContent[mapIndex]->m_fastStatistics;
                 break;
         }
         
@@ -2016,6 +2339,310 @@ CiftiMappableDataFile::updateScalarColoringForMap(const int32_t mapIndex,
     else {
         CaretAssert(0);
     }
+    
+    retainMapColoring(mapIndex);
+}
+
+/**
+ * @return True if maps of this file may be read and colored by
+ * the prefetch thread.  Only files whose maps are columns of the
+ * CIFTI matrix (such as dense scalar and dense time series files)
+ * are prefetched.  When the file is in memory, only coloring is
+ * performed by the thread so files mapped with a label table are
+ * not prefetched.  Files read over the network cannot be opened
+ * again by the thread.
+ */
+bool
+CiftiMappableDataFile::isMapPrefetchSupported() const
+{
+    if ((m_dataReadingAccessMethod != DATA_ACCESS_FILE_COLUMNS_OR_XML_ALONG_ROW)
+        || (m_fileMapDataType != FILE_MAP_DATA_TYPE_MULTI_MAP)
+        || (m_ciftiFile == NULL)) {
+        return false;
+    }
+    
+    if (m_ciftiFile->isInMemory()) {
+        return isMappedWithPalette();
+    }
+    
+    return ( ! isFileOnNetwork(getFileName()));
+}
+
+/**
+ * Called when the given map is colored immediately after the preceding
+ * map.  If the map is not in the maps prepared by the prefetch thread,
+ * the maps from the thread are taken, waiting for the thread if it has
+ * not finished.  The thread is then started on the maps that follow.
+ *
+ * @param mapIndex
+ *    Index of map that is being colored.
+ * @param paletteFile
+ *    Palette file containing palettes.
+ */
+void
+CiftiMappableDataFile::updateMapPrefetch(const int32_t mapIndex,
+                                         const PaletteFile* paletteFile)
+{
+    if ( ! isMapPrefetchSupported()) {
+        return;
+    }
+    
+    if (m_mapPrefetchThread == NULL) {
+        const CiftiFile* inMemoryCiftiFile = (m_ciftiFile->isInMemory()
+                                              ? m_ciftiFile
+                                              : NULL);
+        m_mapPrefetchThread.grabNew(new MapPrefetchThread(inMemoryCiftiFile,
+                                                          getFileName()));
+    }
+    
+    if ((m_mapPrefetch == NULL)
+        || ( ! m_mapPrefetch->containsMap(mapIndex))) {
+        m_mapPrefetch.grabNew(NULL);
+        if (m_mapPrefetchThread->isPrefetchPending()) {
+            CaretPointer<MapPrefetch> prefetch = m_mapPrefetchThread->finishPrefetch();
+            if ( ! prefetch->m_errorMessage.isEmpty()) {
+                CaretLogWarning("Reading maps ahead from "
+                                + getFileNameNoPath()
+                                + " failed: "
+                                + prefetch->m_errorMessage);
+            }
+            else if (prefetch->containsMap(mapIndex)) {
+                m_mapPrefetch = prefetch;
+            }
+        }
+    }
+    
+    if ( ! m_mapPrefetchThread->isPrefetchPending()) {
+        const int32_t nextMapIndex = ((m_mapPrefetch != NULL)
+                                      ? (m_mapPrefetch->m_firstMapIndex + m_mapPrefetch->m_mapCount)
+                                      : (mapIndex + 1));
+        MapPrefetch* prefetch = createMapPrefetch(nextMapIndex,
+                                                  paletteFile);
+        if (prefetch != NULL) {
+            m_mapPrefetchThread->startPrefetch(prefetch);
+        }
+    }
+}
+
+/**
+ * Create a prefetch for consecutive maps containing copies of
+ * the palette settings used to color the maps.
+ *
+ * @param firstMapIndex
+ *    Index of first map in the prefetch.
+ * @param paletteFile
+ *    Palette file containing palettes.
+ * @return
+ *    The prefetch or NULL if there is no data at or after firstMapIndex.
+ */
+CiftiMappableDataFile::MapPrefetch*
+CiftiMappableDataFile::createMapPrefetch(const int32_t firstMapIndex,
+                                         const PaletteFile* paletteFile)
+{
+    const int32_t numberOfMaps = getNumberOfMaps();
+    if ((firstMapIndex >= numberOfMaps)
+        || (m_ciftiFile->getNumberOfRows() <= 0)) {
+        return NULL;
+    }
+    const int32_t mapCount = std::min(S_MAP_PREFETCH_COUNT,
+                                      numberOfMaps - firstMapIndex);
+    
+    MapPrefetch* prefetch = new MapPrefetch(firstMapIndex,
+                                            mapCount,
+                                            m_ciftiFile->getNumberOfRows());
+    prefetch->m_rgba.resize(mapCount);
+    
+    if (isMappedWithPalette()) {
+        prefetch->m_paletteNormalizationMode = getPaletteNormalizationMode();
+        if (prefetch->m_paletteNormalizationMode == PaletteNormalizationModeEnum::NORMALIZATION_ALL_MAP_DATA) {
+            const FastStatistics* fileStatistics = getFileFastStatistics();
+            if (fileStatistics != NULL) {
+                prefetch->m_fileFastStatistics.grabNew(new FastStatistics(*fileStatistics));
+            }
+        }
+        
+        prefetch->m_paletteColorMappings.resize(mapCount);
+        prefetch->m_palettes.resize(mapCount);
+        prefetch->m_mapFastStatistics.resize(mapCount);
+        
+        /*
+         * Maps of files with one palette color mapping for
+         * the file share a copy of the mapping and palette.
+         */
+        const PaletteColorMapping* previousPaletteColorMapping = NULL;
+        for (int32_t iMap = 0; iMap < mapCount; iMap++) {
+            CaretAssertVectorIndex(m_mapContent, firstMapIndex + iMap);
+            const PaletteColorMapping* pcm = m_mapContent[firstMapIndex + iMap]->m_paletteColorMapping;
+            CaretAssert(pcm);
+            if ((iMap > 0)
+                && (pcm == previousPaletteColorMapping)) {
+                prefetch->m_paletteColorMappings[iMap] = prefetch->m_paletteColorMappings[iMap - 1];
+                prefetch->m_palettes[iMap] = prefetch->m_palettes[iMap - 1];
+            }
+            else {
+                const Palette* palette = findPalette(pcm->getSelectedPaletteName(),
+                                                     paletteFile);
+                if (palette != NULL) {
+                    prefetch->m_paletteColorMappings[iMap].grabNew(new PaletteColorMapping(*pcm));
+                    prefetch->m_palettes[iMap].grabNew(new Palette(*palette));
+                }
+            }
+            previousPaletteColorMapping = pcm;
+        }
+    }
+    
+    return prefetch;
+}
+
+/**
+ * Use the coloring made by the prefetch thread for a map but only
+ * if the palette settings have not changed since the thread started.
+ *
+ * @param mapIndex
+ *    Index of map.
+ * @param paletteFile
+ *    Palette file containing palettes.
+ * @return
+ *    True if the map's coloring was set from the prefetch.
+ */
+bool
+CiftiMappableDataFile::applyPrefetchedColoring(const int32_t mapIndex,
+                                               const PaletteFile* paletteFile)
+{
+    if ((m_mapPrefetch == NULL)
+        || ( ! m_mapPrefetch->containsMap(mapIndex))
+        || ( ! isMappedWithPalette())) {
+        return false;
+    }
+    
+    const int32_t iMap = mapIndex - m_mapPrefetch->m_firstMapIndex;
+    CaretAssertVectorIndex(m_mapPrefetch->m_rgba, iMap);
+    std::vector<uint8_t>& rgba = m_mapPrefetch->m_rgba[iMap];
+    if (rgba.empty()) {
+        return false;
+    }
+    
+    MapContent* mc = m_mapContent[mapIndex];
+    const PaletteColorMapping* pcm = m_mapPrefetch->m_paletteColorMappings[iMap];
+    if ((getPaletteNormalizationMode() != m_mapPrefetch->m_paletteNormalizationMode)
+        || ( ! (*mc->m_paletteColorMapping == *pcm))) {
+        return false;
+    }
+    const Palette* palette = findPalette(mc->m_paletteColorMapping->getSelectedPaletteName(),
+                                         paletteFile);
+    if ((palette == NULL)
+        || (palette->toString() != m_mapPrefetch->m_palettes[iMap]->toString())) {
+        return false;
+    }
+    
+    mc->m_rgba.swap(rgba);
+    std::vector<uint8_t>().swap(rgba);
+    mc->m_dataCount = m_mapPrefetch->m_mapSize;
+    if ((mc->m_fastStatistics == NULL)
+        && (m_mapPrefetch->m_mapFastStatistics[iMap] != NULL)) {
+        mc->m_fastStatistics = m_mapPrefetch->m_mapFastStatistics[iMap];
+    }
+    mc->m_rgbaValid = true;
+    
+    return true;
+}
+
+/**
+ * Wait for the prefetch thread to finish and release
+ * all maps read ahead by the thread.
+ */
+void
+CiftiMappableDataFile::stopMapPrefetch()
+{
+    m_mapPrefetchThread.grabNew(NULL);
+    m_mapPrefetch.grabNew(NULL);
+}
+
+/**
+ * Note that the coloring of a map was just updated.  So that stepping
+ * through the maps of a file with many maps does not keep the coloring
+ * of every map in memory, the coloring of the least recently colored
+ * map is released once too many maps are colored.
+ *
+ * @param mapIndex
+ *    Index of map that was colored.
+ */
+void
+CiftiMappableDataFile::retainMapColoring(const int32_t mapIndex)
+{
+    if (static_cast<int32_t>(m_mapContent.size()) <= S_MAXIMUM_RETAINED_MAP_COLORINGS) {
+        return;
+    }
+    
+    std::deque<int32_t>::iterator iter = std::find(m_retainedColoringMapIndices.begin(),
+                                                   m_retainedColoringMapIndices.end(),
+                                                   mapIndex);
+    if (iter != m_retainedColoringMapIndices.end()) {
+        m_retainedColoringMapIndices.erase(iter);
+    }
+    m_retainedColoringMapIndices.push_back(mapIndex);
+    
+    while (static_cast<int32_t>(m_retainedColoringMapIndices.size()) > S_MAXIMUM_RETAINED_MAP_COLORINGS) {
+        const int32_t releaseMapIndex = m_retainedColoringMapIndices.front();
+        m_retainedColoringMapIndices.pop_front();
+        
+        CaretAssertVectorIndex(m_mapContent, releaseMapIndex);
+        MapContent* mc = m_mapContent[releaseMapIndex];
+        mc->m_rgbaValid = false;
+        std::vector<uint8_t>().swap(mc->m_rgba);
+    }
+}
+
+/**
+ * Find a palette by name.
+ *
+ * @param paletteName
+ *    Name of palette.
+ * @param paletteFile
+ *    File containing the palettes.  If NULL or the palette is not
+ *    in the file, the find palette event is used to find the palette.
+ * @return
+ *    The palette or NULL if not found.
+ */
+Palette*
+CiftiMappableDataFile::findPalette(const AString& paletteName,
+                                   const PaletteFile* paletteFile)
+{
+    /*
+     * First, look for palette in palette file but only
+     * if the palette file is valid
+     */
+    Palette* paletteFromFile = NULL;
+    if (paletteFile != NULL) {
+        paletteFromFile = paletteFile->getPaletteByName(paletteName);
+        if (paletteFromFile == NULL) {
+            CaretLogSevere("No palette named "
+                           + paletteName
+                           + " found in "
+                           + paletteFile->getFileNameNoPath()
+                           + ".");
+        }
+    }
+    
+    /*
+     * If palette was not found in palette file,
+     * find palette using event.
+     */
+    Palette* paletteFromEvent = NULL;
+    if (paletteFromFile == NULL) {
+        EventPaletteGetByName eventPaletteGetName(paletteName);
+        EventManager::get()->sendEvent(eventPaletteGetName.getPointer());
+        paletteFromEvent = eventPaletteGetName.getPalette();
+        if (paletteFromEvent == NULL) {
+            CaretLogSevere("No palette named "
+                           + paletteName
+                           + " found using EventPaletteGetByName.");
+        }
+    }
+    
+    return ((paletteFromFile != NULL)
+            ? paletteFromFile
+            : paletteFromEvent);
 }
 
 /**
@@ -4146,6 +4773,9 @@ CiftiMappableDataFile::getSurfaceNodeIdentificationForMaps(const std::vector<int
         case DataFileTypeEnum::CONNECTIVITY_DENSE_SCALAR:
             useSeriesData = true;
            break;
+        case DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE:
+            useMapData = true;
+            break;
         case DataFileTypeEnum::CONNECTIVITY_DENSE_TIME_SERIES:
             useSeriesData = true;
             break;
@@ -6842,43 +7472,8 @@ CiftiMappableDataFile::MapContent::updateColoring(const std::vector<float>& data
     }
     else {
         CaretAssert(m_paletteColorMapping);
-        const AString paletteName = m_paletteColorMapping->getSelectedPaletteName();
-
-        /*
-         * First, look for palette in palette file but only
-         * if the palette file is valid
-         */
-        Palette* paletteFromFile = NULL;
-        if (paletteFile != NULL) {
-            paletteFromFile = paletteFile->getPaletteByName(paletteName);
-            if (paletteFromFile == NULL) {
-                CaretLogSevere("No palette named "
-                               + paletteName
-                               + " found in "
-                               + paletteFile->getFileNameNoPath()
-                               + ".");
-            }
-        }
-
-        /*
-         * If palette was not found in palette file, 
-         * find palette using event.
-         */
-        Palette* paletteFromEvent = NULL;
-        if (paletteFromFile == NULL) {
-            EventPaletteGetByName eventPaletteGetName(paletteName);
-            EventManager::get()->sendEvent(eventPaletteGetName.getPointer());
-            paletteFromEvent = eventPaletteGetName.getPalette();
-            if (paletteFromEvent == NULL) {
-                CaretLogSevere("No palette named "
-                               + paletteName
-                               + " found using EventPaletteGetByName.");
-            }
-        }
-        
-        Palette* palette = ((paletteFromFile != NULL)
-                                  ? paletteFromFile
-                                  : paletteFromEvent);
+        Palette* palette = CiftiMappableDataFile::findPalette(m_paletteColorMapping->getSelectedPaletteName(),
+                                                              paletteFile);
         if ((palette != NULL)
             && (fastStatistics != NULL)) {
             NodeAndVoxelColoring::colorScalarsWithPalette(fastStatistics,
@@ -29,6 +29,7 @@
 #include "DisplayGroupEnum.h"
 #include "VolumeMappableInterface.h"
 
+#include <deque>
 #include <set>
 
 namespace caret {
@@ -41,6 +42,7 @@ namespace caret {
     class FastStatistics;
     class GroupAndNameHierarchyModel;
     class Histogram;
+    class Palette;
     class SparseVolumeIndexer;
 
     
@@ -625,8 +627,30 @@ namespace caret {
             CaretPointer<GiftiMetaData> m_metadataForMapsWithNoMetaData;
         };
         
+        class MapPrefetch;
+        
+        class MapPrefetchThread;
+        
         void clearPrivate();
         
+        bool isMapPrefetchSupported() const;
+        
+        void updateMapPrefetch(const int32_t mapIndex,
+                               const PaletteFile* paletteFile);
+        
+        MapPrefetch* createMapPrefetch(const int32_t firstMapIndex,
+                                       const PaletteFile* paletteFile);
+        
+        bool applyPrefetchedColoring(const int32_t mapIndex,
+                                     const PaletteFile* paletteFile);
+        
+        void stopMapPrefetch();
+        
+        void retainMapColoring(const int32_t mapIndex);
+        
+        static Palette* findPalette(const AString& paletteName,
+                                    const PaletteFile* paletteFile);
+        
     protected:
         void initializeAfterReading(const AString& filename);
         
@@ -736,6 +760,22 @@ namespace caret {
         
         /** force an update of the class and name hierarchy */
         mutable bool m_forceUpdateOfGroupAndNameHierarchy;
+        
+        /** Data and coloring for consecutive maps read ahead while maps are stepped through in order */
+        CaretPointer<MapPrefetch> m_mapPrefetch;
+        
+        /** Reads and colors the maps following those in m_mapPrefetch */
+        CaretPointer<MapPrefetchThread> m_mapPrefetchThread;
+        
+        /** Index of map most recently colored by updateScalarColoringForMap() */
+        int32_t m_lastColoredMapIndex;
+        
+        /** Maps whose coloring is retained, least recently colored first */
+        std::deque<int32_t> m_retainedColoringMapIndices;
+        
+        static const int32_t S_MAP_PREFETCH_COUNT;
+        
+        static const int32_t S_MAXIMUM_RETAINED_MAP_COLORINGS;
 
         
         static const int32_t S_CIFTI_XML_ALONG_INVALID;
@@ -748,6 +788,8 @@ namespace caret {
     
 #ifdef __CIFTI_MAPPABLE_DATA_FILE_DECLARE__
     const int32_t CiftiMappableDataFile::S_CIFTI_XML_ALONG_INVALID = -1;
+    const int32_t CiftiMappableDataFile::S_MAP_PREFETCH_COUNT = 32;
+    const int32_t CiftiMappableDataFile::S_MAXIMUM_RETAINED_MAP_COLORINGS = 64;
 #endif // __CIFTI_MAPPABLE_DATA_FILE_DECLARE__
     
 } // namespace
@@ -0,0 +1,69 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "CiftiRowBlock.h"
+
+#include "CaretAssert.h"
+#include "CiftiFile.h"
+#include "DataFileException.h"
+
+#include <algorithm>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+int64_t CiftiRowBlock::getRowsPerBlock(const CiftiFile* ciftiIn, const int64_t& memoryLimitBytes)
+{
+    CaretAssert(ciftiIn != NULL);
+    const int64_t rowLength = max(ciftiIn->getNumberOfColumns(), (int64_t)1);
+    return max(memoryLimitBytes / (rowLength * (int64_t)sizeof(float)), (int64_t)1);
+}
+
+void CiftiRowBlock::readBlock(const CiftiFile* ciftiIn, const int64_t& firstRow, const int64_t& numRows, CiftiFile* blockOut)
+{
+    CaretAssert(ciftiIn != NULL && blockOut != NULL);
+    const CiftiXML& inXML = ciftiIn->getCiftiXML();
+    if (inXML.getNumberOfDimensions() != 2) throw DataFileException("row blocks are only supported on 2D cifti");
+    if (firstRow < 0 || numRows < 1 || firstRow + numRows > ciftiIn->getNumberOfRows()) throw DataFileException("row block is outside of the cifti file");
+    CiftiXML blockXML = inXML;
+    blockXML.setMap(CiftiXML::ALONG_COLUMN, CiftiScalarsMap(numRows));
+    blockOut->setCiftiXML(blockXML, false);
+    vector<float> rowScratch(ciftiIn->getNumberOfColumns());
+    for (int64_t i = 0; i < numRows; ++i)
+    {
+        ciftiIn->getRow(rowScratch.data(), firstRow + i);
+        blockOut->setRow(rowScratch.data(), i);
+    }
+}
+
+void CiftiRowBlock::writeBlock(const CiftiFile* blockIn, const int64_t& firstRow, CiftiFile* ciftiOut)
+{
+    CaretAssert(blockIn != NULL && ciftiOut != NULL);
+    const int64_t numRows = blockIn->getNumberOfRows();
+    if (blockIn->getNumberOfColumns() != ciftiOut->getNumberOfColumns()) throw DataFileException("row block has a different row length than the output cifti file");
+    if (firstRow < 0 || firstRow + numRows > ciftiOut->getNumberOfRows()) throw DataFileException("row block is outside of the output cifti file");
+    vector<float> rowScratch(blockIn->getNumberOfColumns());
+    for (int64_t i = 0; i < numRows; ++i)
+    {
+        blockIn->getRow(rowScratch.data(), i);
+        ciftiOut->setRow(rowScratch.data(), firstRow + i);
+    }
+}
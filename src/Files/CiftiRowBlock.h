@@ -0,0 +1,49 @@
+#ifndef __CIFTI_ROW_BLOCK_H__
+#define __CIFTI_ROW_BLOCK_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include <stdint.h>
+
+namespace caret {
+    
+    class CiftiFile;
+    
+    ///copies a block of rows of a 2D cifti file into a small in-memory cifti file, and back out again
+    ///commands that process each row independently along ROW (smoothing, dilation, etc) can run on one block at a time,
+    ///so that the input is read once and the output written once, rather than once per structure
+    class CiftiRowBlock
+    {
+        CiftiRowBlock();
+    public:
+        ///number of rows in a block that stays within the memory limit, at least 1
+        static int64_t getRowsPerBlock(const CiftiFile* ciftiIn, const int64_t& memoryLimitBytes = 128 * 1024 * 1024);
+        
+        ///make blockOut hold rows [firstRow, firstRow + numRows) of ciftiIn, the column dimension of blockOut is scalars
+        static void readBlock(const CiftiFile* ciftiIn, const int64_t& firstRow, const int64_t& numRows, CiftiFile* blockOut);
+        
+        ///write every row of blockIn to ciftiOut, starting at firstRow
+        static void writeBlock(const CiftiFile* blockIn, const int64_t& firstRow, CiftiFile* ciftiOut);
+    };
+    
+}
+
+#endif //__CIFTI_ROW_BLOCK_H__
@@ -0,0 +1,42 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "CiftiRowSource.h"
+
+#include "CaretAssert.h"
+#include "CiftiFile.h"
+
+using namespace caret;
+
+CiftiRowSource::CiftiRowSource(const CiftiFile* file)
+{
+    CaretAssert(file != NULL);
+    m_file = file;
+    m_numRows = file->getCiftiXML().getDimensionLength(CiftiXML::ALONG_COLUMN);
+    m_numCols = file->getCiftiXML().getDimensionLength(CiftiXML::ALONG_ROW);
+}
+
+void CiftiRowSource::getRows(float* dataOut, const int64_t& firstRow, const int64_t& numRows)
+{
+    for (int64_t i = 0; i < numRows; ++i)
+    {
+        m_file->getRow(dataOut + i * m_numCols, firstRow + i);
+    }
+}
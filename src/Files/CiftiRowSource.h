@@ -0,0 +1,44 @@
+#ifndef __CIFTI_ROW_SOURCE_H__
+#define __CIFTI_ROW_SOURCE_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "StreamingReduction.h"
+
+namespace caret {
+    
+    class CiftiFile;
+    
+    ///rows of a 2D cifti file for StreamingReduction, read in file order so that on-disk files are read sequentially
+    class CiftiRowSource : public StreamingReduction::RowSource
+    {
+        const CiftiFile* m_file;
+        int64_t m_numRows, m_numCols;
+    public:
+        CiftiRowSource(const CiftiFile* file);
+        int64_t getNumberOfRows() const { return m_numRows; }
+        int64_t getNumberOfColumns() const { return m_numCols; }
+        void getRows(float* dataOut, const int64_t& firstRow, const int64_t& numRows);
+    };
+    
+}
+
+#endif //__CIFTI_ROW_SOURCE_H__
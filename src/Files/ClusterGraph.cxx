@@ -0,0 +1,594 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "ClusterGraph.h"
+
+#include "CaretAssert.h"
+#include "CaretException.h"
+#include "CaretOMP.h"
+#include "CiftiBrainModelsMap.h"
+#include "SurfaceFile.h"
+#include "TopologyHelper.h"
+#include "VolumeSpace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+using namespace caret;
+using namespace std;
+
+namespace
+{
+    //find with path halving, only touches the path it walks
+    inline int64_t findRoot(int64_t* parent, int64_t elem)
+    {
+        while (parent[elem] != elem)
+        {
+            parent[elem] = parent[parent[elem]];
+            elem = parent[elem];
+        }
+        return elem;
+    }
+
+    //read-only find, for concurrent use after all unions are done
+    inline int64_t findRootConst(const int64_t* parent, int64_t elem)
+    {
+        while (parent[elem] != elem)
+        {
+            elem = parent[elem];
+        }
+        return elem;
+    }
+
+    //always link the higher root under the lower, so the root is the lowest index in the component, and chunks never write outside their own range
+    inline void unite(int64_t* parent, const int64_t& a, const int64_t& b)
+    {
+        int64_t rootA = findRoot(parent, a), rootB = findRoot(parent, b);
+        if (rootA == rootB) return;
+        if (rootA < rootB)
+        {
+            parent[rootB] = rootA;
+        } else {
+            parent[rootA] = rootB;
+        }
+    }
+
+    struct SortDescending
+    {
+        const float* m_values;
+        SortDescending(const float* values) : m_values(values) { }
+        bool operator()(const int64_t& left, const int64_t& right) const
+        {
+            if (m_values[left] != m_values[right]) return m_values[left] > m_values[right];
+            return left < right;//make the order deterministic
+        }
+    };
+
+    inline void updateCluster(ClusterGraph::TFCEScratch& scratch, const int64_t& root, const float& bottomVal, const float& param_e, const float& param_h)
+    {
+        float& lastVal = scratch.m_clusterLast[root];
+        if (bottomVal != lastVal)//skip computing if there is no difference
+        {
+            CaretAssert(bottomVal < lastVal);
+            double integrated_h = param_h + 1.0f;//integral(x^h) = (x^(h + 1))/(h + 1) + C
+            double newSlice = pow(scratch.m_clusterSize[root], (double)param_e) * (pow((double)lastVal, integrated_h) - pow((double)bottomVal, integrated_h)) / integrated_h;
+            scratch.m_clusterAccum[root] += newSlice;
+            lastVal = bottomVal;
+        }
+    }
+
+    //find that also accumulates the per-link accum offsets, so compressing the path doesn't change the sum from an element to its root
+    inline int64_t findRootOffset(ClusterGraph::TFCEScratch& scratch, int64_t elem)
+    {
+        int64_t* parent = scratch.m_parent.data();
+        double* offset = scratch.m_offset.data();
+        while (parent[elem] != elem)
+        {
+            int64_t next = parent[elem];
+            if (parent[next] != next)
+            {
+                offset[elem] += offset[next];
+                parent[elem] = parent[next];
+            }
+            elem = parent[elem];
+        }
+        return elem;
+    }
+}
+
+ClusterGraph::ClusterGraph(const SurfaceFile* mySurf, const float* nodeAreas)
+{
+    CaretAssert(mySurf != NULL);
+    int32_t numNodes = mySurf->getNumberOfNodes();
+    if (nodeAreas == NULL)
+    {
+        mySurf->computeNodeAreas(m_elementSizes);
+    } else {
+        m_elementSizes.assign(nodeAreas, nodeAreas + numNodes);
+    }
+    CaretPointer<TopologyHelper> myTopoHelp = mySurf->getTopologyHelper();
+    m_offsets.resize(numNodes + 1);
+    m_offsets[0] = 0;
+    for (int32_t i = 0; i < numNodes; ++i)
+    {
+        m_offsets[i + 1] = m_offsets[i] + (int64_t)myTopoHelp->getNodeNeighbors(i).size();
+    }
+    m_neighbors.resize(m_offsets[numNodes]);
+    for (int32_t i = 0; i < numNodes; ++i)
+    {
+        const vector<int32_t>& neighbors = myTopoHelp->getNodeNeighbors(i);
+        copy(neighbors.begin(), neighbors.end(), m_neighbors.begin() + m_offsets[i]);
+    }
+}
+
+ClusterGraph::ClusterGraph(const VolumeSpace& mySpace, const VolumeNeighbors& neighbors)
+{
+    const int64_t* dims = mySpace.getDims();
+    int64_t frameSize = dims[0] * dims[1] * dims[2];
+    if (frameSize > numeric_limits<int32_t>::max()) throw CaretException("volume is too large for cluster graph");
+    m_elementSizes.assign(frameSize, mySpace.getVoxelVolume());
+    vector<int> stencil;
+    getVolumeStencil(neighbors, stencil);
+    int stencilSize = (int)stencil.size();
+    m_offsets.resize(frameSize + 1);
+    m_offsets[0] = 0;
+    for (int64_t k = 0; k < dims[2]; ++k)//count first, so we never need per-voxel vectors
+    {
+        for (int64_t j = 0; j < dims[1]; ++j)
+        {
+            for (int64_t i = 0; i < dims[0]; ++i)
+            {
+                int64_t count = 0;
+                for (int s = 0; s < stencilSize; s += 3)
+                {
+                    if (mySpace.indexValid(i + stencil[s], j + stencil[s + 1], k + stencil[s + 2])) ++count;
+                }
+                int64_t index = mySpace.getIndex(i, j, k);
+                m_offsets[index + 1] = count;
+            }
+        }
+    }
+    for (int64_t index = 0; index < frameSize; ++index)
+    {
+        m_offsets[index + 1] += m_offsets[index];
+    }
+    m_neighbors.resize(m_offsets[frameSize]);
+#pragma omp CARET_PARFOR schedule(dynamic)
+    for (int64_t k = 0; k < dims[2]; ++k)
+    {
+        for (int64_t j = 0; j < dims[1]; ++j)
+        {
+            for (int64_t i = 0; i < dims[0]; ++i)
+            {
+                int64_t index = mySpace.getIndex(i, j, k);
+                int64_t pos = m_offsets[index];
+                for (int s = 0; s < stencilSize; s += 3)
+                {
+                    int64_t neighIJK[3] = { i + stencil[s], j + stencil[s + 1], k + stencil[s + 2] };
+                    if (mySpace.indexValid(neighIJK))
+                    {
+                        m_neighbors[pos] = (int32_t)mySpace.getIndex(neighIJK);
+                        ++pos;
+                    }
+                }
+                CaretAssert(pos == m_offsets[index + 1]);
+            }
+        }
+    }
+}
+
+ClusterGraph::ClusterGraph(const CiftiBrainModelsMap& myMap, const vector<const SurfaceFile*>& surfaces, const vector<const float*>& surfAreas,
+                           const VolumeNeighbors& neighbors, const bool& mergedVolume)
+{
+    int64_t numElements = myMap.getLength();
+    if (numElements > numeric_limits<int32_t>::max()) throw CaretException("cifti mapping is too large for cluster graph");
+    m_elementSizes.resize(numElements, 0.0f);
+    vector<vector<int64_t> > lists(numElements);
+    vector<StructureEnum::Enum> surfList = myMap.getSurfaceStructureList();
+    if (surfaces.size() != surfList.size()) throw CaretException("cluster graph needs one surface per cifti surface structure");
+    for (int whichStruct = 0; whichStruct < (int)surfList.size(); ++whichStruct)
+    {
+        const SurfaceFile* mySurf = surfaces[whichStruct];
+        CaretAssert(mySurf != NULL);
+        if (mySurf->getNumberOfNodes() != myMap.getSurfaceNumberOfNodes(surfList[whichStruct]))
+        {
+            throw CaretException("surface for structure " + StructureEnum::toName(surfList[whichStruct]) + " has the wrong number of vertices");
+        }
+        vector<float> areaScratch;
+        const float* areas = NULL;
+        if (whichStruct < (int)surfAreas.size()) areas = surfAreas[whichStruct];
+        if (areas == NULL)
+        {
+            mySurf->computeNodeAreas(areaScratch);
+            areas = areaScratch.data();
+        }
+        CaretPointer<TopologyHelper> myTopoHelp = mySurf->getTopologyHelper();
+        vector<CiftiBrainModelsMap::SurfaceMap> surfMap = myMap.getSurfaceMap(surfList[whichStruct]);
+        vector<int64_t> nodeToCifti(mySurf->getNumberOfNodes(), -1);
+        for (int64_t i = 0; i < (int64_t)surfMap.size(); ++i)
+        {
+            nodeToCifti[surfMap[i].m_surfaceNode] = surfMap[i].m_ciftiIndex;
+        }
+        for (int64_t i = 0; i < (int64_t)surfMap.size(); ++i)
+        {
+            int64_t ciftiIndex = surfMap[i].m_ciftiIndex;
+            m_elementSizes[ciftiIndex] = areas[surfMap[i].m_surfaceNode];
+            const vector<int32_t>& nodeNeighbors = myTopoHelp->getNodeNeighbors(surfMap[i].m_surfaceNode);
+            for (int n = 0; n < (int)nodeNeighbors.size(); ++n)
+            {
+                int64_t neighCifti = nodeToCifti[nodeNeighbors[n]];
+                if (neighCifti != -1) lists[ciftiIndex].push_back(neighCifti);
+            }
+        }
+    }
+    if (myMap.hasVolumeData())
+    {
+        const VolumeSpace& mySpace = myMap.getVolumeSpace();
+        float voxelVolume = mySpace.getVoxelVolume();
+        vector<int> stencil;
+        getVolumeStencil(neighbors, stencil);
+        vector<StructureEnum::Enum> volList = myMap.getVolumeStructureList();
+        for (int whichStruct = 0; whichStruct < (int)volList.size(); ++whichStruct)
+        {
+            vector<CiftiBrainModelsMap::VolumeMap> volMap = myMap.getVolumeStructureMap(volList[whichStruct]);
+            for (int64_t i = 0; i < (int64_t)volMap.size(); ++i)
+            {
+                int64_t ciftiIndex = volMap[i].m_ciftiIndex;
+                m_elementSizes[ciftiIndex] = voxelVolume;
+                for (int s = 0; s < (int)stencil.size(); s += 3)
+                {
+                    int64_t neighIJK[3] = { volMap[i].m_ijk[0] + stencil[s], volMap[i].m_ijk[1] + stencil[s + 1], volMap[i].m_ijk[2] + stencil[s + 2] };
+                    if (!mySpace.indexValid(neighIJK)) continue;
+                    StructureEnum::Enum neighStruct;
+                    int64_t neighCifti = myMap.getIndexForVoxel(neighIJK, &neighStruct);
+                    if (neighCifti != -1 && (mergedVolume || neighStruct == volList[whichStruct]))
+                    {
+                        lists[ciftiIndex].push_back(neighCifti);
+                    }
+                }
+            }
+        }
+    }
+    buildFromLists(lists);
+}
+
+void ClusterGraph::buildFromLists(const vector<vector<int64_t> >& lists)
+{
+    int64_t numElements = (int64_t)lists.size();
+    m_offsets.resize(numElements + 1);
+    m_offsets[0] = 0;
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        m_offsets[i + 1] = m_offsets[i] + (int64_t)lists[i].size();
+    }
+    m_neighbors.resize(m_offsets[numElements]);
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        for (int64_t n = 0; n < (int64_t)lists[i].size(); ++n)
+        {
+            m_neighbors[m_offsets[i] + n] = (int32_t)lists[i][n];
+        }
+    }
+}
+
+void ClusterGraph::getVolumeStencil(const VolumeNeighbors& neighbors, vector<int>& stencilOut)
+{
+    stencilOut.clear();
+    for (int k = -1; k <= 1; ++k)
+    {
+        for (int j = -1; j <= 1; ++j)
+        {
+            for (int i = -1; i <= 1; ++i)
+            {
+                int manhattan = abs(i) + abs(j) + abs(k);
+                if (manhattan == 0) continue;
+                switch (neighbors)
+                {
+                    case FACE:
+                        if (manhattan > 1) continue;
+                        break;
+                    case EDGE:
+                        if (manhattan > 2) continue;
+                        break;
+                    case CORNER:
+                        break;
+                }
+                stencilOut.push_back(i);
+                stencilOut.push_back(j);
+                stencilOut.push_back(k);
+            }
+        }
+    }
+}
+
+void ClusterGraph::labelComponents(const char* mask, int64_t* labelsOut) const
+{
+    int64_t numElements = getNumberOfElements();
+    vector<int64_t> parent(numElements);
+    int numChunks = 1;
+#ifdef CARET_OMP
+    numChunks = omp_get_max_threads();
+#endif
+    int64_t chunkSize = (numElements + numChunks - 1) / numChunks;
+    vector<vector<pair<int64_t, int64_t> > > crossEdges(numChunks);
+    //first pass: each chunk only unites elements within its own index range, and since roots are always the lowest index, no chunk writes outside its range
+#pragma omp CARET_PARFOR schedule(static, 1)
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        int64_t chunkStart = chunk * chunkSize, chunkEnd = min(numElements, chunkStart + chunkSize);
+        for (int64_t i = chunkStart; i < chunkEnd; ++i)
+        {
+            parent[i] = i;
+        }
+        for (int64_t i = chunkStart; i < chunkEnd; ++i)
+        {
+            if (!mask[i]) continue;
+            const int32_t* neighbors;
+            int64_t numNeigh = getNeighbors(i, neighbors);
+            for (int64_t n = 0; n < numNeigh; ++n)
+            {
+                int64_t neighbor = neighbors[n];
+                if (neighbor >= i || !mask[neighbor]) continue;//every edge is seen from both ends, only use it from the higher end
+                if (neighbor >= chunkStart)
+                {
+                    unite(parent.data(), i, neighbor);
+                } else {
+                    crossEdges[chunk].push_back(make_pair(i, neighbor));
+                }
+            }
+        }
+    }
+    //second pass: stitch the chunks together, this is usually a tiny fraction of the edges
+    for (int chunk = 0; chunk < numChunks; ++chunk)
+    {
+        for (size_t e = 0; e < crossEdges[chunk].size(); ++e)
+        {
+            unite(parent.data(), crossEdges[chunk][e].first, crossEdges[chunk][e].second);
+        }
+    }
+#pragma omp CARET_PARFOR schedule(static)
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        if (mask[i])
+        {
+            labelsOut[i] = findRootConst(parent.data(), i);
+        } else {
+            labelsOut[i] = -1;
+        }
+    }
+}
+
+void ClusterGraph::findClusters(const float* data, const float& threshold, const bool& lessThan, vector<vector<int64_t> >& clustersOut,
+                                vector<double>& sizesOut, const float* roiData) const
+{
+    int64_t numElements = getNumberOfElements();
+    vector<char> mask(numElements);
+#pragma omp CARET_PARFOR schedule(static)
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        if (roiData == NULL || roiData[i] > 0.0f)
+        {
+            if (lessThan)
+            {
+                mask[i] = (data[i] < threshold ? 1 : 0);
+            } else {
+                mask[i] = (data[i] > threshold ? 1 : 0);
+            }
+        } else {
+            mask[i] = 0;
+        }
+    }
+    findClusters(mask.data(), clustersOut, sizesOut);
+}
+
+void ClusterGraph::findClusters(const char* mask, vector<vector<int64_t> >& clustersOut, vector<double>& sizesOut) const
+{
+    int64_t numElements = getNumberOfElements();
+    vector<int64_t> labels(numElements);
+    labelComponents(mask, labels.data());
+    clustersOut.clear();
+    sizesOut.clear();
+    vector<int64_t> rootToCluster(numElements, -1);
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        if (labels[i] == -1) continue;
+        if (labels[i] == i)//roots are the lowest index, so they are always seen before the rest of their cluster
+        {
+            rootToCluster[i] = (int64_t)clustersOut.size();
+            clustersOut.push_back(vector<int64_t>());
+            sizesOut.push_back(0.0);
+        }
+        int64_t whichCluster = rootToCluster[labels[i]];
+        CaretAssert(whichCluster != -1);
+        clustersOut[whichCluster].push_back(i);
+        sizesOut[whichCluster] += m_elementSizes[i];
+    }
+}
+
+void ClusterGraph::tfceSweep(const float* data, const float* roiData, const bool& negate, const float& param_e, const float& param_h,
+                             TFCEScratch& scratch, double* accumData) const
+{//same integration strategy as the old per-algorithm code, but clusters live at their union-find root, and membership corrections are stored on links instead of applied to member lists
+    int64_t numElements = getNumberOfElements();
+    scratch.m_values.resize(numElements);
+    scratch.m_parent.assign(numElements, -1);//-1 means not yet added
+    scratch.m_offset.resize(numElements);
+    scratch.m_clusterAccum.resize(numElements);
+    scratch.m_clusterSize.resize(numElements);
+    scratch.m_clusterLast.resize(numElements);
+    scratch.m_order.clear();
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        float value = (negate ? -data[i] : data[i]);
+        scratch.m_values[i] = value;
+        if ((roiData == NULL || roiData[i] > 0.0f) && value > 0.0f)
+        {
+            scratch.m_order.push_back(i);
+        }
+    }
+    sort(scratch.m_order.begin(), scratch.m_order.end(), SortDescending(scratch.m_values.data()));
+    int64_t* parent = scratch.m_parent.data();
+    vector<int64_t>& roots = scratch.m_roots;
+    int64_t numOrdered = (int64_t)scratch.m_order.size();
+    for (int64_t o = 0; o < numOrdered; ++o)
+    {
+        int64_t elem = scratch.m_order[o];
+        float value = scratch.m_values[elem];
+        roots.clear();
+        const int32_t* neighbors;
+        int64_t numNeigh = getNeighbors(elem, neighbors);
+        for (int64_t n = 0; n < numNeigh; ++n)
+        {
+            if (parent[neighbors[n]] != -1)
+            {
+                int64_t thisRoot = findRootOffset(scratch, neighbors[n]);
+                if (find(roots.begin(), roots.end(), thisRoot) == roots.end()) roots.push_back(thisRoot);
+            }
+        }
+        switch (roots.size())
+        {
+            case 0://new cluster
+                parent[elem] = elem;
+                scratch.m_offset[elem] = 0.0;
+                scratch.m_clusterAccum[elem] = 0.0;
+                scratch.m_clusterSize[elem] = m_elementSizes[elem];
+                scratch.m_clusterLast[elem] = value;
+                break;
+            case 1://add to cluster
+            {
+                int64_t whichRoot = roots[0];
+                updateCluster(scratch, whichRoot, value, param_e, param_h);
+                parent[elem] = whichRoot;
+                scratch.m_offset[elem] = 0.0;
+                scratch.m_clusterSize[whichRoot] += m_elementSizes[elem];
+                accumData[elem] -= scratch.m_clusterAccum[whichRoot];//record how far below the cluster peak this element starts
+                break;
+            }
+            default://merge, keep the biggest cluster as the root
+            {
+                int64_t mergedRoot = roots[0];
+                for (size_t r = 1; r < roots.size(); ++r)
+                {
+                    if (scratch.m_clusterSize[roots[r]] > scratch.m_clusterSize[mergedRoot]) mergedRoot = roots[r];
+                }
+                updateCluster(scratch, mergedRoot, value, param_e, param_h);
+                for (size_t r = 0; r < roots.size(); ++r)
+                {
+                    int64_t thisRoot = roots[r];
+                    if (thisRoot == mergedRoot) continue;
+                    updateCluster(scratch, thisRoot, value, param_e, param_h);
+                    parent[thisRoot] = mergedRoot;
+                    scratch.m_offset[thisRoot] = scratch.m_clusterAccum[thisRoot] - scratch.m_clusterAccum[mergedRoot];//every member of the side cluster gets this correction via the link
+                    scratch.m_clusterSize[mergedRoot] += scratch.m_clusterSize[thisRoot];
+                }
+                parent[elem] = mergedRoot;
+                scratch.m_offset[elem] = 0.0;
+                scratch.m_clusterSize[mergedRoot] += m_elementSizes[elem];
+                accumData[elem] -= scratch.m_clusterAccum[mergedRoot];
+                break;
+            }
+        }
+    }
+    for (int64_t o = 0; o < numOrdered; ++o)//integrate each remaining cluster down to zero
+    {
+        int64_t elem = scratch.m_order[o];
+        if (parent[elem] == elem) updateCluster(scratch, elem, 0.0f, param_e, param_h);
+    }
+    for (int64_t o = 0; o < numOrdered; ++o)
+    {
+        int64_t elem = scratch.m_order[o];
+        double correction = 0.0;
+        int64_t root = elem;
+        while (parent[root] != root)//sum the link corrections all the way up, the roots' own accum values are final now
+        {
+            correction += scratch.m_offset[root];
+            root = parent[root];
+        }
+        accumData[elem] += correction + scratch.m_clusterAccum[root];
+    }
+}
+
+void ClusterGraph::tfce(const float* data, float* outData, const float& param_e, const float& param_h, const float* roiData, TFCEScratch& scratch) const
+{
+    int64_t numElements = getNumberOfElements();
+    scratch.m_accum.assign(numElements, 0.0);
+    tfceSweep(data, roiData, false, param_e, param_h, scratch, scratch.m_accum.data());
+    tfceSweep(data, roiData, true, param_e, param_h, scratch, scratch.m_accum.data());//negatives and positives don't overlap, so reuse the accum array
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        if (roiData == NULL || roiData[i] > 0.0f)
+        {
+            if (data[i] < 0.0f)
+            {
+                outData[i] = (float)-scratch.m_accum[i];
+            } else {
+                outData[i] = (float)scratch.m_accum[i];
+            }
+        } else {
+            outData[i] = 0.0f;
+        }
+    }
+}
+
+void ClusterGraph::tfce(const float* data, float* outData, const float& param_e, const float& param_h, const float* roiData) const
+{//positive and negative sweeps each get their own buffers, so they can run at the same time
+    int64_t numElements = getNumberOfElements();
+    TFCEScratch posScratch, negScratch;
+    posScratch.m_accum.assign(numElements, 0.0);
+    negScratch.m_accum.assign(numElements, 0.0);
+#pragma omp CARET_PAR sections
+    {
+#pragma omp section
+        tfceSweep(data, roiData, false, param_e, param_h, posScratch, posScratch.m_accum.data());
+#pragma omp section
+        tfceSweep(data, roiData, true, param_e, param_h, negScratch, negScratch.m_accum.data());
+    }
+#pragma omp CARET_PARFOR schedule(static)
+    for (int64_t i = 0; i < numElements; ++i)
+    {
+        if (roiData == NULL || roiData[i] > 0.0f)
+        {
+            if (data[i] < 0.0f)
+            {
+                outData[i] = (float)-negScratch.m_accum[i];
+            } else {
+                outData[i] = (float)posScratch.m_accum[i];
+            }
+        } else {
+            outData[i] = 0.0f;
+        }
+    }
+}
+
+void ClusterGraph::tfceBatch(const vector<const float*>& dataList, const vector<float*>& outList, const float& param_e, const float& param_h, const float* roiData) const
+{
+    CaretAssert(dataList.size() == outList.size());
+    int64_t numMaps = (int64_t)dataList.size();
+#pragma omp CARET_PAR
+    {
+        TFCEScratch scratch;//allocated once per thread, reused for every map
+#pragma omp CARET_FOR schedule(dynamic)
+        for (int64_t m = 0; m < numMaps; ++m)
+        {
+            tfce(dataList[m], outList[m], param_e, param_h, roiData, scratch);
+        }
+    }
+}
@@ -0,0 +1,115 @@
+#ifndef __CLUSTER_GRAPH_H__
+#define __CLUSTER_GRAPH_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+//NOTE: this flattens surface topology, volume stencils, or a cifti dense mapping into a single CSR (compressed sparse row) adjacency list, so that clustering
+//      code doesn't need to care which kind of data it is running on.  Building it costs about as much as one pass of cluster finding, so build it once and
+//      reuse it for every map, permutation, or threshold you need.
+//
+//NOTE: the object is not modified by any of the processing functions, so multiple threads can use the same instance concurrently, as long as each thread
+//      uses its own TFCEScratch
+
+#include "stdint.h"
+#include "stddef.h"
+#include <vector>
+
+namespace caret {
+
+    class CiftiBrainModelsMap;
+    class SurfaceFile;
+    class VolumeSpace;
+
+    class ClusterGraph
+    {
+    public:
+        enum VolumeNeighbors
+        {
+            FACE,//6 neighbors
+            EDGE,//18 neighbors
+            CORNER//26 neighbors
+        };
+
+        ///reusable per-thread working memory for TFCE, so repeated calls on the same graph (permutations) don't reallocate
+        struct TFCEScratch
+        {
+            std::vector<int64_t> m_order, m_parent, m_roots;
+            std::vector<float> m_values, m_clusterLast;
+            std::vector<double> m_offset, m_clusterAccum, m_clusterSize, m_accum;
+        };
+
+        ///surface adjacency, element sizes are vertex areas (computed from the surface if NULL)
+        ClusterGraph(const SurfaceFile* mySurf, const float* nodeAreas = NULL);
+
+        ///volume adjacency over one frame, element sizes are the voxel volume
+        ClusterGraph(const VolumeSpace& mySpace, const VolumeNeighbors& neighbors = FACE);
+
+        ///cifti dense mapping adjacency, indices are cifti indices, structures are never connected to each other except when mergedVolume is true (voxels only)
+        ///surfaces and areas are indexed by the position of the structure in myMap.getSurfaceStructureList()
+        ClusterGraph(const CiftiBrainModelsMap& myMap, const std::vector<const SurfaceFile*>& surfaces, const std::vector<const float*>& surfAreas,
+                     const VolumeNeighbors& neighbors = FACE, const bool& mergedVolume = false);
+
+        int64_t getNumberOfElements() const { return (int64_t)m_elementSizes.size(); }
+
+        ///size (area or volume) of a single element
+        float getElementSize(const int64_t& element) const { return m_elementSizes[element]; }
+
+        ///neighbors of an element, returns the count
+        int64_t getNeighbors(const int64_t& element, const int32_t*& neighborsOut) const
+        {
+            neighborsOut = m_neighbors.data() + m_offsets[element];
+            return m_offsets[element + 1] - m_offsets[element];
+        }
+
+        ///label connected components of the elements where mask is nonzero, labelsOut gets the lowest element index in the component, or -1 outside the mask
+        ///parallel within the single map, results do not depend on the number of threads
+        void labelComponents(const char* mask, int64_t* labelsOut) const;
+
+        ///threshold the data (and roi, if given), and return clusters ordered by lowest member index, members in ascending order
+        void findClusters(const float* data, const float& threshold, const bool& lessThan, std::vector<std::vector<int64_t> >& clustersOut,
+                          std::vector<double>& sizesOut, const float* roiData = NULL) const;
+
+        ///find clusters of the elements where mask is nonzero, same ordering as above
+        void findClusters(const char* mask, std::vector<std::vector<int64_t> >& clustersOut, std::vector<double>& sizesOut) const;
+
+        ///TFCE on one map, positive and negative sweeps run concurrently when called outside a parallel region, output is 0 outside the roi
+        void tfce(const float* data, float* outData, const float& param_e, const float& param_h, const float* roiData = NULL) const;
+
+        ///TFCE on one map using provided scratch, does not spawn threads, for use inside your own parallel loop
+        void tfce(const float* data, float* outData, const float& param_e, const float& param_h, const float* roiData, TFCEScratch& scratch) const;
+
+        ///TFCE on many maps of the same shape (permutations, columns), parallel over maps with one scratch per thread
+        void tfceBatch(const std::vector<const float*>& dataList, const std::vector<float*>& outList, const float& param_e, const float& param_h,
+                       const float* roiData = NULL) const;
+    private:
+        std::vector<int64_t> m_offsets;
+        std::vector<int32_t> m_neighbors;//int32_t to halve memory use for volume stencils, constructors check the element count
+        std::vector<float> m_elementSizes;
+        ClusterGraph();
+        void buildFromLists(const std::vector<std::vector<int64_t> >& lists);
+        void tfceSweep(const float* data, const float* roiData, const bool& negate, const float& param_e, const float& param_h,
+                       TFCEScratch& scratch, double* accumData) const;
+        static void getVolumeStencil(const VolumeNeighbors& neighbors, std::vector<int>& stencilOut);
+    };
+
+}
+
+#endif //__CLUSTER_GRAPH_H__
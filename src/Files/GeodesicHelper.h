@@ -48,7 +48,7 @@ namespace caret {
             float edgeWeight, pieceDists[2];
         };
     private:
-        GeodesicHelperBase();//can't construct without arguments
+        GeodesicHelperBase() { }//only for SurfaceHelperCache, which fills in the members itself
         GeodesicHelperBase& operator=(const GeodesicHelperBase& right);//can't assign
         GeodesicHelperBase(const GeodesicHelperBase& right);//can't use copy constructor
         std::vector<std::vector<float> > distances, distances2;
@@ -61,6 +61,7 @@ namespace caret {
     public:
         explicit GeodesicHelperBase(const SurfaceFile* surfaceIn, const float* correctedAreas = NULL);//NOTE: this is only an APPROXIMATE correction, use the real surface whenever possible
         friend class GeodesicHelper;//let it grab the private variables it needs
+        friend class SurfaceHelperCache;//reads and writes the members directly, to save the neighbors-2 crawl
     };
 
     class GeodesicHelper
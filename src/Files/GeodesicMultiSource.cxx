@@ -0,0 +1,220 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "GeodesicMultiSource.h"
+
+#include "AString.h"
+#include "CaretAssert.h"
+#include "CaretException.h"
+#include "CaretOMP.h"
+#include "GeodesicHelper.h"
+#include "SurfaceFile.h"
+
+#include <algorithm>
+
+using namespace caret;
+using namespace std;
+
+GeodesicMultiSource::RowSink::~RowSink()
+{
+}
+
+GeodesicMultiSource::SparseRowSink::~SparseRowSink()
+{
+}
+
+GeodesicMultiSource::GeodesicMultiSource(const SurfaceFile* surfaceIn, const float* correctedAreas)
+{
+    CaretAssert(surfaceIn != NULL);
+    m_surface = surfaceIn;
+    if (correctedAreas != NULL)
+    {
+        m_correctedBase.grabNew(new GeodesicHelperBase(surfaceIn, correctedAreas));
+    }
+    int numThreads = 1;
+#ifdef CARET_OMP
+    numThreads = omp_get_max_threads();
+#endif
+    m_blockSize = 16 * max(numThreads, 1);//enough rows per block that the threads stay busy across dynamic scheduling, few enough to keep the block buffer small
+}
+
+void GeodesicMultiSource::getHelper(CaretPointer<GeodesicHelper>& helpOut) const
+{
+    if (m_correctedBase == NULL)
+    {
+        m_surface->getGeodesicHelper(helpOut);//reuses the surface's shared base and its pool of helpers
+    } else {
+        helpOut.grabNew(new GeodesicHelper(m_correctedBase));
+    }
+}
+
+void GeodesicMultiSource::computeDense(const vector<int32_t>& sources, const vector<int32_t>& targets, const float& maxDist, RowSink* sinkOut, const bool& smooth)
+{
+    CaretAssert(sinkOut != NULL);
+    const int32_t numNodes = m_surface->getNumberOfNodes();
+    const int64_t numSources = (int64_t)sources.size();
+    const bool allTargets = targets.empty();
+    const int64_t rowLength = (allTargets ? numNodes : (int64_t)targets.size());
+    vector<int64_t> targetColumn;//only needed to scatter distance-limited results into a subset of columns
+    if (!allTargets && maxDist >= 0.0f)
+    {
+        targetColumn.resize(numNodes, -1);
+        for (int64_t i = 0; i < rowLength; ++i)
+        {
+            CaretAssert(targets[i] >= 0 && targets[i] < numNodes);
+            targetColumn[targets[i]] = i;
+        }
+    }
+    vector<float> blockRows(min(m_blockSize, numSources) * rowLength);
+    bool failed = false;
+    AString failMessage;
+#pragma omp CARET_PAR
+    {
+        CaretPointer<GeodesicHelper> myHelp;
+        getHelper(myHelp);
+        vector<int32_t> nodes;
+        vector<float> dists;
+        for (int64_t blockStart = 0; blockStart < numSources; blockStart += m_blockSize)
+        {//every thread runs this loop, so the worksharing and single constructs inside it line up
+            const int64_t blockEnd = min(blockStart + m_blockSize, numSources);
+#pragma omp CARET_FOR schedule(dynamic)
+            for (int64_t i = blockStart; i < blockEnd; ++i)
+            {
+                const int32_t source = sources[i];
+                CaretAssert(source >= 0 && source < numNodes);
+                float* rowOut = blockRows.data() + (i - blockStart) * rowLength;
+                if (maxDist >= 0.0f)
+                {
+                    for (int64_t j = 0; j < rowLength; ++j)
+                    {
+                        rowOut[j] = -1.0f;
+                    }
+                    myHelp->getNodesToGeoDist(source, maxDist, nodes, dists, smooth);
+                    for (size_t j = 0; j < nodes.size(); ++j)
+                    {
+                        if (allTargets)
+                        {
+                            rowOut[nodes[j]] = dists[j];
+                        } else if (targetColumn[nodes[j]] != -1) {
+                            rowOut[targetColumn[nodes[j]]] = dists[j];
+                        }
+                    }
+                } else if (allTargets) {
+                    myHelp->getGeoFromNode(source, rowOut, smooth);
+                } else {
+                    myHelp->getGeoToTheseNodes(source, targets, dists, smooth);
+                    CaretAssert((int64_t)dists.size() == rowLength);
+                    for (int64_t j = 0; j < rowLength; ++j)
+                    {
+                        rowOut[j] = dists[j];
+                    }
+                }
+            }
+#pragma omp CARET_SINGLE
+            {//the sink may write to a file, so hand it rows from one thread, in order
+                try
+                {
+                    for (int64_t i = blockStart; i < blockEnd; ++i)
+                    {
+                        sinkOut->addRow(i, blockRows.data() + (i - blockStart) * rowLength);
+                    }
+                } catch (CaretException& e) {
+                    failed = true;
+                    failMessage = e.whatString();
+                }
+            }//implicit barrier, so every thread sees the failure flag before the next block
+            if (failed) break;
+        }
+    }
+    if (failed) throw CaretException(failMessage);
+}
+
+void GeodesicMultiSource::computeSparse(const vector<int32_t>& sources, const vector<int32_t>& targets, const float& maxDist, SparseRowSink* sinkOut, const bool& smooth)
+{
+    CaretAssert(sinkOut != NULL);
+    if (!(maxDist >= 0.0f)) throw CaretException("sparse geodesic rows require a distance limit");
+    const int32_t numNodes = m_surface->getNumberOfNodes();
+    const int64_t numSources = (int64_t)sources.size();
+    const bool allTargets = targets.empty();
+    vector<int64_t> targetColumn;
+    if (!allTargets)
+    {
+        targetColumn.resize(numNodes, -1);
+        for (int64_t i = 0; i < (int64_t)targets.size(); ++i)
+        {
+            CaretAssert(targets[i] >= 0 && targets[i] < numNodes);
+            targetColumn[targets[i]] = i;
+        }
+    }
+    vector<vector<int64_t> > blockColumns(min(m_blockSize, numSources));
+    vector<vector<float> > blockDists(blockColumns.size());
+    bool failed = false;
+    AString failMessage;
+#pragma omp CARET_PAR
+    {
+        CaretPointer<GeodesicHelper> myHelp;
+        getHelper(myHelp);
+        vector<int32_t> nodes;
+        vector<float> dists;
+        vector<pair<int64_t, float> > sorted;
+        for (int64_t blockStart = 0; blockStart < numSources; blockStart += m_blockSize)
+        {//same block structure as computeDense
+            const int64_t blockEnd = min(blockStart + m_blockSize, numSources);
+#pragma omp CARET_FOR schedule(dynamic)
+            for (int64_t i = blockStart; i < blockEnd; ++i)
+            {
+                const int32_t source = sources[i];
+                CaretAssert(source >= 0 && source < numNodes);
+                myHelp->getNodesToGeoDist(source, maxDist, nodes, dists, smooth);
+                sorted.clear();//the helper returns them in order of distance, sparse rows need them in column order
+                for (size_t j = 0; j < nodes.size(); ++j)
+                {
+                    const int64_t column = (allTargets ? nodes[j] : targetColumn[nodes[j]]);
+                    if (column != -1) sorted.push_back(pair<int64_t, float>(column, dists[j]));
+                }
+                sort(sorted.begin(), sorted.end());
+                vector<int64_t>& columnsOut = blockColumns[i - blockStart];
+                vector<float>& distsOut = blockDists[i - blockStart];
+                columnsOut.resize(sorted.size());
+                distsOut.resize(sorted.size());
+                for (size_t j = 0; j < sorted.size(); ++j)
+                {
+                    columnsOut[j] = sorted[j].first;
+                    distsOut[j] = sorted[j].second;
+                }
+            }
+#pragma omp CARET_SINGLE
+            {
+                try
+                {
+                    for (int64_t i = blockStart; i < blockEnd; ++i)
+                    {
+                        sinkOut->addSparseRow(i, blockColumns[i - blockStart], blockDists[i - blockStart]);
+                    }
+                } catch (CaretException& e) {
+                    failed = true;
+                    failMessage = e.whatString();
+                }
+            }
+            if (failed) break;
+        }
+    }
+    if (failed) throw CaretException(failMessage);
+}
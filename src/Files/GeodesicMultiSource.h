@@ -0,0 +1,75 @@
+#ifndef __GEODESIC_MULTI_SOURCE_H__
+#define __GEODESIC_MULTI_SOURCE_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "CaretPointer.h"
+
+#include <vector>
+#include <stdint.h>
+
+namespace caret {
+
+    class GeodesicHelper;
+    class GeodesicHelperBase;
+    class SurfaceFile;
+
+    ///geodesic distances from many source vertices, one GeodesicHelper per thread over a shared base
+    ///sources are processed in blocks, each block in parallel, and finished rows are handed out in source order from one thread at a time
+    class GeodesicMultiSource
+    {
+    public:
+        ///receives dense rows, called in source order, never concurrently
+        class RowSink
+        {
+        public:
+            ///distances has one element per target, -1 where the distance was not computed
+            virtual void addRow(const int64_t& sourceIndex, const float* distances) = 0;
+            virtual ~RowSink();
+        };
+
+        ///receives distance-limited rows, called in source order, never concurrently
+        class SparseRowSink
+        {
+        public:
+            ///columns are target indices in increasing order, only for the targets within the limit
+            virtual void addSparseRow(const int64_t& sourceIndex, const std::vector<int64_t>& columns, const std::vector<float>& distances) = 0;
+            virtual ~SparseRowSink();
+        };
+
+        ///correctedAreas is optional, see GeodesicHelperBase
+        GeodesicMultiSource(const SurfaceFile* surfaceIn, const float* correctedAreas = NULL);
+
+        ///dense rows over the target vertices (all vertices if targets is empty), with maxDist < 0 meaning no limit
+        void computeDense(const std::vector<int32_t>& sources, const std::vector<int32_t>& targets, const float& maxDist, RowSink* sinkOut, const bool& smooth = true);
+
+        ///only the target vertices (all vertices if targets is empty) within maxDist of each source, which must not be negative
+        void computeSparse(const std::vector<int32_t>& sources, const std::vector<int32_t>& targets, const float& maxDist, SparseRowSink* sinkOut, const bool& smooth = true);
+    private:
+        const SurfaceFile* m_surface;
+        CaretPointer<GeodesicHelperBase> m_correctedBase;
+        int64_t m_blockSize;
+        void getHelper(CaretPointer<GeodesicHelper>& helpOut) const;
+    };
+
+}
+
+#endif //__GEODESIC_MULTI_SOURCE_H__
@@ -19,8 +19,10 @@
  */
 /*LICENSE_END*/
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
+#include <vector>
 
 //#include <QRunnable>
 //#include <QSemaphore>
@@ -56,7 +58,108 @@ static const float negativeThresholdGreenColor[] = {
     255.0f / 255.0f
 };
 
-
+namespace {
+    /**
+     * Colors of the labels in a label table for a display group and tab, so that
+     * coloring an element does not need a map lookup and selection test.
+     * Keys index a dense array unless they are too sparse, when a
+     * binary search of the sorted keys is used.
+     */
+    class LabelColorLookup {
+    public:
+        LabelColorLookup(const GiftiLabelTable* labelTable,
+                         const DisplayGroupEnum::Enum displayGroup,
+                         const int32_t tabIndex,
+                         const int32_t invalidTabIndex)
+        {
+            labelTable->getKeys(m_keys);
+            const int64_t numKeys = m_keys.size();
+            m_minKey = 0;
+            m_dense = false;
+            if (numKeys > 0) {
+                m_minKey = m_keys[0];
+                const int64_t keyRange = static_cast<int64_t>(m_keys[numKeys - 1]) - m_minKey + 1;
+                m_dense = (keyRange <= 4 * numKeys + 1024);
+            }
+            const int64_t numEntries = (m_dense ? (static_cast<int64_t>(m_keys[numKeys - 1]) - m_minKey + 1) : numKeys);
+            m_rgbaFloat.resize(numEntries * 4, 0.0f);
+            m_rgbaByte.resize(numEntries * 4, 0);
+            m_colorFlag.resize(numEntries, 0);
+            for (int64_t k = 0; k < numKeys; k++) {
+                const GiftiLabel* gl = labelTable->getLabel(m_keys[k]);
+                CaretAssert(gl != NULL);
+                const GroupAndNameHierarchyItem* item = gl->getGroupNameSelectionItem();
+                bool colorDataFlag = false;
+                if (item != NULL) {
+                    if (tabIndex == invalidTabIndex) {
+                        colorDataFlag = true;
+                    }
+                    else if (item->isSelected(displayGroup, tabIndex)) {
+                        colorDataFlag = true;
+                    }
+                }
+                else {
+                    colorDataFlag = true;
+                }
+                if ( ! colorDataFlag) {
+                    continue;
+                }
+                float labelRGBA[4];
+                gl->getColor(labelRGBA);
+                if (labelRGBA[3] > 0.0) {
+                    const int64_t entry = (m_dense ? (m_keys[k] - m_minKey) : k);
+                    const int64_t e4 = entry * 4;
+                    for (int32_t j = 0; j < 4; j++) {
+                        m_rgbaFloat[e4 + j] = labelRGBA[j];
+                        m_rgbaByte[e4 + j]  = labelRGBA[j] * 255.0;
+                    }
+                    m_colorFlag[entry] = 1;
+                }
+            }
+        }
+        
+        /**
+         * @return Entry for the key, or negative if the key has no color.
+         */
+        inline int64_t getEntry(const int32_t key) const
+        {
+            int64_t entry = -1;
+            if (m_dense) {
+                entry = static_cast<int64_t>(key) - m_minKey;
+                if ((entry < 0) || (entry >= static_cast<int64_t>(m_colorFlag.size()))) {
+                    return -1;
+                }
+            }
+            else {
+                std::vector<int32_t>::const_iterator iter = std::lower_bound(m_keys.begin(), m_keys.end(), key);
+                if ((iter == m_keys.end()) || (*iter != key)) {
+                    return -1;
+                }
+                entry = iter - m_keys.begin();
+            }
+            return (m_colorFlag[entry] ? entry : -1);
+        }
+        
+        /** RGBA, 4 per entry */
+        std::vector<float> m_rgbaFloat;
+        
+        /** RGBA, 4 per entry */
+        std::vector<uint8_t> m_rgbaByte;
+        
+    private:
+        /** Nonzero if the entry's label is displayed and not transparent */
+        std::vector<uint8_t> m_colorFlag;
+        
+        /** Keys in ascending order */
+        std::vector<int32_t> m_keys;
+        
+        /** Key of the first entry when dense */
+        int64_t m_minKey;
+        
+        /** True if entries are indexed by key, else by position in the sorted keys */
+        bool m_dense;
+    };
+}
     
 /**
  * \class NodeAndVoxelColoring 
@@ -706,72 +809,61 @@ NodeAndVoxelColoring::colorIndicesWithLabelTableForDisplayGroupTabPrivate(const
     
     
     /*
-     * Invalidate all coloring.
+     * Look up the colors and selection status once per label,
+     * not once per element
+     */
+    const LabelColorLookup labelLookup(labelTable,
+                                       displayGroup,
+                                       tabIndex,
+                                       NodeAndVoxelColoring::INVALID_TAB_INDEX);
+    
+    /*
+     * Assign colors from labels to nodes, elements without a
+     * displayed label only have their alpha set to zero
      */
     switch (colorDataType) {
         case COLOR_TYPE_FLOAT:
+        {
+            const float* lookupRGBA = labelLookup.m_rgbaFloat.data();
+#pragma omp CARET_PARFOR schedule(dynamic, 4096)
             for (int64_t i = 0; i < numberOfIndices; i++) {
-                rgbaFloat[i*4+3] = 0.0;
+                const int64_t labelKey = static_cast<int64_t>(labelIndices[i]);
+                const int64_t entry = labelLookup.getEntry(labelKey);
+                const int64_t i4 = i * 4;
+                if (entry >= 0) {
+                    const float* rgba = lookupRGBA + entry * 4;
+                    rgbaFloat[i4]   = rgba[0];
+                    rgbaFloat[i4+1] = rgba[1];
+                    rgbaFloat[i4+2] = rgba[2];
+                    rgbaFloat[i4+3] = rgba[3];
+                }
+                else {
+                    rgbaFloat[i4+3] = 0.0;
+                }
             }
+        }
             break;
         case COLOR_TYPE_UNSIGNED_BTYE:
+        {
+            const uint8_t* lookupRGBA = labelLookup.m_rgbaByte.data();
+#pragma omp CARET_PARFOR schedule(dynamic, 4096)
             for (int64_t i = 0; i < numberOfIndices; i++) {
-                rgbaUnsignedByte[i*4+3] = 0;
-            }
-            break;
-    }
-    
-    /*
-     * Assign colors from labels to nodes
-     */
-    float labelRGBA[4];
-	for (int64_t i = 0; i < numberOfIndices; i++) {
-        const int64_t labelKey = static_cast<int64_t>(labelIndices[i]);
-        const GiftiLabel* gl = labelTable->getLabel(labelKey);
-        if (gl != NULL) {
-            const GroupAndNameHierarchyItem* item = gl->getGroupNameSelectionItem();
-            bool colorDataFlag = false;
-            if (item != NULL) {
-                if (tabIndex == NodeAndVoxelColoring::INVALID_TAB_INDEX) {
-                    colorDataFlag = true;
-                }
-                else if (item->isSelected(displayGroup, tabIndex)) {
-                    colorDataFlag = true;
+                const int64_t labelKey = static_cast<int64_t>(labelIndices[i]);
+                const int64_t entry = labelLookup.getEntry(labelKey);
+                const int64_t i4 = i * 4;
+                if (entry >= 0) {
+                    const uint8_t* rgba = lookupRGBA + entry * 4;
+                    rgbaUnsignedByte[i4]   = rgba[0];
+                    rgbaUnsignedByte[i4+1] = rgba[1];
+                    rgbaUnsignedByte[i4+2] = rgba[2];
+                    rgbaUnsignedByte[i4+3] = rgba[3];
                 }
-            }
-            else {
-                colorDataFlag = true;
-            }
-            
-            if (colorDataFlag) {
-                gl->getColor(labelRGBA);
-                if (labelRGBA[3] > 0.0) {
-                    const int64_t i4 = i * 4;
-                    
-                    switch (colorDataType) {
-                        case COLOR_TYPE_FLOAT:
-                            CaretAssertArrayIndex(rgbaFloat, numberOfIndices * 4, i*4+3);
-                            rgbaFloat[i*4] = labelRGBA[0];
-                            rgbaFloat[i*4+1] = labelRGBA[1];
-                            rgbaFloat[i*4+2] = labelRGBA[2];
-                            rgbaFloat[i*4+3] = labelRGBA[3];
-                            break;
-                        case COLOR_TYPE_UNSIGNED_BTYE:
-                            CaretAssertArrayIndex(rgbaUnsignedByte, numberOfIndices * 4, i*4+3);
-                            rgbaUnsignedByte[i4]   = labelRGBA[0] * 255.0;
-                            rgbaUnsignedByte[i4+1] = labelRGBA[1] * 255.0;
-                            rgbaUnsignedByte[i4+2] = labelRGBA[2] * 255.0;
-                            if (labelRGBA[3] > 0.0) {
-                                rgbaUnsignedByte[i4+3] = labelRGBA[3] * 255.0;
-                            }
-                            else {
-                                rgbaUnsignedByte[i4+3] = 0;
-                            }
-                            break;
-                    }
+                else {
+                    rgbaUnsignedByte[i4+3] = 0;
                 }
             }
         }
+            break;
     }
 }
 
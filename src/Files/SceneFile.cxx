@@ -19,6 +19,7 @@
  */
 /*LICENSE_END*/
 
+#include <QFile>
 #include <QTextStream>
 
 #include <algorithm>
@@ -49,7 +50,154 @@
 
 using namespace caret;
 
-
+namespace {
+    /**
+     * Find the byte ranges of the top level scene elements in a scene file,
+     * and create a copy of the file without the scene classes, keeping
+     * each scene's name and description, so that the file's metadata, scene
+     * info, and scene names can be read without parsing the scene classes.
+     *
+     * @param fileBytes
+     *    Content of the scene file.
+     * @param skeletonOut
+     *    Output with the scene classes removed.
+     * @param sceneRangesOut
+     *    Output with the start and length of each scene element.
+     * @return
+     *    True if the file's elements were matched up, else false.
+     */
+    bool findSceneElements(const QByteArray& fileBytes,
+                           QByteArray& skeletonOut,
+                           std::vector<std::pair<int, int> >& sceneRangesOut)
+    {
+        skeletonOut.clear();
+        sceneRangesOut.clear();
+        const char* data = fileBytes.constData();
+        const int numBytes = fileBytes.size();
+        int depth = 0;
+        int copiedUpTo = 0;
+        int sceneStart = -1;
+        int firstObjectStart = -1;
+        int pos = fileBytes.indexOf('<');
+        while (pos >= 0) {
+            int tagEnd = -1;
+            if (fileBytes.mid(pos, 9) == "<![CDATA[") {
+                tagEnd = fileBytes.indexOf("]]>", pos + 9);
+                if (tagEnd < 0) return false;
+                pos = fileBytes.indexOf('<', tagEnd + 3);
+                continue;
+            }
+            if (fileBytes.mid(pos, 4) == "<!--") {
+                tagEnd = fileBytes.indexOf("-->", pos + 4);
+                if (tagEnd < 0) return false;
+                pos = fileBytes.indexOf('<', tagEnd + 3);
+                continue;
+            }
+            if ((pos + 1 < numBytes)
+                && ((data[pos + 1] == '?') || (data[pos + 1] == '!'))) {
+                tagEnd = fileBytes.indexOf('>', pos);
+                if (tagEnd < 0) return false;
+                pos = fileBytes.indexOf('<', tagEnd + 1);
+                continue;
+            }
+            
+            /*
+             * Find end of tag, '>' may occur in quoted attribute values
+             */
+            char quote = 0;
+            for (int i = pos + 1; i < numBytes; i++) {
+                const char c = data[i];
+                if (quote != 0) {
+                    if (c == quote) quote = 0;
+                }
+                else if ((c == '"') || (c == '\'')) {
+                    quote = c;
+                }
+                else if (c == '>') {
+                    tagEnd = i + 1;
+                    break;
+                }
+            }
+            if (tagEnd < 0) return false;
+            
+            const bool closingTag = (data[pos + 1] == '/');
+            const bool emptyTag = (data[tagEnd - 2] == '/');
+            int nameStart = pos + (closingTag ? 2 : 1);
+            int nameEnd = nameStart;
+            while ((nameEnd < tagEnd)
+                   && (data[nameEnd] != '>')
+                   && (data[nameEnd] != '/')
+                   && ( ! QChar(data[nameEnd]).isSpace())) {
+                nameEnd++;
+            }
+            const QByteArray tagName = fileBytes.mid(nameStart, nameEnd - nameStart);
+            
+            if (closingTag) {
+                depth--;
+                if (depth < 0) return false;
+                if ((depth == 1)
+                    && (sceneStart >= 0)) {
+                    if (tagName != SceneXmlElements::SCENE_TAG.toLatin1()) return false;
+                    sceneRangesOut.push_back(std::make_pair(sceneStart,
+                                                            tagEnd - sceneStart));
+                    const int keepEnd = ((firstObjectStart >= 0) ? firstObjectStart : pos);
+                    skeletonOut.append(data + copiedUpTo, keepEnd - copiedUpTo);
+                    skeletonOut.append("</");
+                    skeletonOut.append(tagName);
+                    skeletonOut.append(">");
+                    copiedUpTo = tagEnd;
+                    sceneStart = -1;
+                    firstObjectStart = -1;
+                }
+            }
+            else {
+                if ((depth == 1)
+                    && (tagName == SceneXmlElements::SCENE_TAG.toLatin1())
+                    && ( ! emptyTag)) {
+                    sceneStart = pos;
+                }
+                else if ((depth == 2)
+                         && (sceneStart >= 0)
+                         && (firstObjectStart < 0)
+                         && (tagName == SceneXmlElements::OBJECT_TAG.toLatin1())) {
+                    firstObjectStart = pos;
+                }
+                if ( ! emptyTag) {
+                    depth++;
+                }
+            }
+            pos = fileBytes.indexOf('<', tagEnd);
+        }
+        if ((depth != 0)
+            || (sceneStart >= 0)) {
+            return false;
+        }
+        skeletonOut.append(data + copiedUpTo, numBytes - copiedUpTo);
+        
+        return true;
+    }
+    
+    /**
+     * Releases the parsed classes of a scene when it goes out of scope,
+     * if the scene had not been parsed when this was created.
+     */
+    class SceneReleaser {
+    public:
+        SceneReleaser(Scene* scene)
+        : m_scene(scene),
+        m_deferredFlag(scene->isDeferred()) { }
+        
+        ~SceneReleaser() {
+            if (m_deferredFlag) {
+                m_scene->releaseParsedScene();
+            }
+        }
+    private:
+        Scene* m_scene;
+        
+        const bool m_deferredFlag;
+    };
+}
     
 /**
  * \class caret::SceneFile 
@@ -534,10 +682,55 @@ SceneFile::readFile(const AString& filenameIn)
     checkFileReadability(filename);
     
     this->setFileName(filename);
-    SceneFileSaxReader saxReader(this);
-    std::auto_ptr<XmlSaxParser> parser(XmlSaxParser::createXmlParser());
     try {
-        parser->parseFile(filename, &saxReader);
+        /*
+         * Scene files may contain hundreds of scenes, and usually only
+         * one or a few are used, so only read the scene names and info
+         * now, and leave the scene classes unparsed until they are used
+         */
+        bool deferredFlag = false;
+        if ( ! DataFile::isFileOnNetwork(filename)) {
+            QFile file(filename);
+            if ( ! file.open(QFile::ReadOnly)) {
+                throw XmlSaxParserException("Unable to open file " + filename);
+            }
+            const QByteArray fileBytes = file.readAll();
+            file.close();
+            
+            QByteArray skeletonBytes;
+            std::vector<std::pair<int, int> > sceneRanges;
+            if (findSceneElements(fileBytes,
+                                  skeletonBytes,
+                                  sceneRanges)) {
+                SceneFileSaxReader saxReader(this);
+                std::auto_ptr<XmlSaxParser> parser(XmlSaxParser::createXmlParser());
+                parser->parseString(QString::fromUtf8(skeletonBytes.constData(),
+                                                      skeletonBytes.size()),
+                                    &saxReader);
+                const int32_t numScenes = getNumberOfScenes();
+                if (numScenes == static_cast<int32_t>(sceneRanges.size())) {
+                    for (int32_t i = 0; i < numScenes; i++) {
+                        m_scenes[i]->setDeferredSceneXml(fileBytes.mid(sceneRanges[i].first,
+                                                                       sceneRanges[i].second),
+                                                         filename);
+                    }
+                    deferredFlag = true;
+                }
+                else {
+                    CaretLogWarning("Scenes in "
+                                    + filename
+                                    + " did not match, reading all scenes");
+                    clear();
+                    this->setFileName(filename);
+                }
+            }
+        }
+        
+        if ( ! deferredFlag) {
+            SceneFileSaxReader saxReader(this);
+            std::auto_ptr<XmlSaxParser> parser(XmlSaxParser::createXmlParser());
+            parser->parseFile(filename, &saxReader);
+        }
     }
     catch (const XmlSaxParserException& e) {
         clear();
@@ -660,8 +853,18 @@ SceneFile::writeFile(const AString& filename)
         SceneWriterXml sceneWriter(xmlWriter,
                                    this->getFileName());
         for (int32_t i = 0; i < numScenes; i++) {
+            /*
+             * Scenes that have not been used since the file was read are
+             * parsed only while they are written, so that all of the scenes
+             * are never in memory at the same time
+             */
+            const bool deferredFlag = m_scenes[i]->isDeferred();
+            m_scenes[i]->parseDeferredScene();
             sceneWriter.writeScene(*m_scenes[i], 
                                    i);
+            if (deferredFlag) {
+                m_scenes[i]->releaseParsedScene();
+            }
         }
         
         xmlWriter.writeEndElement();
@@ -677,6 +880,10 @@ SceneFile::writeFile(const AString& filename)
     catch (const XmlException& e) {
         throw DataFileException(e);
     }
+    catch (const XmlSaxParserException& e) {
+        throw DataFileException(filename,
+                                e.whatString());
+    }
 }
 
 /**
@@ -694,11 +901,12 @@ SceneFile::addToDataFileContentInformation(DataFileContentInformation& dataFileI
     if (numScenes > 0) {
         AString sceneNamesText = "Scenes:";
         for (int32_t i = 0; i < numScenes; i++) {
-            const Scene* scene = getSceneAtIndex(i);
+            Scene* scene = getSceneAtIndex(i);
             sceneNamesText.appendWithNewLine("#" + AString::number(i + 1) + "  " +
                                              scene->getName());
             if (dataFileInformation.isOptionFlag(DataFileContentInformation::OPTION_SHOW_MAP_INFORMATION))
             {
+                SceneReleaser myReleaser(scene);//don't keep every scene parsed after listing them
                 sceneNamesText += ":";
                 const SceneAttributes* myAttrs = scene->getAttributes();
                 const SceneClass* guiMgrClass = scene->getClassWithName("guiManager");
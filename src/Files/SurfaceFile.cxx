@@ -45,6 +45,7 @@
 #include "GeodesicHelper.h"
 #include "PlainTextStringBuilder.h"
 #include "SignedDistanceHelper.h"
+#include "SurfaceHelperCache.h"
 #include "TopologyHelper.h"
 
 using namespace caret;
@@ -525,6 +526,11 @@ SurfaceFile::initializeMembersSurfaceFile()
     m_geoHelperIndex = 0;
     m_topoHelperIndex = 0;
     m_normalsComputed = false;
+    for (int32_t i = 0; i < BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS; i++) {
+        this->surfaceNodeColoringKeyForBrowserTabs[i] = 0;
+        this->surfaceMontageNodeColoringKeyForBrowserTabs[i] = 0;
+        this->wholeBrainNodeColoringKeyForBrowserTabs[i] = 0;
+    }
 }
 
 /**
@@ -757,7 +763,11 @@ void SurfaceFile::getGeodesicHelper(CaretPointer<GeodesicHelper>& helpOut) const
         {
             m_geoHelpers.clear();//just to be sure
             m_geoHelperIndex = 0;
-            m_geoBase.grabNew(new GeodesicHelperBase(this));//yes, this takes some time, and is single threaded at the moment
+            m_geoBase.grabNew(SurfaceHelperCache::readGeodesicBase(this));//use a prebuilt sidecar, if there is a valid one
+            if (m_geoBase == NULL)
+            {
+                m_geoBase.grabNew(new GeodesicHelperBase(this));//yes, this takes some time, and is single threaded at the moment
+            }
         }//keep locked while searching
         int32_t& myIndex = m_geoHelperIndex;
         int32_t myEnd = m_geoHelpers.size();
@@ -1457,16 +1467,38 @@ SurfaceFile::getSurfaceNodeColoringRgbaForBrowserTab(const int32_t browserTabInd
     return &rgba[0];
 }
 
+/**
+ * Get the key of the overlays that were used to create the coloring
+ * for this single surface in the given tab.
+ * @param browserTabIndex
+ *    Index of browser tab.
+ * @return
+ *    Key passed when the coloring was set.  Only meaningful when
+ *    the coloring for the tab is valid.
+ */
+uint64_t
+SurfaceFile::getSurfaceNodeColoringKeyForBrowserTab(const int32_t browserTabIndex) const
+{
+    CaretAssertArrayIndex(this->surfaceNodeColoringKeyForBrowserTabs, 
+                          BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS, 
+                          browserTabIndex);
+    
+    return this->surfaceNodeColoringKeyForBrowserTabs[browserTabIndex];
+}
+
 /**
  * Set the RGBA color components for this a single surface in the given tab.
  * @param browserTabIndex
  *    Index of browser tab.
  * @param rgbaNodeColorComponents
  *    RGBA color components for this surface in the given tab.
+ * @param coloringKey
+ *    Key of the overlays used to create the coloring.
  */
 void 
 SurfaceFile::setSurfaceNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex,
-                         const float* rgbaNodeColorComponents)
+                         const float* rgbaNodeColorComponents,
+                         const uint64_t coloringKey)
 {
     CaretAssertArrayIndex(this->surfaceNodeColoringForBrowserTabs, 
                           BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS, 
@@ -1479,6 +1511,7 @@ SurfaceFile::setSurfaceNodeColoringRgbaForBrowserTab(const int32_t browserTabInd
     for (int32_t i = 0; i < numberOfComponentsRGBA; i++) {
         rgba[i] = rgbaNodeColorComponents[i];
     }
+    this->surfaceNodeColoringKeyForBrowserTabs[browserTabIndex] = coloringKey;
 }
 
 /**
@@ -1504,16 +1537,38 @@ SurfaceFile::getSurfaceMontageNodeColoringRgbaForBrowserTab(const int32_t browse
     return &rgba[0];
 }
 
+/**
+ * Get the key of the overlays that were used to create the coloring
+ * for this surface montage in the given tab.
+ * @param browserTabIndex
+ *    Index of browser tab.
+ * @return
+ *    Key passed when the coloring was set.  Only meaningful when
+ *    the coloring for the tab is valid.
+ */
+uint64_t
+SurfaceFile::getSurfaceMontageNodeColoringKeyForBrowserTab(const int32_t browserTabIndex) const
+{
+    CaretAssertArrayIndex(this->surfaceMontageNodeColoringKeyForBrowserTabs, 
+                          BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS, 
+                          browserTabIndex);
+    
+    return this->surfaceMontageNodeColoringKeyForBrowserTabs[browserTabIndex];
+}
+
 /**
  * Set the RGBA color components for this a surface montage in the given tab.
  * @param browserTabIndex
  *    Index of browser tab.
  * @param rgbaNodeColorComponents
  *    RGBA color components for this surface montage in the given tab.
+ * @param coloringKey
+ *    Key of the overlays used to create the coloring.
  */
 void 
 SurfaceFile::setSurfaceMontageNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex,
-                                                     const float* rgbaNodeColorComponents)
+                                                     const float* rgbaNodeColorComponents,
+                                                     const uint64_t coloringKey)
 {
     CaretAssertArrayIndex(this->surfaceMontageNodeColoringForBrowserTabs, 
                           BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS, 
@@ -1526,6 +1581,7 @@ SurfaceFile::setSurfaceMontageNodeColoringRgbaForBrowserTab(const int32_t browse
     for (int32_t i = 0; i < numberOfComponentsRGBA; i++) {
         rgba[i] = rgbaNodeColorComponents[i];
     }
+    this->surfaceMontageNodeColoringKeyForBrowserTabs[browserTabIndex] = coloringKey;
 }
 
 
@@ -1551,16 +1607,38 @@ SurfaceFile::getWholeBrainNodeColoringRgbaForBrowserTab(const int32_t browserTab
 }
 
 
+/**
+ * Get the key of the overlays that were used to create the coloring
+ * for this whole brain surface in the given tab.
+ * @param browserTabIndex
+ *    Index of browser tab.
+ * @return
+ *    Key passed when the coloring was set.  Only meaningful when
+ *    the coloring for the tab is valid.
+ */
+uint64_t
+SurfaceFile::getWholeBrainNodeColoringKeyForBrowserTab(const int32_t browserTabIndex) const
+{
+    CaretAssertArrayIndex(this->wholeBrainNodeColoringKeyForBrowserTabs, 
+                          BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS, 
+                          browserTabIndex);
+    
+    return this->wholeBrainNodeColoringKeyForBrowserTabs[browserTabIndex];
+}
+
 /**
  * Set the RGBA color components for this a whole brain surface in the given tab.
  * @param browserTabIndex
  *    Index of browser tab.
  * @param rgbaNodeColorComponents
  *    RGBA color components for this surface in the given tab.
+ * @param coloringKey
+ *    Key of the overlays used to create the coloring.
  */
 void 
 SurfaceFile::setWholeBrainNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex,
-                                                     const float* rgbaNodeColorComponents)
+                                                     const float* rgbaNodeColorComponents,
+                                                     const uint64_t coloringKey)
 {
     CaretAssertArrayIndex(this->wholeBrainNodeColoringForBrowserTabs, 
                           BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS, 
@@ -1573,6 +1651,7 @@ SurfaceFile::setWholeBrainNodeColoringRgbaForBrowserTab(const int32_t browserTab
     for (int32_t i = 0; i < numberOfComponentsRGBA; i++) {
         rgba[i] = rgbaNodeColorComponents[i];
     }
+    this->wholeBrainNodeColoringKeyForBrowserTabs[browserTabIndex] = coloringKey;
 }
 
 /**
@@ -161,18 +161,27 @@ namespace caret {
         
         float* getSurfaceNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex);
         
+        uint64_t getSurfaceNodeColoringKeyForBrowserTab(const int32_t browserTabIndex) const;
+        
         void setSurfaceNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex,
-                                              const float* rgbaNodeColorComponents);
+                                              const float* rgbaNodeColorComponents,
+                                              const uint64_t coloringKey);
         
         float* getSurfaceMontageNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex);
         
+        uint64_t getSurfaceMontageNodeColoringKeyForBrowserTab(const int32_t browserTabIndex) const;
+        
         void setSurfaceMontageNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex,
-                                                     const float* rgbaNodeColorComponents);
+                                                     const float* rgbaNodeColorComponents,
+                                                     const uint64_t coloringKey);
         
         float* getWholeBrainNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex);
         
+        uint64_t getWholeBrainNodeColoringKeyForBrowserTab(const int32_t browserTabIndex) const;
+        
         void setWholeBrainNodeColoringRgbaForBrowserTab(const int32_t browserTabIndex,
-                                              const float* rgbaNodeColorComponents);
+                                              const float* rgbaNodeColorComponents,
+                                              const uint64_t coloringKey);
 
         void invalidateNormals();
         
@@ -230,6 +239,9 @@ namespace caret {
          */
         std::vector<float> surfaceNodeColoringForBrowserTabs[BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS];
         
+        /** Key of the overlays used to create the coloring in surfaceNodeColoringForBrowserTabs */
+        uint64_t surfaceNodeColoringKeyForBrowserTabs[BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS];
+        
         /** 
          * This coloring is used when a surface montage is displayed.
          * Node color components Red, Green, Blue, Alpha for each browser tab.
@@ -238,6 +250,9 @@ namespace caret {
          */
         std::vector<float> surfaceMontageNodeColoringForBrowserTabs[BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS];
         
+        /** Key of the overlays used to create the coloring in surfaceMontageNodeColoringForBrowserTabs */
+        uint64_t surfaceMontageNodeColoringKeyForBrowserTabs[BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS];
+        
         /** 
          * This coloring is used when a Whole Brain is displayed.
          * Node color components Red, Green, Blue, Alpha for each browser tab.
@@ -246,6 +261,9 @@ namespace caret {
          */
         std::vector<float> wholeBrainNodeColoringForBrowserTabs[BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS];
         
+        /** Key of the overlays used to create the coloring in wholeBrainNodeColoringForBrowserTabs */
+        uint64_t wholeBrainNodeColoringKeyForBrowserTabs[BrainConstants::MAXIMUM_NUMBER_OF_BROWSER_TABS];
+        
         /** Points to memory containing the coordinates. */
         float* coordinatePointer;
         
@@ -0,0 +1,249 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "SurfaceHelperCache.h"
+
+#include "CaretAssert.h"
+#include "CaretBinaryFile.h"
+#include "CaretException.h"
+#include "CaretLogger.h"
+#include "CaretPointer.h"
+#include "DataFileException.h"
+#include "FnvHash.h"
+#include "GeodesicHelper.h"
+#include "SurfaceFile.h"
+
+#include <QFileInfo>
+
+#include <cstring>
+#include <new>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+namespace
+{
+    //layout, all in native byte order (the byte order mark rejects a sidecar from a machine with the other order, it is only derived data):
+    //magic[8], int32 version, uint32 byte order mark, uint64 surface hash, int32 nodes, int32 triangles,
+    //float average node spacing, float smallest area correction factor,
+    //int32 neighbor counts[nodes], int32 neighbors[sum], float distances[sum],
+    //int32 neighbor2 counts[nodes], int32 neighbors2[sum2], float distances2[sum2],
+    //int32 crawl edge nodes[2 * sum2], float crawl edge weights[sum2], float crawl piece distances[2 * sum2]
+    const char CACHE_MAGIC[9] = "wbhelpc\0";
+    const int32_t CACHE_VERSION = 1;
+    const uint32_t CACHE_BYTE_ORDER_MARK = 0x01020304;
+
+    template <typename T>
+    void writeArray(CaretBinaryFile& fileOut, const vector<T>& data)
+    {
+        if (!data.empty()) fileOut.write(data.data(), data.size() * sizeof(T));
+    }
+
+    template <typename T>
+    void readArray(CaretBinaryFile& fileIn, vector<T>& data, const int64_t& count)
+    {
+        data.resize(count);
+        if (count > 0) fileIn.read(data.data(), count * sizeof(T));
+    }
+
+    int64_t sumCounts(const vector<int32_t>& counts, const int32_t& numNodes, const int64_t& bytesLeft, const int64_t& bytesPerElement)
+    {//returns -1 if any count is impossible, or the total needs more bytes than are left in the file, so corrupt or truncated sidecars don't cause huge allocations
+        int64_t ret = 0;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i] < 0 || counts[i] > numNodes) return -1;
+            ret += counts[i];
+        }
+        if (ret > bytesLeft / bytesPerElement) return -1;
+        return ret;
+    }
+}
+
+uint64_t SurfaceHelperCache::computeSurfaceHash(const SurfaceFile* surfaceIn)
+{
+    CaretAssert(surfaceIn != NULL);
+    FnvHash hash;
+    const int32_t numNodes = surfaceIn->getNumberOfNodes();
+    const int32_t numTriangles = surfaceIn->getNumberOfTriangles();
+    hash.add(numNodes);
+    hash.add(numTriangles);
+    hash.addBytes(surfaceIn->getCoordinateData(), numNodes * 3 * sizeof(float));
+    for (int32_t i = 0; i < numTriangles; ++i)
+    {
+        hash.addBytes(surfaceIn->getTriangle(i), 3 * sizeof(int32_t));
+    }
+    return hash.getHash();
+}
+
+AString SurfaceHelperCache::getCacheFileName(const AString& surfaceFileName)
+{
+    return surfaceFileName + ".helpercache";
+}
+
+void SurfaceHelperCache::writeCache(const SurfaceFile* surfaceIn, const AString& cacheFileName)
+{
+    CaretAssert(surfaceIn != NULL);
+    GeodesicHelperBase myBase(surfaceIn);
+    const int32_t numNodes = myBase.numNodes;
+    vector<int32_t> counts(numNodes), counts2(numNodes), flatNeighbors, flatNeighbors2, crawlNodes;
+    vector<float> flatDistances, flatDistances2, crawlWeights, crawlPieces;
+    for (int32_t i = 0; i < numNodes; ++i)
+    {
+        counts[i] = (int32_t)myBase.nodeNeighbors[i].size();
+        flatNeighbors.insert(flatNeighbors.end(), myBase.nodeNeighbors[i].begin(), myBase.nodeNeighbors[i].end());
+        flatDistances.insert(flatDistances.end(), myBase.distances[i].begin(), myBase.distances[i].end());
+        counts2[i] = (int32_t)myBase.nodeNeighbors2[i].size();
+        flatNeighbors2.insert(flatNeighbors2.end(), myBase.nodeNeighbors2[i].begin(), myBase.nodeNeighbors2[i].end());
+        flatDistances2.insert(flatDistances2.end(), myBase.distances2[i].begin(), myBase.distances2[i].end());
+        const vector<GeodesicHelperBase::CrawlInfo>& crawl = myBase.neighbors2PathInfo[i];
+        for (size_t j = 0; j < crawl.size(); ++j)
+        {
+            crawlNodes.push_back(crawl[j].edgeNodes[0]);
+            crawlNodes.push_back(crawl[j].edgeNodes[1]);
+            crawlWeights.push_back(crawl[j].edgeWeight);
+            crawlPieces.push_back(crawl[j].pieceDists[0]);
+            crawlPieces.push_back(crawl[j].pieceDists[1]);
+        }
+    }
+    uint64_t hash = computeSurfaceHash(surfaceIn);
+    int32_t header[2] = { CACHE_VERSION, 0 };
+    memcpy(&header[1], &CACHE_BYTE_ORDER_MARK, sizeof(uint32_t));
+    int32_t sizes[2] = { numNodes, surfaceIn->getNumberOfTriangles() };
+    float spacing[2] = { myBase.m_avgNodeSpacing, myBase.m_corrAreaSmallestFactor };
+    CaretBinaryFile fileOut(cacheFileName, CaretBinaryFile::WRITE_TRUNCATE);
+    fileOut.write(CACHE_MAGIC, 8);
+    fileOut.write(header, 2 * sizeof(int32_t));
+    fileOut.write(&hash, sizeof(uint64_t));
+    fileOut.write(sizes, 2 * sizeof(int32_t));
+    fileOut.write(spacing, 2 * sizeof(float));
+    writeArray(fileOut, counts);
+    writeArray(fileOut, flatNeighbors);
+    writeArray(fileOut, flatDistances);
+    writeArray(fileOut, counts2);
+    writeArray(fileOut, flatNeighbors2);
+    writeArray(fileOut, flatDistances2);
+    writeArray(fileOut, crawlNodes);
+    writeArray(fileOut, crawlWeights);
+    writeArray(fileOut, crawlPieces);
+    fileOut.close();
+}
+
+GeodesicHelperBase* SurfaceHelperCache::readGeodesicBase(const SurfaceFile* surfaceIn)
+{
+    CaretAssert(surfaceIn != NULL);
+    const AString surfaceFileName = surfaceIn->getFileName();
+    if (surfaceFileName.isEmpty()) return NULL;
+    const AString cacheFileName = getCacheFileName(surfaceFileName);
+    const QFileInfo cacheInfo(cacheFileName);
+    if (!cacheInfo.isFile()) return NULL;//no sidecar is the normal case, so don't log it
+    const int64_t fileSize = cacheInfo.size();
+    const int32_t numNodes = surfaceIn->getNumberOfNodes();
+    try
+    {
+        CaretBinaryFile fileIn(cacheFileName);
+        char magic[8];
+        int32_t header[2], sizes[2];
+        uint64_t hash;
+        float spacing[2];
+        uint32_t byteOrderMark;
+        fileIn.read(magic, 8);
+        fileIn.read(header, 2 * sizeof(int32_t));
+        memcpy(&byteOrderMark, &header[1], sizeof(uint32_t));
+        if (memcmp(magic, CACHE_MAGIC, 8) != 0 || header[0] != CACHE_VERSION || byteOrderMark != CACHE_BYTE_ORDER_MARK)
+        {
+            CaretLogInfo("ignoring helper cache '" + cacheFileName + "', it has an unsupported format or byte order");
+            return NULL;
+        }
+        fileIn.read(&hash, sizeof(uint64_t));
+        fileIn.read(sizes, 2 * sizeof(int32_t));
+        if (sizes[0] != numNodes || sizes[1] != surfaceIn->getNumberOfTriangles() || hash != computeSurfaceHash(surfaceIn))
+        {
+            CaretLogInfo("ignoring helper cache '" + cacheFileName + "', it was built from a different surface");
+            return NULL;
+        }
+        fileIn.read(spacing, 2 * sizeof(float));
+        vector<int32_t> counts, counts2, flatNeighbors, flatNeighbors2, crawlNodes;
+        vector<float> flatDistances, flatDistances2, crawlWeights, crawlPieces;
+        readArray(fileIn, counts, numNodes);
+        const int64_t total = sumCounts(counts, numNodes, fileSize - fileIn.pos(), sizeof(int32_t) + sizeof(float));
+        if (total < 0) throw DataFileException("invalid neighbor count");
+        readArray(fileIn, flatNeighbors, total);
+        readArray(fileIn, flatDistances, total);
+        readArray(fileIn, counts2, numNodes);
+        const int64_t total2 = sumCounts(counts2, numNodes, fileSize - fileIn.pos(), 3 * sizeof(int32_t) + 4 * sizeof(float));//neighbor, distance, 2 crawl nodes, crawl weight, 2 crawl pieces
+        if (total2 < 0) throw DataFileException("invalid neighbor count");
+        readArray(fileIn, flatNeighbors2, total2);
+        readArray(fileIn, flatDistances2, total2);
+        readArray(fileIn, crawlNodes, 2 * total2);
+        readArray(fileIn, crawlWeights, total2);
+        readArray(fileIn, crawlPieces, 2 * total2);
+        for (int64_t i = 0; i < total; ++i)
+        {
+            if (flatNeighbors[i] < 0 || flatNeighbors[i] >= numNodes) throw DataFileException("invalid neighbor index");
+        }
+        for (int64_t i = 0; i < total2; ++i)
+        {
+            if (flatNeighbors2[i] < 0 || flatNeighbors2[i] >= numNodes) throw DataFileException("invalid neighbor index");
+        }
+        for (int64_t i = 0; i < 2 * total2; ++i)
+        {
+            if (crawlNodes[i] < 0 || crawlNodes[i] >= numNodes) throw DataFileException("invalid neighbor index");
+        }
+        CaretPointer<GeodesicHelperBase> ret(new GeodesicHelperBase());//in case of bad_alloc
+        ret->numNodes = numNodes;
+        ret->m_avgNodeSpacing = spacing[0];
+        ret->m_corrAreaSmallestFactor = spacing[1];
+        ret->nodeCoords.resize(numNodes);
+        ret->nodeNeighbors.resize(numNodes);
+        ret->distances.resize(numNodes);
+        ret->nodeNeighbors2.resize(numNodes);
+        ret->distances2.resize(numNodes);
+        ret->neighbors2PathInfo.resize(numNodes);
+        int64_t offset = 0, offset2 = 0;
+        for (int32_t i = 0; i < numNodes; ++i)
+        {
+            ret->nodeCoords[i] = surfaceIn->getCoordinate(i);
+            ret->nodeNeighbors[i].assign(flatNeighbors.begin() + offset, flatNeighbors.begin() + offset + counts[i]);
+            ret->distances[i].assign(flatDistances.begin() + offset, flatDistances.begin() + offset + counts[i]);
+            offset += counts[i];
+            ret->nodeNeighbors2[i].assign(flatNeighbors2.begin() + offset2, flatNeighbors2.begin() + offset2 + counts2[i]);
+            ret->distances2[i].assign(flatDistances2.begin() + offset2, flatDistances2.begin() + offset2 + counts2[i]);
+            vector<GeodesicHelperBase::CrawlInfo>& crawl = ret->neighbors2PathInfo[i];
+            crawl.resize(counts2[i]);
+            for (int32_t j = 0; j < counts2[i]; ++j)
+            {
+                const int64_t index = offset2 + j;
+                crawl[j].edgeNodes[0] = crawlNodes[2 * index];
+                crawl[j].edgeNodes[1] = crawlNodes[2 * index + 1];
+                crawl[j].edgeWeight = crawlWeights[index];
+                crawl[j].pieceDists[0] = crawlPieces[2 * index];
+                crawl[j].pieceDists[1] = crawlPieces[2 * index + 1];
+            }
+            offset2 += counts2[i];
+        }
+        return ret.releasePointer();
+    } catch (CaretException& e) {
+        CaretLogWarning("ignoring helper cache '" + cacheFileName + "': " + e.whatString());
+    } catch (std::bad_alloc&) {
+        CaretLogWarning("ignoring helper cache '" + cacheFileName + "', not enough memory to read it");
+    }
+    return NULL;
+}
@@ -0,0 +1,54 @@
+#ifndef __SURFACE_HELPER_CACHE_H__
+#define __SURFACE_HELPER_CACHE_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "AString.h"
+
+#include <stdint.h>
+
+namespace caret {
+
+    class GeodesicHelperBase;
+    class SurfaceFile;
+
+    ///binary sidecar file next to a surface, holding helper structures that are slow to build, currently the geodesic base (neighbors and the neighbors-2 crawl)
+    ///the sidecar is keyed by a hash of the coordinates and topology, so a stale or foreign sidecar is ignored rather than used
+    class SurfaceHelperCache
+    {
+        SurfaceHelperCache();
+    public:
+        ///hash of the node count, coordinates, and triangles of the surface
+        static uint64_t computeSurfaceHash(const SurfaceFile* surfaceIn);
+
+        ///name of the sidecar for a surface file name
+        static AString getCacheFileName(const AString& surfaceFileName);
+
+        ///build the geodesic base for the surface and write the sidecar, throws DataFileException on failure
+        static void writeCache(const SurfaceFile* surfaceIn, const AString& cacheFileName);
+
+        ///returns a new geodesic base from the surface's sidecar, or NULL if there is no valid sidecar for this surface
+        static GeodesicHelperBase* readGeodesicBase(const SurfaceFile* surfaceIn);
+    };
+
+}
+
+#endif //__SURFACE_HELPER_CACHE_H__
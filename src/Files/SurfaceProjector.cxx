@@ -18,6 +18,7 @@
  */
 /*LICENSE_END*/
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <limits>
@@ -27,6 +28,7 @@
 #undef __SURFACE_PROJECTOR_DEFINE__
 
 #include "CaretLogger.h"
+#include "CaretOMP.h"
 #include "FociFile.h"
 #include "Focus.h"
 #include "MathFunctions.h"
@@ -109,6 +111,29 @@ m_surfaceFileRight(rightSurfaceFile),
 m_surfaceFileCerebellum(cerebellumSurfaceFile),
 m_mode(MODE_LEFT_RIGHT_CEREBELLUM)
 {
+    initializeMembersSurfaceProjector();
+}
+
+/**
+ * Copy constructor.  Only used to give each thread its own projector
+ * when projecting a foci file since projection keeps the state of the
+ * item being projected in members.
+ *
+ * @param o
+ *     Projector that is copied.
+ */
+SurfaceProjector::SurfaceProjector(const SurfaceProjector& o)
+: CaretObject(o),
+m_surfaceFiles(o.m_surfaceFiles),
+m_surfaceFileLeft(o.m_surfaceFileLeft),
+m_surfaceFileRight(o.m_surfaceFileRight),
+m_surfaceFileCerebellum(o.m_surfaceFileCerebellum),
+m_mode(o.m_mode)
+{
+    initializeMembersSurfaceProjector();
+    m_surfaceOffset = o.m_surfaceOffset;
+    m_surfaceOffsetValid = o.m_surfaceOffsetValid;
+    m_validateFlag = o.m_validateFlag;
 }
 
 
@@ -135,6 +160,47 @@ SurfaceProjector::initializeMembersSurfaceProjector()
      */
     m_validateFlag = CaretLogger::getLogger()->isFine();
     m_validateItemName = "";
+    m_allowEdgeProjection = true;
+    m_perturbationSeed = 1;
+}
+
+/**
+ * Create the helpers (search octree, topology, bounding box) of the
+ * projection surfaces.  The surface files create these on first use
+ * so doing it before projecting in parallel keeps threads from waiting
+ * on each other while the first one builds them.
+ */
+void
+SurfaceProjector::initializeSurfaceHelpers() const
+{
+    std::vector<const SurfaceFile*> surfaceFiles = m_surfaceFiles;
+    surfaceFiles.push_back(m_surfaceFileLeft);
+    surfaceFiles.push_back(m_surfaceFileRight);
+    surfaceFiles.push_back(m_surfaceFileCerebellum);
+    
+    const int32_t numberOfSurfaceFiles = static_cast<int32_t>(surfaceFiles.size());
+    for (int32_t i = 0; i < numberOfSurfaceFiles; i++) {
+        const SurfaceFile* sf = surfaceFiles[i];
+        if ((sf != NULL)
+            && (sf->getNumberOfNodes() > 0)
+            && (sf->getNumberOfTriangles() > 0)) {
+            sf->getTopologyHelper();
+            sf->getSignedDistanceHelper();
+        }
+    }
+}
+
+/**
+ * @return A pseudo-random number in [0, 1] for perturbing an item
+ * whose projection has too much error.  Uses the projector's own
+ * seed so that results do not depend upon which thread projected
+ * the item.
+ */
+float
+SurfaceProjector::getPerturbationRandom()
+{
+    m_perturbationSeed = m_perturbationSeed * 1103515245u + 12345u;
+    return static_cast<float>((m_perturbationSeed >> 8) & 0xFFFFFF) / static_cast<float>(0xFFFFFF);
 }
 
 
@@ -152,7 +218,9 @@ SurfaceProjector::setSurfaceOffset(const float surfaceOffset)
 }
 
 /**
- * Project all foci in a foci file.
+ * Project all foci in a foci file.  Foci are independent of each
+ * other so they are projected in parallel, each thread using its
+ * own copy of this projector.
  * @param fociFile
  *     The foci file.
  * @throws SurfaceProjectorException
@@ -163,29 +231,66 @@ SurfaceProjector::projectFociFile(FociFile* fociFile)
 {
     CaretAssert(fociFile);
     const int32_t numberOfFoci = fociFile->getNumberOfFoci();
+    if (numberOfFoci <= 0) {
+        return;
+    }
+    
+    initializeSurfaceHelpers();
+    
+    /*
+     * Messages are kept by focus index and reported after projection
+     * so that they are in the same order as the foci.
+     */
+    std::vector<AString> errorMessages(numberOfFoci);
+    std::vector<AString> warningMessages(numberOfFoci);
+    
+    /*
+     * Validation logs from inside the projection so do not use threads.
+     * Debug builds track CaretObject allocations in a map that is not
+     * thread safe and projection creates CaretObjects.
+     */
+    bool parallelFlag = (m_validateFlag == false);
+#ifndef NDEBUG
+    parallelFlag = false;
+#endif
+    
+#pragma omp CARET_PAR if (parallelFlag)
+    {
+        SurfaceProjector threadProjector(*this);
+#pragma omp CARET_FOR schedule(dynamic, 8)
+        for (int32_t i = 0; i < numberOfFoci; i++) {
+            Focus* focus = fociFile->getFocus(i);
+            try {
+                if (threadProjector.m_validateFlag) {
+                    threadProjector.m_validateItemName = ("Focus "
+                                                          + AString::number(i)
+                                                          + ", "
+                                                          + focus->getName());
+                }
+                threadProjector.projectFocusPrivate(i,
+                                                    focus,
+                                                    warningMessages[i]);
+            }
+            catch (const SurfaceProjectorException& spe) {
+                errorMessages[i] = (focus->getName()
+                                    + ", index="
+                                    + AString::number(i)
+                                    + ": "
+                                    + spe.whatString());
+            }
+        }
+    }
     
     AString errorMessage = "";
     for (int32_t i = 0; i < numberOfFoci; i++) {
-        Focus* focus = fociFile->getFocus(i);
-        try {
-            if (m_validateFlag) {
-                m_validateItemName = ("Focus "
-                                      + AString::number(i)
-                                      + ", "
-                                      + focus->getName());
-            }
-            projectFocus(i,
-                         focus);
+        if (warningMessages[i].isEmpty() == false) {
+            CaretLogWarning(warningMessages[i]);
         }
-        catch (const SurfaceProjectorException& spe) {
+        if (errorMessages[i].isEmpty() == false) {
             if (errorMessage.isEmpty() == false) {
                 errorMessage += "\n";
             }
-            errorMessage += (focus->getName()
-                             + ", index="
-                             + AString::number(i)
-                             + ": "
-                             + spe.whatString());
+            errorMessage += errorMessages[i];
         }
     }
     
@@ -207,6 +312,33 @@ void
 SurfaceProjector::projectFocus(const int32_t focusIndex,
                                Focus* focus)
 {
+    AString warningMessage;
+    projectFocusPrivate(focusIndex,
+                        focus,
+                        warningMessage);
+    if (warningMessage.isEmpty() == false) {
+        CaretLogWarning(warningMessage);
+    }
+}
+
+/**
+ * Project a focus without logging.
+ * @param focusIndex
+ *    Index of the focus (negative indicates no index)
+ * @param focus
+ *    The focus.
+ * @param warningMessageOut
+ *    Output containing a warning for the focus, empty if none.
+ * @throws SurfaceProjectorException
+ *      If projecting an item failed.
+ */
+void
+SurfaceProjector::projectFocusPrivate(const int32_t focusIndex,
+                                      Focus* focus,
+                                      AString& warningMessageOut)
+{
+    warningMessageOut = "";
+    
     const int32_t numberOfProjections = focus->getNumberOfProjections();
     CaretAssert(numberOfProjections > 0);
     if (numberOfProjections < 0) {
@@ -220,6 +352,11 @@ SurfaceProjector::projectFocus(const int32_t focusIndex,
         spiSecond = new SurfaceProjectedItem();
     }
     
+    /*
+     * Seed from the focus index so a focus is always perturbed the same way
+     */
+    m_perturbationSeed = static_cast<uint32_t>(std::max(focusIndex, 0)) + 1;
+    
     m_allowEdgeProjection = true;
     projectItem(spi,
                 spiSecond);
@@ -235,15 +372,14 @@ SurfaceProjector::projectFocus(const int32_t focusIndex,
     }
     
     if (m_projectionWarning.isEmpty() == false) {
-        AString msg = ("Focus: Name="
-                       + focus->getName());
+        warningMessageOut = ("Focus: Name="
+                             + focus->getName());
         if (focusIndex >= 0) {
-            msg += (", Index="
-                    + AString::number(focusIndex));
+            warningMessageOut += (", Index="
+                                  + AString::number(focusIndex));
         }
-        msg += (": "
-                + m_projectionWarning);
-        CaretLogWarning(msg);;
+        warningMessageOut += (": "
+                              + m_projectionWarning);
     }
 }
 
@@ -501,7 +637,7 @@ SurfaceProjector::projectItemToSurfaceFile(const SurfaceFile* surfaceFile,
             const float originalDistanceError = distanceError;
             
             for (int32_t iTry = 0; iTry < 10; iTry++) {
-                const float randomZeroToOne = ((float)std::rand()) / ((float)RAND_MAX);
+                const float randomZeroToOne = getPerturbationRandom();
                 const float randomPlusMinusOneHalf = randomZeroToOne - 0.5;
                 const float moveLittleBit = randomPlusMinusOneHalf * 0.5;
                 xyz[0] = originalXYZ[0] + moveLittleBit;
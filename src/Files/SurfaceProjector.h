@@ -28,6 +28,7 @@
 #include <stdint.h>
 
 #include <set>
+#include <vector>
 
 namespace caret {
     
@@ -122,6 +123,14 @@ namespace caret {
 
         void initializeMembersSurfaceProjector();
         
+        void initializeSurfaceHelpers() const;
+        
+        void projectFocusPrivate(const int32_t focusIndex,
+                                 Focus* focus,
+                                 AString& warningMessageOut);
+        
+        float getPerturbationRandom();
+        
         void getProjectionLocation(const SurfaceFile* surfaceFile,
                                    const float xyz[3],
                                    ProjectionLocation& projectionLocation) const;
@@ -197,6 +206,9 @@ namespace caret {
         
         AString m_projectionWarning;
         
+        /** Seed for the small moves made when a projection has too much error */
+        uint32_t m_perturbationSeed;
+        
         /** Point in triangle test tolerance that requires point inside triangle */
         static float s_normalTriangleAreaTolerance;
         
@@ -52,6 +52,7 @@ using namespace std;
 
 const float VolumeFile::INVALID_INTERP_VALUE = 0.0f;//we may want NaN or something more obvious
 bool VolumeFile::s_voxelColoringEnabled = true;
+bool VolumeFile::s_nativeStorageEnabled = true;
 
 /**
  * Static method that sets the status of voxel coloring.  Coloring may take
@@ -73,6 +74,39 @@ VolumeFile::setVoxelColoringEnabled(const bool enabled)
                            : "Volume coloring is disabled."));
 }
 
+/**
+ * Static method that sets whether volumes with 8 or 16 bit integer data are
+ * kept in memory as that type when read, rather than converted to float.
+ * Label volumes are kept as integers regardless.  Only affects files read
+ * after the call.
+ *
+ * @param enabled
+ *    New status for native storage.
+ */
+void
+VolumeFile::setNativeStorageEnabled(const bool enabled)
+{
+    s_nativeStorageEnabled = enabled;
+    
+    CaretLogConfig(AString(s_nativeStorageEnabled
+                              ? "Volume native integer storage is enabled."
+                           : "Volume native integer storage is disabled."));
+}
+
+namespace
+{
+    template<typename T>
+    void readNativeFrames(NiftiIO& myIO, VolumeFile* myVol, const int& fullDims, const vector<int64_t>& extraDims, const int64_t& frameSize)
+    {
+        vector<T> tempFrame(frameSize);
+        for (MultiDimIterator<int64_t> myiter(extraDims); !myiter.atEnd(); ++myiter)
+        {
+            myIO.readData(tempFrame.data(), fullDims, *myiter, false, false);//scaling is applied when converting to float
+            myVol->setNativeFrame(tempFrame.data(), myVol->getBrickIndexFromNonSpatialIndexes(*myiter));
+        }
+    }
+}
+
 
 VolumeFile::VolumeFile()
 : VolumeBase(), CaretMappableDataFile(DataFileTypeEnum::VOLUME)
@@ -236,8 +270,55 @@ void VolumeFile::readFile(const AString& filename)
         reinitialize(myDims, inHeader.getSForm(), numComponents);
         setFileName(filename);  // must be donw after reinitialize() since it calls clear() which clears the name of the file
         int64_t frameSize = myDims[0] * myDims[1] * myDims[2];
-        if (numComponents != 1)
+        StorageType nativeType = STORAGE_FLOAT32;
+        if (numComponents == 1)
         {
+            switch (inHeader.getDataType())
+            {
+                case NIFTI_TYPE_UINT8:
+                    nativeType = STORAGE_UINT8;
+                    break;
+                case NIFTI_TYPE_INT8:
+                    nativeType = STORAGE_INT8;
+                    break;
+                case NIFTI_TYPE_UINT16:
+                    nativeType = STORAGE_UINT16;
+                    break;
+                case NIFTI_TYPE_INT16:
+                    nativeType = STORAGE_INT16;
+                    break;
+                default:
+                    break;
+            }
+        }
+        if (nativeType != STORAGE_FLOAT32)
+        {
+            double mult = 1.0, offset = 0.0;
+            if (!inHeader.getDataScaling(mult, offset))
+            {
+                mult = 1.0;
+                offset = 0.0;
+            }
+            setNativeStorage(nativeType, mult, offset);
+            switch (nativeType)
+            {
+                case STORAGE_UINT8:
+                    readNativeFrames<uint8_t>(myIO, this, fullDims, extraDims, frameSize);
+                    break;
+                case STORAGE_INT8:
+                    readNativeFrames<int8_t>(myIO, this, fullDims, extraDims, frameSize);
+                    break;
+                case STORAGE_UINT16:
+                    readNativeFrames<uint16_t>(myIO, this, fullDims, extraDims, frameSize);
+                    break;
+                case STORAGE_INT16:
+                    readNativeFrames<int16_t>(myIO, this, fullDims, extraDims, frameSize);
+                    break;
+                case STORAGE_FLOAT32:
+                    CaretAssert(false);
+                    break;
+            }
+        } else if (numComponents != 1) {
             vector<float> tempFrame(frameSize), readBuffer(frameSize * numComponents);
             for (MultiDimIterator<int64_t> myiter(extraDims); !myiter.atEnd(); ++myiter)
             {
@@ -265,6 +346,10 @@ void VolumeFile::readFile(const AString& filename)
                      + " seconds.");
         m_header.grabNew(new NiftiHeader(inHeader));//end nifti-specific code
         parseExtensions();
+        if (!s_nativeStorageEnabled && getStorageType() != STORAGE_FLOAT32 && getType() != SubvolumeAttributes::LABEL)
+        {
+            convertToFloatStorage();//we don't know it is a label volume until after reading the extension
+        }
         clearModified();
     }
     
@@ -326,9 +411,22 @@ VolumeFile::writeFile(const AString& filename)
     {
         extraDims = vector<int64_t>(origDims.begin() + 3, origDims.end());
     }
+    vector<float> tempFrame;
+    if (getStorageType() != STORAGE_FLOAT32)
+    {
+        const int64_t* dims = getDimensionsPtr();
+        tempFrame.resize(dims[0] * dims[1] * dims[2]);
+    }
     for (MultiDimIterator<int64_t> myiter(extraDims); !myiter.atEnd(); ++myiter)
     {
-        myIO.writeData(getFrame(getBrickIndexFromNonSpatialIndexes(*myiter)), 3, *myiter);//NOTE: does not deal with multi-component volumes
+        int64_t brick = getBrickIndexFromNonSpatialIndexes(*myiter);
+        if (tempFrame.empty())
+        {
+            myIO.writeData(getFrame(brick), 3, *myiter);//NOTE: does not deal with multi-component volumes
+        } else {
+            getFrameCopy(tempFrame.data(), brick);//don't keep float copies of every frame just to write them
+            myIO.writeData(tempFrame.data(), 3, *myiter);
+        }
     }
     m_header.grabNew(new NiftiHeader(outHeader));//update header to last written version, end nifti-specific code
     
@@ -450,7 +548,8 @@ void VolumeFile::validateSpline(const int64_t brickIndex, const int64_t componen
         CaretMutexLocker locked(&m_splineMutex);//prevent concurrent modify access to spline state
         if (!m_frameSplineValid[whichFrame])//double check
         {
-            m_frameSplines[whichFrame] = VolumeSpline(getFrame(brickIndex, component), dimensions);
+            vector<float> scratchFrame;
+            m_frameSplines[whichFrame] = VolumeSpline(getFrameUncached(scratchFrame, brickIndex, component), dimensions);
             if (m_frameSplines[whichFrame].ignoredNonNumeric())
             {
                 CaretLogWarning("ignored non-numeric input value when calculating cubic splines in volume '" + getFileName() + "', frame #" + AString::number(brickIndex + 1));
@@ -837,7 +936,8 @@ const FastStatistics* VolumeFile::getMapFastStatistics(const int32_t mapIndex)
     const int64_t* dimensions = getDimensionsPtr();
     if (m_brickAttributes[mapIndex].m_fastStatistics == NULL)
     {
-        m_brickAttributes[mapIndex].m_fastStatistics.grabNew(new FastStatistics(getFrame(mapIndex), dimensions[0] * dimensions[1] * dimensions[2]));
+        vector<float> scratchFrame;
+        m_brickAttributes[mapIndex].m_fastStatistics.grabNew(new FastStatistics(getFrameUncached(scratchFrame, mapIndex), dimensions[0] * dimensions[1] * dimensions[2]));
     }
     return m_brickAttributes[mapIndex].m_fastStatistics;
 }
@@ -849,7 +949,8 @@ const Histogram* VolumeFile::getMapHistogram(const int32_t mapIndex)
     const int64_t* dimensions = getDimensionsPtr();
     if (m_brickAttributes[mapIndex].m_histogram == NULL)
     {
-        m_brickAttributes[mapIndex].m_histogram.grabNew(new Histogram(100, getFrame(mapIndex), dimensions[0] * dimensions[1] * dimensions[2]));
+        vector<float> scratchFrame;
+        m_brickAttributes[mapIndex].m_histogram.grabNew(new Histogram(100, getFrameUncached(scratchFrame, mapIndex), dimensions[0] * dimensions[1] * dimensions[2]));
     }
     return m_brickAttributes[mapIndex].m_histogram;
 }
@@ -898,7 +999,8 @@ VolumeFile::getMapHistogram(const int32_t mapIndex,
     }
     
     if (updateHistogramFlag) {
-        m_brickAttributes[mapIndex].m_histogramLimitedValues->update(getFrame(mapIndex),
+        vector<float> scratchFrame;
+        m_brickAttributes[mapIndex].m_histogramLimitedValues->update(getFrameUncached(scratchFrame, mapIndex),
                                                                      dimensions[0] * dimensions[1] * dimensions[2],
                                                                      mostPositiveValueInclusive,
                                                                      leastPositiveValueInclusive,
@@ -1076,13 +1178,9 @@ VolumeFile::getFileData(std::vector<float>& dataOut) const
     int64_t dataOffset = 0;
     
     for (int iMap = 0; iMap < numMaps; iMap++) {
-        const float* mapData = getFrame(iMap);
-        
-        for (int64_t i = 0; i < mapSize; i++) {
-            CaretAssertVectorIndex(dataOut, dataOffset);
-            dataOut[dataOffset] = mapData[i];
-            ++dataOffset;
-        }
+        CaretAssertVectorIndex(dataOut, dataOffset + mapSize - 1);
+        getFrameCopy(dataOut.data() + dataOffset, iMap);
+        dataOffset += mapSize;
     }
     
     CaretAssert(dataOffset == static_cast<int64_t>(dataOut.size()));
@@ -1688,13 +1786,35 @@ VolumeFile::getDataRangeFromAllMaps(float& dataRangeMinimumOut,
     
     const int64_t* dimensions = getDimensionsPtr();
     int64_t m_dataSize = dimensions[0] * dimensions[1] * dimensions[2] * dimensions[3] * dimensions[4];
-    const float* data = getFrame();//HACK: use first frame knowing all data is contiguous after it
-    for (int64_t i = 0; i < m_dataSize; i++) {
-        if (data[i] > m_dataRangeMaximum) {
-            m_dataRangeMaximum = data[i];
+    if (getStorageType() == STORAGE_FLOAT32) {
+        const float* data = getFrame();//HACK: use first frame knowing all data is contiguous after it
+        for (int64_t i = 0; i < m_dataSize; i++) {
+            if (data[i] > m_dataRangeMaximum) {
+                m_dataRangeMaximum = data[i];
+            }
+            if (data[i] < m_dataRangeMinimum) {
+                m_dataRangeMinimum = data[i];
+            }
         }
-        if (data[i] < m_dataRangeMinimum) {
-            m_dataRangeMinimum = data[i];
+    }
+    else {
+        /*
+         * Integer storage is not contiguous as float, convert a frame at a time
+         */
+        const int64_t frameSize = dimensions[0] * dimensions[1] * dimensions[2];
+        std::vector<float> frameData(frameSize);
+        for (int64_t c = 0; c < dimensions[4]; c++) {
+            for (int64_t b = 0; b < dimensions[3]; b++) {
+                getFrameCopy(frameData.data(), b, c);
+                for (int64_t i = 0; i < frameSize; i++) {
+                    if (frameData[i] > m_dataRangeMaximum) {
+                        m_dataRangeMaximum = frameData[i];
+                    }
+                    if (frameData[i] < m_dataRangeMinimum) {
+                        m_dataRangeMinimum = frameData[i];
+                    }
+                }
+            }
         }
     }
     
@@ -143,6 +143,12 @@ namespace caret {
         
         static void setVoxelColoringEnabled(const bool enabled);
         
+        /** Keep 8 and 16 bit integer volumes in their file type when reading.  Saves memory when many volumes are loaded, but costs
+            extra memory when most frames are used as float anyway, as most commands do.  Integer label volumes are always kept native */
+        static bool s_nativeStorageEnabled;
+        
+        static void setNativeStorageEnabled(const bool enabled);
+        
         VolumeFile();
         VolumeFile(const std::vector<int64_t>& dimensionsIn, const std::vector<std::vector<float> >& indexToSpace, const int64_t numComponents = 1, SubvolumeAttributes::VolumeType whatType = SubvolumeAttributes::ANATOMY);
         ~VolumeFile();
@@ -107,9 +107,11 @@ VolumeFileVoxelColorizer::assignVoxelColorsForMap(const int32_t mapIndex,
     timer.start();
     
     /*
-     * Pointer to map's data 
+     * Pointer to map's data, integer volumes are converted into scratch
+     * memory so that coloring doesn't keep a float copy of every map
      */
-    const float* mapDataPointer = m_volumeFile->getFrame(mapIndex);
+    std::vector<float> mapScratch;
+    const float* mapDataPointer = m_volumeFile->getFrameUncached(mapScratch, mapIndex);
     
     /*
      * Get access to threshold data
@@ -187,13 +189,14 @@ VolumeFileVoxelColorizer::assignVoxelColorsForMap(const int32_t mapIndex,
             const int32_t numberOfComponents = m_volumeFile->getNumberOfComponents();
             if ((numberOfComponents == 3)
                 || (numberOfComponents == 4)) {
+                std::vector<float> redScratch, greenScratch, blueScratch, alphaScratch;
                 const float* alphaComponents = ((numberOfComponents == 4)
-                                                ? m_volumeFile->getFrame(mapIndex, 3)
+                                                ? m_volumeFile->getFrameUncached(alphaScratch, mapIndex, 3)
                                                 : NULL);
                 
-                NodeAndVoxelColoring::colorScalarsWithRGBA(m_volumeFile->getFrame(mapIndex, 0),
-                                                           m_volumeFile->getFrame(mapIndex, 1),
-                                                           m_volumeFile->getFrame(mapIndex, 2),
+                NodeAndVoxelColoring::colorScalarsWithRGBA(m_volumeFile->getFrameUncached(redScratch, mapIndex, 0),
+                                                           m_volumeFile->getFrameUncached(greenScratch, mapIndex, 1),
+                                                           m_volumeFile->getFrameUncached(blueScratch, mapIndex, 2),
                                                            alphaComponents,
                                                            m_voxelCountPerMap,
                                                            thresholdRGB,
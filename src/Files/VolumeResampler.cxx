@@ -0,0 +1,186 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026  Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "VolumeResampler.h"
+
+#include "CaretAssert.h"
+#include "CaretLogger.h"
+#include "CaretOMP.h"
+#include "CaretPointer.h"
+#include "VolumeSpline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+namespace
+{
+    const int64_t BATCH_MEMORY_FLOATS = 1 << 27;//512MB of splines and output frames per batch
+    const int64_t MAX_BATCH_FRAMES = 64;
+
+    inline bool inRange(const int64_t& index, const int64_t& dim)
+    {
+        return index >= 0 && index < dim;
+    }
+}
+
+VolumeResampler::VolumeResampler(const VolumeFile* inVol, const VolumeFile::InterpType& method)
+{
+    CaretAssert(inVol != NULL);
+    m_inVol = inVol;
+    m_method = method;
+    const int64_t* inDims = inVol->getDimensionsPtr();
+    if (inDims[0] == 1 || inDims[1] == 1 || inDims[2] == 1)
+    {
+        m_method = VolumeFile::ENCLOSING_VOXEL;//same as interpolateValue, CUBIC and TRILINEAR need adjacent slices
+    }
+}
+
+void VolumeResampler::resample(const SampleMapping& mapping, VolumeFile* outVol) const
+{
+    const int64_t* inDims = m_inVol->getDimensionsPtr();
+    const int64_t* outDims = outVol->getDimensionsPtr();
+    CaretAssert(inDims[3] == outDims[3] && inDims[4] == outDims[4]);
+    const int64_t numMaps = inDims[3], numFrames = inDims[3] * inDims[4];
+    const int64_t inFrameSize = inDims[0] * inDims[1] * inDims[2], outFrameSize = outDims[0] * outDims[1] * outDims[2];
+    const int64_t inRowStep = inDims[0], inSliceStep = inDims[0] * inDims[1];
+    int64_t perFrameFloats = outFrameSize + (m_method == VolumeFile::CUBIC ? inFrameSize : 0);
+    int64_t batchFrames = max((int64_t)1, min(MAX_BATCH_FRAMES, BATCH_MEMORY_FLOATS / max((int64_t)1, perFrameFloats)));
+    batchFrames = min(batchFrames, numFrames);
+    vector<vector<float> > outFrames(batchFrames, vector<float>(outFrameSize));
+    vector<VolumeSpline> splines;
+    vector<const float*> inFrames(batchFrames);
+    for (int64_t batchStart = 0; batchStart < numFrames; batchStart += batchFrames)
+    {
+        const int64_t batchCount = min(batchFrames, numFrames - batchStart);
+        for (int64_t f = 0; f < batchCount; ++f)
+        {
+            inFrames[f] = m_inVol->getFrame((batchStart + f) % numMaps, (batchStart + f) / numMaps);
+        }
+        if (m_method == VolumeFile::CUBIC)
+        {
+            splines = vector<VolumeSpline>(batchCount);//release the previous batch before allocating the next
+            if (batchCount > 1)
+            {//deconvolving is parallel inside each frame, but parallel across frames scales better
+#pragma omp CARET_PARFOR schedule(dynamic)
+                for (int64_t f = 0; f < batchCount; ++f)
+                {
+                    splines[f] = VolumeSpline(inFrames[f], inDims);
+                }
+            } else {
+                splines[0] = VolumeSpline(inFrames[0], inDims);
+            }
+            for (int64_t f = 0; f < batchCount; ++f)
+            {
+                if (splines[f].ignoredNonNumeric())
+                {
+                    CaretLogWarning("ignored non-numeric input value when calculating cubic splines in volume '" + m_inVol->getFileName() +
+                                    "', frame #" + AString::number((batchStart + f) % numMaps + 1));
+                }
+            }
+        }
+#pragma omp CARET_PAR
+        {
+            vector<float> indexCoords(outDims[0] * 3);
+            CaretArray<bool> valid(outDims[0]);
+#pragma omp CARET_FOR schedule(dynamic)
+            for (int64_t row = 0; row < outDims[1] * outDims[2]; ++row)
+            {
+                const int64_t j = row % outDims[1], k = row / outDims[1];
+                const int64_t rowBase = outDims[0] * row;
+                mapping.getRow(j, k, indexCoords.data(), valid.getArray());
+                for (int64_t i = 0; i < outDims[0]; ++i)
+                {
+                    const float* index = indexCoords.data() + i * 3;
+                    const int64_t outIndex = rowBase + i;
+                    switch (m_method)
+                    {
+                        case VolumeFile::CUBIC:
+                        case VolumeFile::TRILINEAR:
+                        {
+                            int64_t low[3] = { (int64_t)floor(index[0]), (int64_t)floor(index[1]), (int64_t)floor(index[2]) };
+                            if (!valid[i] || !inRange(low[0], inDims[0] - 1) || !inRange(low[1], inDims[1] - 1) || !inRange(low[2], inDims[2] - 1))
+                            {//low and low + 1 must both be in the volume
+                                for (int64_t f = 0; f < batchCount; ++f)
+                                {
+                                    outFrames[f][outIndex] = VolumeFile::INVALID_INTERP_VALUE;
+                                }
+                                break;
+                            }
+                            if (m_method == VolumeFile::CUBIC)
+                            {
+                                VolumeSpline::SampleWeights weights;
+                                VolumeSpline::getSampleWeights(inDims, index[0], index[1], index[2], weights);
+                                for (int64_t f = 0; f < batchCount; ++f)
+                                {
+                                    outFrames[f][outIndex] = splines[f].sample(weights);
+                                }
+                                break;
+                            }
+                            const float xhighWeight = index[0] - low[0], xlowWeight = 1.0f - xhighWeight;
+                            const float yhighWeight = index[1] - low[1], ylowWeight = 1.0f - yhighWeight;
+                            const float zhighWeight = index[2] - low[2], zlowWeight = 1.0f - zhighWeight;
+                            const int64_t base = low[0] + inRowStep * low[1] + inSliceStep * low[2];
+                            for (int64_t f = 0; f < batchCount; ++f)
+                            {//same operation order as interpolateValue
+                                const float* p = inFrames[f] + base;
+                                float xinterp[2][2];
+                                xinterp[0][0] = xlowWeight * p[0] + xhighWeight * p[1];
+                                xinterp[1][0] = xlowWeight * p[inRowStep] + xhighWeight * p[inRowStep + 1];
+                                xinterp[0][1] = xlowWeight * p[inSliceStep] + xhighWeight * p[inSliceStep + 1];
+                                xinterp[1][1] = xlowWeight * p[inSliceStep + inRowStep] + xhighWeight * p[inSliceStep + inRowStep + 1];
+                                float yinterp[2];
+                                yinterp[0] = ylowWeight * xinterp[0][0] + yhighWeight * xinterp[1][0];
+                                yinterp[1] = ylowWeight * xinterp[0][1] + yhighWeight * xinterp[1][1];
+                                outFrames[f][outIndex] = zlowWeight * yinterp[0] + zhighWeight * yinterp[1];
+                            }
+                            break;
+                        }
+                        case VolumeFile::ENCLOSING_VOXEL:
+                        {
+                            int64_t voxel[3] = { (int64_t)floor(0.5f + index[0]), (int64_t)floor(0.5f + index[1]), (int64_t)floor(0.5f + index[2]) };
+                            if (!valid[i] || !inRange(voxel[0], inDims[0]) || !inRange(voxel[1], inDims[1]) || !inRange(voxel[2], inDims[2]))
+                            {
+                                for (int64_t f = 0; f < batchCount; ++f)
+                                {
+                                    outFrames[f][outIndex] = VolumeFile::INVALID_INTERP_VALUE;
+                                }
+                                break;
+                            }
+                            const int64_t inIndex = voxel[0] + inRowStep * voxel[1] + inSliceStep * voxel[2];
+                            for (int64_t f = 0; f < batchCount; ++f)
+                            {
+                                outFrames[f][outIndex] = inFrames[f][inIndex];
+                            }
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        for (int64_t f = 0; f < batchCount; ++f)
+        {
+            outVol->setFrame(outFrames[f].data(), (batchStart + f) % numMaps, (batchStart + f) / numMaps);
+        }
+    }
+}
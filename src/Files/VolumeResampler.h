@@ -0,0 +1,58 @@
+#ifndef __VOLUME_RESAMPLER_H__
+#define __VOLUME_RESAMPLER_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026  Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+//NOTE: resampling every frame through VolumeFile::interpolateValue recomputes the transform, the bounds checks, and the interpolation weights for every
+//      frame, and forces the frames to be deconvolved one at a time.  This computes each output voxel's sample location and weights once per batch of
+//      frames, deconvolves the batch in parallel across frames, and gives the same values as interpolateValue.
+
+#include "VolumeFile.h"
+
+#include "stdint.h"
+
+namespace caret {
+
+    class VolumeResampler
+    {
+    public:
+        ///where each output voxel samples the input volume
+        class SampleMapping
+        {
+        public:
+            ///fill in the input index space coordinates (3 floats per voxel) for the row of output voxels (all i) at j, k
+            ///set valid to false for voxels that should be INVALID_INTERP_VALUE no matter where they point
+            virtual void getRow(const int64_t& j, const int64_t& k, float* indexCoordsOut, bool* validOut) const = 0;
+            virtual ~SampleMapping() { }
+        };
+
+        VolumeResampler(const VolumeFile* inVol, const VolumeFile::InterpType& method);
+
+        ///outVol must already have the output spatial dimensions and the same number of maps and components as the input
+        void resample(const SampleMapping& mapping, VolumeFile* outVol) const;
+    private:
+        const VolumeFile* m_inVol;
+        VolumeFile::InterpType m_method;
+    };
+
+}
+
+#endif //__VOLUME_RESAMPLER_H__
@@ -0,0 +1,554 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "VolumeSmoothingObject.h"
+
+#include "CaretAssert.h"
+#include "CaretException.h"
+#include "CaretLogger.h"
+#include "CaretOMP.h"
+#include "Vector3D.h"
+#include "VolumeFile.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace caret;
+using namespace std;
+
+//makes the program issue warning only once per launch, prevents repeated calls by other algorithms from spamming
+bool VolumeSmoothingObject::s_haveWarned = false;
+
+namespace
+{
+    //frames with at most this many voxels are smoothed concurrently, one frame per thread, instead of splitting every frame across all threads
+    //this keeps the per-thread scratch memory to a few tens of megabytes, larger frames have enough work per pass to split well anyway
+    const int64_t SMALL_FRAME_VOXELS = 1 << 21;
+}
+
+//working memory for one frame, one per thread when frames are processed concurrently
+struct VolumeSmoothingObject::FrameScratch
+{
+    vector<float> m_masked, m_sum1, m_sum2, m_weight1, m_weight2;
+};
+
+class VolumeSmoothingObject::FrameSmoother
+{
+public:
+    virtual void smoothFrame(const float* inFrame, float* outFrame, FrameScratch& scratch, const bool& threaded) const = 0;
+    virtual ~FrameSmoother() { }
+};
+
+//for orthogonal volumes, do three 1-dimensional smoothings for O(voxels * (ki + kj + kk)) instead of O(voxels * (ki * kj * kk))
+//each pass is written as a weighted sum of shifted rows (i) or of whole neighboring rows (j) or planes (k), so the innermost loop always runs along the
+//contiguous i axis and vectorizes, while every voxel still sums its kernel in the same order as a per-voxel loop would
+class VolumeSmoothingObject::OrthoSmoother : public VolumeSmoothingObject::FrameSmoother
+{
+    int64_t m_dims[3], m_lo[3], m_hi[3];//with an roi, work is restricted to its bounding box, because masked data is zero outside it
+    vector<float> m_weights[3];
+    int m_range[3];
+    const float* m_roiFrame;
+    bool m_fixZeros, m_empty;
+    vector<float> m_normalize;//final sums of weights, when they don't depend on the frame data (no -fix-zeros), so they are computed only once
+    void convolveI(const float* in, float* out, const bool& threaded) const;
+    void convolveJ(const float* in, float* out, const bool& threaded) const;
+    void convolveK(const float* in, float* out, const bool& threaded) const;
+    void makeMask(const float* inFrame, float* maskOut, const bool& threaded) const;
+public:
+    OrthoSmoother(const vector<int64_t>& myDims, const float* roiFrame, const bool& fixZeros, const vector<float> weights[3], const int ranges[3]);
+    void smoothFrame(const float* inFrame, float* outFrame, FrameScratch& scratch, const bool& threaded) const;
+};
+
+VolumeSmoothingObject::OrthoSmoother::OrthoSmoother(const vector<int64_t>& myDims, const float* roiFrame, const bool& fixZeros, const vector<float> weights[3], const int ranges[3])
+{
+    m_roiFrame = roiFrame;
+    m_fixZeros = fixZeros;
+    m_empty = false;
+    for (int i = 0; i < 3; ++i)
+    {
+        m_dims[i] = myDims[i];
+        m_weights[i] = weights[i];
+        m_range[i] = ranges[i];
+        m_lo[i] = 0;
+        m_hi[i] = myDims[i];
+    }
+    if (roiFrame != NULL)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            m_lo[i] = myDims[i];
+            m_hi[i] = 0;
+        }
+        int64_t index = 0;
+        for (int64_t k = 0; k < m_dims[2]; ++k)
+        {
+            for (int64_t j = 0; j < m_dims[1]; ++j)
+            {
+                for (int64_t i = 0; i < m_dims[0]; ++i, ++index)
+                {
+                    if (roiFrame[index] > 0.0f)
+                    {
+                        if (i < m_lo[0]) m_lo[0] = i;
+                        if (i >= m_hi[0]) m_hi[0] = i + 1;
+                        if (j < m_lo[1]) m_lo[1] = j;
+                        if (j >= m_hi[1]) m_hi[1] = j + 1;
+                        if (k < m_lo[2]) m_lo[2] = k;
+                        if (k >= m_hi[2]) m_hi[2] = k + 1;
+                    }
+                }
+            }
+        }
+        if (m_hi[0] == 0)
+        {
+            m_empty = true;
+            return;
+        }
+    }
+    if (!fixZeros)
+    {
+        int64_t frameSize = m_dims[0] * m_dims[1] * m_dims[2];
+        vector<float> mask(frameSize), temp(frameSize);
+        m_normalize.resize(frameSize);
+        makeMask(NULL, mask.data(), true);
+        convolveI(mask.data(), temp.data(), true);
+        convolveJ(temp.data(), mask.data(), true);
+        convolveK(mask.data(), m_normalize.data(), true);
+    }
+}
+
+void VolumeSmoothingObject::OrthoSmoother::makeMask(const float* inFrame, float* maskOut, const bool& threaded) const
+{//1 where a voxel contributes to smoothing, 0 otherwise
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+    for (int k = (int)m_lo[2]; k < (int)m_hi[2]; ++k)
+    {
+        for (int64_t j = m_lo[1]; j < m_hi[1]; ++j)
+        {
+            int64_t rowStart = (k * m_dims[1] + j) * m_dims[0];
+            for (int64_t i = m_lo[0]; i < m_hi[0]; ++i)
+            {
+                int64_t index = rowStart + i;
+                bool use = (m_roiFrame == NULL || m_roiFrame[index] > 0.0f) && (!m_fixZeros || inFrame[index] != 0.0f);
+                maskOut[index] = (use ? 1.0f : 0.0f);
+            }
+        }
+    }
+}
+
+void VolumeSmoothingObject::OrthoSmoother::convolveI(const float* in, float* out, const bool& threaded) const
+{
+    const float* kern = m_weights[0].data();
+    const int range = m_range[0];
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+    for (int k = (int)m_lo[2]; k < (int)m_hi[2]; ++k)
+    {
+        for (int64_t j = m_lo[1]; j < m_hi[1]; ++j)
+        {
+            int64_t rowStart = (k * m_dims[1] + j) * m_dims[0];
+            const float* inRow = in + rowStart;
+            float* outRow = out + rowStart;
+            for (int64_t i = m_lo[0]; i < m_hi[0]; ++i) outRow[i] = 0.0f;
+            for (int t = 0; t <= 2 * range; ++t)//sliding window as a sum of shifted rows, ascending source index like the per-voxel loop
+            {
+                const int shift = t - range;
+                const int64_t istart = max(m_lo[0], m_lo[0] - shift), iend = min(m_hi[0], m_hi[0] - shift);
+                const float weight = kern[t];
+                const float* shifted = inRow + shift;
+                for (int64_t i = istart; i < iend; ++i)
+                {
+                    outRow[i] += weight * shifted[i];
+                }
+            }
+        }
+    }
+}
+
+void VolumeSmoothingObject::OrthoSmoother::convolveJ(const float* in, float* out, const bool& threaded) const
+{
+    const float* kern = m_weights[1].data();
+    const int range = m_range[1];
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+    for (int k = (int)m_lo[2]; k < (int)m_hi[2]; ++k)
+    {
+        const int64_t planeStart = k * m_dims[1] * m_dims[0];
+        for (int64_t j = m_lo[1]; j < m_hi[1]; ++j)
+        {
+            float* outRow = out + planeStart + j * m_dims[0];
+            for (int64_t i = m_lo[0]; i < m_hi[0]; ++i) outRow[i] = 0.0f;
+            const int64_t jmin = max(m_lo[1], j - range), jmax = min(m_hi[1], j + range + 1);//one-after array size convention
+            for (int64_t jkern = jmin; jkern < jmax; ++jkern)
+            {
+                const float weight = kern[jkern - j + range];
+                const float* inRow = in + planeStart + jkern * m_dims[0];
+                for (int64_t i = m_lo[0]; i < m_hi[0]; ++i)
+                {
+                    outRow[i] += weight * inRow[i];
+                }
+            }
+        }
+    }
+}
+
+void VolumeSmoothingObject::OrthoSmoother::convolveK(const float* in, float* out, const bool& threaded) const
+{
+    const float* kern = m_weights[2].data();
+    const int range = m_range[2];
+    const int64_t planeSize = m_dims[0] * m_dims[1];
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+    for (int k = (int)m_lo[2]; k < (int)m_hi[2]; ++k)
+    {
+        const int64_t kmin = max(m_lo[2], (int64_t)k - range), kmax = min(m_hi[2], (int64_t)k + range + 1);
+        for (int64_t j = m_lo[1]; j < m_hi[1]; ++j)//finish one output row at a time, so it stays in cache while the neighboring planes are added
+        {
+            float* outRow = out + k * planeSize + j * m_dims[0];
+            for (int64_t i = m_lo[0]; i < m_hi[0]; ++i) outRow[i] = 0.0f;
+            for (int64_t kkern = kmin; kkern < kmax; ++kkern)
+            {
+                const float weight = kern[kkern - k + range];
+                const float* inRow = in + kkern * planeSize + j * m_dims[0];
+                for (int64_t i = m_lo[0]; i < m_hi[0]; ++i)
+                {
+                    outRow[i] += weight * inRow[i];
+                }
+            }
+        }
+    }
+}
+
+void VolumeSmoothingObject::OrthoSmoother::smoothFrame(const float* inFrame, float* outFrame, FrameScratch& scratch, const bool& threaded) const
+{
+    const int64_t frameSize = m_dims[0] * m_dims[1] * m_dims[2];
+    if (m_empty)
+    {
+        for (int64_t i = 0; i < frameSize; ++i) outFrame[i] = 0.0f;
+        return;
+    }
+    scratch.m_sum1.resize(frameSize);
+    scratch.m_sum2.resize(frameSize);
+    const float* source = inFrame;
+    if (m_roiFrame != NULL || m_fixZeros)
+    {//zero the data that doesn't contribute, then the sums don't need to test anything
+        scratch.m_masked.resize(frameSize);
+        float* masked = scratch.m_masked.data();
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+        for (int k = (int)m_lo[2]; k < (int)m_hi[2]; ++k)
+        {
+            for (int64_t j = m_lo[1]; j < m_hi[1]; ++j)
+            {
+                int64_t rowStart = (k * m_dims[1] + j) * m_dims[0];
+                for (int64_t i = m_lo[0]; i < m_hi[0]; ++i)
+                {
+                    int64_t index = rowStart + i;
+                    bool use = (m_roiFrame == NULL || m_roiFrame[index] > 0.0f) && (!m_fixZeros || inFrame[index] != 0.0f);
+                    masked[index] = (use ? inFrame[index] : 0.0f);
+                }
+            }
+        }
+        source = masked;
+    }
+    float* sum1 = scratch.m_sum1.data(), * sum2 = scratch.m_sum2.data();
+    convolveI(source, sum1, threaded);
+    convolveJ(sum1, sum2, threaded);
+    convolveK(sum2, sum1, threaded);//don't divide yet, sums of weights are smoothed the same way, and we divide at the end
+    const float* normalize = m_normalize.data();
+    if (m_normalize.empty())
+    {//weights depend on which voxels are zero in this frame
+        scratch.m_weight1.resize(frameSize);
+        scratch.m_weight2.resize(frameSize);
+        float* weight1 = scratch.m_weight1.data(), * weight2 = scratch.m_weight2.data();
+        makeMask(inFrame, weight2, threaded);
+        convolveI(weight2, weight1, threaded);
+        convolveJ(weight1, weight2, threaded);
+        convolveK(weight2, weight1, threaded);
+        normalize = weight1;
+    }
+    if (m_roiFrame != NULL)
+    {
+        for (int64_t i = 0; i < frameSize; ++i) outFrame[i] = 0.0f;
+    }
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+    for (int k = (int)m_lo[2]; k < (int)m_hi[2]; ++k)
+    {
+        for (int64_t j = m_lo[1]; j < m_hi[1]; ++j)
+        {
+            int64_t rowStart = (k * m_dims[1] + j) * m_dims[0];
+            for (int64_t i = m_lo[0]; i < m_hi[0]; ++i)
+            {
+                int64_t index = rowStart + i;
+                if ((m_roiFrame == NULL || m_roiFrame[index] > 0.0f) && normalize[index] != 0.0f)
+                {
+                    outFrame[index] = sum1[index] / normalize[index];
+                } else {
+                    outFrame[index] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+//for non-orthogonal volumes, full 3D kernel at every voxel
+class VolumeSmoothingObject::NonOrthSmoother : public VolumeSmoothingObject::FrameSmoother
+{
+    int64_t m_dims[3];
+    vector<float> m_weights;//flattened kernel box, i fastest, zero outside the sphere
+    int m_range[3];
+    const float* m_roiFrame;
+    bool m_fixZeros;
+public:
+    NonOrthSmoother(const vector<int64_t>& myDims, const float* roiFrame, const bool& fixZeros, const vector<float>& weights, const int ranges[3])
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            m_dims[i] = myDims[i];
+            m_range[i] = ranges[i];
+        }
+        m_weights = weights;
+        m_roiFrame = roiFrame;
+        m_fixZeros = fixZeros;
+    }
+    void smoothFrame(const float* inFrame, float* outFrame, FrameScratch& scratch, const bool& threaded) const;
+};
+
+void VolumeSmoothingObject::NonOrthSmoother::smoothFrame(const float* inFrame, float* outFrame, FrameScratch&, const bool& threaded) const
+{
+    const int irange = m_range[0], jrange = m_range[1], krange = m_range[2];
+    const int64_t isize = irange * 2 + 1, jsize = jrange * 2 + 1;
+    const float* weights = m_weights.data();
+#pragma omp CARET_PARFOR schedule(dynamic) if(threaded)
+    for (int k = 0; k < m_dims[2]; ++k)
+    {
+        for (int j = 0; j < m_dims[1]; ++j)
+        {
+            for (int i = 0; i < m_dims[0]; ++i)
+            {
+                int64_t curIndex = (k * m_dims[1] + j) * m_dims[0] + i;
+                if (m_roiFrame == NULL || m_roiFrame[curIndex] > 0.0f)
+                {
+                    int imin = i - irange, imax = i + irange + 1;//one-after array size convention
+                    if (imin < 0) imin = 0;
+                    if (imax > m_dims[0]) imax = m_dims[0];
+                    int jmin = j - jrange, jmax = j + jrange + 1;
+                    if (jmin < 0) jmin = 0;
+                    if (jmax > m_dims[1]) jmax = m_dims[1];
+                    int kmin = k - krange, kmax = k + krange + 1;
+                    if (kmin < 0) kmin = 0;
+                    if (kmax > m_dims[2]) kmax = m_dims[2];
+                    float sum = 0.0f, weightsum = 0.0f;
+                    for (int kkern = kmin; kkern < kmax; ++kkern)
+                    {
+                        int64_t kindpart = kkern * m_dims[1];
+                        int64_t kkernpart = (kkern - k + krange) * jsize;
+                        for (int jkern = jmin; jkern < jmax; ++jkern)
+                        {
+                            int64_t jindpart = (kindpart + jkern) * m_dims[0];
+                            int64_t weightBase = (kkernpart + jkern - j + jrange) * isize + irange - i;//add ikern to get the kernel index
+                            for (int ikern = imin; ikern < imax; ++ikern)
+                            {
+                                int64_t thisIndex = jindpart + ikern;
+                                float weight = weights[weightBase + ikern];
+                                if (weight != 0.0f && (m_roiFrame == NULL || m_roiFrame[thisIndex] > 0.0f) && (!m_fixZeros || inFrame[thisIndex] != 0.0f))
+                                {
+                                    weightsum += weight;
+                                    sum += weight * inFrame[thisIndex];
+                                }
+                            }
+                        }
+                    }
+                    if (weightsum != 0.0f)
+                    {
+                        outFrame[curIndex] = sum / weightsum;
+                    } else {
+                        outFrame[curIndex] = 0.0f;
+                    }
+                } else {
+                    outFrame[curIndex] = 0.0f;
+                }
+            }
+        }
+    }
+}
+
+//when there are several small frames, give each thread whole frames, which avoids a barrier after every pass of every frame
+//output frames are collected in a batch and written serially, since setFrame isn't meant to be called concurrently
+void VolumeSmoothingObject::smoothFrames(const VolumeFile* inVol, VolumeFile* outVol, const vector<int>& inSubvols) const
+{
+    vector<int64_t> myDims;
+    inVol->getDimensions(myDims);
+    const int numComponents = (int)myDims[4];
+    const int64_t frameSize = myDims[0] * myDims[1] * myDims[2];
+    const int numFrames = (int)inSubvols.size() * numComponents;//frame f is subvolume f / numComponents, component f % numComponents
+    int batchSize = 1;
+#ifdef CARET_OMP
+    if (frameSize <= SMALL_FRAME_VOXELS) batchSize = 2 * omp_get_max_threads();
+#endif
+    if (batchSize < 2 || numFrames < 2)
+    {
+        FrameScratch myScratch;
+        vector<float> outFrame(frameSize);
+        for (int f = 0; f < numFrames; ++f)
+        {
+            m_smoother->smoothFrame(inVol->getFrame(inSubvols[f / numComponents], f % numComponents), outFrame.data(), myScratch, true);
+            outVol->setFrame(outFrame.data(), f / numComponents, f % numComponents);
+        }
+        return;
+    }
+    if (batchSize > numFrames) batchSize = numFrames;
+    vector<vector<float> > outFrames(batchSize, vector<float>(frameSize));
+    for (int batchStart = 0; batchStart < numFrames; batchStart += batchSize)
+    {
+        const int batchEnd = min(batchStart + batchSize, numFrames);
+#pragma omp CARET_PAR
+        {
+            FrameScratch myScratch;
+#pragma omp CARET_FOR schedule(dynamic)
+            for (int f = batchStart; f < batchEnd; ++f)
+            {
+                m_smoother->smoothFrame(inVol->getFrame(inSubvols[f / numComponents], f % numComponents), outFrames[f - batchStart].data(), myScratch, false);
+            }
+        }
+        for (int f = batchStart; f < batchEnd; ++f)
+        {
+            outVol->setFrame(outFrames[f - batchStart].data(), f / numComponents, f % numComponents);
+        }
+    }
+}
+
+VolumeSmoothingObject::VolumeSmoothingObject(const VolumeFile* templateVol, const float& kernel, const VolumeFile* roiVol, const bool& fixZeros)
+{
+    CaretAssert(templateVol != NULL);
+    if (roiVol != NULL && !templateVol->matchesVolumeSpace(roiVol))
+    {
+        throw CaretException("volume roi space does not match input volume");
+    }
+    if (kernel <= 0.0f)
+    {
+        throw CaretException("kernel too small");
+    }
+    templateVol->getDimensions(m_dims);
+    m_dims.resize(3);
+    m_sform = templateVol->getSform();
+    const float* roiFrame = NULL;
+    if (roiVol != NULL)
+    {
+        m_roiFrame.assign(roiVol->getFrame(), roiVol->getFrame() + m_dims[0] * m_dims[1] * m_dims[2]);
+        roiFrame = m_roiFrame.data();
+    }
+    float kernBox = kernel * 3.0f;
+    const vector<vector<float> >& volSpace = m_sform;
+    Vector3D ivec, jvec, kvec, origin, ijorth, jkorth, kiorth;
+    ivec[0] = volSpace[0][0]; jvec[0] = volSpace[0][1]; kvec[0] = volSpace[0][2]; origin[0] = volSpace[0][3];
+    ivec[1] = volSpace[1][0]; jvec[1] = volSpace[1][1]; kvec[1] = volSpace[1][2]; origin[1] = volSpace[1][3];
+    ivec[2] = volSpace[2][0]; jvec[2] = volSpace[2][1]; kvec[2] = volSpace[2][2]; origin[2] = volSpace[2][3];
+    const float ORTH_TOLERANCE = 0.001f;//tolerate this much deviation from orthogonal (dot product divided by product of lengths) to use orthogonal assumptions to smooth
+    if (abs(ivec.dot(jvec.normal())) / ivec.length() < ORTH_TOLERANCE && abs(jvec.dot(kvec.normal())) / jvec.length() < ORTH_TOLERANCE && abs(kvec.dot(ivec.normal())) / kvec.length() < ORTH_TOLERANCE)
+    {
+        float spacing[3] = { ivec.length(), jvec.length(), kvec.length() };
+        int ranges[3];
+        vector<float> weights[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            ranges[axis] = (int)floor(kernBox / spacing[axis]);
+            if (ranges[axis] < 1) ranges[axis] = 1;//don't underflow
+            int size = ranges[axis] * 2 + 1;//and construct a precomputed kernel
+            weights[axis].resize(size);
+            for (int i = 0; i < size; ++i)
+            {
+                float tempf = spacing[axis] * (i - ranges[axis]) / kernel;
+                weights[axis][i] = exp(-tempf * tempf / 2.0f);
+            }
+        }
+        m_smoother.grabNew(new OrthoSmoother(m_dims, roiFrame, fixZeros, weights, ranges));
+    } else {
+        if (!s_haveWarned)
+        {
+            CaretLogWarning("input volume is not orthogonal, smoothing will take longer");
+            s_haveWarned = true;
+        }
+        ijorth = ivec.cross(jvec).normal();//find the bounding box that encloses a sphere of radius kernBox
+        jkorth = jvec.cross(kvec).normal();
+        kiorth = kvec.cross(ivec).normal();
+        int ranges[3];
+        ranges[0] = (int)floor(abs(kernBox / ivec.dot(jkorth)));
+        ranges[1] = (int)floor(abs(kernBox / jvec.dot(kiorth)));
+        ranges[2] = (int)floor(abs(kernBox / kvec.dot(ijorth)));
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            if (ranges[axis] < 1) ranges[axis] = 1;//don't underflow
+        }
+        int isize = ranges[0] * 2 + 1;//and construct a precomputed kernel in the box
+        int jsize = ranges[1] * 2 + 1;
+        int ksize = ranges[2] * 2 + 1;
+        vector<float> weights(ksize * jsize * isize);//index i comes last because that is linear for volume frames
+        Vector3D kscratch, jscratch, iscratch;
+        for (int k = 0; k < ksize; ++k)
+        {
+            kscratch = kvec * (k - ranges[2]);
+            for (int j = 0; j < jsize; ++j)
+            {
+                jscratch = kscratch + jvec * (j - ranges[1]);
+                for (int i = 0; i < isize; ++i)
+                {
+                    iscratch = jscratch + ivec * (i - ranges[0]);
+                    float tempf = iscratch.length();
+                    float& weight = weights[((k * jsize) + j) * isize + i];
+                    if (tempf > kernBox)
+                    {
+                        weight = 0.0f;//test for zero to avoid some multiplies/adds, cheaper or cleaner than checking bounds on indexes from an index list
+                    } else {
+                        weight = exp(-tempf * tempf / kernel / kernel / 2.0f);//optimization here isn't critical
+                    }
+                }
+            }
+        }
+        m_smoother.grabNew(new NonOrthSmoother(m_dims, roiFrame, fixZeros, weights, ranges));
+    }
+}
+
+VolumeSmoothingObject::~VolumeSmoothingObject()
+{
+}
+
+void VolumeSmoothingObject::smoothVolume(const VolumeFile* volIn, VolumeFile* volOut, const int& subvol) const
+{
+    CaretAssert(volIn != NULL);
+    CaretAssert(volOut != NULL);
+    if (!volIn->matchesVolumeSpace(m_dims.data(), m_sform))
+    {
+        throw CaretException("volume space does not match the smoothing object");
+    }
+    vector<int64_t> myDims;
+    volIn->getDimensions(myDims);
+    if (subvol < -1 || subvol >= myDims[3])
+    {
+        throw CaretException("invalid subvolume specified");
+    }
+    vector<int> inSubvols;
+    if (subvol == -1)
+    {
+        volOut->reinitialize(volIn->getOriginalDimensions(), m_sform, myDims[4]);
+        for (int s = 0; s < myDims[3]; ++s)
+        {
+            inSubvols.push_back(s);
+        }
+    } else {
+        volOut->reinitialize(m_dims, m_sform, myDims[4]);
+        inSubvols.push_back(subvol);
+    }
+    smoothFrames(volIn, volOut, inSubvols);
+}
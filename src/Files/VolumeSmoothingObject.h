@@ -0,0 +1,63 @@
+#ifndef __VOLUME_SMOOTHING_OBJECT_H__
+#define __VOLUME_SMOOTHING_OBJECT_H__
+
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+//NOTE: like MetricSmoothingObject, this builds the smoothing kernel once, so that many volumes in the same space with the same roi can be smoothed
+//      without rebuilding it.  If you just want to smooth one volume, you probably want AlgorithmVolumeSmoothing.
+//
+//NOTE: the roi frame is copied, so the roi volume doesn't need to outlive this object
+
+#include "CaretPointer.h"
+
+#include "stdint.h"
+#include <vector>
+
+namespace caret {
+    
+    class VolumeFile;
+    
+    class VolumeSmoothingObject
+    {
+    public:
+        VolumeSmoothingObject(const VolumeFile* templateVol, const float& kernel, const VolumeFile* roiVol = NULL, const bool& fixZeros = false);
+        ~VolumeSmoothingObject();
+        ///smooth all subvolumes (subvol = -1) or one subvolume of volIn, volOut is reinitialized to match, map names are not set
+        void smoothVolume(const VolumeFile* volIn, VolumeFile* volOut, const int& subvol = -1) const;
+    private:
+        struct FrameScratch;
+        class FrameSmoother;
+        class OrthoSmoother;
+        class NonOrthSmoother;
+        CaretPointer<FrameSmoother> m_smoother;
+        std::vector<int64_t> m_dims;
+        std::vector<std::vector<float> > m_sform;
+        std::vector<float> m_roiFrame;
+        static bool s_haveWarned;
+        void smoothFrames(const VolumeFile* inVol, VolumeFile* outVol, const std::vector<int>& inSubvols) const;
+        VolumeSmoothingObject();
+        VolumeSmoothingObject(const VolumeSmoothingObject&);//the smoother points into m_roiFrame, so don't allow copies
+        VolumeSmoothingObject& operator=(const VolumeSmoothingObject&);
+    };
+    
+}
+
+#endif //__VOLUME_SMOOTHING_OBJECT_H__
@@ -18,6 +18,7 @@
  */
 /*LICENSE_END*/
 
+#include "CaretAssert.h"
 #include "CaretOMP.h"
 #include "CubicSpline.h"
 #include "MathFunctions.h"
@@ -154,26 +155,63 @@ VolumeSpline::VolumeSpline(const float* frame, const int64_t framedims[3])
     }
 }
 
-float VolumeSpline::sample(const float& ifloat, const float& jfloat, const float& kfloat)
+float VolumeSpline::sample(const float& ifloat, const float& jfloat, const float& kfloat) const
 {
-    if (m_dims[0] < 2 || ifloat < 0.0f || jfloat < 0.0f || kfloat < 0.0f || ifloat > m_dims[0] - 1 || jfloat > m_dims[1] - 1 || kfloat > m_dims[2] - 1) return 0.0f;//yeesh
+    SampleWeights weights;
+    getSampleWeights(m_dims, ifloat, jfloat, kfloat, weights);
+    return sample(weights);
+}
+
+void VolumeSpline::getSampleWeights(const int64_t framedims[3], const float& ifloat, const float& jfloat, const float& kfloat, SampleWeights& weightsOut)
+{
+    weightsOut.m_valid = false;
+    if (framedims[0] < 2 || ifloat < 0.0f || jfloat < 0.0f || kfloat < 0.0f || ifloat > framedims[0] - 1 || jfloat > framedims[1] - 1 || kfloat > framedims[2] - 1) return;//yeesh
+    const float coords[3] = { ifloat, jfloat, kfloat };
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        float ipart;
+        float fpart = modf(coords[axis], &ipart);
+        weightsOut.m_low[axis] = (int64_t)ipart;
+        weightsOut.m_lowEdge[axis] = (weightsOut.m_low[axis] < 1);
+        weightsOut.m_highEdge[axis] = (weightsOut.m_low[axis] >= framedims[axis] - 2);
+        CubicSpline spline = CubicSpline::bspline(fpart, weightsOut.m_lowEdge[axis], weightsOut.m_highEdge[axis]);
+        spline.getWeights(weightsOut.m_weights[axis]);
+    }
+    weightsOut.m_valid = true;
+}
+
+namespace
+{//same arithmetic as CubicSpline::evaluate and its edge variants
+    inline float evaluate(const float w[4], const float p0, const float p1, const float p2, const float p3)
+    {
+        return p0 * w[0] + p1 * w[1] + p2 * w[2] + p3 * w[3];
+    }
+    
+    inline float evalLowEdge(const float w[4], const float p1, const float p2, const float p3)
+    {
+        return p1 * w[1] + p2 * w[2] + p3 * w[3];
+    }
+    
+    inline float evalHighEdge(const float w[4], const float p0, const float p1, const float p2)
+    {
+        return p0 * w[0] + p1 * w[1] + p2 * w[2];
+    }
+    
+    inline float evalBothEdge(const float w[4], const float p1, const float p2)
+    {
+        return p1 * w[1] + p2 * w[2];
+    }
+}
+
+float VolumeSpline::sample(const SampleWeights& weights) const
+{
+    if (!weights.m_valid) return 0.0f;
+    CaretAssert(m_deconv.getArray() != NULL);
     const int64_t zstep = m_dims[0] * m_dims[1];
-    float iparti, ipartj, ipartk;
-    float fparti = modf(ifloat, &iparti);
-    float fpartj = modf(jfloat, &ipartj);
-    float fpartk = modf(kfloat, &ipartk);
-    int64_t lowi = (int64_t)iparti;
-    int64_t lowj = (int64_t)ipartj;
-    int64_t lowk = (int64_t)ipartk;
-    bool lowedgei = (lowi < 1);
-    bool lowedgej = (lowj < 1);
-    bool lowedgek = (lowk < 1);
-    bool highedgei = (lowi >= m_dims[0] - 2);
-    bool highedgej = (lowj >= m_dims[1] - 2);
-    bool highedgek = (lowk >= m_dims[2] - 2);
-    CubicSpline ispline = CubicSpline::bspline(fparti, lowedgei, highedgei);
-    CubicSpline jspline = CubicSpline::bspline(fpartj, lowedgej, highedgej);
-    CubicSpline kspline = CubicSpline::bspline(fpartk, lowedgek, highedgek);
+    const int64_t lowi = weights.m_low[0], lowj = weights.m_low[1], lowk = weights.m_low[2];
+    const bool lowedgei = weights.m_lowEdge[0], lowedgej = weights.m_lowEdge[1], lowedgek = weights.m_lowEdge[2];
+    const bool highedgei = weights.m_highEdge[0], highedgej = weights.m_highEdge[1], highedgek = weights.m_highEdge[2];
+    const float* iweights = weights.m_weights[0], * jweights = weights.m_weights[1], * kweights = weights.m_weights[2];
     float jtemp[4], ktemp[4];//the weights of the splines are zero for off-the edge values, but zero the data anyway
     jtemp[0] = 0.0f;
     jtemp[3] = 0.0f;
@@ -195,22 +233,22 @@ float VolumeSpline::sample(const float& ifloat, const float& jfloat, const float
                 {
                     if (highedgei)
                     {
-                        jtemp[j] = ispline.evalBothEdge(m_deconv[indexj + 1], m_deconv[indexj + 2]);
+                        jtemp[j] = evalBothEdge(iweights, m_deconv[indexj + 1], m_deconv[indexj + 2]);
                     } else {
-                        jtemp[j] = ispline.evalLowEdge(m_deconv[indexj + 1], m_deconv[indexj + 2], m_deconv[indexj + 3]);
+                        jtemp[j] = evalLowEdge(iweights, m_deconv[indexj + 1], m_deconv[indexj + 2], m_deconv[indexj + 3]);
                     }
                 } else {
                     if (highedgei)
                     {
-                        jtemp[j] = ispline.evalHighEdge(m_deconv[indexj], m_deconv[indexj + 1], m_deconv[indexj + 2]);
+                        jtemp[j] = evalHighEdge(iweights, m_deconv[indexj], m_deconv[indexj + 1], m_deconv[indexj + 2]);
                     } else {
-                        jtemp[j] = ispline.evaluate(m_deconv[indexj], m_deconv[indexj + 1], m_deconv[indexj + 2], m_deconv[indexj + 3]);
+                        jtemp[j] = evaluate(iweights, m_deconv[indexj], m_deconv[indexj + 1], m_deconv[indexj + 2], m_deconv[indexj + 3]);
                     }
                 }
             }
-            ktemp[k] = jspline.evaluate(jtemp[0], jtemp[1], jtemp[2], jtemp[3]);
+            ktemp[k] = evaluate(jweights, jtemp[0], jtemp[1], jtemp[2], jtemp[3]);
         }
-        return kspline.evaluate(ktemp[0], ktemp[1], ktemp[2], ktemp[3]);
+        return evaluate(kweights, ktemp[0], ktemp[1], ktemp[2], ktemp[3]);
     } else {//we are clear of all edges, we can use fewer conditionals
         int64_t indexbase = lowi - 1 + m_dims[0] * (lowj - 1 + m_dims[1] * (lowk - 1));
         const float* basePtr = m_deconv.getArray() + indexbase;
@@ -220,13 +258,13 @@ float VolumeSpline::sample(const float& ifloat, const float& jfloat, const float
             int64_t indexj = indexk;
             for (int j = 0; j < 4; ++j)
             {
-                jtemp[j] = ispline.evaluate(basePtr[indexj], basePtr[indexj + 1], basePtr[indexj + 2], basePtr[indexj + 3]);
+                jtemp[j] = evaluate(iweights, basePtr[indexj], basePtr[indexj + 1], basePtr[indexj + 2], basePtr[indexj + 3]);
                 indexj += m_dims[0];
             }
-            ktemp[k] = jspline.evaluate(jtemp[0], jtemp[1], jtemp[2], jtemp[3]);
+            ktemp[k] = evaluate(jweights, jtemp[0], jtemp[1], jtemp[2], jtemp[3]);
             indexk += zstep;
         }
-        return kspline.evaluate(ktemp[0], ktemp[1], ktemp[2], ktemp[3]);
+        return evaluate(kweights, ktemp[0], ktemp[1], ktemp[2], ktemp[3]);
     }
 }
 
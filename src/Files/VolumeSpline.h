@@ -34,10 +34,20 @@ namespace caret {
         void deconvolve(float* data, const float* backsubs, const int64_t& length);//use CaretArray so that it doesn't reallocate like a vector on copy, and the data is static once computed
         void predeconvolve(float* backsubs, const int64_t& length);//since the back substitution on the same size array uses the same coefficients, precompute them
     public:
+        ///where a sample falls and its spline weights, which depend only on the position and frame dimensions, so they can be computed once and used on many frames
+        struct SampleWeights
+        {
+            int64_t m_low[3];
+            float m_weights[3][4];
+            bool m_lowEdge[3], m_highEdge[3], m_valid;
+        };
         VolumeSpline();
         VolumeSpline(const float* frame, const int64_t framedims[3]);
-        float sample(const float& i, const float& j, const float& k);
-        float sample(const float ijk[3]) { return sample(ijk[0], ijk[1], ijk[2]); }
+        float sample(const float& i, const float& j, const float& k) const;
+        float sample(const float ijk[3]) const { return sample(ijk[0], ijk[1], ijk[2]); }
+        ///compute the weights for sampling a frame of these dimensions at a fractional index, m_valid is false (and sample will return 0) outside the frame
+        static void getSampleWeights(const int64_t framedims[3], const float& i, const float& j, const float& k, SampleWeights& weightsOut);
+        float sample(const SampleWeights& weights) const;
         bool ignoredNonNumeric() const { return m_ignoredNonNumeric; }
     };
     
@@ -29,6 +29,8 @@
 #include "Vector3D.h"
 
 #include <cmath>
+#include <cstring>
+#include <limits>
 
 using namespace caret;
 using namespace std;
@@ -81,11 +83,12 @@ void VolumeBase::addSubvolumes(const int64_t& numToAdd)
     VolumeStorage newStorage(newdims.data());
     newdims.resize(4);//drop the number of components from the dimensions array
     m_origDims = newdims;//and reset our original dimensions
+    vector<float> scratchFrame;
     for (int64_t c = 0; c < olddims[4]; ++c)
     {
         for (int64_t b = 0; b < olddims[3]; ++b)
         {
-            newStorage.setFrame(m_storage.getFrame(b, c), b, c);
+            newStorage.setFrame(m_storage.getFrameUncached(scratchFrame, b, c), b, c);
         }
     }
     m_storage.swap(newStorage);
@@ -147,14 +150,14 @@ void VolumeBase::reorient(const VolumeSpace::OrientTypes newOrient[3])
     int64_t rowSize = dims[0];
     int64_t sliceSize = rowSize * dims[1];
     int64_t frameSize = sliceSize * dims[2];
-    vector<float> scratchFrame(frameSize);
+    vector<float> scratchFrame(frameSize), oldScratch;
     int64_t newDims[5] = {dims[fetchFrom[0]], dims[fetchFrom[1]], dims[fetchFrom[2]], dims[3], dims[4]};
     VolumeStorage newStorage(newDims);
     for (int c = 0; c < dims[4]; ++c)
     {
         for (int b = 0; b < dims[3]; ++b)
         {
-            const float* oldFrame = m_storage.getFrame(b, c);
+            const float* oldFrame = m_storage.getFrameUncached(oldScratch, b, c);
             int64_t newIndices[3], oldIndices[3];
             for (newIndices[2] = 0; newIndices[2] < newDims[2]; ++newIndices[2])
             {
@@ -349,6 +352,9 @@ VolumeBase::isEmpty() const
 
 VolumeBase::VolumeStorage::VolumeStorage()
 {
+    m_storageType = STORAGE_FLOAT32;
+    m_scale = 1.0;
+    m_offset = 0.0;
     for (int i = 0; i < 5; ++i)
     {
         m_dimensions[i] = 0;
@@ -369,6 +375,12 @@ void VolumeBase::VolumeStorage::reinitialize(int64_t dims[5])
     {
         m_mult[i] = m_mult[i - 1] * m_dimensions[i];
     }
+    m_storageType = STORAGE_FLOAT32;
+    m_scale = 1.0;
+    m_offset = 0.0;
+    vector<char>().swap(m_nativeData);
+    vector<vector<float> >().swap(m_frameCache);
+    vector<char>().swap(m_frameCacheValid);
     m_data.resize(m_mult[4]);
 }
 
@@ -377,22 +389,292 @@ VolumeBase::VolumeStorage::VolumeStorage(int64_t dims[5])
     reinitialize(dims);
 }
 
+namespace
+{
+    int64_t storageTypeSize(const VolumeBase::StorageType& storageType)
+    {
+        switch (storageType)
+        {
+            case VolumeBase::STORAGE_FLOAT32:
+                return sizeof(float);
+            case VolumeBase::STORAGE_UINT8:
+            case VolumeBase::STORAGE_INT8:
+                return 1;
+            case VolumeBase::STORAGE_UINT16:
+            case VolumeBase::STORAGE_INT16:
+                return 2;
+        }
+        CaretAssert(false);
+        return 0;
+    }
+    
+    template<typename T>
+    void convertNative(const T* rawIn, float* frameOut, const int64_t& count, const double& scale, const double& offset)
+    {
+        if (scale == 1.0 && offset == 0.0)
+        {
+            for (int64_t i = 0; i < count; ++i)
+            {
+                frameOut[i] = rawIn[i];
+            }
+        } else {
+            for (int64_t i = 0; i < count; ++i)
+            {
+                frameOut[i] = (float)(offset + scale * rawIn[i]);
+            }
+        }
+    }
+    
+    void convertNative(const VolumeBase::StorageType& storageType, const void* rawIn, float* frameOut, const int64_t& count, const double& scale, const double& offset)
+    {
+        switch (storageType)
+        {
+            case VolumeBase::STORAGE_FLOAT32:
+                CaretAssert(false);
+                break;
+            case VolumeBase::STORAGE_UINT8:
+                convertNative((const uint8_t*)rawIn, frameOut, count, scale, offset);
+                break;
+            case VolumeBase::STORAGE_INT8:
+                convertNative((const int8_t*)rawIn, frameOut, count, scale, offset);
+                break;
+            case VolumeBase::STORAGE_UINT16:
+                convertNative((const uint16_t*)rawIn, frameOut, count, scale, offset);
+                break;
+            case VolumeBase::STORAGE_INT16:
+                convertNative((const int16_t*)rawIn, frameOut, count, scale, offset);
+                break;
+        }
+    }
+    
+    template<typename T>
+    bool storeNative(const float& valueIn, T& rawOut, const double& scale, const double& offset)
+    {//only store values that will convert back to exactly the same float
+        double raw = floor(0.5 + (valueIn - offset) / scale);
+        if (!(raw >= numeric_limits<T>::min() && raw <= numeric_limits<T>::max())) return false;//also catches NaN
+        T temp = (T)raw;
+        if ((float)(offset + scale * temp) != valueIn) return false;
+        rawOut = temp;
+        return true;
+    }
+}
+
+void VolumeBase::VolumeStorage::setNativeStorage(const StorageType& storageType, const double& scale, const double& offset)
+{
+    CaretAssert(m_mult[4] > 0);
+    vector<float>().swap(m_data);
+    vector<vector<float> >().swap(m_frameCache);
+    vector<char>().swap(m_frameCacheValid);
+    m_storageType = storageType;
+    if (storageType == STORAGE_FLOAT32)
+    {
+        vector<char>().swap(m_nativeData);
+        m_scale = 1.0;
+        m_offset = 0.0;
+        m_data.resize(m_mult[4]);
+        return;
+    }
+    CaretAssert(scale != 0.0);
+    m_scale = scale;
+    m_offset = offset;
+    m_nativeData.resize(m_mult[4] * storageTypeSize(storageType));
+    m_frameCache.resize(m_mult[4] / m_mult[2]);//empty until requested, but getFrame must never resize the outer vector
+    m_frameCacheValid.resize(m_mult[4] / m_mult[2], 0);
+}
+
+float VolumeBase::VolumeStorage::getNativeValue(const int64_t& index) const
+{
+    double raw = 0.0;
+    switch (m_storageType)
+    {
+        case STORAGE_FLOAT32:
+            return m_data[index];
+        case STORAGE_UINT8:
+            raw = ((const uint8_t*)m_nativeData.data())[index];
+            break;
+        case STORAGE_INT8:
+            raw = ((const int8_t*)m_nativeData.data())[index];
+            break;
+        case STORAGE_UINT16:
+            raw = ((const uint16_t*)m_nativeData.data())[index];
+            break;
+        case STORAGE_INT16:
+            raw = ((const int16_t*)m_nativeData.data())[index];
+            break;
+    }
+    return (float)(m_offset + m_scale * raw);
+}
+
+bool VolumeBase::VolumeStorage::setNativeValue(const float& valueIn, const int64_t& index)
+{
+    bool ret = false;
+    switch (m_storageType)
+    {
+        case STORAGE_FLOAT32:
+            CaretAssert(false);
+            break;
+        case STORAGE_UINT8:
+            ret = storeNative(valueIn, ((uint8_t*)m_nativeData.data())[index], m_scale, m_offset);
+            break;
+        case STORAGE_INT8:
+            ret = storeNative(valueIn, ((int8_t*)m_nativeData.data())[index], m_scale, m_offset);
+            break;
+        case STORAGE_UINT16:
+            ret = storeNative(valueIn, ((uint16_t*)m_nativeData.data())[index], m_scale, m_offset);
+            break;
+        case STORAGE_INT16:
+            ret = storeNative(valueIn, ((int16_t*)m_nativeData.data())[index], m_scale, m_offset);
+            break;
+    }
+    if (ret && m_frameCacheValid[index / m_mult[2]])
+    {
+        m_frameCache[index / m_mult[2]][index % m_mult[2]] = valueIn;//keep already converted frames current
+    }
+    return ret;
+}
+
+void VolumeBase::VolumeStorage::convertToFloat()
+{//NOTE: invalidates pointers from getFrame, but modifying a volume while using a frame pointer from it is already asking for trouble
+    if (m_storageType == STORAGE_FLOAT32) return;
+    vector<float> newData(m_mult[4]);
+    convertNative(m_storageType, m_nativeData.data(), newData.data(), m_mult[4], m_scale, m_offset);
+    vector<vector<float> >().swap(m_frameCache);
+    vector<char>().swap(m_frameCacheValid);
+    vector<char>().swap(m_nativeData);
+    m_data.swap(newData);
+    m_storageType = STORAGE_FLOAT32;
+    m_scale = 1.0;
+    m_offset = 0.0;
+}
+
 const float* VolumeBase::VolumeStorage::getFrame(const int64_t brickIndex, const int64_t component) const
 {
-    return m_data.data() + brickIndex * m_mult[2] + component * m_mult[3];//NOTE: do not use [4]
+    int64_t start = getFrameStart(brickIndex, component);//NOTE: do not use [4]
+    if (m_storageType == STORAGE_FLOAT32) return m_data.data() + start;
+    int64_t whichFrame = brickIndex + component * m_dimensions[3];
+    CaretAssert(whichFrame < (int64_t)m_frameCacheValid.size());
+    if (!m_frameCacheValid[whichFrame])
+    {//lock only on a miss, repeated calls on a converted frame don't touch the mutex
+        CaretMutexLocker locked(&m_cacheMutex);
+        if (!m_frameCacheValid[whichFrame])//another thread may have converted it while we waited
+        {
+            vector<float>& thisFrame = m_frameCache[whichFrame];
+            thisFrame.resize(m_mult[2]);
+            convertNative(m_storageType, m_nativeData.data() + start * storageTypeSize(m_storageType), thisFrame.data(), m_mult[2], m_scale, m_offset);
+            m_frameCacheValid[whichFrame] = 1;//same double check as the spline cache in VolumeFile
+        }
+    }
+    return m_frameCache[whichFrame].data();
+}
+
+const float* VolumeBase::VolumeStorage::getFrameUncached(vector<float>& scratch, const int64_t brickIndex, const int64_t component) const
+{
+    int64_t start = getFrameStart(brickIndex, component);
+    if (m_storageType == STORAGE_FLOAT32) return m_data.data() + start;
+    int64_t whichFrame = brickIndex + component * m_dimensions[3];
+    if (m_frameCacheValid[whichFrame]) return m_frameCache[whichFrame].data();//already converted by someone else, don't do it again
+    scratch.resize(m_mult[2]);
+    convertNative(m_storageType, m_nativeData.data() + start * storageTypeSize(m_storageType), scratch.data(), m_mult[2], m_scale, m_offset);
+    return scratch.data();
+}
+
+void VolumeBase::VolumeStorage::getFrameCopy(float* frameOut, const int64_t brickIndex, const int64_t component) const
+{
+    int64_t start = getFrameStart(brickIndex, component);
+    if (m_storageType == STORAGE_FLOAT32)
+    {
+        for (int64_t i = 0; i < m_mult[2]; ++i)
+        {
+            frameOut[i] = m_data[i + start];
+        }
+    } else {
+        convertNative(m_storageType, m_nativeData.data() + start * storageTypeSize(m_storageType), frameOut, m_mult[2], m_scale, m_offset);
+    }
+}
+
+void VolumeBase::VolumeStorage::getFrameRounded(int32_t* frameOut, const int64_t brickIndex, const int64_t component) const
+{
+    int64_t start = getFrameStart(brickIndex, component);
+    if (m_storageType != STORAGE_FLOAT32 && m_scale == 1.0 && m_offset == 0.0)
+    {
+        const char* raw = m_nativeData.data() + start * storageTypeSize(m_storageType);
+        for (int64_t i = 0; i < m_mult[2]; ++i)
+        {
+            switch (m_storageType)
+            {
+                case STORAGE_FLOAT32:
+                    break;
+                case STORAGE_UINT8:
+                    frameOut[i] = ((const uint8_t*)raw)[i];
+                    break;
+                case STORAGE_INT8:
+                    frameOut[i] = ((const int8_t*)raw)[i];
+                    break;
+                case STORAGE_UINT16:
+                    frameOut[i] = ((const uint16_t*)raw)[i];
+                    break;
+                case STORAGE_INT16:
+                    frameOut[i] = ((const int16_t*)raw)[i];
+                    break;
+            }
+        }
+    } else {
+        for (int64_t i = 0; i < m_mult[2]; ++i)
+        {
+            frameOut[i] = (int32_t)floor((m_storageType == STORAGE_FLOAT32 ? m_data[i + start] : getNativeValue(i + start)) + 0.5f);
+        }
+    }
+}
+
+const void* VolumeBase::VolumeStorage::getNativeFrame(const int64_t brickIndex, const int64_t component) const
+{
+    if (m_storageType == STORAGE_FLOAT32) return NULL;
+    return m_nativeData.data() + getFrameStart(brickIndex, component) * storageTypeSize(m_storageType);
 }
 
 void VolumeBase::VolumeStorage::setFrame(const float* frameIn, const int64_t brickIndex, const int64_t component)
 {
-    int64_t start = brickIndex * m_mult[2] + component * m_mult[3];
+    int64_t start = getFrameStart(brickIndex, component);
+    if (m_storageType != STORAGE_FLOAT32)
+    {
+        int64_t i;
+        for (i = 0; i < m_mult[2]; ++i)
+        {
+            if (!setNativeValue(frameIn[i], i + start)) break;
+        }
+        if (i == m_mult[2]) return;
+        convertToFloat();//frame has non-integer values, give up on native storage
+    }
     for (int64_t i = 0; i < m_mult[2]; ++i)
     {
         m_data[i + start] = frameIn[i];
     }
 }
 
+void VolumeBase::VolumeStorage::setNativeFrame(const void* frameIn, const int64_t brickIndex, const int64_t component)
+{
+    CaretAssert(m_storageType != STORAGE_FLOAT32);
+    int64_t typeSize = storageTypeSize(m_storageType), start = getFrameStart(brickIndex, component);
+    memcpy(m_nativeData.data() + start * typeSize, frameIn, m_mult[2] * typeSize);
+    m_frameCacheValid[brickIndex + component * m_dimensions[3]] = 0;//keep the memory, the frame gets converted again in place if requested
+}
+
 void VolumeBase::VolumeStorage::setValueAllVoxels(const float value)
 {
+    if (m_storageType != STORAGE_FLOAT32)
+    {
+        bool allNative = true;
+        for (int64_t i = 0; i < m_mult[4]; ++i)
+        {
+            if (!setNativeValue(value, i))
+            {
+                allNative = false;
+                break;
+            }
+        }
+        if (allNative) return;
+        setNativeStorage(STORAGE_FLOAT32, 1.0, 0.0);//about to overwrite everything, so don't bother converting
+    }
     for (int64_t i = 0; i < m_mult[4]; ++i)
     {
         m_data[i] = value;
@@ -402,6 +684,12 @@ void VolumeBase::VolumeStorage::setValueAllVoxels(const float value)
 void VolumeBase::VolumeStorage::swap(VolumeStorage& rhs)
 {
     m_data.swap(rhs.m_data);
+    m_nativeData.swap(rhs.m_nativeData);
+    m_frameCache.swap(rhs.m_frameCache);
+    m_frameCacheValid.swap(rhs.m_frameCacheValid);
+    std::swap(m_storageType, rhs.m_storageType);
+    std::swap(m_scale, rhs.m_scale);
+    std::swap(m_offset, rhs.m_offset);
     for (int i = 0; i < 5; ++i)
     {
         std::swap(m_dimensions[i], rhs.m_dimensions[i]);
@@ -437,6 +725,12 @@ vector<int64_t> VolumeBase::VolumeStorage::getDimensions() const
 void VolumeBase::VolumeStorage::clear()
 {
     m_data.clear();
+    vector<char>().swap(m_nativeData);
+    vector<vector<float> >().swap(m_frameCache);
+    vector<char>().swap(m_frameCacheValid);
+    m_storageType = STORAGE_FLOAT32;
+    m_scale = 1.0;
+    m_offset = 0.0;
     for (int i = 0; i < 5; ++i)
     {
         m_dimensions[i] = 0;
@@ -25,6 +25,7 @@
 #include "stdint.h"
 #include <vector>
 #include "CaretAssert.h"
+#include "CaretMutex.h"
 #include "CaretPointer.h"
 #include "VolumeMappableInterface.h"
 #include "VolumeSpace.h"
@@ -44,19 +45,44 @@ namespace caret {
     
     class VolumeBase : public VolumeMappableInterface
     {
+    public:
+        ///how voxel values are held in memory - integer types keep the on-disk type (without applying the scaling) to save memory
+        enum StorageType
+        {
+            STORAGE_FLOAT32,
+            STORAGE_UINT8,
+            STORAGE_INT8,
+            STORAGE_UINT16,
+            STORAGE_INT16
+        };
+    private:
         class VolumeStorage
         {
             std::vector<float> m_data;
+            std::vector<char> m_nativeData;//used instead of m_data when m_storageType isn't float
+            StorageType m_storageType;
+            double m_scale, m_offset;//value = raw * m_scale + m_offset, for native storage only
+            mutable std::vector<std::vector<float> > m_frameCache;//one entry per frame, each allocated only when getFrame is called on that frame with native storage
+            mutable std::vector<char> m_frameCacheValid;//per frame, not vector<bool> so different frames can be set from different threads
+            mutable CaretMutex m_cacheMutex;//only taken to convert a frame that isn't in the cache yet
             int64_t m_dimensions[5];//store internally as 4d+component
             int64_t m_mult[5];//precalculated multipliers for getIndex/getValue/setValue - NOTE: [0] is for index[1], [4] is the entire size of the data
             VolumeStorage(const VolumeStorage& rhs);//deny copy, assignment for now
             VolumeStorage& operator=(const VolumeStorage& rhs);
+            float getNativeValue(const int64_t& index) const;
+            bool setNativeValue(const float& valueIn, const int64_t& index);//returns false if the value can't be represented exactly
+            int64_t getFrameStart(const int64_t& brickIndex, const int64_t& component) const { return brickIndex * m_mult[2] + component * m_mult[3]; }
         public:
             VolumeStorage();
             VolumeStorage(int64_t dims[5]);
             void reinitialize(int64_t dims[5]);
             void clear();
             
+            ///switch to integer storage, discarding the current contents, values are raw * scale + offset
+            void setNativeStorage(const StorageType& storageType, const double& scale, const double& offset);
+            const StorageType& getStorageType() const { return m_storageType; }
+            void convertToFloat();
+            
             void getDimensions(std::vector<int64_t>& dimOut) const;//NOTE: always returns a vector of 5 elements
             void getDimensions(int64_t& dimOut1, int64_t& dimOut2, int64_t& dimOut3, int64_t& dimTimeOut, int64_t& numComponents) const;
             std::vector<int64_t> getDimensions() const;
@@ -68,12 +94,14 @@ namespace caret {
             void swap(VolumeStorage& rhs);
             
             ///get a value at three indexes and optionally timepoint
-            inline const float& getValue(const int64_t& indexIn1, const int64_t& indexIn2, const int64_t& indexIn3, const int64_t brickIndex, const int64_t component) const
+            inline float getValue(const int64_t& indexIn1, const int64_t& indexIn2, const int64_t& indexIn3, const int64_t brickIndex, const int64_t component) const
             {
                 CaretAssert(indexValid(indexIn1, indexIn2, indexIn3, brickIndex, component));//assert so release version isn't slowed by checking
-                return m_data[getIndex(indexIn1, indexIn2, indexIn3, brickIndex, component)];
+                int64_t index = getIndex(indexIn1, indexIn2, indexIn3, brickIndex, component);
+                if (m_storageType == STORAGE_FLOAT32) return m_data[index];
+                return getNativeValue(index);
             }
-            inline const float& getValue(const int64_t indexIn[3], const int64_t brickIndex, const int64_t component) const
+            inline float getValue(const int64_t indexIn[3], const int64_t brickIndex, const int64_t component) const
             {
                 return getValue(indexIn[0], indexIn[1], indexIn[2], brickIndex, component);
             }
@@ -108,7 +136,12 @@ namespace caret {
             inline void setValue(const float& valueIn, const int64_t& indexIn1, const int64_t& indexIn2, const int64_t& indexIn3, const int64_t brickIndex, const int64_t component)
             {
                 CaretAssert(indexValid(indexIn1, indexIn2, indexIn3, brickIndex, component));//assert so release version isn't slowed by checking
-                m_data[getIndex(indexIn1, indexIn2, indexIn3, brickIndex, component)] = valueIn;
+                int64_t index = getIndex(indexIn1, indexIn2, indexIn3, brickIndex, component);
+                if (m_storageType != STORAGE_FLOAT32 && !setNativeValue(valueIn, index))
+                {
+                    convertToFloat();
+                }
+                if (m_storageType == STORAGE_FLOAT32) m_data[index] = valueIn;
             }
             inline void setValue(const float& valueIn, const int64_t indexIn[3], const int64_t brickIndex, const int64_t component)
             {
@@ -118,11 +151,26 @@ namespace caret {
             /// set every voxel to the given value
             void setValueAllVoxels(const float value);
             
-            ///get a frame (const)
+            ///get a frame (const), native storage converts the frame the first time it is requested, and keeps it until the volume is modified
             const float* getFrame(const int64_t brickIndex = 0, const int64_t component = 0) const;
             
+            ///get a frame without adding it to the cache, native storage is converted into scratch, for callers that only need the frame briefly
+            const float* getFrameUncached(std::vector<float>& scratch, const int64_t brickIndex = 0, const int64_t component = 0) const;
+            
+            ///copy a frame as float values, without caching a converted frame
+            void getFrameCopy(float* frameOut, const int64_t brickIndex = 0, const int64_t component = 0) const;
+            
+            ///get a frame rounded to integers, native storage without scaling doesn't go through float
+            void getFrameRounded(int32_t* frameOut, const int64_t brickIndex = 0, const int64_t component = 0) const;
+            
+            ///raw integer data of a frame, NULL when storage is float
+            const void* getNativeFrame(const int64_t brickIndex = 0, const int64_t component = 0) const;
+            
             ///set a frame
             void setFrame(const float* frameIn, const int64_t brickIndex = 0, const int64_t component = 0);
+            
+            ///set a frame of raw integer data, for native storage only
+            void setNativeFrame(const void* frameIn, const int64_t brickIndex = 0, const int64_t component = 0);
         };
         
         VolumeStorage m_storage;
@@ -216,13 +264,13 @@ namespace caret {
         inline const VolumeSpace& getVolumeSpace() const { return m_volSpace; }
 
         ///get a value at an index triplet and optionally timepoint
-        inline const float& getValue(const int64_t* indexIn, const int64_t brickIndex = 0, const int64_t component = 0) const
+        inline float getValue(const int64_t* indexIn, const int64_t brickIndex = 0, const int64_t component = 0) const
         {
             return m_storage.getValue(indexIn[0], indexIn[1], indexIn[2], brickIndex, component);
         }
         
         ///get a value at three indexes and optionally timepoint
-        inline const float& getValue(const int64_t& indexIn1, const int64_t& indexIn2, const int64_t& indexIn3, const int64_t brickIndex = 0, const int64_t component = 0) const
+        inline float getValue(const int64_t& indexIn1, const int64_t& indexIn2, const int64_t& indexIn3, const int64_t brickIndex = 0, const int64_t component = 0) const
         {
             return m_storage.getValue(indexIn1, indexIn2, indexIn3, brickIndex, component);
         }
@@ -306,9 +354,34 @@ namespace caret {
             return 0.0;
         }
         
-        ///get a frame (const)
+        ///get a frame (const) - for integer storage, this converts and keeps a float copy of the frame, so prefer the functions below when they suffice
         const float* getFrame(const int64_t brickIndex = 0, const int64_t component = 0) const { return m_storage.getFrame(brickIndex, component); }
         
+        ///get a frame without caching a converted copy of integer storage, the returned pointer may point into scratch
+        const float* getFrameUncached(std::vector<float>& scratch, const int64_t brickIndex = 0, const int64_t component = 0) const { return m_storage.getFrameUncached(scratch, brickIndex, component); }
+        
+        ///copy a frame into provided memory, does not keep a float copy of integer storage
+        void getFrameCopy(float* frameOut, const int64_t brickIndex = 0, const int64_t component = 0) const { m_storage.getFrameCopy(frameOut, brickIndex, component); }
+        
+        ///get a frame rounded to the nearest integer, for label keys and masks
+        void getFrameRounded(int32_t* frameOut, const int64_t brickIndex = 0, const int64_t component = 0) const { m_storage.getFrameRounded(frameOut, brickIndex, component); }
+        
+        ///type of the in-memory voxel data, see getNativeFrame
+        const StorageType& getStorageType() const { return m_storage.getStorageType(); }
+        
+        ///raw voxel data of a frame when getStorageType() isn't STORAGE_FLOAT32 (NULL otherwise), without the header scaling applied
+        const void* getNativeFrame(const int64_t brickIndex = 0, const int64_t component = 0) const { return m_storage.getNativeFrame(brickIndex, component); }
+        
+        ///switch to keeping integer data in its native type, discarding the current voxel values, for use by file reading
+        ///NOTE: setting a value that the type can't hold converts the whole volume to float, so don't modify such a volume from multiple threads
+        void setNativeStorage(const StorageType& storageType, const double& scale = 1.0, const double& offset = 0.0) { m_storage.setNativeStorage(storageType, scale, offset); setModified(); }
+        
+        ///convert integer storage to float, keeping the values
+        void convertToFloatStorage() { m_storage.convertToFloat(); }
+        
+        ///set a frame of raw data in the type given to setNativeStorage
+        void setNativeFrame(const void* frameIn, const int64_t brickIndex = 0, const int64_t component = 0) { m_storage.setNativeFrame(frameIn, brickIndex, component); setModified(); }
+        
         ///set a value at an index triplet and optionally timepoint
         inline void setValue(const float& valueIn, const int64_t* indexIn, const int64_t brickIndex = 0, const int64_t component = 0)
         {
@@ -110,6 +110,9 @@ m_textRenderer(NULL)
     this->openGL = NULL;
     this->borderBeingDrawn = new Border();
     
+    m_tabImageReuseRequested = false;
+    m_tabImagesInvalidated = true;
+    
     m_mousePositionValid = false;
     m_mousePositionEvent.grabNew(new MouseEvent(NULL,
                                                 NULL,
@@ -556,8 +559,21 @@ BrainOpenGLWidget::paintGL()
     else {
         this->openGL->setBorderBeingDrawn(NULL);
     }
+    
+    /*
+     * Tile tabs may be drawn from their saved images only when every
+     * update since the last drawing was limited to tab content that
+     * is in the tab's graphics content key.  Paints not requested by
+     * an update event (expose, resize, image capture) draw all tabs.
+     */
+    this->openGL->setReuseUnchangedTabImages(m_tabImageReuseRequested
+                                             && ( ! m_tabImagesInvalidated));
+    m_tabImageReuseRequested = false;
+    m_tabImagesInvalidated   = false;
+    
     this->openGL->drawModels(GuiManager::get()->getBrain(),
                              this->drawingViewportContents);
+    this->openGL->setReuseUnchangedTabImages(false);
     
     /*
      * Issue browser window redrawn event
@@ -1445,6 +1461,13 @@ BrainOpenGLWidget::receiveEvent(Event* event)
         
         updateAllEvent->setEventProcessed();
         
+        if (updateAllEvent->isReuseUnchangedTabImages()) {
+            m_tabImageReuseRequested = true;
+        }
+        else {
+            m_tabImagesInvalidated = true;
+        }
+        
         if (updateAllEvent->isRepaint()) {
             this->repaint();
         }
@@ -1464,6 +1487,13 @@ BrainOpenGLWidget::receiveEvent(Event* event)
         if (updateOneEvent->getWindowIndex() == this->windowIndex) {
             updateOneEvent->setEventProcessed();
             
+            if (updateOneEvent->isReuseUnchangedTabImages()) {
+                m_tabImageReuseRequested = true;
+            }
+            else {
+                m_tabImagesInvalidated = true;
+            }
+            
 #ifdef WORKBENCH_USE_QT5_QOPENGL_WIDGET
             this->update();
 #else
@@ -191,6 +191,12 @@ namespace caret {
         bool    m_mousePositionValid;
         CaretPointer<MouseEvent> m_mousePositionEvent;
         
+        /** A graphics update allowing reuse of unchanged tile tab images is pending */
+        bool m_tabImageReuseRequested;
+        
+        /** A graphics update that may change any tab is pending */
+        bool m_tabImagesInvalidated;
+        
         static bool s_defaultGLFormatInitialized;
     };
     
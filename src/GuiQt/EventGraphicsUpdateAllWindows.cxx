@@ -40,6 +40,7 @@ EventGraphicsUpdateAllWindows::EventGraphicsUpdateAllWindows(const bool doRepain
 : Event(EventTypeEnum::EVENT_GRAPHICS_UPDATE_ALL_WINDOWS)
 {
     this->doRepaint = doRepaint;
+    this->reuseUnchangedTabImages = false;
 }
 
 /*
@@ -60,3 +61,28 @@ EventGraphicsUpdateAllWindows::isRepaint() const
     return this->doRepaint; 
 }
 
+/**
+ * Indicate that the changes that require this update are limited
+ * to state in BrowserTabContent::getGraphicsContentKey() (overlay
+ * selections, viewing transformations, volume slices) so that tile
+ * tabs whose key is unchanged may be drawn from their saved image.
+ *
+ * @return Reference to this event.
+ */
+EventGraphicsUpdateAllWindows&
+EventGraphicsUpdateAllWindows::setReuseUnchangedTabImages()
+{
+    this->reuseUnchangedTabImages = true;
+    return *this;
+}
+
+/**
+ * @return True if tile tabs whose content is unchanged may be drawn
+ * from their saved image.
+ */
+bool
+EventGraphicsUpdateAllWindows::isReuseUnchangedTabImages() const
+{
+    return this->reuseUnchangedTabImages;
+}
+
@@ -36,12 +36,18 @@ namespace caret {
         
         bool isRepaint() const;
         
+        EventGraphicsUpdateAllWindows& setReuseUnchangedTabImages();
+        
+        bool isReuseUnchangedTabImages() const;
+        
     private:
         EventGraphicsUpdateAllWindows(const EventGraphicsUpdateAllWindows&);
         
         EventGraphicsUpdateAllWindows& operator=(const EventGraphicsUpdateAllWindows&);
         
         bool doRepaint;
+        
+        bool reuseUnchangedTabImages;
     };
 
 } // namespace
@@ -35,6 +35,7 @@ EventGraphicsUpdateOneWindow::EventGraphicsUpdateOneWindow(const int32_t windowI
 : Event(EventTypeEnum::EVENT_GRAPHICS_UPDATE_ONE_WINDOW)
 {
     this->windowIndex = windowIndex;
+    this->reuseUnchangedTabImages = false;
 }
 
 /*
@@ -45,3 +46,28 @@ EventGraphicsUpdateOneWindow::~EventGraphicsUpdateOneWindow()
     
 }
 
+/**
+ * Indicate that the changes that require this update are limited
+ * to state in BrowserTabContent::getGraphicsContentKey() (overlay
+ * selections, viewing transformations, volume slices) so that tile
+ * tabs whose key is unchanged may be drawn from their saved image.
+ *
+ * @return Reference to this event.
+ */
+EventGraphicsUpdateOneWindow&
+EventGraphicsUpdateOneWindow::setReuseUnchangedTabImages()
+{
+    this->reuseUnchangedTabImages = true;
+    return *this;
+}
+
+/**
+ * @return True if tile tabs whose content is unchanged may be drawn
+ * from their saved image.
+ */
+bool
+EventGraphicsUpdateOneWindow::isReuseUnchangedTabImages() const
+{
+    return this->reuseUnchangedTabImages;
+}
+
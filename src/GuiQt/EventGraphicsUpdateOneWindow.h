@@ -37,6 +37,10 @@ namespace caret {
         /// get the index of the window that is to be updated.
         int32_t getWindowIndex() const { return this->windowIndex; }
         
+        EventGraphicsUpdateOneWindow& setReuseUnchangedTabImages();
+        
+        bool isReuseUnchangedTabImages() const;
+        
     private:
         EventGraphicsUpdateOneWindow(const EventGraphicsUpdateOneWindow&);
         
@@ -44,6 +48,9 @@ namespace caret {
         
         /** index of window for update */
         int32_t windowIndex;
+        
+        /** tabs with unchanged graphics content key may be drawn from their saved image */
+        bool reuseUnchangedTabImages;
     };
 
 } // namespace
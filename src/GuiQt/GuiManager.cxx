@@ -644,6 +644,7 @@ GuiManager::testForModifiedFiles(const TestModifiedMode testModifiedMode,
     std::vector<DataFileTypeEnum::Enum> dataFileTypesToExclude;
     dataFileTypesToExclude.push_back(DataFileTypeEnum::CONNECTIVITY_DENSE);
     dataFileTypesToExclude.push_back(DataFileTypeEnum::CONNECTIVITY_DENSE_DYNAMIC);
+    dataFileTypesToExclude.push_back(DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE);
     dataFileTypesToExclude.push_back(DataFileTypeEnum::CONNECTIVITY_FIBER_ORIENTATIONS_TEMPORARY);
     dataFileTypesToExclude.push_back(DataFileTypeEnum::CONNECTIVITY_FIBER_TRAJECTORY_TEMPORARY);
     
@@ -789,12 +789,18 @@ OverlayViewController::updateUserInterface()
 void
 OverlayViewController::updateGraphicsWindow()
 {
-    EventManager::get()->sendEvent(EventSurfaceColoringInvalidate().getPointer());
     if (this->overlay->getMapYokingGroup() != MapYokingGroupEnum::MAP_YOKING_GROUP_OFF) {
+        EventManager::get()->sendEvent(EventSurfaceColoringInvalidate().getPointer());
         EventManager::get()->sendEvent(EventGraphicsUpdateAllWindows().getPointer());
     }
     else {
-        EventManager::get()->sendEvent(EventGraphicsUpdateOneWindow(this->browserWindowIndex).getPointer());
+        /*
+         * Without map yoking only this tab's overlay selections
+         * changed so other tile tabs may reuse their images, and
+         * surface coloring is updated through the overlay coloring
+         * key without invalidating the coloring of other tabs.
+         */
+        EventManager::get()->sendEvent(EventGraphicsUpdateOneWindow(this->browserWindowIndex).setReuseUnchangedTabImages().getPointer());
     }
 }
 
@@ -351,7 +351,7 @@ UserInputModeView::updateGraphics(const MouseEvent& mouseEvent)
     if (mouseEvent.getViewportContent() != NULL) {
         BrowserTabContent* browserTabContent = mouseEvent.getViewportContent()->getBrowserTabContent();
         const int32_t browserWindowIndex = mouseEvent.getBrowserWindowIndex();
-        EventManager::get()->sendEvent(EventGraphicsUpdateOneWindow(browserWindowIndex).getPointer());
+        EventManager::get()->sendEvent(EventGraphicsUpdateOneWindow(browserWindowIndex).setReuseUnchangedTabImages().getPointer());
         
         if (browserTabContent != NULL) {
             if (browserTabContent->isYoked()) {
@@ -365,7 +365,7 @@ UserInputModeView::updateGraphics(const MouseEvent& mouseEvent)
      * If not yoked, just need to update graphics.
      */
     if (issuedYokeEvent == false) {
-        EventManager::get()->sendEvent(EventGraphicsUpdateOneWindow(mouseEvent.getBrowserWindowIndex()).getPointer());
+        EventManager::get()->sendEvent(EventGraphicsUpdateOneWindow(mouseEvent.getBrowserWindowIndex()).setReuseUnchangedTabImages().getPointer());
     }
 }
 
@@ -46,7 +46,7 @@ namespace caret
         CaretMutex m_mutex;//protect multithreaded calls from each other
         int numBytesPerElem();//for resizing scratch
         template<typename TO, typename FROM>
-        void convertRead(TO* out, FROM* in, const int64_t& count);//for reading from file
+        void convertRead(TO* out, FROM* in, const int64_t& count, const bool& applyScaling);//for reading from file
         template<typename TO, typename FROM>
         void convertWrite(TO* out, const FROM* in, const int64_t& count);//for writing to file
         template<typename TO, typename FROM>
@@ -62,14 +62,15 @@ namespace caret
         int getNumComponents() const;
         //to read/write 1 frame of a standard volume file, call with fullDims = 3, indexSelect containing indexes for any of dims 4-7 that exist
         //NOTE: you need to provide storage for all components within the range, if getNumComponents() == 3 and fullDims == 0, you need 3 elements allocated
+        //set applyScaling to false to get the stored values, for keeping integer data in its own type
         template<typename T>
-        void readData(T* dataOut, const int& fullDims, const std::vector<int64_t>& indexSelect, const bool& tolerateShortRead = false);
+        void readData(T* dataOut, const int& fullDims, const std::vector<int64_t>& indexSelect, const bool& tolerateShortRead = false, const bool& applyScaling = true);
         template<typename T>
         void writeData(const T* dataIn, const int& fullDims, const std::vector<int64_t>& indexSelect);
     };
     
     template<typename T>
-    void NiftiIO::readData(T* dataOut, const int& fullDims, const std::vector<int64_t>& indexSelect, const bool& tolerateShortRead)
+    void NiftiIO::readData(T* dataOut, const int& fullDims, const std::vector<int64_t>& indexSelect, const bool& tolerateShortRead, const bool& applyScaling)
     {
         CaretAssert(fullDims >= 0 && fullDims <= (int)m_dims.size());
         CaretAssert((size_t)fullDims + indexSelect.size() == m_dims.size());//could be >=, but should catch more stupid mistakes as ==
@@ -101,40 +102,40 @@ namespace caret
         {
             case NIFTI_TYPE_UINT8:
             case NIFTI_TYPE_RGB24://handled by components
-                convertRead(dataOut, (uint8_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (uint8_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_INT8:
-                convertRead(dataOut, (int8_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (int8_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_UINT16:
-                convertRead(dataOut, (uint16_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (uint16_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_INT16:
-                convertRead(dataOut, (int16_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (int16_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_UINT32:
-                convertRead(dataOut, (uint32_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (uint32_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_INT32:
-                convertRead(dataOut, (int32_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (int32_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_UINT64:
-                convertRead(dataOut, (uint64_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (uint64_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_INT64:
-                convertRead(dataOut, (int64_t*)m_scratch.data(), numElems);
+                convertRead(dataOut, (int64_t*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_FLOAT32:
             case NIFTI_TYPE_COMPLEX64://components
-                convertRead(dataOut, (float*)m_scratch.data(), numElems);
+                convertRead(dataOut, (float*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_FLOAT64:
             case NIFTI_TYPE_COMPLEX128:
-                convertRead(dataOut, (double*)m_scratch.data(), numElems);
+                convertRead(dataOut, (double*)m_scratch.data(), numElems, applyScaling);
                 break;
             case NIFTI_TYPE_FLOAT128:
             case NIFTI_TYPE_COMPLEX256:
-                convertRead(dataOut, (long double*)m_scratch.data(), numElems);
+                convertRead(dataOut, (long double*)m_scratch.data(), numElems, applyScaling);
                 break;
             default:
                 CaretAssert(0);
@@ -211,14 +212,14 @@ namespace caret
     }
     
     template<typename TO, typename FROM>
-    void NiftiIO::convertRead(TO* out, FROM* in, const int64_t& count)
+    void NiftiIO::convertRead(TO* out, FROM* in, const int64_t& count, const bool& applyScaling)
     {
         if (m_header.isSwapped())
         {
             ByteSwapping::swapArray(in, count);
         }
         double mult, offset;
-        bool doScale = m_header.getDataScaling(mult, offset);
+        bool doScale = applyScaling && m_header.getDataScaling(mult, offset);
         if (std::numeric_limits<TO>::is_integer)//do round to nearest when integer output type
         {
             if (doScale)
@@ -0,0 +1,135 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026  Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "OperationCiftiCorrelationSparse.h"
+#include "OperationException.h"
+
+#include "AlgorithmCiftiCorrelation.h"
+#include "CiftiFile.h"
+
+#include <fstream>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+AString OperationCiftiCorrelationSparse::getCommandSwitch()
+{
+    return "-cifti-correlation-sparse";
+}
+
+AString OperationCiftiCorrelationSparse::getShortDescription()
+{
+    return "CORRELATE ROWS OF A CIFTI FILE, KEEPING ONLY THE STRONGEST VALUES";
+}
+
+OperationParameters* OperationCiftiCorrelationSparse::getParameters()
+{
+    OperationParameters* ret = new OperationParameters();
+    ret->addCiftiParameter(1, "cifti", "input cifti file");
+    
+    ret->addStringParameter(2, "wbsparse-out", "output - the output wbsparse file");//HACK: fake the output format since we don't have a wbsparse parameter type
+    
+    OptionalParameter* topKOpt = ret->createOptionalParameter(3, "-top-k", "keep a fixed number of values per row");
+    topKOpt->addIntegerParameter(1, "count", "the number of values with the largest magnitude to keep in each row");
+    
+    OptionalParameter* thresholdOpt = ret->createOptionalParameter(4, "-threshold", "keep values above a magnitude");
+    thresholdOpt->addDoubleParameter(1, "value", "the smallest magnitude to keep");
+    
+    OptionalParameter* weightsOpt = ret->createOptionalParameter(5, "-weights", "specify column weights");
+    weightsOpt->addStringParameter(1, "weight-file", "text file containing one weight per column");
+    
+    ret->createOptionalParameter(6, "-fisher-z", "apply fisher small z transform (ie, artanh) to correlation");
+    
+    ret->createOptionalParameter(7, "-no-demean", "instead of correlation, do dot product of rows, then normalize by diagonal");
+    
+    ret->createOptionalParameter(8, "-covariance", "compute covariance instead of correlation");
+    
+    OptionalParameter* memLimitOpt = ret->createOptionalParameter(9, "-mem-limit", "restrict memory usage");
+    memLimitOpt->addDoubleParameter(1, "limit-GB", "memory limit in gigabytes");
+    
+    ret->setHelpText(
+        AString("Computes the same values as -cifti-correlation, but only keeps the strongest values of each row, and writes them to a version 2 wbsparse file as they are computed, ") +
+        "instead of writing the full dense matrix.  " +
+        "At least one of -top-k or -threshold must be specified.  " +
+        "-top-k keeps the specified number of values with the largest magnitude in each row (ties are broken arbitrarily), " +
+        "-threshold keeps only values whose magnitude is at least the specified value, and if both are specified, each row keeps at most count values above the threshold.  " +
+        "NaN values are never kept.  " +
+        "Except with -covariance, the diagonal (each row's correlation with itself, which is 1, or about 7.25 with -fisher-z because r is clamped to 0.999999) is never kept, " +
+        "so it does not use up one of the -top-k values of every row.  " +
+        "The output is generally not symmetric, because each row is truncated separately.\n\n" +
+        "The output contains the dense mapping of the input along both dimensions, and the values are stored exactly.  " +
+        "For the meaning of the other options, see -cifti-correlation."
+    );
+    return ret;
+}
+
+void OperationCiftiCorrelationSparse::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
+{
+    LevelProgress myProgress(myProgObj);
+    CiftiFile* myCifti = myParams->getCifti(1);
+    AString outputName = myParams->getString(2);
+    int64_t topK = -1;
+    OptionalParameter* topKOpt = myParams->getOptionalParameter(3);
+    if (topKOpt->m_present)
+    {
+        topK = topKOpt->getInteger(1);
+        if (topK < 1) throw OperationException("-top-k count must be positive");
+    }
+    float threshold = -1.0f;
+    OptionalParameter* thresholdOpt = myParams->getOptionalParameter(4);
+    if (thresholdOpt->m_present)
+    {
+        threshold = (float)thresholdOpt->getDouble(1);
+        if (!(threshold >= 0.0f)) throw OperationException("-threshold value must not be negative");
+    }
+    if (!topKOpt->m_present && !thresholdOpt->m_present) throw OperationException("you must specify -top-k, -threshold, or both");
+    OptionalParameter* weightsOpt = myParams->getOptionalParameter(5);
+    vector<float>* weights = NULL, realweights;//NOTE: realweights is NOT a pointer
+    if (weightsOpt->m_present)
+    {
+        weights = &realweights;//point it to the actual vector to signify the option is present
+        AString weightFileName = weightsOpt->getString(1);
+        fstream weightListFile(weightFileName.toLocal8Bit().constData(), fstream::in);
+        if (!weightListFile.good())
+        {
+            throw OperationException("error reading weight list file");
+        }
+        float weight;
+        while (weightListFile >> weight)
+        {
+            realweights.push_back(weight);
+        }
+    }
+    bool fisherZ = myParams->getOptionalParameter(6)->m_present;
+    bool noDemean = myParams->getOptionalParameter(7)->m_present;
+    bool covariance = myParams->getOptionalParameter(8)->m_present;
+    float memLimitGB = -1.0f;
+    OptionalParameter* memLimitOpt = myParams->getOptionalParameter(9);
+    if (memLimitOpt->m_present)
+    {
+        memLimitGB = (float)memLimitOpt->getDouble(1);
+        if (memLimitGB < 0.0f)
+        {
+            throw OperationException("memory limit cannot be negative");
+        }
+    }
+    AlgorithmCiftiCorrelation(myProgObj, myCifti, outputName, topK, threshold, weights, fisherZ, memLimitGB, noDemean, covariance);
+}
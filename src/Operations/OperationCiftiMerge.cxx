@@ -22,8 +22,11 @@
 #include "OperationException.h"
 
 #include "CaretAssert.h"
+#include "CaretLogger.h"
+#include "CaretOMP.h"
 #include "CaretPointer.h"
 #include "CiftiFile.h"
+#include "CiftiGroupReader.h"
 
 #include <algorithm>
 
@@ -140,7 +143,7 @@ void OperationCiftiMerge::useParameters(OperationParameters* myParams, ProgressO
         default:
             CaretAssert(false);
     }
-    int64_t curCol = 0, scratchRowLength = 0;
+    int64_t curCol = 0;
     for (int i = 0; i < numInputs; ++i)
     {
         const CiftiFile* ciftiIn = myInputs[i]->getCifti(1);
@@ -150,7 +153,6 @@ void OperationCiftiMerge::useParameters(OperationParameters* myParams, ProgressO
         int numColumnOpts = (int)columnOpts.size();
         if (numColumnOpts > 0)
         {
-            scratchRowLength = max(scratchRowLength, thisXML.getDimensionLength(CiftiXML::ALONG_ROW));//if we use the entire row, we don't need a separate scratch row for it
             if (doLoop)
             {
                 for (int j = 0; j < numColumnOpts; ++j)
@@ -256,53 +258,78 @@ void OperationCiftiMerge::useParameters(OperationParameters* myParams, ProgressO
     }
     ciftiOut->setCiftiXML(outXML);
     int64_t numRows = baseColMapping.getLength();
-    vector<float> outRow(numOutColumns), scratchRow(scratchRowLength);
-    for (int64_t row = 0; row < numRows; ++row)
+    vector<const CiftiFile*> inputFiles(numInputs);
+    vector<int64_t> inputLengths(numInputs);
+    vector<vector<int64_t> > selectedColumns(numInputs);//empty means the whole row
+    for (int i = 0; i < numInputs; ++i)
     {
-        curCol = 0;
-        for (int i = 0; i < numInputs; ++i)
+        const CiftiFile* ciftiIn = myInputs[i]->getCifti(1);
+        inputFiles[i] = ciftiIn;
+        const CiftiXML& thisXML = ciftiIn->getCiftiXML();
+        inputLengths[i] = thisXML.getDimensionLength(CiftiXML::ALONG_ROW);
+        const vector<ParameterComponent*>& columnOpts = *(myInputs[i]->getRepeatableParameterInstances(2));
+        int numColumnOpts = (int)columnOpts.size();
+        for (int j = 0; j < numColumnOpts; ++j)
         {
-            const CiftiFile* ciftiIn = myInputs[i]->getCifti(1);
-            vector<int64_t> thisDims = ciftiIn->getDimensions();
-            const CiftiXML& thisXML = ciftiIn->getCiftiXML();
-            const vector<ParameterComponent*>& columnOpts = *(myInputs[i]->getRepeatableParameterInstances(2));
-            int numColumnOpts = (int)columnOpts.size();
-            if (numColumnOpts > 0)
+            int64_t initialColumn = thisXML.getMap(CiftiXML::ALONG_ROW)->getIndexFromNumberOrName(columnOpts[j]->getString(1));//this function has the 1-indexing convention built in
+            OptionalParameter* upToOpt = columnOpts[j]->getOptionalParameter(2);//we already checked that these strings give a valid column
+            if (upToOpt->m_present)
             {
-                ciftiIn->getRow(scratchRow.data(), row);
-                for (int j = 0; j < numColumnOpts; ++j)
+                int finalColumn = thisXML.getMap(CiftiXML::ALONG_ROW)->getIndexFromNumberOrName(upToOpt->getString(1));//ditto
+                bool reverse = upToOpt->getOptionalParameter(2)->m_present;
+                if (reverse)
                 {
-                    int64_t initialColumn = thisXML.getMap(CiftiXML::ALONG_ROW)->getIndexFromNumberOrName(columnOpts[j]->getString(1));//this function has the 1-indexing convention built in
-                    OptionalParameter* upToOpt = columnOpts[j]->getOptionalParameter(2);//we already checked that these strings give a valid column
-                    if (upToOpt->m_present)
+                    for (int c = finalColumn; c >= initialColumn; --c)
                     {
-                        int finalColumn = thisXML.getMap(CiftiXML::ALONG_ROW)->getIndexFromNumberOrName(upToOpt->getString(1));//ditto
-                        bool reverse = upToOpt->getOptionalParameter(2)->m_present;
-                        if (reverse)
-                        {
-                            for (int c = finalColumn; c >= initialColumn; --c)
-                            {
-                                outRow[curCol] = scratchRow[c];
-                                ++curCol;
-                            }
-                        } else {
-                            for (int c = initialColumn; c <= finalColumn; ++c)
-                            {
-                                outRow[curCol] = scratchRow[c];
-                                ++curCol;
-                            }
-                        }
-                    } else {
-                        outRow[curCol] = scratchRow[initialColumn];
-                        ++curCol;
+                        selectedColumns[i].push_back(c);
+                    }
+                } else {
+                    for (int c = initialColumn; c <= finalColumn; ++c)
+                    {
+                        selectedColumns[i].push_back(c);
                     }
                 }
             } else {
-                ciftiIn->getRow(outRow.data() + curCol, row);
-                curCol += thisDims[0];
+                selectedColumns[i].push_back(initialColumn);
             }
         }
-        CaretAssert(curCol == numOutColumns);
-        ciftiOut->setRow(outRow.data(), row);
     }
+    CiftiGroupReader myReader(inputFiles);//reads all inputs concurrently, a block of rows at a time
+    const int64_t rowsPerBlock = myReader.getRowsPerBlock();
+    vector<float> outBlock(rowsPerBlock * numOutColumns);
+    for (int64_t firstRow = 0; firstRow < numRows; firstRow += rowsPerBlock)
+    {
+        const int64_t blockRows = min(rowsPerBlock, numRows - firstRow);
+        myReader.readBlock(firstRow, blockRows);
+#pragma omp CARET_PARFOR schedule(dynamic)
+        for (int64_t r = 0; r < blockRows; ++r)
+        {
+            float* outRow = outBlock.data() + r * numOutColumns;
+            int64_t outCol = 0;
+            for (int i = 0; i < numInputs; ++i)
+            {
+                const float* inRow = myReader.getRow(i, firstRow + r);
+                if (selectedColumns[i].empty())
+                {
+                    for (int64_t c = 0; c < inputLengths[i]; ++c)
+                    {
+                        outRow[outCol] = inRow[c];
+                        ++outCol;
+                    }
+                } else {
+                    for (int64_t j = 0; j < (int64_t)selectedColumns[i].size(); ++j)
+                    {
+                        outRow[outCol] = inRow[selectedColumns[i][j]];
+                        ++outCol;
+                    }
+                }
+            }
+            CaretAssert(outCol == numOutColumns);
+        }
+        for (int64_t r = 0; r < blockRows; ++r)
+        {
+            ciftiOut->setRow(outBlock.data() + r * numOutColumns, firstRow + r);
+        }
+    }
+    CaretLogInfo("cifti merge " + myReader.getThroughputDescription());
 }
@@ -21,8 +21,12 @@
 #include "OperationCiftiStats.h"
 #include "OperationException.h"
 
+#include "CaretException.h"
+#include "CaretPointer.h"
 #include "CiftiFile.h"
+#include "CiftiRowSource.h"
 #include "ReductionOperation.h"
+#include "StreamingReduction.h"
 
 #include <algorithm>
 #include <cmath>
@@ -102,31 +106,22 @@ namespace
     float percentile(const vector<float>& data, const float& percent, const vector<float>& roiData)
     {
         CaretAssert(percent >= 0.0f && percent <= 100.0f);
+        if (roiData.empty()) return ReductionOperation::percentile(data.data(), data.size(), percent);
         vector<float> toUse;
-        if (roiData.empty())
+        int64_t numElems = (int64_t)data.size();
+        CaretAssert(numElems == (int64_t)roiData.size());
+        toUse.reserve(numElems);
+        for (int i = 0; i < numElems; ++i)
         {
-            toUse = data;
-        } else {
-            int64_t numElems = (int64_t)data.size();
-            CaretAssert(numElems == (int64_t)roiData.size());
-            toUse.reserve(numElems);
-            for (int i = 0; i < numElems; ++i)
+            if (roiData[i] > 0.0f)
             {
-                if (roiData[i] > 0.0f)
-                {
-                    toUse.push_back(data[i]);
-                }
+                toUse.push_back(data[i]);
             }
         }
         if (toUse.empty()) throw OperationException("roi is empty");
-        sort(toUse.begin(), toUse.end());
-        const float index = percent / 100.0f * (toUse.size() - 1);
-        if (index <= 0) return toUse[0];
-        if (index >= toUse.size() - 1) return toUse.back();
-        float ipart, fpart;
-        fpart = modf(index, &ipart);
-        return (1.0f - fpart) * toUse[(int)ipart] + fpart * toUse[((int)ipart) + 1];
+        return ReductionOperation::percentile(toUse.data(), toUse.size(), percent);
     }
+    
 }
 
 void OperationCiftiStats::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
@@ -189,8 +184,46 @@ void OperationCiftiStats::useParameters(OperationParameters* myParams, ProgressO
     bool showMapName = myParams->getOptionalParameter(6)->m_present;
     const CiftiMappingType* rowMap = myXML.getMap(CiftiXML::ALONG_ROW);
     vector<float> colScratch(colLength);
-    if (useColumn == -1)
-    {
+    if (useColumn == -1 && (percentileOpt->m_present || StreamingReduction::canReduce(myop, false)))
+    {//one sequential pass (a few for percentiles) over the rows, instead of getting every column
+        CiftiRowSource dataSource(myInput);
+        StreamingReduction myReduction(&dataSource);
+        CaretPointer<StreamingReduction::RowSource> roiSource;
+        if (matchColumnMode)
+        {
+            roiSource.grabNew(new CiftiRowSource(roiCifti));
+        } else if (roiCifti != NULL) {
+            roiSource.grabNew(new StreamingReduction::ColumnPointerSource(vector<const float*>(1, roiData.data()), colLength));
+        }
+        myReduction.setRoi(roiSource);
+        vector<float> results;
+        try
+        {
+            if (reduceOpt->m_present)
+            {
+                results = myReduction.reduce(myop);
+            } else {
+                results = myReduction.percentile(percent);
+            }
+        } catch (CaretException& e) {
+            throw OperationException(e);
+        }
+        const vector<int64_t>& counts = myReduction.getCounts();
+        for (int i = 0; i < numCols; ++i)
+        {
+            if (counts[i] == 0) throw OperationException("roi column is empty");
+        }
+        for (int i = 0; i < numCols; ++i)
+        {
+            if (showMapName)
+            {
+                cout << AString::number(i + 1) << ": " << rowMap->getIndexName(i) << ": ";
+            }
+            stringstream resultsstr;
+            resultsstr << setprecision(7) << results[i];
+            cout << resultsstr.str() << endl;
+        }
+    } else if (useColumn == -1) {
         myInput->convertToInMemory();//we will be getting all columns, so read it all in first
         if (matchColumnMode)
         {
@@ -21,11 +21,16 @@
 #include "OperationCiftiWeightedStats.h"
 #include "OperationException.h"
 
+#include "CaretException.h"
 #include "CaretHeap.h"
+#include "CaretPointer.h"
 #include "CiftiFile.h"
+#include "CiftiRowSource.h"
 #include "MetricFile.h"
+#include "StreamingReduction.h"
 #include "SurfaceFile.h"
 
+#include <algorithm>
 #include <cmath>
 #include <iomanip>
 #include <iostream>
@@ -217,6 +222,24 @@ namespace
         CaretAssert(false);//make sure execution never actually reaches end of function
         throw OperationException("internal error in weighted stats");
     }
+    
+    ReductionEnum::Enum toReduction(const OperationType& myop)
+    {
+        switch (myop)
+        {
+            case MEAN:
+                return ReductionEnum::MEAN;
+            case STDEV:
+                return ReductionEnum::STDEV;
+            case SAMPSTDEV:
+                return ReductionEnum::SAMPSTDEV;
+            case SUM:
+                return ReductionEnum::SUM;
+            case PERCENTILE:
+                break;
+        }
+        return ReductionEnum::INVALID;
+    }
 }
 
 void OperationCiftiWeightedStats::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
@@ -391,8 +414,94 @@ void OperationCiftiWeightedStats::useParameters(OperationParameters* myParams, P
     bool showMapName = myParams->getOptionalParameter(10)->m_present;
     const CiftiMappingType* rowMap = myXML.getMap(CiftiXML::ALONG_ROW);
     vector<float> inColumn(colLength);
-    if (useColumn == -1)
-    {
+    if (useColumn == -1 && myop != PERCENTILE)
+    {//one sequential pass over the rows, with each surface and the volume as a group of rows, instead of getting every column
+        const bool denseMode = (myXML.getMappingType(CiftiXML::ALONG_COLUMN) == CiftiMappingType::BRAIN_MODELS);
+        vector<int> rowGroups(colLength, 0);
+        vector<AString> groupNames;
+        if (denseMode)
+        {
+            const CiftiBrainModelsMap& myDenseMap = myXML.getBrainModelsMap(CiftiXML::ALONG_COLUMN);
+            vector<CiftiBrainModelsMap::ModelInfo> myModels = myDenseMap.getModelInfo();
+            rowGroups.assign(colLength, -1);
+            for (int j = 0; j < (int)myModels.size(); ++j)
+            {
+                if (myModels[j].m_type == CiftiBrainModelsMap::SURFACE)
+                {
+                    for (int64_t k = 0; k < myModels[j].m_indexCount; ++k)
+                    {
+                        rowGroups[myModels[j].m_indexStart + k] = (int)groupNames.size();
+                    }
+                    groupNames.push_back(StructureEnum::toName(myModels[j].m_structure));
+                }
+            }
+            vector<CiftiBrainModelsMap::VolumeMap> volMap = myDenseMap.getFullVolumeMap();
+            if (!volMap.empty())
+            {
+                for (int64_t k = 0; k < (int64_t)volMap.size(); ++k)
+                {
+                    rowGroups[volMap[k].m_ciftiIndex] = (int)groupNames.size();
+                }
+                groupNames.push_back("VOLUME");
+            }
+        }
+        const int numGroups = max(1, (int)groupNames.size());
+        if (roiOpt->m_present)
+        {//same check as doOperation, which only looks at the weights
+            vector<bool> haveData(numGroups, false);
+            for (int64_t k = 0; k < colLength; ++k)
+            {
+                if (rowGroups[k] >= 0 && combinedWeights[k] > 0.0f) haveData[rowGroups[k]] = true;
+            }
+            for (int g = 0; g < numGroups; ++g)
+            {
+                if (!haveData[g]) throw OperationException("roi column is empty");
+            }
+        }
+        CiftiRowSource dataSource(myInput);
+        StreamingReduction myReduction(&dataSource);
+        CaretPointer<StreamingReduction::RowSource> roiSource;
+        if (matchColumnMode)
+        {
+            roiSource.grabNew(new CiftiRowSource(myRoi));
+        } else if (myRoi != NULL) {
+            roiSource.grabNew(new StreamingReduction::ColumnPointerSource(vector<const float*>(1, roiData.data()), colLength));
+        }
+        vector<float> results;
+        try
+        {
+            myReduction.setRoi(roiSource);
+            myReduction.setWeights(combinedWeights);
+            myReduction.setGroups(rowGroups, numGroups);
+            results = myReduction.reduce(toReduction(myop));
+        } catch (CaretException& e) {
+            throw OperationException(e);
+        }
+        for (int64_t i = 0; i < numCols; ++i)
+        {
+            if (denseMode)
+            {
+                if (showMapName)
+                {
+                    cout << AString::number(i + 1) << ": " << rowMap->getIndexName(i) << ":" << endl;
+                }
+                for (int g = 0; g < numGroups; ++g)
+                {
+                    stringstream resultsstr;
+                    resultsstr << setprecision(7) << results[g * numCols + i];
+                    cout << groupNames[g] << ": " << resultsstr.str() << endl;
+                }
+            } else {
+                if (showMapName)
+                {
+                    cout << AString::number(i + 1) << ": " << rowMap->getIndexName(i) << ": ";
+                }
+                stringstream resultsstr;
+                resultsstr << setprecision(7) << results[i];
+                cout << resultsstr.str() << endl;
+            }
+        }
+    } else if (useColumn == -1) {
         myInput->convertToInMemory();//we will be getting all columns, so read it all in first
         if (matchColumnMode)
         {
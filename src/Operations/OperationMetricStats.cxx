@@ -21,8 +21,10 @@
 #include "OperationMetricStats.h"
 #include "OperationException.h"
 
+#include "CaretException.h"
 #include "MetricFile.h"
 #include "ReductionOperation.h"
+#include "StreamingReduction.h"
 
 #include <algorithm>
 #include <cmath>
@@ -100,28 +102,18 @@ namespace
     float percentile(const float* data, const int& numNodes, const float& percent, const float* roiData)
     {
         CaretAssert(percent >= 0.0f && percent <= 100.0f);
+        if (roiData == NULL) return ReductionOperation::percentile(data, numNodes, percent);
         vector<float> toUse;
-        if (roiData == NULL)
+        toUse.reserve(numNodes);
+        for (int i = 0; i < numNodes; ++i)
         {
-            toUse = vector<float>(data, data + numNodes);
-        } else {
-            toUse.reserve(numNodes);
-            for (int i = 0; i < numNodes; ++i)
+            if (roiData[i] > 0.0f)
             {
-                if (roiData[i] > 0.0f)
-                {
-                    toUse.push_back(data[i]);
-                }
+                toUse.push_back(data[i]);
             }
         }
         if (toUse.empty()) throw OperationException("roi contains no vertices");
-        sort(toUse.begin(), toUse.end());
-        const float index = percent / 100.0f * (toUse.size() - 1);
-        if (index <= 0) return toUse[0];
-        if (index >= toUse.size() - 1) return toUse.back();
-        float ipart, fpart;
-        fpart = modf(index, &ipart);
-        return (1.0f - fpart) * toUse[(int)ipart] + fpart * toUse[((int)ipart) + 1];
+        return ReductionOperation::percentile(toUse.data(), toUse.size(), percent);
     }
 }
 
@@ -177,8 +169,42 @@ void OperationMetricStats::useParameters(OperationParameters* myParams, Progress
         }
     }
     bool showMapName = myParams->getOptionalParameter(6)->m_present;
-    if (column == -1)
-    {
+    if (column == -1 && (percentileOpt->m_present || StreamingReduction::canReduce(myop, false)))
+    {//all maps at once, in parallel across maps
+        vector<const float*> dataColumns(numCols), roiColumns;
+        for (int i = 0; i < numCols; ++i)
+        {
+            dataColumns[i] = input->getValuePointerForColumn(i);
+            if (matchColumnMode) roiColumns.push_back(myRoi->getValuePointerForColumn(i));
+        }
+        if (roiData != NULL) roiColumns.push_back(roiData);
+        StreamingReduction::ColumnPointerSource dataSource(dataColumns, numNodes), roiSource(roiColumns, numNodes);
+        StreamingReduction myReduction(&dataSource);
+        if (myRoi != NULL) myReduction.setRoi(&roiSource);
+        vector<float> results;
+        try
+        {
+            if (reduceOpt->m_present)
+            {
+                results = myReduction.reduce(myop);
+            } else {
+                results = myReduction.percentile(percent);
+            }
+        } catch (CaretException& e) {
+            throw OperationException(e);
+        }
+        for (int i = 0; i < numCols; ++i)
+        {
+            if (myReduction.getCounts()[i] == 0) throw OperationException("roi contains no vertices");
+        }
+        for (int i = 0; i < numCols; ++i)
+        {
+            if (showMapName) cout << AString::number(i + 1) << ": " << input->getMapName(i) << ": ";
+            stringstream resultsstr;
+            resultsstr << setprecision(7) << results[i];
+            cout << resultsstr.str() << endl;
+        }
+    } else if (column == -1) {
         if (reduceOpt->m_present)
         {
             for (int i = 0; i < numCols; ++i)
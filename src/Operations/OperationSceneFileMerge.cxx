@@ -62,7 +62,7 @@ OperationParameters* OperationSceneFileMerge::getParameters()
 void OperationSceneFileMerge::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
 {
     LevelProgress myProgress(myProgObj);
-    SceneFile outSceneFile;
+    SceneFile outSceneFile;//copying a scene that hasn't been used doesn't parse it, and writeFile parses them one at a time
     const vector<ParameterComponent*>& myInputs = *(myParams->getRepeatableParameterInstances(2));
     int numInputs = (int)myInputs.size();
     if (numInputs == 0) throw OperationException("no inputs specified");
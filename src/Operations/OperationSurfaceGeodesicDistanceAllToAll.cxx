@@ -0,0 +1,223 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026  Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "OperationSurfaceGeodesicDistanceAllToAll.h"
+#include "OperationException.h"
+
+#include "CaretException.h"
+#include "CaretLogger.h"
+#include "CaretSparseFile.h"
+#include "CiftiFile.h"
+#include "GeodesicMultiSource.h"
+#include "MetricFile.h"
+#include "SurfaceFile.h"
+
+#include <fstream>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+AString OperationSurfaceGeodesicDistanceAllToAll::getCommandSwitch()
+{
+    return "-surface-geodesic-distance-all-to-all";
+}
+
+AString OperationSurfaceGeodesicDistanceAllToAll::getShortDescription()
+{
+    return "COMPUTE GEODESIC DISTANCE FROM MANY VERTICES";
+}
+
+OperationParameters* OperationSurfaceGeodesicDistanceAllToAll::getParameters()
+{
+    OperationParameters* ret = new OperationParameters();
+    ret->addSurfaceParameter(1, "surface", "the surface to compute on");
+    
+    ret->addStringParameter(2, "output", "output - the output dconn file, or wbsparse file with -sparse");//HACK: fake the output format, because the sparse option changes the type of the output file
+    
+    OptionalParameter* roiOpt = ret->createOptionalParameter(3, "-roi", "only compute distances between vertices in an roi");
+    roiOpt->addMetricParameter(1, "roi-metric", "the roi to use, as a metric");
+    
+    OptionalParameter* sourceOpt = ret->createOptionalParameter(4, "-source-list", "only compute distances from the listed vertices");
+    sourceOpt->addStringParameter(1, "vertex-list-file", "a text file containing the vertices to use as sources");
+    
+    OptionalParameter* limitOpt = ret->createOptionalParameter(5, "-limit", "stop at a certain distance");
+    limitOpt->addDoubleParameter(1, "limit-mm", "distance in mm to stop at");
+    limitOpt->createOptionalParameter(2, "-sparse", "write only the distances within the limit, to a version 2 wbsparse file");
+    
+    OptionalParameter* corrAreaOpt = ret->createOptionalParameter(6, "-corrected-areas", "vertex areas to use instead of computing them from the surface");
+    corrAreaOpt->addMetricParameter(1, "area-metric", "the corrected vertex areas, as a metric");
+    
+    ret->createOptionalParameter(7, "-naive", "use only neighbors, don't crawl triangles (not recommended)");
+    
+    ret->setHelpText(
+        AString("Computes geodesic distance from every source vertex to every vertex in the roi (or the entire surface), and writes it as a dconn, with a value of -1 for distances that were not computed.  ") +
+        "By default, every vertex in the roi (or the surface) is a source, so the output is square.  " +
+        "Use -source-list to compute only the rows for the vertices listed in a text file, which are output in order of increasing vertex number, without duplicates.  " +
+        "When -roi is also specified, listed vertices outside the roi are ignored.  " +
+        "Sources are processed in parallel, and rows are written as they are finished, so the output does not need to fit in memory.\n\n" +
+        "Use -limit to stop each search at the specified geodesic distance, which is much faster for small limits, such as for exclusion zones.  " +
+        "With -limit, -sparse writes the output as a version 2 wbsparse file instead of a dconn, which stores only the distances within the limit, exactly, " +
+        "and is much smaller when the limit is small compared to the surface.  " +
+        "When read, elements beyond the limit are zero rather than -1, but the distance from a vertex to itself is also zero, and is stored.  " +
+        "Name the sparse output with the .dconn.wbsparse extension so that wb_view can open it and display the row for a selected vertex.  " +
+        "The -corrected-areas option is intended for when it is unavoidable to compute distances on a group average surface, it is only an approximate correction " +
+        "for the reduction of structure in a group average surface.\n\n" +
+        "If -naive is not specified, it uses not just immediate neighbors, but also neighbors derived from crawling across pairs of triangles that share an edge."
+    );
+    return ret;
+}
+
+namespace
+{
+    class CiftiRowSink : public GeodesicMultiSource::RowSink
+    {
+        CiftiFile* m_ciftiOut;
+    public:
+        CiftiRowSink(CiftiFile* ciftiOut) : m_ciftiOut(ciftiOut) { }
+        void addRow(const int64_t& sourceIndex, const float* distances)
+        {
+            m_ciftiOut->setRow(distances, sourceIndex);
+        }
+    };
+    
+    class SparseFileRowSink : public GeodesicMultiSource::SparseRowSink
+    {
+        CaretSparseFileWriter* m_sparseOut;
+    public:
+        SparseFileRowSink(CaretSparseFileWriter* sparseOut) : m_sparseOut(sparseOut) { }
+        void addSparseRow(const int64_t& sourceIndex, const vector<int64_t>& columns, const vector<float>& distances)
+        {
+            m_sparseOut->writeFloatRowSparse(sourceIndex, columns, distances);
+        }
+    };
+}
+
+void OperationSurfaceGeodesicDistanceAllToAll::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
+{
+    LevelProgress myProgress(myProgObj);
+    SurfaceFile* mySurf = myParams->getSurface(1);
+    AString outputName = myParams->getString(2);
+    const int numNodes = mySurf->getNumberOfNodes();
+    const float* roiData = NULL;
+    OptionalParameter* roiOpt = myParams->getOptionalParameter(3);
+    if (roiOpt->m_present)
+    {
+        MetricFile* myRoi = roiOpt->getMetric(1);
+        if (myRoi->getNumberOfNodes() != numNodes) throw OperationException("roi metric doesn't match surface in number of vertices");
+        roiData = myRoi->getValuePointerForColumn(0);
+    }
+    vector<float> sourceRoi;
+    OptionalParameter* sourceOpt = myParams->getOptionalParameter(4);
+    if (sourceOpt->m_present)
+    {
+        AString listFileName = sourceOpt->getString(1);
+        fstream textFile(listFileName.toLocal8Bit().constData(), fstream::in);
+        if (!textFile.good())
+        {
+            throw OperationException("error opening list file for reading");
+        }
+        sourceRoi.resize(numNodes, 0.0f);
+        int nodenum;
+        textFile >> nodenum;
+        while (textFile)
+        {
+            if (nodenum < 0 || nodenum >= numNodes)
+            {
+                throw OperationException("invalid vertex number: " + AString::number(nodenum));
+            }
+            sourceRoi[nodenum] = 1.0f;
+            textFile >> nodenum;
+        }
+        if (roiData != NULL)
+        {//rows are only output for vertices in the roi
+            int64_t outsideCount = 0;
+            for (int i = 0; i < numNodes; ++i)
+            {
+                if (sourceRoi[i] > 0.0f && !(roiData[i] > 0.0f))
+                {
+                    sourceRoi[i] = 0.0f;
+                    ++outsideCount;
+                }
+            }
+            if (outsideCount > 0) CaretLogWarning(AString::number(outsideCount) + " listed source vertices are outside the roi, and will not be output");
+        }
+    }
+    float limit = -1.0f;
+    bool sparse = false;
+    OptionalParameter* limitOpt = myParams->getOptionalParameter(5);
+    if (limitOpt->m_present)
+    {
+        limit = (float)limitOpt->getDouble(1);
+        if (!(limit >= 0.0f)) throw OperationException("limit must be non-negative");
+        sparse = limitOpt->getOptionalParameter(2)->m_present;
+    }
+    const float* corrAreaData = NULL;
+    OptionalParameter* corrAreaOpt = myParams->getOptionalParameter(6);
+    if (corrAreaOpt->m_present)
+    {
+        MetricFile* corrAreas = corrAreaOpt->getMetric(1);
+        if (corrAreas->getNumberOfNodes() != numNodes) throw OperationException("corrected areas metric number of vertices does not match");
+        corrAreaData = corrAreas->getValuePointerForColumn(0);
+    }
+    bool smooth = !(myParams->getOptionalParameter(7)->m_present);
+    vector<int32_t> sources, targets;
+    for (int i = 0; i < numNodes; ++i)
+    {
+        if (roiData == NULL || roiData[i] > 0.0f)
+        {
+            targets.push_back(i);
+        }
+        if (sourceRoi.empty() ? (roiData == NULL || roiData[i] > 0.0f) : sourceRoi[i] > 0.0f)
+        {
+            sources.push_back(i);
+        }
+    }
+    if (sources.empty()) throw OperationException("no source vertices specified");
+    if (targets.empty()) throw OperationException("roi contains no vertices");
+    if (roiData == NULL) targets.clear();//empty means the whole surface, which avoids the per-target lookup
+    try
+    {
+        CiftiBrainModelsMap rowMap, colMap;
+        rowMap.addSurfaceModel(numNodes, mySurf->getStructure(), roiData);
+        colMap.addSurfaceModel(numNodes, mySurf->getStructure(), (sourceRoi.empty() ? roiData : sourceRoi.data()));
+        CiftiXML outXML;
+        outXML.setNumberOfDimensions(2);
+        outXML.setMap(CiftiXML::ALONG_ROW, rowMap);
+        outXML.setMap(CiftiXML::ALONG_COLUMN, colMap);
+        GeodesicMultiSource myEngine(mySurf, corrAreaData);
+        if (sparse)
+        {
+            CaretSparseFileWriter mySparseOut(outputName, outXML, 2);
+            SparseFileRowSink mySink(&mySparseOut);
+            myEngine.computeSparse(sources, targets, limit, &mySink, smooth);
+            mySparseOut.finish();
+        } else {
+            CiftiFile myCiftiOut;
+            myCiftiOut.setWritingFile(outputName);//write rows to disk as they are finished
+            myCiftiOut.setCiftiXML(outXML);
+            CiftiRowSink mySink(&myCiftiOut);
+            myEngine.computeDense(sources, targets, limit, &mySink, smooth);
+            myCiftiOut.writeFile(outputName);
+        }
+    } catch (CaretException& e) {
+        throw OperationException(e);
+    }
+}
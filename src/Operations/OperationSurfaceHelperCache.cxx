@@ -0,0 +1,77 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026  Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "OperationSurfaceHelperCache.h"
+#include "OperationException.h"
+
+#include "CaretException.h"
+#include "SurfaceFile.h"
+#include "SurfaceHelperCache.h"
+
+#include <QFile>
+
+using namespace caret;
+using namespace std;
+
+AString OperationSurfaceHelperCache::getCommandSwitch()
+{
+    return "-surface-helper-cache";
+}
+
+AString OperationSurfaceHelperCache::getShortDescription()
+{
+    return "PREBUILD THE GEODESIC HELPER CACHE FOR A SURFACE";
+}
+
+OperationParameters* OperationSurfaceHelperCache::getParameters()
+{
+    OperationParameters* ret = new OperationParameters();
+    ret->addSurfaceParameter(1, "surface", "the surface to build the cache for");
+    ret->createOptionalParameter(2, "-remove", "delete the cache file instead of building it");
+    ret->setHelpText(
+        AString("Computes the vertex neighbor and geodesic crawl information that geodesic distance computations need, and writes it to a file next to the surface, ") +
+        "with '" + SurfaceHelperCache::getCacheFileName("") + "' appended to the surface file name.  " +
+        "When that file exists and was built from a surface with identical coordinates and topology, wb_command and wb_view load it instead of recomputing it, " +
+        "otherwise it is ignored.  " +
+        "This is useful for template surfaces that are used in many geodesic computations, such as dilation, erosion, extrema finding, and geodesic distance, when -corrected-areas is not used.  " +
+        "The cache is found by the surface file name, so if the surface is moved or renamed, the cache file must be moved or renamed with it.  " +
+        "It must be rebuilt if the surface is modified."
+    );
+    return ret;
+}
+
+void OperationSurfaceHelperCache::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
+{
+    LevelProgress myProgress(myProgObj);
+    SurfaceFile* mySurf = myParams->getSurface(1);
+    bool removeCache = myParams->getOptionalParameter(2)->m_present;
+    AString cacheFileName = SurfaceHelperCache::getCacheFileName(mySurf->getFileName());
+    if (removeCache)
+    {
+        if (QFile::exists(cacheFileName) && !QFile::remove(cacheFileName)) throw OperationException("failed to remove file '" + cacheFileName + "'");
+        return;
+    }
+    try
+    {
+        SurfaceHelperCache::writeCache(mySurf, cacheFileName);
+    } catch (CaretException& e) {
+        throw OperationException(e);
+    }
+}
@@ -21,7 +21,9 @@
 #include "OperationVolumeStats.h"
 #include "OperationException.h"
 
+#include "CaretException.h"
 #include "ReductionOperation.h"
+#include "StreamingReduction.h"
 #include "VolumeFile.h"
 
 #include <algorithm>
@@ -100,28 +102,18 @@ namespace
     float percentile(const float* data, const int64_t& numElements, const float& percent, const float* roiData)
     {
         CaretAssert(percent >= 0.0f && percent <= 100.0f);
+        if (roiData == NULL) return ReductionOperation::percentile(data, numElements, percent);
         vector<float> toUse;
-        if (roiData == NULL)
+        toUse.reserve(numElements);
+        for (int64_t i = 0; i < numElements; ++i)
         {
-            toUse = vector<float>(data, data + numElements);
-        } else {
-            toUse.reserve(numElements);
-            for (int64_t i = 0; i < numElements; ++i)
+            if (roiData[i] > 0.0f)
             {
-                if (roiData[i] > 0.0f)
-                {
-                    toUse.push_back(data[i]);
-                }
+                toUse.push_back(data[i]);
             }
         }
         if (toUse.empty()) throw OperationException("roi contains no voxels");
-        sort(toUse.begin(), toUse.end());
-        const double index = percent / 100.0f * (toUse.size() - 1);
-        if (index <= 0) return toUse[0];
-        if (index >= toUse.size() - 1) return toUse.back();
-        double ipart, fpart;
-        fpart = modf(index, &ipart);
-        return (1.0f - fpart) * toUse[(int64_t)ipart] + fpart * toUse[((int64_t)ipart) + 1];
+        return ReductionOperation::percentile(toUse.data(), toUse.size(), percent);
     }
 }
 
@@ -179,8 +171,42 @@ void OperationVolumeStats::useParameters(OperationParameters* myParams, Progress
     }
     bool showMapName = myParams->getOptionalParameter(6)->m_present;
     int numMaps = input->getNumberOfMaps();
-    if (subvol == -1)
-    {
+    if (subvol == -1 && (percentileOpt->m_present || StreamingReduction::canReduce(myop, false)))
+    {//all subvolumes at once, in parallel across subvolumes
+        vector<const float*> dataFrames(numMaps), roiFrames;
+        for (int i = 0; i < numMaps; ++i)
+        {
+            dataFrames[i] = input->getFrame(i);
+            if (matchSubvolMode) roiFrames.push_back(myRoi->getFrame(i));
+        }
+        if (roiData != NULL) roiFrames.push_back(roiData);
+        StreamingReduction::ColumnPointerSource dataSource(dataFrames, frameSize), roiSource(roiFrames, frameSize);
+        StreamingReduction myReduction(&dataSource);
+        if (myRoi != NULL) myReduction.setRoi(&roiSource);
+        vector<float> results;
+        try
+        {
+            if (reduceOpt->m_present)
+            {
+                results = myReduction.reduce(myop);
+            } else {
+                results = myReduction.percentile(percent);
+            }
+        } catch (CaretException& e) {
+            throw OperationException(e);
+        }
+        for (int i = 0; i < numMaps; ++i)
+        {
+            if (myReduction.getCounts()[i] == 0) throw OperationException("roi contains no voxels");
+        }
+        for (int i = 0; i < numMaps; ++i)
+        {
+            if (showMapName) cout << AString::number(i + 1) << ": " << input->getMapName(i) << ": ";
+            stringstream resultsstr;
+            resultsstr << setprecision(7) << results[i];
+            cout << resultsstr.str() << endl;
+        }
+    } else if (subvol == -1) {
         if (reduceOpt->m_present)
         {
             for (int i = 0; i < numMaps; ++i)
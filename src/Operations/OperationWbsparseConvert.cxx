@@ -0,0 +1,111 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026  Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+#include "OperationWbsparseConvert.h"
+#include "OperationException.h"
+
+#include "CaretSparseFile.h"
+
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+AString OperationWbsparseConvert::getCommandSwitch()
+{
+    return "-wbsparse-convert";
+}
+
+AString OperationWbsparseConvert::getShortDescription()
+{
+    return "CONVERT A WBSPARSE FILE TO ANOTHER FORMAT VERSION";
+}
+
+OperationParameters* OperationWbsparseConvert::getParameters()
+{
+    OperationParameters* ret = new OperationParameters();
+    ret->addStringParameter(1, "wbsparse-in", "the input wbsparse file");
+    
+    ret->addStringParameter(2, "wbsparse-out", "output - the output wbsparse file");//HACK: fake the output format since we don't have a wbsparse parameter type (or file type, really)
+    
+    OptionalParameter* versionOpt = ret->createOptionalParameter(3, "-version", "choose the output format version");
+    versionOpt->addIntegerParameter(1, "version", "the version number, 1 or 2 (default 2)");
+    
+    ret->createOptionalParameter(4, "-compress", "compress blocks of rows in the output (version 2 only)");
+    
+    ret->createOptionalParameter(5, "-fibers", "the file contains fiber fractions, use the compact coding for them (version 2 only)");
+    
+    ret->setHelpText(
+        AString("Version 1 wbsparse files store each nonzero as a pair of 64-bit integers, and can be read by all versions of workbench.  ") +
+        "Version 2 stores the gaps between the column indices of each row as variable length integers, and the values as variable length integers, " +
+        "or, with -fibers, the streamline count as a variable length integer followed by the packed fractions and distance, and is usually several times smaller.  " +
+        "With -compress, each block of rows is also compressed with zlib, which makes the file smaller but makes reading rows in a random order slower.  " +
+        "Rows of float values, such as from -cifti-correlation-sparse, are copied exactly, and can only be written to version 2.  " +
+        "Both versions are read transparently."
+    );
+    return ret;
+}
+
+void OperationWbsparseConvert::useParameters(OperationParameters* myParams, ProgressObject* myProgObj)
+{
+    LevelProgress myProgress(myProgObj);
+    AString inputName = myParams->getString(1);
+    AString outputName = myParams->getString(2);
+    int32_t version = 2;
+    OptionalParameter* versionOpt = myParams->getOptionalParameter(3);
+    if (versionOpt->m_present)
+    {
+        version = (int32_t)versionOpt->getInteger(1);
+        if (version != 1 && version != 2) throw OperationException("version must be 1 or 2");
+    }
+    bool compress = myParams->getOptionalParameter(4)->m_present;
+    bool fibers = myParams->getOptionalParameter(5)->m_present;
+    if (compress && version != 2) throw OperationException("-compress requires version 2");
+    if (inputName == outputName) throw OperationException("output file must be different from the input file");//the writer truncates the output before the input is read
+    CaretSparseFile inFile(inputName);
+    const int64_t* dims = inFile.getDimensions();
+    if (version == 1)
+    {//check before the writer truncates the output file
+        for (int64_t i = 0; i < dims[1]; ++i)
+        {
+            if (inFile.isFloatRow(i)) throw OperationException("input file contains float values (row " + AString::number(i) + "), which require version 2");
+        }
+    }
+    CaretSparseFileWriter outFile(outputName, inFile.getCiftiXML(), version, compress);
+    vector<int64_t> indices, values;
+    vector<FiberFractions> fiberValues;
+    vector<float> floatValues;
+    for (int64_t i = 0; i < dims[1]; ++i)
+    {
+        if (inFile.isFloatRow(i))
+        {
+            inFile.getFloatRowSparse(i, indices, floatValues);
+            outFile.writeFloatRowSparse(i, indices, floatValues);
+        } else if (fibers)
+        {
+            inFile.getFibersRowSparse(i, indices, fiberValues);
+            if (!indices.empty()) outFile.writeFibersRowSparse(i, indices, fiberValues);
+        } else {
+            inFile.getRowSparse(i, indices, values);
+            if (!indices.empty()) outFile.writeRowSparse(i, indices, values);
+        }
+    }
+    outFile.finish();
+}
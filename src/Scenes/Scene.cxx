@@ -23,10 +23,15 @@
 #include "Scene.h"
 #undef __SCENE_DECLARE__
 
+#include <memory>
+
 #include "CaretAssert.h"
+#include "CaretLogger.h"
 #include "SceneAttributes.h"
 #include "SceneClass.h"
 #include "SceneInfo.h"
+#include "SceneSaxReader.h"
+#include "XmlSaxParser.h"
 
 using namespace caret;
 
@@ -236,13 +241,22 @@ Scene::Scene(const SceneTypeEnum::Enum sceneType)
     m_sceneAttributes = new SceneAttributes(sceneType);
     m_hasFilesWithRemotePaths = false;
     m_sceneInfo = new SceneInfo();
+    m_deferredSceneParsed = false;
 }
 
+/**
+ * Copy constructor.  A deferred scene that has not been parsed
+ * is copied without parsing it.
+ */
 Scene::Scene(const Scene& rhs) : CaretObject()
 {
     m_sceneAttributes = new SceneAttributes(*(rhs.m_sceneAttributes));
     m_hasFilesWithRemotePaths = rhs.m_hasFilesWithRemotePaths;
     m_sceneInfo = new SceneInfo(*(rhs.m_sceneInfo));
+    m_deferredSceneXml = rhs.m_deferredSceneXml;
+    m_deferredSceneFileName = rhs.m_deferredSceneFileName;
+    m_deferredSceneParsed = rhs.m_deferredSceneParsed;
+    m_deferredSceneError = rhs.m_deferredSceneError;
     for (std::vector<SceneClass*>::const_iterator iter = rhs.m_sceneClasses.begin(); iter != rhs.m_sceneClasses.end(); ++iter)
     {
         m_sceneClasses.push_back(new SceneClass(**iter));
@@ -256,7 +270,7 @@ Scene::~Scene()
 {
     delete m_sceneAttributes;
 
-    const int32_t numberOfSceneClasses = this->getNumberOfClasses();
+    const int32_t numberOfSceneClasses = m_sceneClasses.size();
     for (int32_t i = 0; i < numberOfSceneClasses; i++) {
         delete m_sceneClasses[i];
     }
@@ -287,6 +301,14 @@ void
 Scene::addClass(SceneClass* sceneClass)
 {
     if (sceneClass != NULL) {
+        loadDeferredScene();
+        
+        /*
+         * Scene no longer matches the deferred XML
+         */
+        m_deferredSceneXml.clear();
+        m_deferredSceneFileName = "";
+        
         m_sceneClasses.push_back(sceneClass);
     }
 }
@@ -298,6 +320,7 @@ Scene::addClass(SceneClass* sceneClass)
 int32_t
 Scene::getNumberOfClasses() const
 {
+    loadDeferredScene();
     return m_sceneClasses.size();
 }
 
@@ -310,6 +333,7 @@ Scene::getNumberOfClasses() const
 const SceneClass* 
 Scene::getClassAtIndex(const int32_t indx) const
 {
+    loadDeferredScene();
     CaretAssertVectorIndex(m_sceneClasses, indx);
     return m_sceneClasses[indx];
 }
@@ -401,6 +425,7 @@ Scene::setDescription(const AString& sceneDescription)
 bool
 Scene::hasFilesWithRemotePaths() const
 {
+    loadDeferredScene();
     return m_hasFilesWithRemotePaths;
 }
 
@@ -416,6 +441,134 @@ Scene::setHasFilesWithRemotePaths(const bool hasFilesWithRemotePaths)
     m_hasFilesWithRemotePaths = hasFilesWithRemotePaths;
 }
 
+/**
+ * Set the XML of the scene element so that the scene's classes are
+ * parsed only when they are first accessed.  The name, description,
+ * and scene info must already be set, they are not taken from the XML.
+ *
+ * @param sceneXml
+ *    XML of the scene element, as read from the scene file.
+ * @param sceneFileName
+ *    Name of the scene file, used for resolving relative paths.
+ */
+void
+Scene::setDeferredSceneXml(const QByteArray& sceneXml,
+                           const AString& sceneFileName)
+{
+    for (std::vector<SceneClass*>::iterator iter = m_sceneClasses.begin();
+         iter != m_sceneClasses.end();
+         iter++) {
+        delete *iter;
+    }
+    m_sceneClasses.clear();
+    
+    m_deferredSceneXml = sceneXml;
+    m_deferredSceneFileName = sceneFileName;
+    m_deferredSceneParsed = false;
+    m_deferredSceneError = "";
+    m_hasFilesWithRemotePaths = false;
+}
+
+/**
+ * @return true if the scene's classes have not yet been parsed
+ * from the deferred XML.
+ */
+bool
+Scene::isDeferred() const
+{
+    return (( ! m_deferredSceneXml.isEmpty())
+            && ( ! m_deferredSceneParsed));
+}
+
+/**
+ * Parse the deferred XML into the scene's classes if that has
+ * not already been done.
+ *
+ * @throws XmlSaxParserException
+ *    If there is an error parsing the scene.
+ */
+void
+Scene::parseDeferredScene() const
+{
+    if (m_deferredSceneParsed) {
+        if ( ! m_deferredSceneError.isEmpty()) {
+            throw XmlSaxParserException(m_deferredSceneError);
+        }
+        return;
+    }
+    if (m_deferredSceneXml.isEmpty()) {
+        return;
+    }
+    
+    /*
+     * Mark as parsed first so that a scene that fails to
+     * parse is not parsed again on every access
+     */
+    m_deferredSceneParsed = true;
+    
+    Scene tempScene(m_sceneAttributes->getSceneType());
+    SceneSaxReader saxReader(m_deferredSceneFileName,
+                             &tempScene);
+    std::auto_ptr<XmlSaxParser> parser(XmlSaxParser::createXmlParser());
+    try {
+        parser->parseString(QString::fromUtf8(m_deferredSceneXml.constData(),
+                                              m_deferredSceneXml.size()),
+                            &saxReader);
+    }
+    catch (const XmlSaxParserException& e) {
+        m_deferredSceneError = ("Error reading scene \""
+                                + getName()
+                                + "\" from "
+                                + m_deferredSceneFileName
+                                + ": "
+                                + e.whatString());
+        throw XmlSaxParserException(m_deferredSceneError);
+    }
+    
+    m_sceneClasses.swap(tempScene.m_sceneClasses);
+    m_hasFilesWithRemotePaths = tempScene.m_hasFilesWithRemotePaths;
+}
+
+/**
+ * Release the classes parsed from the deferred XML to save memory,
+ * they are parsed again when next accessed.  Does nothing if the
+ * scene was not read from a file or has been changed.
+ */
+void
+Scene::releaseParsedScene()
+{
+    if (m_deferredSceneXml.isEmpty()
+        || ( ! m_deferredSceneParsed)
+        || ( ! m_deferredSceneError.isEmpty())) {
+        return;
+    }
+    
+    for (std::vector<SceneClass*>::iterator iter = m_sceneClasses.begin();
+         iter != m_sceneClasses.end();
+         iter++) {
+        delete *iter;
+    }
+    m_sceneClasses.clear();
+    m_deferredSceneParsed = false;
+}
+
+/**
+ * Parse the deferred XML, if any, logging errors since
+ * the accessors that call this do not throw.
+ */
+void
+Scene::loadDeferredScene() const
+{
+    if (isDeferred()) {
+        try {
+            parseDeferredScene();
+        }
+        catch (const XmlSaxParserException& e) {
+            CaretLogSevere(e.whatString());
+        }
+    }
+}
+
 /**
  * Set a static value for the scene that is being created.
  */
@@ -22,6 +22,8 @@
 /*LICENSE_END*/
 
 
+#include <QByteArray>
+
 #include "CaretObject.h"
 #include "SceneTypeEnum.h"
 
@@ -78,6 +80,14 @@ namespace caret {
         
         void setHasFilesWithRemotePaths(const bool hasFilesWithRemotePaths);
 
+        void setDeferredSceneXml(const QByteArray& sceneXml,
+                                 const AString& sceneFileName);
+        
+        bool isDeferred() const;
+        
+        void parseDeferredScene() const;
+        
+        void releaseParsedScene();
         
         // ADD_NEW_METHODS_HERE
 
@@ -90,14 +100,28 @@ namespace caret {
         /** Attributes of the scene*/
         SceneAttributes* m_sceneAttributes;
 
-        /** Classes contained in the scene*/
-        std::vector<SceneClass*> m_sceneClasses;
+        void loadDeferredScene() const;
+        
+        /** Classes contained in the scene (mutable since deferred scenes are parsed when first accessed) */
+        mutable std::vector<SceneClass*> m_sceneClasses;
 
         /** Info about scene */
         SceneInfo* m_sceneInfo;
         
         /** True if it found a ScenePathName with a remote file */
-        bool m_hasFilesWithRemotePaths;
+        mutable bool m_hasFilesWithRemotePaths;
+        
+        /** Unparsed XML of the scene element, empty if the scene was not read from a file */
+        QByteArray m_deferredSceneXml;
+        
+        /** Name of file the deferred XML was read from, relative paths are relative to it */
+        AString m_deferredSceneFileName;
+        
+        /** True if the deferred XML has been parsed into the scene classes */
+        mutable bool m_deferredSceneParsed;
+        
+        /** Error from parsing the deferred XML, if any */
+        mutable AString m_deferredSceneError;
         
         /** When a scene is being created, this will be set */
         static Scene* s_sceneBeingCreated;
@@ -0,0 +1,151 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+#include "ClusterGraphTest.h"
+
+#include "ClusterGraph.h"
+#include "VolumeSpace.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+ClusterGraphTest::ClusterGraphTest(const AString& identifier) : TestInterface(identifier)
+{
+}
+
+void ClusterGraphTest::execute()
+{
+    const int64_t dims[3] = { 11, 9, 7 };
+    const float sform[12] = { 2.0f, 0.0f, 0.0f, 0.0f,
+                              0.0f, 2.0f, 0.0f, 0.0f,
+                              0.0f, 0.0f, 2.0f, 0.0f };
+    VolumeSpace mySpace(dims, sform);
+    int64_t frameSize = dims[0] * dims[1] * dims[2];
+    int64_t center = mySpace.getIndex(5, 4, 3);
+    const ClusterGraph::VolumeNeighbors neighTypes[3] = { ClusterGraph::FACE, ClusterGraph::EDGE, ClusterGraph::CORNER };
+    const int64_t neighCounts[3] = { 6, 18, 26 }, cornerCounts[3] = { 3, 6, 7 };
+    for (int t = 0; t < 3; ++t)
+    {
+        ClusterGraph myGraph(mySpace, neighTypes[t]);
+        const int32_t* neighbors;
+        if (myGraph.getNeighbors(center, neighbors) != neighCounts[t])
+        {
+            setFailed("interior voxel has wrong number of neighbors for stencil " + AString::number(t));
+        }
+        if (myGraph.getNeighbors(0, neighbors) != cornerCounts[t])
+        {
+            setFailed("corner voxel has wrong number of neighbors for stencil " + AString::number(t));
+        }
+    }
+    ClusterGraph myGraph(mySpace, ClusterGraph::FACE);
+    vector<float> data(frameSize);
+    vector<char> mask(frameSize);
+    for (int64_t i = 0; i < frameSize; ++i)
+    {
+        data[i] = (rand() % 2001 - 1000) / 100.0f;
+        mask[i] = (data[i] > 2.0f ? 1 : 0);
+    }
+    vector<vector<int64_t> > clusters;
+    vector<double> sizes;
+    myGraph.findClusters(data.data(), 2.0f, false, clusters, sizes);
+    vector<vector<int64_t> > expected;//sequential flood fill, in scan order
+    const int stencil[18] = { 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1, 0, 0, 0, 1, 0, 0, -1 };
+    for (int64_t start = 0; start < frameSize; ++start)
+    {
+        if (!mask[start]) continue;
+        vector<int64_t> members(1, start);
+        mask[start] = 0;
+        for (size_t m = 0; m < members.size(); ++m)
+        {
+            int64_t ijk[3] = { members[m] % dims[0], (members[m] / dims[0]) % dims[1], members[m] / (dims[0] * dims[1]) };
+            for (int s = 0; s < 18; s += 3)
+            {
+                int64_t neighIJK[3] = { ijk[0] + stencil[s], ijk[1] + stencil[s + 1], ijk[2] + stencil[s + 2] };
+                if (!mySpace.indexValid(neighIJK)) continue;
+                int64_t neighIndex = mySpace.getIndex(neighIJK);
+                if (mask[neighIndex])
+                {
+                    mask[neighIndex] = 0;
+                    members.push_back(neighIndex);
+                }
+            }
+        }
+        sort(members.begin(), members.end());
+        expected.push_back(members);
+    }
+    if (clusters != expected)
+    {
+        setFailed("found " + AString::number(clusters.size()) + " clusters, flood fill found " + AString::number(expected.size()) + ", or membership differs");
+    }
+    for (size_t i = 0; i < clusters.size() && i < sizes.size(); ++i)
+    {
+        if (abs(sizes[i] - 8.0 * clusters[i].size()) > 0.001)
+        {
+            setFailed("cluster " + AString::number(i) + " has wrong volume");
+            break;
+        }
+    }
+    vector<float> isolated(frameSize, 0.0f), isolatedOut(frameSize);//single voxel: integral of 8^E * h^H dh from 0 to 3
+    isolated[center] = 3.0f;
+    myGraph.tfce(isolated.data(), isolatedOut.data(), 0.5f, 2.0f);
+    float expectTFCE = sqrt(8.0f) * 27.0f / 3.0f;
+    if (abs(isolatedOut[center] - expectTFCE) > 0.0001f * expectTFCE)
+    {
+        setFailed("isolated voxel TFCE should be " + AString::number(expectTFCE) + ", got " + AString::number(isolatedOut[center]));
+    }
+    vector<float> merging(frameSize, 0.0f), mergingOut(frameSize);//two clusters along a row that join when the threshold drops below the saddle
+    const int64_t mergeX[4] = { 2, 3, 4, 5 };//peak, shoulder, saddle, second peak
+    const float mergeValues[4] = { 3.0f, 2.5f, 1.0f, 2.0f };
+    for (int i = 0; i < 4; ++i)
+    {
+        merging[mySpace.getIndex(mergeX[i], 4, 3)] = mergeValues[i];
+        merging[mySpace.getIndex(mergeX[i], 7, 3)] = -mergeValues[i];//same shape, negated, to cover the negative sweep
+    }
+    myGraph.tfce(merging.data(), mergingOut.data(), 0.5f, 2.0f);
+    const float mergedPart = sqrt(32.0f) / 3.0f;//all 4 voxels below h = 1, the saddle's whole score
+    const float expectMerge[4] = { mergedPart + 4.0f * (15.625f - 1.0f) / 3.0f + sqrt(8.0f) * (27.0f - 15.625f) / 3.0f,
+                                   mergedPart + 4.0f * (15.625f - 1.0f) / 3.0f,
+                                   mergedPart,
+                                   mergedPart + sqrt(8.0f) * (8.0f - 1.0f) / 3.0f };
+    for (int i = 0; i < 4; ++i)
+    {
+        float posOut = mergingOut[mySpace.getIndex(mergeX[i], 4, 3)], negOut = mergingOut[mySpace.getIndex(mergeX[i], 7, 3)];
+        if (abs(posOut - expectMerge[i]) > 0.0001f * expectMerge[i] || abs(negOut + expectMerge[i]) > 0.0001f * expectMerge[i])
+        {
+            setFailed("merging clusters TFCE at position " + AString::number(i) + " should be +/-" + AString::number(expectMerge[i]) +
+                      ", got " + AString::number(posOut) + " and " + AString::number(negOut));
+        }
+    }
+    vector<float> single(frameSize), batch0(frameSize), batch1(frameSize);
+    myGraph.tfce(data.data(), single.data(), 0.5f, 2.0f);
+    vector<const float*> batchIn(2, data.data());
+    vector<float*> batchOut;
+    batchOut.push_back(batch0.data());
+    batchOut.push_back(batch1.data());
+    myGraph.tfceBatch(batchIn, batchOut, 0.5f, 2.0f);
+    if (single != batch0 || single != batch1)
+    {
+        setFailed("batched TFCE differs from single map TFCE");
+    }
+}
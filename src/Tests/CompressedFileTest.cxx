@@ -0,0 +1,106 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+#include "CompressedFileTest.h"
+
+#include "CaretBinaryFile.h"
+#include "CaretException.h"
+#include "ElapsedTimer.h"
+
+#include <QDir>
+#include <QFile>
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+CompressedFileTest::CompressedFileTest(const AString& identifier) : TestInterface(identifier)
+{
+}
+
+void CompressedFileTest::execute()
+{
+    const int64_t dataSize = 80 * 1024 * 1024;//more than one write batch
+    vector<unsigned char> data(dataSize);
+    for (int64_t i = 0; i < dataSize; ++i)
+    {//compressible, but not trivially
+        data[i] = (i % 7 == 0) ? (unsigned char)(rand() & 0xff) : (unsigned char)(i / 1000);
+    }
+    const AString fileName = QDir::tempPath() + "/compressedFileTest.bin.gz";
+    try
+    {
+        ElapsedTimer myTimer;
+        myTimer.start();
+        {
+            CaretBinaryFile writer(fileName, CaretBinaryFile::WRITE_TRUNCATE);
+            for (int64_t done = 0; done < dataSize; done += 999999)
+            {//odd-sized writes to cross block boundaries
+                writer.write(data.data() + done, min((int64_t)999999, dataSize - done));
+            }
+            writer.close();
+        }
+        cout << "compressed write: " << dataSize / 1048576.0 / myTimer.getElapsedTimeSeconds() << " MiB/s" << endl;
+        CaretBinaryFile reader(fileName);
+        vector<unsigned char> readBack(dataSize);
+        myTimer.start();
+        reader.read(readBack.data(), dataSize);
+        cout << "sequential compressed read: " << dataSize / 1048576.0 / myTimer.getElapsedTimeSeconds() << " MiB/s" << endl;
+        if (memcmp(readBack.data(), data.data(), dataSize) != 0)
+        {
+            setFailed("compressed file sequential read doesn't match written data");
+            return;
+        }
+        int64_t numRead = -1;
+        reader.read(readBack.data(), 1, &numRead);
+        if (numRead != 0)
+        {
+            setFailed("compressed file read past the end of the data");
+            return;
+        }
+        const int numSeeks = 1000, readSize = 4096;
+        myTimer.start();
+        for (int i = 0; i < numSeeks; ++i)
+        {
+            int64_t position = (((int64_t)rand() << 16) ^ rand()) % (dataSize - readSize);
+            reader.seek(position);
+            reader.read(readBack.data(), readSize);
+            if (memcmp(readBack.data(), data.data() + position, readSize) != 0)
+            {
+                setFailed("compressed file read after seek to " + AString::number(position) + " doesn't match written data");
+                return;
+            }
+        }
+        cout << "random compressed reads: " << myTimer.getElapsedTimeSeconds() * 1000.0 / numSeeks << " ms per seek" << endl;
+        reader.close();
+        CaretBinaryFile fresh(fileName);//seek before anything is indexed
+        fresh.seek(dataSize - readSize);
+        fresh.read(readBack.data(), readSize);
+        if (memcmp(readBack.data(), data.data() + dataSize - readSize, readSize) != 0)
+        {
+            setFailed("compressed file read at end of unindexed file doesn't match written data");
+        }
+    } catch (CaretException& e) {
+        setFailed("caught exception: " + e.whatString());
+    }
+    QFile::remove(fileName);
+}
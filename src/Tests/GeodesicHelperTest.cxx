@@ -20,6 +20,7 @@
 #include "GeodesicHelperTest.h"
 
 #include "GeodesicHelper.h"
+#include "GeodesicMultiSource.h"
 #include "SurfaceFile.h"
 
 #include <cstdlib>
@@ -49,6 +50,129 @@ namespace
             }
         }
     }
+    
+    class StoreRowSink : public GeodesicMultiSource::RowSink
+    {
+        int64_t m_rowLength;
+    public:
+        vector<float> m_rows;
+        vector<int64_t> m_order;
+        StoreRowSink(const int64_t& numRows, const int64_t& rowLength) : m_rowLength(rowLength), m_rows(numRows * rowLength) { }
+        void addRow(const int64_t& sourceIndex, const float* distances)
+        {
+            m_order.push_back(sourceIndex);
+            for (int64_t i = 0; i < m_rowLength; ++i)
+            {
+                m_rows[sourceIndex * m_rowLength + i] = distances[i];
+            }
+        }
+    };
+    
+    class StoreSparseRowSink : public GeodesicMultiSource::SparseRowSink
+    {
+        int64_t m_rowLength;
+    public:
+        vector<float> m_rows;
+        vector<int64_t> m_order;
+        bool m_unsorted;
+        StoreSparseRowSink(const int64_t& numRows, const int64_t& rowLength) : m_rowLength(rowLength), m_rows(numRows * rowLength, -1.0f), m_unsorted(false) { }
+        void addSparseRow(const int64_t& sourceIndex, const vector<int64_t>& columns, const vector<float>& distances)
+        {
+            m_order.push_back(sourceIndex);
+            for (size_t i = 0; i < columns.size(); ++i)
+            {
+                if (i > 0 && columns[i] <= columns[i - 1]) m_unsorted = true;
+                m_rows[sourceIndex * m_rowLength + columns[i]] = distances[i];
+            }
+        }
+    };
+    
+    ///sparse rows filled in with -1 should be exactly the dense rows with the same limit
+    void checkSparseMultiSource(GeodesicHelperTest* theTest, const AString& condition, GeodesicMultiSource& multiSource, const int32_t& numNodes,
+                                const vector<int32_t>& sources, const vector<int32_t>& targets, const float& maxDist)
+    {
+        const int64_t rowLength = (targets.empty() ? numNodes : (int64_t)targets.size());
+        StoreRowSink denseSink(sources.size(), rowLength);
+        StoreSparseRowSink sparseSink(sources.size(), rowLength);
+        multiSource.computeDense(sources, targets, maxDist, &denseSink);
+        multiSource.computeSparse(sources, targets, maxDist, &sparseSink);
+        if (sparseSink.m_order.size() != sources.size())
+        {
+            theTest->setFailed(condition + ", sink received " + AString::number(sparseSink.m_order.size()) + " rows instead of " + AString::number(sources.size()));
+            return;
+        }
+        for (size_t i = 0; i < sparseSink.m_order.size(); ++i)
+        {
+            if (sparseSink.m_order[i] != (int64_t)i)
+            {
+                theTest->setFailed(condition + ", rows were not handed to the sink in source order");
+                return;
+            }
+        }
+        if (sparseSink.m_unsorted)
+        {
+            theTest->setFailed(condition + ", sparse row columns were not in increasing order");
+            return;
+        }
+        for (size_t i = 0; i < denseSink.m_rows.size(); ++i)
+        {
+            if (sparseSink.m_rows[i] != denseSink.m_rows[i])
+            {
+                theTest->setFailed(condition + ", row " + AString::number(i / rowLength) + ", column " + AString::number(i % rowLength) +
+                                   ": sparse gave " + AString::number(sparseSink.m_rows[i]) + ", dense gave " + AString::number(denseSink.m_rows[i]));
+                return;
+            }
+        }
+    }
+    
+    ///compare multi-source rows against one single-source call per source on the given helper
+    void checkMultiSource(GeodesicHelperTest* theTest, const AString& condition, GeodesicMultiSource& multiSource, GeodesicHelper* singleHelp, const int32_t& numNodes,
+                          const vector<int32_t>& sources, const vector<int32_t>& targets, const float& maxDist)
+    {
+        const int64_t rowLength = (targets.empty() ? numNodes : (int64_t)targets.size());
+        StoreRowSink mySink(sources.size(), rowLength);
+        multiSource.computeDense(sources, targets, maxDist, &mySink);
+        for (size_t i = 0; i < mySink.m_order.size(); ++i)
+        {
+            if (mySink.m_order[i] != (int64_t)i)
+            {
+                theTest->setFailed(condition + ", rows were not handed to the sink in source order");
+                return;
+            }
+        }
+        if (mySink.m_order.size() != sources.size())
+        {
+            theTest->setFailed(condition + ", sink received " + AString::number(mySink.m_order.size()) + " rows instead of " + AString::number(sources.size()));
+            return;
+        }
+        vector<float> expected(numNodes), dists;
+        vector<int32_t> nodes;
+        for (size_t i = 0; i < sources.size(); ++i)
+        {
+            if (maxDist >= 0.0f)
+            {
+                expected.assign(numNodes, -1.0f);
+                singleHelp->getNodesToGeoDist(sources[i], maxDist, nodes, dists);
+                for (size_t j = 0; j < nodes.size(); ++j)
+                {
+                    expected[nodes[j]] = dists[j];
+                }
+            } else {
+                singleHelp->getGeoFromNode(sources[i], expected.data());
+            }
+            const float* row = mySink.m_rows.data() + i * rowLength;
+            for (int64_t j = 0; j < rowLength; ++j)
+            {
+                const int32_t node = (targets.empty() ? j : targets[j]);
+                if (row[j] != expected[node])//same algorithm on the same structures, so the answers should be exactly the same
+                {
+                    theTest->setFailed(condition + ", source vertex " + AString::number(sources[i]) + ", target vertex " + AString::number(node) +
+                                       ": multi-source gave " + AString::number(row[j]) + ", single source gave " + AString::number(expected[node]));
+                    return;
+                }
+            }
+        }
+    }
 }
 
 void GeodesicHelperTest::execute()
@@ -96,4 +220,23 @@ void GeodesicHelperTest::execute()
         checkNodeLists(this, "Comparing normal to quarter areas, getPathFollowingData", nodesNorm, nodesQuarter);
         checkNodeLists(this, "Comparing normal to quad areas, getPathFollowingData", nodesNorm, nodesQuad);
     }
+    const int MULTI_SOURCES = 50;//more than one block when single threaded
+    vector<int32_t> sources, targets;
+    for (int i = 0; i < MULTI_SOURCES; ++i)
+    {
+        sources.push_back(rand() % numNodes);
+    }
+    for (int i = 0; i < numNodes; i += 7)
+    {
+        targets.push_back(i);
+    }
+    GeodesicMultiSource normalMulti(&mySurf);
+    if (!failed()) checkMultiSource(this, "Comparing multi-source to single source, all targets", normalMulti, normalHelp, numNodes, sources, vector<int32_t>(), -1.0f);
+    if (!failed()) checkMultiSource(this, "Comparing multi-source to single source, target subset", normalMulti, normalHelp, numNodes, sources, targets, -1.0f);
+    if (!failed()) checkMultiSource(this, "Comparing multi-source to single source, all targets with limit", normalMulti, normalHelp, numNodes, sources, vector<int32_t>(), 20.0f);
+    if (!failed()) checkMultiSource(this, "Comparing multi-source to single source, target subset with limit", normalMulti, normalHelp, numNodes, sources, targets, 20.0f);
+    if (!failed()) checkSparseMultiSource(this, "Comparing sparse to dense multi-source, all targets", normalMulti, numNodes, sources, vector<int32_t>(), 20.0f);
+    if (!failed()) checkSparseMultiSource(this, "Comparing sparse to dense multi-source, target subset", normalMulti, numNodes, sources, targets, 20.0f);
+    GeodesicMultiSource quadMulti(&mySurf, areas.data());//areas are still the quad areas
+    if (!failed()) checkMultiSource(this, "Comparing multi-source to single source, quad areas with limit", quadMulti, quadHelp, numNodes, sources, targets, 40.0f);
 }
@@ -0,0 +1,118 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+#include "MetricGradientTest.h"
+
+#include "AlgorithmMetricGradient.h"
+#include "MetricFile.h"
+#include "SurfaceFile.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+MetricGradientTest::MetricGradientTest(const AString& identifier) : TestInterface(identifier)
+{
+}
+
+namespace
+{
+    ///latitude/longitude sphere, rings of nodes between a node at each pole
+    void makeSphere(SurfaceFile& mySurf, const int32_t numRings, const int32_t numAround, const float radius)
+    {
+        const int32_t numNodes = 2 + numRings * numAround;
+        const int32_t southPole = numNodes - 1;
+        mySurf.setNumberOfNodesAndTriangles(numNodes, 2 * numAround * numRings);
+        mySurf.setStructure(StructureEnum::CORTEX_LEFT);
+        vector<float> coords(numNodes * 3);
+        coords[2] = radius;
+        coords[southPole * 3 + 2] = -radius;
+        for (int32_t r = 0; r < numRings; ++r)
+        {
+            const double theta = M_PI * (r + 1) / (numRings + 1);
+            for (int32_t j = 0; j < numAround; ++j)
+            {
+                const double phi = 2.0 * M_PI * j / numAround;
+                const int32_t node3 = (1 + r * numAround + j) * 3;
+                coords[node3] = radius * sin(theta) * cos(phi);
+                coords[node3 + 1] = radius * sin(theta) * sin(phi);
+                coords[node3 + 2] = radius * cos(theta);
+            }
+        }
+        mySurf.setCoordinates(coords.data());
+        int32_t tri = 0;
+        for (int32_t j = 0; j < numAround; ++j)
+        {
+            const int32_t next = (j + 1) % numAround;
+            mySurf.setTriangle(tri++, 0, 1 + j, 1 + next);
+            for (int32_t r = 0; r < numRings - 1; ++r)
+            {
+                const int32_t upper = 1 + r * numAround, lower = upper + numAround;
+                mySurf.setTriangle(tri++, upper + j, lower + j, lower + next);
+                mySurf.setTriangle(tri++, upper + j, lower + next, upper + next);
+            }
+            const int32_t lastRing = 1 + (numRings - 1) * numAround;
+            mySurf.setTriangle(tri++, southPole, lastRing + next, lastRing + j);
+        }
+    }
+}
+
+void MetricGradientTest::execute()
+{//a batch of columns with a different roi per column (as used by cifti-correlation-gradient with -surface-exclude) must match one call per column
+    SurfaceFile mySurf;
+    makeSphere(mySurf, 20, 40, 100.0f);
+    const int32_t numNodes = mySurf.getNumberOfNodes(), numColumns = 5;
+    MetricFile batchMetric, batchRoi;
+    batchMetric.setNumberOfNodesAndColumns(numNodes, numColumns);
+    batchRoi.setNumberOfNodesAndColumns(numNodes, numColumns);
+    const float* coords = mySurf.getCoordinateData();
+    for (int32_t col = 0; col < numColumns; ++col)
+    {
+        const int32_t excludeCenter = (col * numNodes) / numColumns;//exclude a different patch from each column
+        for (int32_t i = 0; i < numNodes; ++i)
+        {
+            batchMetric.setValue(i, col, coords[i * 3] * (col + 1) + coords[i * 3 + 2] * coords[i * 3 + 1] / 100.0f + ((float)rand()) / RAND_MAX);
+            float dx = coords[i * 3] - coords[excludeCenter * 3], dy = coords[i * 3 + 1] - coords[excludeCenter * 3 + 1], dz = coords[i * 3 + 2] - coords[excludeCenter * 3 + 2];
+            batchRoi.setValue(i, col, (dx * dx + dy * dy + dz * dz < 30.0f * 30.0f ? 0.0f : 1.0f));
+        }
+    }
+    MetricFile batchOut;
+    AlgorithmMetricGradient(NULL, &mySurf, &batchMetric, &batchOut, NULL, -1.0f, &batchRoi, false, -1, NULL, true);
+    for (int32_t col = 0; col < numColumns; ++col)
+    {
+        MetricFile singleRoi, singleOut;
+        singleRoi.setNumberOfNodesAndColumns(numNodes, 1);
+        singleRoi.setValuesForColumn(0, batchRoi.getValuePointerForColumn(col));
+        AlgorithmMetricGradient(NULL, &mySurf, &batchMetric, &singleOut, NULL, -1.0f, &singleRoi, false, col);
+        const float* batchData = batchOut.getValuePointerForColumn(col);
+        const float* singleData = singleOut.getValuePointerForColumn(0);
+        for (int32_t i = 0; i < numNodes; ++i)
+        {
+            if (abs(batchData[i] - singleData[i]) > 0.00001f * (1.0f + abs(singleData[i])))
+            {
+                setFailed("batched gradient with per-column roi differs from single column gradient in column " + AString::number(col) +
+                          ", vertex " + AString::number(i) + ": " + AString::number(batchData[i]) + " vs " + AString::number(singleData[i]));
+                return;
+            }
+        }
+    }
+}
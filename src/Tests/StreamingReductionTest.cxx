@@ -0,0 +1,260 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+#include "StreamingReductionTest.h"
+
+#include "MathFunctions.h"
+#include "ReductionOperation.h"
+#include "StreamingReduction.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+StreamingReductionTest::StreamingReductionTest(const AString& identifier) : TestInterface(identifier)
+{
+}
+
+namespace
+{
+    const int64_t GEN_COLS = 64, GEN_GROUPS = 1024, GEN_ROWS_PER_GROUP = 300;//64K results puts the per-column collection cap at its minimum of 256, so every group overflows into histogram passes
+    
+    uint32_t hashIndex(uint32_t x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+    
+    ///values computed from the row and column, so the test doesn't need to hold the matrix
+    ///columns cycle through plain values with many ties, sprinkled infinities, finite values near the float limits, sprinkled NaNs, and mostly infinite
+    float generatedValue(const int64_t& row, const int64_t& col)
+    {
+        const uint32_t h = hashIndex((uint32_t)(row * GEN_COLS + col));
+        float value = ((int)(h % 4001) - 2000) * 0.5f;
+        const bool rare = (h >> 24) < 5;//about 2%
+        switch (col % 5)
+        {
+            case 1:
+                if (rare) value = ((h & 1) ? numeric_limits<float>::infinity() : -numeric_limits<float>::infinity());
+                break;
+            case 2:
+                if (rare) value = ((h & 1) ? 3.0e38f : -3.0e38f);
+                break;
+            case 3:
+                if (rare) value = numeric_limits<float>::quiet_NaN();
+                break;
+            case 4:
+                if ((h >> 24) < 154) value = numeric_limits<float>::infinity();//about 60%
+                break;
+        }
+        return value;
+    }
+    
+    class GeneratedSource : public StreamingReduction::RowSource
+    {
+    public:
+        int64_t getNumberOfRows() const { return GEN_GROUPS * GEN_ROWS_PER_GROUP; }
+        int64_t getNumberOfColumns() const { return GEN_COLS; }
+        void getRows(float* dataOut, const int64_t& firstRow, const int64_t& numRows)
+        {
+            for (int64_t r = 0; r < numRows; ++r)
+            {
+                for (int64_t c = 0; c < GEN_COLS; ++c)
+                {
+                    dataOut[r * GEN_COLS + c] = generatedValue(firstRow + r, c);
+                }
+            }
+        }
+    };
+    
+    struct NaNLast
+    {
+        bool operator()(const float& left, const float& right) const
+        {
+            if (MathFunctions::isNaN(left)) return false;
+            if (MathFunctions::isNaN(right)) return true;
+            return left < right;
+        }
+    };
+    
+    ///full sort with NaNs last, then the same rank arithmetic as ReductionOperation::percentile
+    float sortedPercentile(vector<float> values, const float& percent)
+    {
+        sort(values.begin(), values.end(), NaNLast());
+        const int64_t numElems = (int64_t)values.size();
+        const double index = percent / 100.0f * (numElems - 1);
+        if (index <= 0) return values[0];
+        if (index >= numElems - 1) return values[numElems - 1];
+        double ipart, fpart;
+        fpart = modf(index, &ipart);
+        return (1.0f - fpart) * values[(int64_t)ipart] + fpart * values[(int64_t)ipart + 1];
+    }
+    
+    float sortedMedian(vector<float> values)
+    {
+        sort(values.begin(), values.end(), NaNLast());
+        const int64_t half = (int64_t)values.size() / 2;
+        if ((values.size() & 1) == 0) return (values[half - 1] + values[half]) / 2.0f;
+        return values[half];
+    }
+    
+    bool bitwiseMatch(const float& left, const float& right)
+    {
+        if (MathFunctions::isNaN(left) || MathFunctions::isNaN(right)) return MathFunctions::isNaN(left) && MathFunctions::isNaN(right);
+        return left == right;
+    }
+    
+    bool closeMatch(const float& left, const float& right)
+    {
+        if (bitwiseMatch(left, right)) return true;
+        return abs(left - right) <= 1e-4f * max(1.0f, max(abs(left), abs(right)));
+    }
+}
+
+void StreamingReductionTest::execute()
+{
+    {//exact selection in histogram mode, with ties, infinities, values near the float limits, and NaNs
+        GeneratedSource mySource;
+        const int64_t numRows = mySource.getNumberOfRows();
+        vector<int> rowGroups(numRows);
+        for (int64_t r = 0; r < numRows; ++r)
+        {
+            rowGroups[r] = (int)(r % GEN_GROUPS);
+        }
+        StreamingReduction myReduce(&mySource);
+        myReduce.setGroups(rowGroups, GEN_GROUPS);
+        const float percents[4] = { 0.0f, 10.0f, 97.5f, 100.0f };
+        vector<vector<float> > results;
+        results.push_back(myReduce.reduce(ReductionEnum::MEDIAN));
+        for (int p = 0; p < 4; ++p)
+        {
+            results.push_back(myReduce.percentile(percents[p]));
+        }
+        vector<float> groupValues;
+        for (int64_t c = 0; c < GEN_COLS && !failed(); ++c)
+        {
+            for (int64_t g = 0; g < GEN_GROUPS; ++g)
+            {
+                groupValues.clear();
+                bool hasNaN = false;
+                for (int64_t r = g; r < numRows; r += GEN_GROUPS)
+                {
+                    groupValues.push_back(generatedValue(r, c));
+                    if (MathFunctions::isNaN(groupValues.back())) hasNaN = true;
+                }
+                const int64_t resultIndex = g * GEN_COLS + c;
+                vector<float> expected;
+                expected.push_back(sortedMedian(groupValues));
+                for (int p = 0; p < 4; ++p)
+                {
+                    expected.push_back(sortedPercentile(groupValues, percents[p]));
+                }
+                if (!hasNaN)
+                {//without NaNs, the sorted reference must agree with ReductionOperation itself
+                    if (!bitwiseMatch(expected[0], ReductionOperation::reduce(groupValues.data(), groupValues.size(), ReductionEnum::MEDIAN)) ||
+                        !bitwiseMatch(expected[2], ReductionOperation::percentile(groupValues.data(), groupValues.size(), percents[1])))
+                    {
+                        setFailed("sorted reference disagrees with ReductionOperation in column " + AString::number(c) + ", group " + AString::number(g));
+                        break;
+                    }
+                }
+                for (size_t i = 0; i < expected.size(); ++i)
+                {
+                    if (!bitwiseMatch(results[i][resultIndex], expected[i]))
+                    {
+                        AString which = "median";
+                        if (i > 0) which = "percentile " + AString::number(percents[i - 1]);
+                        setFailed("streaming " + which + " of column " + AString::number(c) +
+                                  ", group " + AString::number(g) + " is " + AString::number(results[i][resultIndex]) + ", expected " + AString::number(expected[i]));
+                        break;
+                    }
+                }
+                if (failed()) break;
+            }
+        }
+    }
+    if (failed()) return;
+    {//one-pass reductions with groups, a skipped group, and weights, against ReductionOperation on each group's values
+        const int64_t numRows = 1000, numCols = 7, numGroups = 3;
+        vector<vector<float> > columns(numCols, vector<float>(numRows));
+        vector<const float*> columnPointers(numCols);
+        vector<float> weights(numRows);
+        vector<int> rowGroups(numRows);
+        for (int64_t r = 0; r < numRows; ++r)
+        {
+            const uint32_t h = hashIndex((uint32_t)r + 12345U);
+            weights[r] = 0.25f + (h % 1000) / 250.0f;
+            rowGroups[r] = (int)(h % (numGroups + 1)) - 1;//some rows in group -1, which is not used
+            for (int64_t c = 0; c < numCols; ++c)
+            {
+                columns[c][r] = ((int)(hashIndex((uint32_t)(r * numCols + c)) % 20001) - 10000) / 100.0f + c * 10.0f;
+            }
+        }
+        for (int64_t c = 0; c < numCols; ++c)
+        {
+            columnPointers[c] = columns[c].data();
+        }
+        StreamingReduction::ColumnPointerSource mySource(columnPointers, numRows);
+        const ReductionEnum::Enum unweightedTypes[9] = { ReductionEnum::SUM, ReductionEnum::MEAN, ReductionEnum::STDEV, ReductionEnum::SAMPSTDEV, ReductionEnum::VARIANCE,
+                                                         ReductionEnum::MAX, ReductionEnum::MIN, ReductionEnum::INDEXMAX, ReductionEnum::COUNT_NONZERO };
+        const ReductionEnum::Enum weightedTypes[4] = { ReductionEnum::SUM, ReductionEnum::MEAN, ReductionEnum::STDEV, ReductionEnum::SAMPSTDEV };
+        for (int pass = 0; pass < 2; ++pass)
+        {
+            const bool weighted = (pass == 1);
+            StreamingReduction myReduce(&mySource);
+            myReduce.setGroups(rowGroups, numGroups);
+            if (weighted) myReduce.setWeights(weights);
+            const int numTypes = (weighted ? 4 : 9);
+            for (int t = 0; t < numTypes; ++t)
+            {
+                const ReductionEnum::Enum type = (weighted ? weightedTypes[t] : unweightedTypes[t]);
+                vector<float> result = myReduce.reduce(type);
+                for (int g = 0; g < numGroups; ++g)
+                {
+                    for (int64_t c = 0; c < numCols; ++c)
+                    {
+                        vector<float> groupValues, groupWeights;
+                        for (int64_t r = 0; r < numRows; ++r)
+                        {
+                            if (rowGroups[r] != g) continue;
+                            groupValues.push_back(columns[c][r]);
+                            groupWeights.push_back(weights[r]);
+                        }
+                        float expected = (weighted ? ReductionOperation::reduceWeighted(groupValues.data(), groupWeights.data(), groupValues.size(), type)
+                                                   : ReductionOperation::reduce(groupValues.data(), groupValues.size(), type));
+                        if (!closeMatch(result[g * numCols + c], expected))
+                        {
+                            setFailed("streaming " + AString(weighted ? "weighted " : "") + ReductionEnum::toName(type) + " of column " + AString::number(c) +
+                                      ", group " + AString::number(g) + " is " + AString::number(result[g * numCols + c]) + ", expected " + AString::number(expected));
+                            return;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
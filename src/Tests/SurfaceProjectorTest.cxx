@@ -0,0 +1,157 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+#include "SurfaceProjectorTest.h"
+
+#include "ElapsedTimer.h"
+#include "FociFile.h"
+#include "Focus.h"
+#include "MathFunctions.h"
+#include "SurfaceFile.h"
+#include "SurfaceProjectedItem.h"
+#include "SurfaceProjector.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+SurfaceProjectorTest::SurfaceProjectorTest(const AString& identifier) : TestInterface(identifier)
+{
+}
+
+namespace
+{
+    ///latitude/longitude sphere, rings of nodes between a node at each pole
+    void makeSphere(SurfaceFile& mySurf, const int32_t numRings, const int32_t numAround, const float radius)
+    {
+        const int32_t numNodes = 2 + numRings * numAround;
+        const int32_t southPole = numNodes - 1;
+        const int32_t numTriangles = 2 * numAround * numRings;
+        mySurf.setNumberOfNodesAndTriangles(numNodes, numTriangles);
+        mySurf.setStructure(StructureEnum::CORTEX_LEFT);
+        mySurf.setSurfaceType(SurfaceTypeEnum::ANATOMICAL);
+        vector<float> coords(numNodes * 3);
+        coords[2] = radius;
+        coords[southPole * 3 + 2] = -radius;
+        for (int32_t r = 0; r < numRings; ++r)
+        {
+            const double theta = M_PI * (r + 1) / (numRings + 1);
+            for (int32_t j = 0; j < numAround; ++j)
+            {
+                const double phi = 2.0 * M_PI * j / numAround;
+                const int32_t node3 = (1 + r * numAround + j) * 3;
+                coords[node3] = radius * sin(theta) * cos(phi);
+                coords[node3 + 1] = radius * sin(theta) * sin(phi);
+                coords[node3 + 2] = radius * cos(theta);
+            }
+        }
+        mySurf.setCoordinates(coords.data());
+        int32_t tri = 0;
+        for (int32_t j = 0; j < numAround; ++j)
+        {
+            const int32_t next = (j + 1) % numAround;
+            mySurf.setTriangle(tri++, 0, 1 + j, 1 + next);
+            for (int32_t r = 0; r < numRings - 1; ++r)
+            {
+                const int32_t upper = 1 + r * numAround, lower = upper + numAround;
+                mySurf.setTriangle(tri++, upper + j, lower + j, lower + next);
+                mySurf.setTriangle(tri++, upper + j, lower + next, upper + next);
+            }
+            const int32_t lastRing = 1 + (numRings - 1) * numAround;
+            mySurf.setTriangle(tri++, southPole, lastRing + next, lastRing + j);
+        }
+        mySurf.computeNormals();
+    }
+    
+    float randomUnit()
+    {
+        return ((float)rand()) / RAND_MAX;
+    }
+}
+
+void SurfaceProjectorTest::execute()
+{
+    SurfaceFile mySurf;
+    makeSphere(mySurf, 286, 573, 100.0f);//163,880 nodes, about the size of a 164k mesh
+    const int32_t numFoci = 100000, numCheck = 2000;
+    FociFile myFoci;
+    vector<Focus*> checkFoci;
+    for (int32_t i = 0; i < numFoci; ++i)
+    {
+        float xyz[3] = { randomUnit() - 0.5f, randomUnit() - 0.5f, randomUnit() - 0.5f };
+        if (MathFunctions::normalizeVector(xyz) == 0.0f) xyz[2] = 1.0f;
+        const float dist = 95.0f + 10.0f * randomUnit();
+        xyz[0] *= dist;
+        xyz[1] *= dist;
+        xyz[2] *= dist;
+        Focus* myFocus = new Focus();
+        myFocus->setName("random");//one name, so the name color table stays small
+        SurfaceProjectedItem* myItem = new SurfaceProjectedItem();
+        myItem->setStereotaxicXYZ(xyz);
+        myFocus->addProjection(myItem);
+        if (i < numCheck) checkFoci.push_back(new Focus(*myFocus));
+        myFoci.addFocus(myFocus);
+    }
+    ElapsedTimer myTimer;
+    myTimer.start();
+    SurfaceProjector fileProjector(&mySurf);
+    try
+    {
+        fileProjector.projectFociFile(&myFoci);
+    } catch (SurfaceProjectorException& e) {
+        setFailed("projecting foci file failed: " + e.whatString());
+        return;
+    }
+    const double fileSeconds = myTimer.getElapsedTimeSeconds();
+    myTimer.start();
+    SurfaceProjector singleProjector(&mySurf);
+    for (int32_t i = 0; i < numCheck; ++i)
+    {
+        try
+        {
+            singleProjector.projectFocus(i, checkFoci[i]);
+        } catch (SurfaceProjectorException& e) {
+            setFailed("projecting focus " + AString::number(i) + " failed: " + e.whatString());
+        }
+    }
+    const double singleSeconds = myTimer.getElapsedTimeSeconds();
+    for (int32_t i = 0; !failed() && i < numCheck; ++i)
+    {
+        float fileXYZ[3], singleXYZ[3];
+        bool fileValid = myFoci.getFocus(i)->getProjection(0)->getProjectedPosition(mySurf, fileXYZ, false);
+        bool singleValid = checkFoci[i]->getProjection(0)->getProjectedPosition(mySurf, singleXYZ, false);
+        if (!fileValid || !singleValid)
+        {
+            setFailed("focus " + AString::number(i) + " did not get a valid projection");
+        } else if (fileXYZ[0] != singleXYZ[0] || fileXYZ[1] != singleXYZ[1] || fileXYZ[2] != singleXYZ[2]) {
+            setFailed("focus " + AString::number(i) + " projected differently from the foci file than by itself");
+        } else if (MathFunctions::distance3D(fileXYZ, myFoci.getFocus(i)->getProjection(0)->getStereotaxicXYZ()) > 0.5f) {
+            setFailed("focus " + AString::number(i) + " projection does not reproduce its coordinate");
+        }
+    }
+    for (int32_t i = 0; i < numCheck; ++i)
+    {
+        delete checkFoci[i];
+    }
+    cout << "foci file: " << numFoci / fileSeconds << " foci per second, single foci: " << numCheck / singleSeconds << " foci per second" << endl;
+}
@@ -0,0 +1,335 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+#include "WbsparseTest.h"
+
+#include "AlgorithmCiftiCorrelation.h"
+#include "CaretSparseFile.h"
+#include "CiftiBrainModelsMap.h"
+#include "CiftiConnectivityMatrixDenseSparseFile.h"
+#include "CiftiFile.h"
+#include "CiftiSeriesMap.h"
+#include "ElapsedTimer.h"
+#include "FileInformation.h"
+
+#include <QDir>
+#include <QFile>
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+WbsparseTest::WbsparseTest(const AString& identifier) : TestInterface(identifier)
+{
+}
+
+void WbsparseTest::execute()
+{
+    const int64_t numCols = 5000, numRows = 2000;
+    CiftiXML myXML;
+    myXML.setNumberOfDimensions(2);
+    CiftiSeriesMap rowMap, colMap;
+    rowMap.setLength(numCols);
+    colMap.setLength(numRows);
+    myXML.setMap(CiftiXML::ALONG_ROW, rowMap);
+    myXML.setMap(CiftiXML::ALONG_COLUMN, colMap);
+    vector<vector<int64_t> > indices(numRows), values(numRows);
+    vector<vector<FiberFractions> > fibers(numRows);
+    for (int64_t i = 0; i < numRows; ++i)
+    {
+        if (i % 11 == 5) continue;//some empty rows
+        for (int64_t j = 0; j < numCols; ++j)
+        {
+            if (rand() % 20 != 0) continue;
+            indices[i].push_back(j);
+            values[i].push_back((rand() % 2 ? -1 : 1) * (int64_t)(rand() % 100000 + 1) * (i % 3 == 0 ? 1000000007LL : 1));
+            FiberFractions temp;
+            temp.totalCount = rand() % 5000 + 1;
+            temp.fiberFractions.resize(3);
+            temp.fiberFractions[0] = (rand() % 500) / 1000.0f;
+            temp.fiberFractions[1] = (rand() % 500) / 1000.0f;
+            temp.fiberFractions[2] = 1.0f - temp.fiberFractions[0] - temp.fiberFractions[1];
+            temp.distance = rand() % 1000;
+            fibers[i].push_back(temp);
+        }
+    }
+    const AString fileName = QDir::tempPath() + "/wbsparse_test.trajTEMP.wbsparse";
+    const int32_t versions[3] = { 1, 2, 2 };
+    const bool compress[3] = { false, false, true };
+    const char* labels[3] = { "v1", "v2", "v2 compressed" };
+    double v1Rate = 0.0;
+    for (int pass = 0; pass < 2; ++pass)//second pass uses fiber coding
+    {
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            {
+                CaretSparseFileWriter myWriter(fileName, myXML, versions[mode], compress[mode]);
+                for (int64_t i = 0; i < numRows; ++i)
+                {
+                    if (indices[i].empty()) continue;
+                    if (pass == 1)
+                    {
+                        myWriter.writeFibersRowSparse(i, indices[i], fibers[i]);
+                    } else if (i % 2 == 0) {
+                        vector<int64_t> denseRow(numCols, 0);
+                        for (size_t j = 0; j < indices[i].size(); ++j) denseRow[indices[i][j]] = values[i][j];
+                        myWriter.writeRow(i, denseRow.data());
+                    } else {
+                        myWriter.writeRowSparse(i, indices[i], values[i]);
+                    }
+                }
+            }
+            int64_t fileSize = FileInformation(fileName).size();
+            CaretSparseFile myFile(fileName);
+            if (myFile.getVersion() != versions[mode])
+            {
+                setFailed(AString(labels[mode]) + " file reports version " + AString::number(myFile.getVersion()));
+            }
+            vector<int64_t> rowIndices, rowValues, denseRow(numCols);
+            vector<FiberFractions> rowFibers, denseFibers(numCols);
+            bool good = true;
+            for (int64_t i = numRows - 1; i >= 0; i -= 7)//out of order, crossing blocks
+            {
+                if (pass == 1)
+                {
+                    myFile.getFibersRowSparse(i, rowIndices, rowFibers);
+                    myFile.getFibersRow(i, denseFibers.data());
+                    if (rowIndices != indices[i]) good = false;
+                    for (size_t j = 0; good && j < rowIndices.size(); ++j)
+                    {
+                        if (rowFibers[j].totalCount != fibers[i][j].totalCount || rowFibers[j].distance != fibers[i][j].distance ||
+                            rowFibers[j].fiberFractions[0] != fibers[i][j].fiberFractions[0] || denseFibers[rowIndices[j]].totalCount != fibers[i][j].totalCount) good = false;
+                    }
+                } else {
+                    myFile.getRowSparse(i, rowIndices, rowValues);
+                    myFile.getRow(i, denseRow.data());
+                    if (rowIndices != indices[i] || rowValues != values[i]) good = false;
+                    for (size_t j = 0; good && j < rowIndices.size(); ++j)
+                    {
+                        if (denseRow[rowIndices[j]] != values[i][j]) good = false;
+                    }
+                }
+            }
+            if (!good)
+            {
+                setFailed(AString(labels[mode]) + (pass == 1 ? " fibers" : "") + " file did not read back the written values");
+            }
+            ElapsedTimer myTimer;
+            myTimer.start();
+            int64_t totalNonzero = 0;
+            for (int repeat = 0; repeat < 5; ++repeat)
+            {
+                for (int64_t i = 0; i < numRows; ++i)
+                {
+                    myFile.getRowSparse(i, rowIndices, rowValues);
+                    totalNonzero += rowIndices.size();
+                }
+            }
+            double seconds = myTimer.getElapsedTimeSeconds();
+            double rate = (seconds > 0.0 ? totalNonzero / seconds : 0.0);
+            if (mode == 0) v1Rate = rate;
+            cout << labels[mode] << (pass == 1 ? " fibers" : "") << ": " << fileSize << " bytes, sequential read " << rate / 1000000.0 << " million nonzeros per second";
+            if (mode != 0 && v1Rate > 0.0) cout << " (" << rate / v1Rate << "x v1)";
+            cout << endl;
+        }
+    }
+    {//float rows, as written by -cifti-correlation-sparse
+        {
+            CaretSparseFileWriter myWriter(fileName, myXML, 2, true);
+            for (int64_t i = 0; i < numRows; ++i)
+            {
+                if (indices[i].empty()) continue;
+                vector<float> floatValues(indices[i].size());
+                for (size_t j = 0; j < floatValues.size(); ++j) floatValues[j] = values[i][j] / 100001.0f;
+                myWriter.writeFloatRowSparse(i, indices[i], floatValues);
+            }
+        }
+        CaretSparseFile myFile(fileName);
+        vector<int64_t> rowIndices;
+        vector<float> rowValues, denseRow(numCols);
+        bool good = true;
+        for (int64_t i = numRows - 1; i >= 0; i -= 7)
+        {
+            myFile.getFloatRowSparse(i, rowIndices, rowValues);
+            myFile.getFloatRow(i, denseRow.data());
+            if (rowIndices != indices[i]) good = false;
+            for (size_t j = 0; good && j < rowIndices.size(); ++j)
+            {
+                if (rowValues[j] != values[i][j] / 100001.0f || denseRow[rowIndices[j]] != rowValues[j]) good = false;
+            }
+        }
+        if (!good) setFailed("float rows did not read back the written values");
+    }
+    QFile::remove(fileName);
+    if (!failed()) checkCorrelationSelection();
+    if (!failed()) checkDenseSparseFile();
+}
+
+void WbsparseTest::checkCorrelationSelection()
+{//-cifti-correlation-sparse row selection, compared to the dense correlation
+    const int64_t numInputRows = 40, numTimepoints = 30;
+    CiftiXML inputXML;
+    inputXML.setNumberOfDimensions(2);
+    CiftiSeriesMap timeMap, rowMap;
+    timeMap.setLength(numTimepoints);
+    rowMap.setLength(numInputRows);
+    inputXML.setMap(CiftiXML::ALONG_ROW, timeMap);
+    inputXML.setMap(CiftiXML::ALONG_COLUMN, rowMap);
+    CiftiFile inputCifti;
+    inputCifti.setCiftiXML(inputXML);
+    vector<float> inputRow(numTimepoints), firstRow(numTimepoints);
+    for (int64_t i = 0; i < numInputRows; ++i)
+    {
+        for (int64_t t = 0; t < numTimepoints; ++t)
+        {
+            inputRow[t] = ((float)rand()) / RAND_MAX;
+        }
+        if (i == 0) firstRow = inputRow;
+        if (i >= 1 && i < 7)
+        {//copies and negated copies of row 0, so row 0 has six values tied at magnitude 1
+            for (int64_t t = 0; t < numTimepoints; ++t)
+            {
+                inputRow[t] = (i % 2 == 0 ? -firstRow[t] : firstRow[t]);
+            }
+        }
+        inputCifti.setRow(inputRow.data(), i);
+    }
+    CiftiFile denseOut;
+    AlgorithmCiftiCorrelation(NULL, &inputCifti, &denseOut);
+    vector<vector<float> > dense(numInputRows, vector<float>(numInputRows));
+    for (int64_t i = 0; i < numInputRows; ++i)
+    {
+        denseOut.getRow(dense[i].data(), i);
+    }
+    const AString fileName = QDir::tempPath() + "/wbsparse_test_correlation.wbsparse";
+    const int64_t topKs[4] = { 1000, -1, 3, 5 };//more than the row length, threshold only, ties in row 0, both options together
+    const float thresholds[4] = { -1.0f, 0.2f, -1.0f, 0.3f };
+    for (int test = 0; test < 4 && !failed(); ++test)
+    {
+        const AString label = "correlation selection with top-k " + AString::number(topKs[test]) + " and threshold " + AString::number(thresholds[test]);
+        AlgorithmCiftiCorrelation(NULL, &inputCifti, fileName, topKs[test], thresholds[test]);
+        CaretSparseFile sparseFile(fileName);
+        vector<int64_t> rowIndices;
+        vector<float> rowValues;
+        for (int64_t i = 0; i < numInputRows; ++i)
+        {
+            sparseFile.getFloatRowSparse(i, rowIndices, rowValues);
+            vector<bool> kept(numInputRows, false);
+            float smallestKept = 2.0f;
+            for (size_t j = 0; j < rowIndices.size(); ++j)
+            {
+                const int64_t col = rowIndices[j];
+                if (col == i)
+                {
+                    setFailed(label + ", row " + AString::number(i) + " contains the diagonal");
+                    return;
+                }
+                if (rowValues[j] != dense[i][col])
+                {
+                    setFailed(label + ", row " + AString::number(i) + " has a value that differs from the dense correlation");
+                    return;
+                }
+                if (thresholds[test] >= 0.0f && abs(rowValues[j]) < thresholds[test])
+                {
+                    setFailed(label + ", row " + AString::number(i) + " kept a value below the threshold");
+                    return;
+                }
+                kept[col] = true;
+                smallestKept = min(smallestKept, abs(rowValues[j]));
+            }
+            int64_t eligible = 0;
+            float largestDropped = -1.0f;
+            for (int64_t col = 0; col < numInputRows; ++col)
+            {
+                if (col == i || (thresholds[test] >= 0.0f && abs(dense[i][col]) < thresholds[test])) continue;
+                ++eligible;
+                if (!kept[col]) largestDropped = max(largestDropped, abs(dense[i][col]));
+            }
+            const int64_t expectedCount = (topKs[test] >= 0 ? min(topKs[test], eligible) : eligible);
+            if ((int64_t)rowIndices.size() != expectedCount)
+            {
+                setFailed(label + ", row " + AString::number(i) + " kept " + AString::number((int64_t)rowIndices.size()) + " values instead of " + AString::number(expectedCount));
+                return;
+            }
+            if (largestDropped > smallestKept)
+            {
+                setFailed(label + ", row " + AString::number(i) + " dropped a value larger than one it kept");
+                return;
+            }
+        }
+    }
+    QFile::remove(fileName);
+}
+
+void WbsparseTest::checkDenseSparseFile()
+{//rows of a .dconn.wbsparse loaded by vertex, as wb_view does, compared to what was written
+    const int64_t numNodes = 300;
+    CiftiXML denseXML;
+    denseXML.setNumberOfDimensions(2);
+    CiftiBrainModelsMap denseMap;
+    denseMap.addSurfaceModel(numNodes, StructureEnum::CORTEX_LEFT);
+    denseXML.setMap(CiftiXML::ALONG_ROW, denseMap);
+    denseXML.setMap(CiftiXML::ALONG_COLUMN, denseMap);
+    const AString fileName = QDir::tempPath() + "/wbsparse_test_dense.dconn.wbsparse";
+    if (DataFileTypeEnum::fromFileExtension(fileName) != DataFileTypeEnum::CONNECTIVITY_DENSE_SPARSE)
+    {
+        setFailed("dconn.wbsparse extension is not a sparse dense connectivity file");
+        return;
+    }
+    vector<vector<float> > expected(numNodes, vector<float>(numNodes, 0.0f));
+    {
+        CaretSparseFileWriter writer(fileName, denseXML, 2);
+        vector<int64_t> indices;
+        vector<float> values;
+        for (int64_t i = 0; i < numNodes; ++i)
+        {
+            if (i % 7 == 3) continue;//some empty rows
+            indices.clear();
+            values.clear();
+            for (int64_t j = 0; j < numNodes; ++j)
+            {
+                if (rand() % 10 != 0 && j != i) continue;
+                indices.push_back(j);
+                values.push_back(((float)rand()) / RAND_MAX);
+                expected[i][j] = values.back();
+            }
+            writer.writeFloatRowSparse(i, indices, values);
+        }
+        writer.finish();
+    }
+    CiftiConnectivityMatrixDenseSparseFile sparseDconn;
+    sparseDconn.readFile(fileName);
+    vector<float> rowData;
+    for (int64_t i = 0; i < numNodes; ++i)
+    {
+        int64_t rowIndex = -1, columnIndex = -1;
+        sparseDconn.loadMapDataForSurfaceNode(0, numNodes, StructureEnum::CORTEX_LEFT, i, rowIndex, columnIndex);
+        sparseDconn.getMapData(0, rowData);
+        if (rowIndex != i || rowData != expected[i])
+        {
+            setFailed("sparse dense connectivity file loaded the wrong data for vertex " + AString::number(i));
+            return;
+        }
+    }
+    QFile::remove(fileName);
+}
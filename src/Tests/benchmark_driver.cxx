@@ -0,0 +1,579 @@
+/*LICENSE_START*/
+/*
+ *  Copyright (C) 2026 Washington University School of Medicine
+ *
+ *  This program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License along
+ *  with this program; if not, write to the Free Software Foundation, Inc.,
+ *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+/*LICENSE_END*/
+
+//times representative wb_command operations on synthetic data, and compares the results against a stored baseline
+//usage:
+//  benchmark_driver run <results.json> [-threads <n,n,...>] [-repeats <n>] [-only <name,name,...>]
+//  benchmark_driver compare <baseline.json> <results.json> [-tolerance <fraction>]
+//  benchmark_driver list
+
+#include "AlgorithmCiftiCorrelation.h"
+#include "AlgorithmCiftiParcellate.h"
+#include "AlgorithmCiftiSmoothing.h"
+#include "AlgorithmMetricResample.h"
+#include "AlgorithmMetricSmoothing.h"
+#include "AlgorithmMetricTFCE.h"
+#include "AlgorithmVolumeSmoothing.h"
+#include "CaretCommandLine.h"
+#include "CaretException.h"
+#include "CaretHttpManager.h"
+#include "CaretOMP.h"
+#include "CiftiFile.h"
+#include "CommandOperationManager.h"
+#include "ElapsedTimer.h"
+#include "GeodesicHelper.h"
+#include "GiftiLabelTable.h"
+#include "MetricFile.h"
+#include "ProgramParameters.h"
+#include "SessionManager.h"
+#include "SurfaceFile.h"
+#include "VolumeFile.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRegExp>
+#include <QStringList>
+#include <QTextStream>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <vector>
+
+using namespace caret;
+using namespace std;
+
+namespace
+{
+    ///synthetic inputs, sized like typical fs_LR 32k data
+    struct BenchmarkData
+    {
+        SurfaceFile m_leftSphere, m_rightSphere, m_lowResSphere;
+        MetricFile m_metric, m_tfceMetric;
+        CiftiFile m_denseSeries, m_smallDenseSeries, m_denseLabel;
+        VolumeFile m_volume;
+        AString m_tempDir;
+        AString m_seriesFileName;//m_denseSeries on disk, for cifti-math
+    };
+
+    ///icosahedron subdivided numSubdiv times, so 10 * 4^numSubdiv + 2 vertices, with triangles wound outward
+    void makeIcosphere(SurfaceFile& mySurf, const int& numSubdiv, const StructureEnum::Enum& structure)
+    {
+        const double t = (1.0 + sqrt(5.0)) / 2.0, radius = 100.0;
+        const double baseCoords[12][3] = { { -1, t, 0 }, { 1, t, 0 }, { -1, -t, 0 }, { 1, -t, 0 },
+                                           { 0, -1, t }, { 0, 1, t }, { 0, -1, -t }, { 0, 1, -t },
+                                           { t, 0, -1 }, { t, 0, 1 }, { -t, 0, -1 }, { -t, 0, 1 } };
+        const int baseTris[20][3] = { { 0, 11, 5 }, { 0, 5, 1 }, { 0, 1, 7 }, { 0, 7, 10 }, { 0, 10, 11 },
+                                      { 1, 5, 9 }, { 5, 11, 4 }, { 11, 10, 2 }, { 10, 7, 6 }, { 7, 1, 8 },
+                                      { 3, 9, 4 }, { 3, 4, 2 }, { 3, 2, 6 }, { 3, 6, 8 }, { 3, 8, 9 },
+                                      { 4, 9, 5 }, { 2, 4, 11 }, { 6, 2, 10 }, { 8, 6, 7 }, { 9, 8, 1 } };
+        vector<double> coords(baseCoords[0], baseCoords[0] + 36);
+        vector<int> tris(baseTris[0], baseTris[0] + 60);
+        for (int level = 0; level < numSubdiv; ++level)
+        {
+            map<pair<int, int>, int> midpoints;
+            vector<int> newTris;
+            newTris.reserve(tris.size() * 4);
+            for (size_t i = 0; i < tris.size(); i += 3)
+            {
+                int mid[3];
+                for (int j = 0; j < 3; ++j)
+                {
+                    int a = tris[i + j], b = tris[i + (j + 1) % 3];
+                    pair<int, int> edge(min(a, b), max(a, b));
+                    map<pair<int, int>, int>::iterator iter = midpoints.find(edge);
+                    if (iter == midpoints.end())
+                    {
+                        int newIndex = (int)coords.size() / 3;
+                        for (int k = 0; k < 3; ++k) coords.push_back((coords[a * 3 + k] + coords[b * 3 + k]) / 2.0);
+                        midpoints[edge] = newIndex;
+                        mid[j] = newIndex;
+                    } else {
+                        mid[j] = iter->second;
+                    }
+                }
+                const int corner[3] = { tris[i], tris[i + 1], tris[i + 2] };
+                const int subTris[4][3] = { { corner[0], mid[0], mid[2] }, { corner[1], mid[1], mid[0] },
+                                            { corner[2], mid[2], mid[1] }, { mid[0], mid[1], mid[2] } };
+                newTris.insert(newTris.end(), subTris[0], subTris[0] + 12);
+            }
+            tris.swap(newTris);
+        }
+        const int numNodes = (int)coords.size() / 3, numTris = (int)tris.size() / 3;
+        mySurf.setNumberOfNodesAndTriangles(numNodes, numTris);
+        mySurf.setStructure(structure);
+        mySurf.setSurfaceType(SurfaceTypeEnum::SPHERICAL);
+        for (int i = 0; i < numNodes; ++i)
+        {
+            double length = sqrt(coords[i * 3] * coords[i * 3] + coords[i * 3 + 1] * coords[i * 3 + 1] + coords[i * 3 + 2] * coords[i * 3 + 2]);
+            mySurf.setCoordinate(i, coords[i * 3] * radius / length, coords[i * 3 + 1] * radius / length, coords[i * 3 + 2] * radius / length);
+        }
+        for (int i = 0; i < numTris; ++i)
+        {
+            mySurf.setTriangle(i, tris[i * 3], tris[i * 3 + 1], tris[i * 3 + 2]);
+        }
+        mySurf.computeNormals();
+    }
+
+    float noise()
+    {
+        return ((float)rand()) / RAND_MAX - 0.5f;
+    }
+
+    ///spatially smooth pattern plus noise, so smoothing and TFCE have realistic clusters
+    void makeMetric(const SurfaceFile& mySurf, const int& numColumns, MetricFile& metricOut)
+    {
+        const int numNodes = mySurf.getNumberOfNodes();
+        metricOut.setNumberOfNodesAndColumns(numNodes, numColumns);
+        metricOut.setStructure(mySurf.getStructure());
+        vector<float> column(numNodes);
+        for (int c = 0; c < numColumns; ++c)
+        {
+            for (int i = 0; i < numNodes; ++i)
+            {
+                const float* xyz = mySurf.getCoordinate(i);
+                column[i] = 3.0f * sin(xyz[0] * (c + 3) / 100.0f) * cos(xyz[1] * 2 / 100.0f) + noise();
+            }
+            metricOut.setValuesForColumn(c, column.data());
+        }
+    }
+
+    ///dense timeseries on both hemispheres, with a low-frequency signal that varies across the surface
+    void makeDenseSeries(const SurfaceFile& leftSurf, const SurfaceFile& rightSurf, const int& numTimepoints, CiftiFile& ciftiOut)
+    {
+        CiftiXML myXML;
+        myXML.setNumberOfDimensions(2);
+        CiftiBrainModelsMap denseMap;
+        denseMap.addSurfaceModel(leftSurf.getNumberOfNodes(), StructureEnum::CORTEX_LEFT);
+        denseMap.addSurfaceModel(rightSurf.getNumberOfNodes(), StructureEnum::CORTEX_RIGHT);
+        myXML.setMap(CiftiXML::ALONG_COLUMN, denseMap);
+        myXML.setMap(CiftiXML::ALONG_ROW, CiftiSeriesMap(numTimepoints, 0.0f, 0.72f));
+        ciftiOut.setCiftiXML(myXML);
+        vector<float> row(numTimepoints);
+        const int64_t numRows = denseMap.getLength();
+        for (int64_t i = 0; i < numRows; ++i)
+        {
+            const SurfaceFile& mySurf = (i < leftSurf.getNumberOfNodes() ? leftSurf : rightSurf);
+            const float* xyz = mySurf.getCoordinate(i % leftSurf.getNumberOfNodes());
+            const float phase = (xyz[0] + xyz[2]) / 50.0f;
+            for (int t = 0; t < numTimepoints; ++t)
+            {
+                row[t] = 100.0f + sin(t * 0.07f + phase) + 0.5f * sin(t * 0.19f - phase) + noise();
+            }
+            ciftiOut.setRow(row.data(), i);
+        }
+    }
+
+    ///dense label file with roughly 180 contiguous parcels per hemisphere, by latitude and longitude
+    void makeDenseLabel(const SurfaceFile& leftSurf, const SurfaceFile& rightSurf, CiftiFile& ciftiOut)
+    {
+        const int numLongitude = 18, numLatitude = 10;
+        CiftiXML myXML;
+        myXML.setNumberOfDimensions(2);
+        CiftiBrainModelsMap denseMap;
+        denseMap.addSurfaceModel(leftSurf.getNumberOfNodes(), StructureEnum::CORTEX_LEFT);
+        denseMap.addSurfaceModel(rightSurf.getNumberOfNodes(), StructureEnum::CORTEX_RIGHT);
+        CiftiLabelsMap labelMap;
+        labelMap.setLength(1);
+        labelMap.setMapName(0, "parcels");
+        vector<int32_t> keys(2 * numLongitude * numLatitude);
+        for (int i = 0; i < (int)keys.size(); ++i)
+        {
+            keys[i] = labelMap.getMapLabelTable(0)->addLabel("parcel_" + AString::number(i), rand() % 256, rand() % 256, rand() % 256, 255);
+        }
+        myXML.setMap(CiftiXML::ALONG_COLUMN, denseMap);
+        myXML.setMap(CiftiXML::ALONG_ROW, labelMap);
+        ciftiOut.setCiftiXML(myXML);
+        const int64_t numRows = denseMap.getLength();
+        for (int64_t i = 0; i < numRows; ++i)
+        {
+            const bool isLeft = i < leftSurf.getNumberOfNodes();
+            const SurfaceFile& mySurf = (isLeft ? leftSurf : rightSurf);
+            const float* xyz = mySurf.getCoordinate(i % leftSurf.getNumberOfNodes());
+            int longitude = min(numLongitude - 1, (int)((atan2(xyz[1], xyz[0]) + M_PI) / (2.0 * M_PI) * numLongitude));
+            int latitude = min(numLatitude - 1, (int)(acos(max(-1.0f, min(1.0f, xyz[2] / 100.0f))) / M_PI * numLatitude));
+            float value = keys[(isLeft ? 0 : numLongitude * numLatitude) + longitude * numLatitude + latitude];
+            ciftiOut.setRow(&value, i);
+        }
+    }
+
+    void makeVolume(const int& numFrames, VolumeFile& volOut)
+    {
+        vector<int64_t> dims(3);
+        dims[0] = 91; dims[1] = 109; dims[2] = 91;//MNI 2mm
+        vector<vector<float> > sform(3, vector<float>(4, 0.0f));
+        sform[0][0] = -2.0f; sform[0][3] = 90.0f;
+        sform[1][1] = 2.0f; sform[1][3] = -126.0f;
+        sform[2][2] = 2.0f; sform[2][3] = -72.0f;
+        dims.push_back(numFrames);
+        volOut.reinitialize(dims, sform);
+        const int64_t frameSize = dims[0] * dims[1] * dims[2];
+        vector<float> frame(frameSize);
+        for (int f = 0; f < numFrames; ++f)
+        {
+            for (int64_t k = 0; k < dims[2]; ++k)
+            {
+                for (int64_t j = 0; j < dims[1]; ++j)
+                {
+                    for (int64_t i = 0; i < dims[0]; ++i)
+                    {
+                        frame[i + dims[0] * (j + dims[1] * k)] = sin(i * 0.2f + f) * cos(j * 0.15f) * sin(k * 0.1f) + noise();
+                    }
+                }
+            }
+            volOut.setFrame(frame.data(), f);
+        }
+    }
+
+    void generateData(BenchmarkData& data)
+    {
+        srand(1234);//same data every run, so results are comparable
+        makeIcosphere(data.m_leftSphere, 6, StructureEnum::CORTEX_LEFT);//40962 vertices, similar spacing to fs_LR 32k
+        makeIcosphere(data.m_rightSphere, 6, StructureEnum::CORTEX_RIGHT);
+        makeIcosphere(data.m_lowResSphere, 5, StructureEnum::CORTEX_LEFT);
+        makeMetric(data.m_leftSphere, 20, data.m_metric);
+        makeMetric(data.m_leftSphere, 4, data.m_tfceMetric);
+        makeDenseSeries(data.m_leftSphere, data.m_rightSphere, 400, data.m_denseSeries);
+        SurfaceFile smallLeft, smallRight;
+        makeIcosphere(smallLeft, 4, StructureEnum::CORTEX_LEFT);//keep the correlation output to a reasonable size
+        makeIcosphere(smallRight, 4, StructureEnum::CORTEX_RIGHT);
+        makeDenseSeries(smallLeft, smallRight, 400, data.m_smallDenseSeries);
+        makeDenseLabel(data.m_leftSphere, data.m_rightSphere, data.m_denseLabel);
+        makeVolume(10, data.m_volume);
+        data.m_tempDir = QDir::tempPath();
+        data.m_seriesFileName = data.m_tempDir + "/wb_benchmark_input.dtseries.nii";
+        data.m_denseSeries.writeFile(data.m_seriesFileName);
+    }
+
+    void benchCiftiCorrelation(BenchmarkData& data)
+    {
+        CiftiFile output;
+        AlgorithmCiftiCorrelation(NULL, &data.m_smallDenseSeries, &output);
+    }
+
+    void benchCiftiSmoothing(BenchmarkData& data)
+    {
+        CiftiFile output;
+        AlgorithmCiftiSmoothing(NULL, &data.m_denseSeries, 4.0f, 0.0f, CiftiXML::ALONG_COLUMN, &output, &data.m_leftSphere, &data.m_rightSphere);
+    }
+
+    void benchMetricSmoothing(BenchmarkData& data)
+    {
+        MetricFile output;
+        AlgorithmMetricSmoothing(NULL, &data.m_leftSphere, &data.m_metric, 4.0, &output);
+    }
+
+    void benchMetricResample(BenchmarkData& data)
+    {
+        MetricFile output;
+        AlgorithmMetricResample(NULL, &data.m_metric, &data.m_leftSphere, &data.m_lowResSphere, SurfaceResamplingMethodEnum::BARYCENTRIC, &output);
+    }
+
+    void benchVolumeSmoothing(BenchmarkData& data)
+    {
+        VolumeFile output;
+        AlgorithmVolumeSmoothing(NULL, &data.m_volume, 4.0f, &output);
+    }
+
+    void benchGeodesic(BenchmarkData& data)
+    {
+        const int numRoots = 256, numNodes = data.m_leftSphere.getNumberOfNodes();
+        const int stride = numNodes / numRoots;
+#pragma omp CARET_PAR
+        {
+            CaretPointer<GeodesicHelper> myHelper = data.m_leftSphere.getGeodesicHelper();
+            vector<float> distances(numNodes);
+#pragma omp CARET_FOR schedule(dynamic)
+            for (int i = 0; i < numRoots; ++i)
+            {
+                myHelper->getGeoFromNode(i * stride, distances);
+            }
+        }
+    }
+
+    void benchMetricTFCE(BenchmarkData& data)
+    {
+        MetricFile output;
+        AlgorithmMetricTFCE(NULL, &data.m_leftSphere, &data.m_tfceMetric, &output);
+    }
+
+    void benchCiftiMath(BenchmarkData& data)
+    {//the expression evaluation lives in the operation, so run it the way wb_command does
+        const AString outName = data.m_tempDir + "/wb_benchmark_math.dtseries.nii";
+        ProgramParameters myParams;
+        myParams.addParameter("-cifti-math");
+        myParams.addParameter("(x - mean) * 2 / (1 + abs(x - mean))");
+        myParams.addParameter(outName);
+        myParams.addParameter("-var");
+        myParams.addParameter("x");
+        myParams.addParameter(data.m_seriesFileName);
+        myParams.addParameter("-var");
+        myParams.addParameter("mean");
+        myParams.addParameter(data.m_seriesFileName);
+        CommandOperationManager::getCommandOperationManager()->runCommand(myParams);
+        QFile::remove(outName);
+    }
+
+    void benchCiftiParcellate(BenchmarkData& data)
+    {
+        CiftiFile output;
+        AlgorithmCiftiParcellate(NULL, &data.m_denseSeries, &data.m_denseLabel, CiftiXML::ALONG_COLUMN, &output);
+    }
+
+    void benchGiftiReadWrite(BenchmarkData& data)
+    {
+        const AString fileName = data.m_tempDir + "/wb_benchmark.func.gii";
+        data.m_metric.writeFile(fileName);
+        MetricFile readBack;
+        readBack.readFile(fileName);
+        QFile::remove(fileName);
+    }
+
+    void benchCiftiReadWrite(BenchmarkData& data)
+    {
+        const AString fileName = data.m_tempDir + "/wb_benchmark.dtseries.nii";
+        data.m_denseSeries.writeFile(fileName);
+        CiftiFile readBack;
+        readBack.openFile(fileName);
+        readBack.convertToInMemory();
+        QFile::remove(fileName);
+    }
+
+    typedef void (*BenchmarkFunction)(BenchmarkData& data);
+
+    struct Benchmark
+    {
+        const char* m_name;
+        BenchmarkFunction m_function;
+    };
+
+    const Benchmark BENCHMARKS[] = {
+        { "cifti-correlation", benchCiftiCorrelation },
+        { "cifti-smoothing", benchCiftiSmoothing },
+        { "metric-smoothing", benchMetricSmoothing },
+        { "metric-resample", benchMetricResample },
+        { "volume-smoothing", benchVolumeSmoothing },
+        { "geodesic-distance", benchGeodesic },
+        { "metric-tfce", benchMetricTFCE },
+        { "cifti-math", benchCiftiMath },
+        { "cifti-parcellate", benchCiftiParcellate },
+        { "gifti-read-write", benchGiftiReadWrite },
+        { "cifti-read-write", benchCiftiReadWrite }
+    };
+    const int NUM_BENCHMARKS = sizeof(BENCHMARKS) / sizeof(Benchmark);
+
+    struct BenchmarkResult
+    {
+        AString m_name;
+        int m_threads;
+        double m_seconds;//best of the repeats
+        int m_repeats;
+    };
+
+    vector<int> parseIntList(const AString& text)
+    {
+        vector<int> ret;
+        QStringList items = text.split(",", QString::SkipEmptyParts);
+        for (int i = 0; i < items.size(); ++i)
+        {
+            bool ok = false;
+            int value = items[i].toInt(&ok);
+            if (!ok || value < 1) throw CaretException("invalid number in list: '" + items[i] + "'");
+            ret.push_back(value);
+        }
+        return ret;
+    }
+
+    ///one result per line, so compare can read the file back without a full JSON parser
+    void writeResults(const AString& fileName, const vector<BenchmarkResult>& results)
+    {
+        QFile myFile(fileName);
+        if (!myFile.open(QIODevice::WriteOnly | QIODevice::Truncate)) throw CaretException("failed to open '" + fileName + "' for writing");
+        QTextStream myStream(&myFile);
+        myStream << "{\n  \"suite\": \"wb_benchmark\",\n  \"results\": [\n";
+        for (int i = 0; i < (int)results.size(); ++i)
+        {
+            myStream << "    {\"name\": \"" << results[i].m_name << "\", \"threads\": " << results[i].m_threads
+                     << ", \"seconds\": " << QString::number(results[i].m_seconds, 'f', 6) << ", \"repeats\": " << results[i].m_repeats << "}"
+                     << (i + 1 < (int)results.size() ? ",\n" : "\n");
+        }
+        myStream << "  ]\n}\n";
+    }
+
+    ///reads files written by writeResults, keyed by "name@threads"
+    map<AString, double> readResults(const AString& fileName)
+    {
+        QFile myFile(fileName);
+        if (!myFile.open(QIODevice::ReadOnly)) throw CaretException("failed to open '" + fileName + "' for reading");
+        QRegExp resultExp("\"name\":\\s*\"([^\"]+)\",\\s*\"threads\":\\s*(\\d+),\\s*\"seconds\":\\s*([-+0-9.eE]+)");
+        map<AString, double> ret;
+        QTextStream myStream(&myFile);
+        while (!myStream.atEnd())
+        {
+            QString line = myStream.readLine();
+            if (resultExp.indexIn(line) != -1)
+            {
+                ret[resultExp.cap(1) + "@" + resultExp.cap(2)] = resultExp.cap(3).toDouble();
+            }
+        }
+        if (ret.empty()) throw CaretException("no benchmark results found in '" + fileName + "'");
+        return ret;
+    }
+
+    int runBenchmarks(int argc, char** argv)
+    {
+        if (argc < 3) throw CaretException("run requires an output file name");
+        const AString outName = argv[2];
+        vector<int> threadCounts;
+        int repeats = 3;
+        vector<AString> only;
+        for (int i = 3; i < argc; ++i)
+        {
+            AString option = argv[i];
+            if (i + 1 >= argc) throw CaretException("missing argument to option '" + option + "'");
+            AString value = argv[++i];
+            if (option == "-threads")
+            {
+                threadCounts = parseIntList(value);
+            } else if (option == "-repeats") {
+                repeats = max(1, value.toInt());
+            } else if (option == "-only") {
+                QStringList items = value.split(",", QString::SkipEmptyParts);
+                for (int j = 0; j < items.size(); ++j) only.push_back(items[j]);
+            } else {
+                throw CaretException("unrecognized option '" + option + "'");
+            }
+        }
+        if (threadCounts.empty())
+        {
+            threadCounts.push_back(1);
+#ifdef CARET_OMP
+            if (omp_get_max_threads() > 1) threadCounts.push_back(omp_get_max_threads());
+#endif
+        }
+        cout << "generating synthetic data..." << endl;
+        BenchmarkData data;
+        generateData(data);
+        vector<BenchmarkResult> results;
+        for (int b = 0; b < NUM_BENCHMARKS; ++b)
+        {
+            if (!only.empty() && find(only.begin(), only.end(), AString(BENCHMARKS[b].m_name)) == only.end()) continue;
+            for (int t = 0; t < (int)threadCounts.size(); ++t)
+            {
+#ifdef CARET_OMP
+                omp_set_num_threads(threadCounts[t]);
+#else
+                if (threadCounts[t] != 1) continue;//thread count doesn't apply without openmp
+#endif
+                BENCHMARKS[b].m_function(data);//warm up caches and lazily built helpers
+                BenchmarkResult myResult;
+                myResult.m_name = BENCHMARKS[b].m_name;
+                myResult.m_threads = threadCounts[t];
+                myResult.m_repeats = repeats;
+                myResult.m_seconds = -1.0;
+                for (int r = 0; r < repeats; ++r)
+                {
+                    ElapsedTimer myTimer;
+                    myTimer.start();
+                    BENCHMARKS[b].m_function(data);
+                    double seconds = myTimer.getElapsedTimeSeconds();
+                    if (myResult.m_seconds < 0.0 || seconds < myResult.m_seconds) myResult.m_seconds = seconds;
+                }
+                cout << myResult.m_name << " (" << myResult.m_threads << " threads): " << myResult.m_seconds << " seconds" << endl;
+                results.push_back(myResult);
+            }
+        }
+        QFile::remove(data.m_seriesFileName);
+        writeResults(outName, results);
+        return 0;
+    }
+
+    int compareResults(int argc, char** argv)
+    {
+        if (argc < 4) throw CaretException("compare requires a baseline and a results file");
+        double tolerance = 0.15;
+        for (int i = 4; i + 1 < argc; i += 2)
+        {
+            if (AString(argv[i]) != "-tolerance") throw CaretException("unrecognized option '" + AString(argv[i]) + "'");
+            tolerance = AString(argv[i + 1]).toDouble();
+        }
+        map<AString, double> baseline = readResults(argv[2]), current = readResults(argv[3]);
+        int numRegressed = 0;
+        for (map<AString, double>::iterator iter = current.begin(); iter != current.end(); ++iter)
+        {
+            map<AString, double>::iterator baseIter = baseline.find(iter->first);
+            if (baseIter == baseline.end())
+            {
+                cout << iter->first << ": " << iter->second << " seconds, no baseline" << endl;
+                continue;
+            }
+            double ratio = iter->second / baseIter->second;
+            bool regressed = ratio > 1.0 + tolerance;
+            if (regressed) ++numRegressed;
+            cout << iter->first << ": " << baseIter->second << " -> " << iter->second << " seconds ("
+                 << QString::number((ratio - 1.0) * 100.0, 'f', 1) << "%)" << (regressed ? "  REGRESSION" : "") << endl;
+        }
+        if (numRegressed != 0)
+        {
+            cout << numRegressed << " benchmarks regressed by more than " << tolerance * 100.0 << "%" << endl;
+            return 1;
+        }
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    int ret = 0;
+    {
+        QCoreApplication myApp(argc, argv);
+        caret_global_commandLine_init(argc, argv);
+        SessionManager::createSessionManager(ApplicationTypeEnum::APPLICATION_TYPE_COMMAND_LINE);
+        AString mode = (argc > 1 ? AString(argv[1]) : AString());
+        try
+        {
+            if (mode == "run")
+            {
+                ret = runBenchmarks(argc, argv);
+            } else if (mode == "compare") {
+                ret = compareResults(argc, argv);
+            } else if (mode == "list") {
+                for (int i = 0; i < NUM_BENCHMARKS; ++i) cout << BENCHMARKS[i].m_name << endl;
+            } else {
+                cout << "usage:" << endl
+                     << "  benchmark_driver run <results.json> [-threads <n,n,...>] [-repeats <n>] [-only <name,name,...>]" << endl
+                     << "  benchmark_driver compare <baseline.json> <results.json> [-tolerance <fraction>]" << endl
+                     << "  benchmark_driver list" << endl;
+                ret = 1;
+            }
+        } catch (CaretException& e) {
+            cout << "benchmark failed: " << e.whatString() << endl;
+            ret = 1;
+        }
+        CommandOperationManager::deleteCommandOperationManager();
+        SessionManager::deleteSessionManager();
+        CaretHttpManager::deleteHttpManager();
+        myApp.processEvents();
+    }
+    return ret;
+}
@@ -34,20 +34,26 @@
 
 //tests
 #include "CiftiFileTest.h"
+#include "ClusterGraphTest.h"
+#include "CompressedFileTest.h"
 #include "DotTest.h"
 #include "GeodesicHelperTest.h"
 #include "HttpTest.h"
 #include "HeapTest.h"
 #include "LookupTest.h"
 #include "MathExpressionTest.h"
+#include "MetricGradientTest.h"
 #include "NiftiTest.h"
 #include "PointerTest.h"
 #include "ProgressTest.h"
 #include "QuatTest.h"
 #include "StatisticsTest.h"
+#include "StreamingReductionTest.h"
+#include "SurfaceProjectorTest.h"
 #include "TimerTest.h"
 #include "TopologyHelperTest.h"
 #include "VolumeFileTest.h"
+#include "WbsparseTest.h"
 #include "XnatTest.h"
 
 using namespace std;
@@ -70,21 +76,27 @@ int main(int argc, char** argv)
         SessionManager::createSessionManager(ApplicationTypeEnum::APPLICATION_TYPE_COMMAND_LINE);
         vector<TestInterface*> mytests;
         mytests.push_back(new CiftiFileTest("ciftifile"));
+        mytests.push_back(new ClusterGraphTest("clustergraph"));
+        mytests.push_back(new CompressedFileTest("compressedfile"));
         mytests.push_back(new DotTest("dotsimd"));
         mytests.push_back(new GeodesicHelperTest("geohelp"));
         mytests.push_back(new HeapTest("heap"));
         mytests.push_back(new HttpTest("http"));
         mytests.push_back(new LookupTest("lookup"));
         mytests.push_back(new MathExpressionTest("mathexpression"));
+        mytests.push_back(new MetricGradientTest("metricgradient"));
         mytests.push_back(new NiftiFileTest("niftifile"));
         mytests.push_back(new NiftiHeaderTest("niftiheader"));
         mytests.push_back(new PointerTest("pointer"));
         mytests.push_back(new ProgressTest("progress"));
         mytests.push_back(new QuatTest("quaternion"));
         mytests.push_back(new StatisticsTest("statistics"));
+        mytests.push_back(new StreamingReductionTest("streamingreduction"));
+        mytests.push_back(new SurfaceProjectorTest("surfaceprojector"));
         mytests.push_back(new TimerTest("timer"));
         mytests.push_back(new TopologyHelperTest("topohelp"));
         mytests.push_back(new VolumeFileTest("volumefile"));
+        mytests.push_back(new WbsparseTest("wbsparse"));
         mytests.push_back(new XnatTest("xnat"));
         if (argc < 2)
         {